@@ -2,7 +2,11 @@
 
 #include <functional>
 
+#include "envoy/api/io_error.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/optref.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
 #include "envoy/network/address.h"
 #include "envoy/thread_local/thread_local.h"
 
@@ -52,9 +56,12 @@ private:
  * @param user_data is any data attached to an entry submitted to the submission
  * queue.
  * @param result is a return code of submitted system call.
+ * @param flags are the flags of the completion, e.g. IORING_CQE_F_MORE if more completions of the
+ * same multishot request follow. Injected completions have no flags.
  * @param injected indicates whether the completion is injected or not.
  */
-using CompletionCb = std::function<void(Request* user_data, int32_t result, bool injected)>;
+using CompletionCb =
+    std::function<void(Request* user_data, int32_t result, uint32_t flags, bool injected)>;
 
 /**
  * Callback for releasing the user data.
@@ -101,6 +108,15 @@ public:
   virtual IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr,
                                       socklen_t* remote_addr_len, Request* user_data) PURE;
 
+  /**
+   * Prepares a multishot accept and puts it into the submission queue. The request completes
+   * once for every accepted connection, with IORING_CQE_F_MORE set as long as it keeps accepting.
+   * The remote addresses of the connections are not reported.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareMultishotAccept(os_fd_t fd, Request* user_data) PURE;
+
   /**
    * Prepares a connect system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -118,6 +134,17 @@ public:
   virtual IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                      off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a read into a buffer registered with registerBuffers() and puts it into the
+   * submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   * @param buf the memory to read into, which must be within the registered buffer.
+   * @param buf_index the index of the registered buffer.
+   */
+  virtual IoUringResult prepareReadFixed(os_fd_t fd, void* buf, unsigned nbytes, off_t offset,
+                                         int buf_index, Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -133,6 +160,21 @@ public:
    */
   virtual IoUringResult prepareClose(os_fd_t fd, Request* user_data) PURE;
 
+  /**
+   * Prepares a cancellation and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   * @param cancelling_user_data the user data of the request to be cancelled.
+   */
+  virtual IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) PURE;
+
+  /**
+   * Prepares a shutdown system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
@@ -143,6 +185,14 @@ public:
    */
   virtual IoUringResult submit() PURE;
 
+  /**
+   * Registers buffers with the ring, so that the kernel does not map their pages for every read
+   * into them with prepareReadFixed().
+   * Returns IoUringResult::Ok in case of success and IoUringResult::Failed otherwise, e.g. if the
+   * buffers exceed the locked memory limit of the process.
+   */
+  virtual IoUringResult registerBuffers(const struct iovec* iovecs, unsigned nr_iovecs) PURE;
+
   /**
    * Inject a request completion into the io_uring. Those completions will be iterated
    * when calling the `forEveryCompletion`. This is used to inject an emulated iouring
@@ -251,6 +301,85 @@ public:
    * @param type the request type of injected completion.
    */
   virtual void injectCompletion(Request::RequestType type) PURE;
+
+  /**
+   * Set the callback which is invoked with Event::FileReadyType events when the socket becomes
+   * readable or writable. A nullptr callback stops delivering events.
+   */
+  virtual void setFileReadyCb(Event::FileReadyCb cb) PURE;
+
+  /**
+   * Enable the delivery of the given Event::FileReadyType events. Enabling Read starts reading
+   * from (or accepting on) the socket, disabling it stops submitting new requests.
+   */
+  virtual void enableFileEvents(uint32_t events) PURE;
+
+  /**
+   * Deliver the given Event::FileReadyType events in the next completion iteration.
+   */
+  virtual void activateFileEvents(uint32_t events) PURE;
+
+  /**
+   * Close the socket. In-flight reads and accepts are cancelled, pending writes are flushed
+   * and the socket is released once all requests completed. No file events are delivered after
+   * this call.
+   */
+  virtual void close() PURE;
+
+  /**
+   * Accept a connection on a listening socket.
+   * @param addr supplies the remote address of the accepted connection.
+   * @param addrlen supplies the length of addr, and is set to the length of the remote address.
+   * @return the fd of the accepted connection, or INVALID_SOCKET if none is pending.
+   */
+  virtual os_fd_t accept(struct sockaddr* addr, socklen_t* addrlen) PURE;
+
+  /**
+   * Connect the socket to the given address. The socket becomes writable once the connect
+   * completes, @see connectError().
+   */
+  virtual void connect(const Network::Address::InstanceConstSharedPtr& address) PURE;
+
+  /**
+   * @return the errno of a failed connect, or 0.
+   */
+  virtual int32_t connectError() const PURE;
+
+  /**
+   * Read data which was received on the socket.
+   * @param buffer supplies the buffer to move the data into.
+   * @param max_length supplies the maximum number of bytes to move.
+   * @return the number of bytes moved, 0 if the peer closed the connection, EAGAIN if no data
+   *         is available yet, or the error of the last read.
+   */
+  virtual Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) PURE;
+
+  /**
+   * Copy data which was received on the socket, like recv(2).
+   * @param buffer supplies the memory to copy the data into.
+   * @param length supplies the size of the memory.
+   * @param flags supplies the recv(2) flags. Only MSG_PEEK is supported, which leaves the data
+   *        in the socket and keeps reading ahead until at least length bytes are available.
+   * @return the number of bytes copied, with the same errors as read().
+   */
+  virtual Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) PURE;
+
+  /**
+   * Write data to the socket. The data is moved out of the buffer and written asynchronously.
+   * @return the number of bytes accepted, EAGAIN if a previous write is still pending, in which
+   *         case a Write event is delivered once it completes, or the error of the last write.
+   */
+  virtual Api::IoCallUint64Result write(Buffer::Instance& buffer) PURE;
+
+  /**
+   * Same as write(Buffer::Instance&), but copies the data out of the given slices.
+   */
+  virtual Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) PURE;
+
+  /**
+   * Shutdown the socket. Shutting down the write side is delayed until pending writes completed.
+   */
+  virtual void shutdown(int how) PURE;
 };
 
 using IoUringSocketPtr = std::unique_ptr<IoUringSocket>;
@@ -266,6 +395,33 @@ public:
    * Return the current thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Add a listening socket to the worker. Connections are accepted through io_uring.
+   * @param fd the fd of the listening socket.
+   * @param cb the callback which is invoked with a Read event when connections are accepted.
+   */
+  virtual IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Add an accepted, connected socket to the worker.
+   * @param fd the fd of the socket.
+   * @param cb the callback which is invoked when the socket becomes readable or writable.
+   */
+  virtual IoUringSocket& addServerSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Add a socket which is not connected yet to the worker. Reading starts once the socket was
+   * connected with IoUringSocket::connect().
+   * @param fd the fd of the socket.
+   * @param cb the callback which is invoked when the socket becomes readable or writable.
+   */
+  virtual IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Return the number of sockets in this worker.
+   */
+  virtual uint32_t getNumOfSockets() const PURE;
 };
 
 /**
@@ -288,5 +444,30 @@ public:
   virtual void onServerInitialized() PURE;
 };
 
+/**
+ * Abstract factory for per-thread IoUringWorkers.
+ */
+class IoUringWorkerFactory {
+public:
+  virtual ~IoUringWorkerFactory() = default;
+
+  /**
+   * Returns the IoUringWorker of the current thread, or an empty reference if the current thread
+   * has none.
+   */
+  virtual OptRef<IoUringWorker> getIoUringWorker() PURE;
+
+  /**
+   * Initializes a worker on every registered thread. This must be called on the main thread
+   * before the worker threads start.
+   */
+  virtual void onWorkerThreadInitialized() PURE;
+
+  /**
+   * Returns true if the current thread has an IoUringWorker.
+   */
+  virtual bool currentThreadRegistered() PURE;
+};
+
 } // namespace Io
 } // namespace Envoy
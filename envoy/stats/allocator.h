@@ -94,6 +94,25 @@ public:
   virtual void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const PURE;
   virtual void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const PURE;
 
+  /**
+   * Starts tracking which stats change, so that forEachChangedSinked*() only visits the stats
+   * which changed since they were last visited by it. Stats which exist when this is called are
+   * all considered changed.
+   */
+  virtual void trackChangedStats() PURE;
+
+  /**
+   * Iterate over the stats that need to be flushed to sinks which changed since they were last
+   * visited by this method, if changed stats are tracked, or else over all the stats that need to
+   * be flushed to sinks. The same locking caveats as forEachSinked*() apply.
+   * @param f_size functor that is provided the number of stats that will be visited.
+   * Note that this is called only once, prior to any calls to f_stat.
+   * @param f_stat functor that is provided one stat that will be flushed to sinks, at a time.
+   */
+  virtual void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) PURE;
+  virtual void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) PURE;
+  virtual void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) PURE;
+
   /**
    * Set the predicates to filter stats for sink.
    */
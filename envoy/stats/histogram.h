@@ -24,6 +24,12 @@ public:
    * @return The buckets for the histogram. Each value is an upper bound of a bucket.
    */
   virtual ConstSupportedBuckets& buckets(absl::string_view stat_name) const PURE;
+
+  /**
+   * @return true if histograms record values into fixed log-linear buckets, which are added up at
+   *         every flush, rather than into per-thread histograms which are merged at every flush.
+   */
+  virtual bool fixedBucketHistograms() const PURE;
 };
 
 using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
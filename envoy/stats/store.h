@@ -140,6 +140,20 @@ public:
   virtual void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const PURE;
   virtual void forEachSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) const PURE;
 
+  /**
+   * Iterate over the stats that need to be flushed to sinks which changed since the previous
+   * flush. Counters, gauges and text readouts are only filtered if the store tracks changed stats,
+   * @see StoreRoot::trackChangedStats(), and are otherwise all visited as by forEachSinked*().
+   * Histograms are visited if values were recorded into them in the latest merge interval.
+   * @param f_size functor that is provided the number of stats that will be visited.
+   * Note that this is called only once, prior to any calls to f_stat.
+   * @param f_stat functor that is provided one stat that will be flushed to sinks, at a time.
+   */
+  virtual void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) PURE;
+  virtual void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) PURE;
+  virtual void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) PURE;
+  virtual void forEachChangedSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) PURE;
+
   /**
    * Calls 'fn' for every stat. Note that in the case of overlapping scopes, the
    * implementation may call fn more than one time for each counter. Iteration
@@ -261,6 +275,12 @@ public:
   virtual void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) PURE;
 
   virtual OptRef<SinkPredicates> sinkPredicates() PURE;
+
+  /**
+   * Start tracking which counters, gauges and text readouts change, so that
+   * forEachChangedSinked*() only visits the stats which changed since the previous flush.
+   */
+  virtual void trackChangedStats() PURE;
 };
 
 using StoreRootPtr = std::unique_ptr<StoreRoot>;
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "envoy/common/optref.h"
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/network/address.h"
@@ -86,6 +88,40 @@ public:
 
 class ClusterInfo;
 
+/**
+ * Per host data of a load balancing policy, e.g. the observed latency of the host. The data is
+ * shared by the load balancers of the policy on all threads, so implementations must be thread
+ * safe.
+ */
+class HostLbPolicyData {
+public:
+  virtual ~HostLbPolicyData() = default;
+
+  /**
+   * Called when the response headers of a request sent to the host have been received.
+   * @param rtt the time from sending the first byte of the request to receiving the response
+   *        headers.
+   */
+  virtual void onRequestRtt(std::chrono::microseconds rtt) PURE;
+
+  /**
+   * Called when a request sent to the host ended before its response headers were received, e.g.
+   * because it timed out or its stream was reset.
+   * @param elapsed the time from sending the first byte of the request until it ended, which is a
+   *        lower bound of its round trip time.
+   */
+  virtual void onRequestFailure(std::chrono::microseconds elapsed) PURE;
+
+  /**
+   * @return the gauges of the host which are specific to the policy. These are reported along with
+   *         the other host stats, e.g. by the /clusters admin endpoint.
+   */
+  virtual std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
+  gauges() const PURE;
+};
+
+using HostLbPolicyDataPtr = std::unique_ptr<HostLbPolicyData>;
+
 /**
  * A description of an upstream host.
  */
@@ -129,6 +165,11 @@ public:
    */
   virtual Outlier::DetectorHostMonitor& outlierDetector() const PURE;
 
+  /**
+   * @return the data of the load balancing policy of the host's cluster, if the policy keeps any.
+   */
+  virtual OptRef<HostLbPolicyData> lbPolicyData() const PURE;
+
   /**
    * @return the host's health checker monitor.
    */
@@ -282,6 +282,13 @@ public:
    */
   virtual void setOutlierDetector(Outlier::DetectorHostMonitorPtr&& outlier_detector) PURE;
 
+  /**
+   * Set the data of the load balancing policy of the host's cluster. Like the monitors, the data
+   * must be installed before the host is used across threads, so this routine should only be
+   * called on the main thread before the host is used across threads.
+   */
+  virtual void setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) PURE;
+
   /**
    * Set the timestamp of when the host has transitioned from unhealthy to healthy state via an
    * active health checking.
@@ -393,6 +400,38 @@ using LocalityWeights = std::vector<uint32_t>;
 using LocalityWeightsSharedPtr = std::shared_ptr<LocalityWeights>;
 using LocalityWeightsConstSharedPtr = std::shared_ptr<const LocalityWeights>;
 
+/**
+ * The hosts added to and removed from a host list by an update.
+ */
+struct HostListDelta {
+  HostVector added;
+  HostVector removed;
+  // Whether the weights of all hosts in the updated list are equal.
+  bool weights_equal{};
+};
+
+/**
+ * The changes made to each host list of a host set by an update, which allows consumers of the
+ * host set to update state derived from the lists in place rather than rebuilding it. The delta is
+ * only valid against the lists it was computed from, which it holds on to so that they can be
+ * compared by identity.
+ */
+struct HostSetDelta {
+  HostVectorConstSharedPtr base_hosts;
+  HealthyHostVectorConstSharedPtr base_healthy_hosts;
+  DegradedHostVectorConstSharedPtr base_degraded_hosts;
+  HostsPerLocalityConstSharedPtr base_healthy_hosts_per_locality;
+  HostsPerLocalityConstSharedPtr base_degraded_hosts_per_locality;
+
+  HostListDelta hosts;
+  HostListDelta healthy_hosts;
+  HostListDelta degraded_hosts;
+  std::vector<HostListDelta> healthy_hosts_per_locality;
+  std::vector<HostListDelta> degraded_hosts_per_locality;
+};
+
+using HostSetDeltaConstSharedPtr = std::shared_ptr<const HostSetDelta>;
+
 /**
  * Base host set interface. This contains all of the endpoints for a given LocalityLbEndpoints
  * priority level.
@@ -520,6 +559,13 @@ public:
    * @return true to use host weights to calculate the health of a priority.
    */
   virtual bool weightedPriorityHealth() const PURE;
+
+  /**
+   * @return the changes made to the host lists by the update which is in progress, if it was
+   * made with a delta that applies to the previous lists. Only set while the update callbacks of
+   * the host set run, and nullptr otherwise.
+   */
+  virtual const HostSetDelta* lastUpdateDelta() const PURE;
 };
 
 using HostSetPtr = std::unique_ptr<HostSet>;
@@ -584,6 +630,8 @@ public:
     HostsPerLocalityConstSharedPtr healthy_hosts_per_locality;
     HostsPerLocalityConstSharedPtr degraded_hosts_per_locality;
     HostsPerLocalityConstSharedPtr excluded_hosts_per_locality;
+    // The changes from the current lists of the host set to the lists above, if known.
+    HostSetDeltaConstSharedPtr delta;
   };
 
   /**
@@ -888,6 +936,18 @@ public:
 };
 using ProtocolOptionsConfigConstSharedPtr = std::shared_ptr<const ProtocolOptionsConfig>;
 
+/**
+ * Extension protocol options which create the sockets of the upstream connections of a cluster with
+ * a specific socket interface, instead of the socket interface of the addresses of its hosts.
+ */
+class SocketInterfaceProtocolOptionsConfig : public ProtocolOptionsConfig {
+public:
+  /**
+   * @return the socket interface of the upstream connections.
+   */
+  virtual const Network::SocketInterface& socketInterface() const PURE;
+};
+
 /**
  *  Base class for all cluster typed metadata factory.
  */
@@ -1084,6 +1144,13 @@ public:
    */
   virtual OptRef<const envoy::config::core::v3::TypedExtensionConfig> upstreamConfig() const PURE;
 
+  /**
+   * @return the socket interface which creates the sockets of upstream connections, if it is
+   *         selected by the extension protocol options of the cluster, or nullptr if the socket
+   *         interface of the host addresses is used.
+   */
+  virtual const Network::SocketInterface* upstreamSocketInterface() const PURE;
+
   /**
    * @return Whether the cluster is currently in maintenance mode and should not be routed to.
    *         Different filters may handle this situation in different ways. The implementation
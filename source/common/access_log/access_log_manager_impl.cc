@@ -9,6 +9,7 @@
 #include "source/common/common/lock_guard.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -40,14 +41,68 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   return access_logs_[file_name];
 }
 
+namespace {
+
+uint64_t nextFileId() {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id++;
+}
+
+} // namespace
+
+AccessLogWriteRing::AccessLogWriteRing(uint64_t capacity)
+    : buffer_(std::make_unique<char[]>(capacity)), capacity_(capacity) {
+  ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+}
+
+absl::optional<uint64_t> AccessLogWriteRing::tryWrite(absl::string_view data) {
+  const uint64_t write_position = write_position_.load(std::memory_order_relaxed);
+  const uint64_t buffered = write_position - read_position_.load(std::memory_order_acquire);
+  if (data.size() > capacity_ - buffered) {
+    return absl::nullopt;
+  }
+  if (data.empty()) {
+    return buffered;
+  }
+  const uint64_t offset = write_position & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(data.size(), capacity_ - offset);
+  memcpy(buffer_.get() + offset, data.data(), first); // NOLINT(safe-memcpy)
+  if (first < data.size()) {
+    memcpy(buffer_.get(), data.data() + first, data.size() - first); // NOLINT(safe-memcpy)
+  }
+  write_position_.store(write_position + data.size(), std::memory_order_release);
+  return buffered;
+}
+
+uint64_t AccessLogWriteRing::readableSlices(std::vector<absl::string_view>& slices) const {
+  const uint64_t read_position = read_position_.load(std::memory_order_relaxed);
+  const uint64_t length = write_position_.load(std::memory_order_acquire) - read_position;
+  if (length == 0) {
+    return 0;
+  }
+  const uint64_t offset = read_position & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(length, capacity_ - offset);
+  slices.emplace_back(buffer_.get() + offset, first);
+  if (first < length) {
+    slices.emplace_back(buffer_.get(), length - first);
+  }
+  return length;
+}
+
+void AccessLogWriteRing::release(uint64_t length) {
+  const uint64_t read_position = read_position_.load(std::memory_order_relaxed);
+  ASSERT(length <= write_position_.load(std::memory_order_relaxed) - read_position);
+  read_position_.store(read_position + length, std::memory_order_release);
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
                                      Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
+    : id_(nextFileId()), file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        notifyFlushThread();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
       thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
@@ -73,26 +128,33 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 }
 
 void AccessLogFileImpl::reopen() {
-  Thread::LockGuard lock(write_lock_);
+  Thread::LockGuard lock(flush_event_lock_);
   reopen_file_ = true;
   flush_event_.notifyOne();
 }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
   {
-    Thread::LockGuard lock(write_lock_);
+    Thread::LockGuard lock(flush_event_lock_);
     flush_thread_exit_ = true;
     flush_event_.notifyOne();
   }
 
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
+  // The flush thread takes writers_lock_ while flushing, so it must not be held while joining.
+  Thread::ThreadPtr flush_thread;
+  {
+    Thread::LockGuard lock(writers_lock_);
+    flush_thread = std::move(flush_thread_);
+  }
+  if (flush_thread != nullptr) {
+    flush_thread->join();
   }
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    {
+      Thread::LockGuard flush_lock(flush_lock_);
+      doWrite();
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -100,8 +162,32 @@ AccessLogFileImpl::~AccessLogFileImpl() {
   }
 }
 
-void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
-  Buffer::RawSliceVector slices = buffer.getRawSlices();
+bool AccessLogFileImpl::doWrite() {
+  slices_to_write_.clear();
+  {
+    Thread::LockGuard writers_lock(writers_lock_);
+    for (const auto& writer : writers_) {
+      // Taking the overflow lock makes sure that all data the thread wrote to its ring before
+      // switching to the overflow buffer is visible, so the data of each thread stays in order.
+      Thread::LockGuard overflow_lock(writer->overflow_lock_);
+      writer->ring_read_length_ = writer->ring_.readableSlices(slices_to_write_);
+      if (writer->overflow_buffer_.length() > 0) {
+        writer->about_to_write_buffer_.move(writer->overflow_buffer_);
+        writer->overflowed_.store(false, std::memory_order_release);
+        for (const Buffer::RawSlice& slice : writer->about_to_write_buffer_.getRawSlices()) {
+          slices_to_write_.emplace_back(static_cast<const char*>(slice.mem_), slice.len_);
+        }
+      }
+    }
+  }
+  if (slices_to_write_.empty()) {
+    return false;
+  }
+
+  uint64_t length = 0;
+  for (absl::string_view slice : slices_to_write_) {
+    length += slice.size();
+  }
 
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
   // different AccessLogFileImpl pointing to the same underlying file. This can happen either via
@@ -113,20 +199,25 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     Thread::LockGuard lock(file_lock_);
-    for (const Buffer::RawSlice& slice : slices) {
-      absl::string_view data(static_cast<char*>(slice.mem_), slice.len_);
-      const Api::IoCallSizeResult result = file_->write(data);
-      if (result.ok() && result.return_value_ == static_cast<ssize_t>(slice.len_)) {
-        stats_.write_completed_.inc();
-      } else {
-        // Probably disk full.
-        stats_.write_failed_.inc();
-      }
+    const Api::IoCallSizeResult result = file_->writev(slices_to_write_);
+    if (result.ok() && result.return_value_ == static_cast<ssize_t>(length)) {
+      stats_.write_completed_.inc();
+    } else {
+      // Probably disk full.
+      stats_.write_failed_.inc();
     }
   }
 
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
+  {
+    Thread::LockGuard writers_lock(writers_lock_);
+    for (const auto& writer : writers_) {
+      writer->ring_.release(writer->ring_read_length_);
+      writer->ring_read_length_ = 0;
+      writer->about_to_write_buffer_.drain(writer->about_to_write_buffer_.length());
+    }
+  }
+  stats_.write_total_buffered_.sub(length);
+  return true;
 }
 
 void AccessLogFileImpl::flushThreadFunc() {
@@ -135,38 +226,37 @@ void AccessLogFileImpl::flushThreadFunc() {
   // accessed while holding the mutex while the actual operation is performed while not holding the
   // mutex.
   bool do_reopen = false;
+  // If the previous flush wrote data, more data was likely written in the meantime. Flush again
+  // right away rather than waiting for the next event.
+  bool wrote_data = true;
 
   while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
-
     {
-      Thread::LockGuard write_lock(write_lock_);
+      Thread::LockGuard flush_event_lock(flush_event_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
+      // flush_event_ can be woken up either by large enough buffered data or by timer.
+      // In case it was timer, there may be no data to write.
       //
       // Note: do not stop waiting when only `do_reopen` is true. In this case, we tried to
       // reopen and failed. We don't want to retry this in a tight loop, so wait for the next
       // event (timer or flush).
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      while (!wrote_data && !flush_pending_ && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
+        flush_event_.wait(flush_event_lock_);
       }
 
       if (flush_thread_exit_) {
         return;
       }
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-
+      flush_pending_ = false;
       if (reopen_file_) {
         do_reopen = true;
         reopen_file_ = false;
       }
     }
 
+    Thread::LockGuard flush_lock(flush_lock_);
     if (do_reopen) {
       if (file_->isOpen()) {
         const Api::IoCallBoolResult result = file_->close();
@@ -181,52 +271,85 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
     }
     // doWrite no matter file isOpen, if not, we can drain buffer
-    doWrite(about_to_write_buffer_);
+    wrote_data = doWrite();
   }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
+  // flush_lock_ also makes sure that data which the flush thread is writing has been written to
+  // disk before returning.
+  Thread::LockGuard flush_lock(flush_lock_);
+  doWrite();
+}
 
+void AccessLogFileImpl::notifyFlushThread() {
   {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+    Thread::LockGuard lock(flush_event_lock_);
+    flush_pending_ = true;
   }
+  flush_event_.notifyOne();
+}
 
-  doWrite(about_to_write_buffer_);
+AccessLogFileImpl::Writer& AccessLogFileImpl::writerForThisThread() {
+  // Keyed by file id rather than by address, so that entries of destroyed files are never used
+  // again. Those entries are only freed when the thread exits, but files are rarely destroyed.
+  static thread_local absl::flat_hash_map<uint64_t, Writer*> thread_writers;
+  Writer*& writer = thread_writers[id_];
+  if (writer == nullptr) {
+    Thread::LockGuard lock(writers_lock_);
+    writers_.push_back(std::make_unique<Writer>());
+    writer = writers_.back().get();
+  }
+  return *writer;
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+  Writer& writer = writerForThisThread();
 
-  if (flush_thread_ == nullptr) {
+  // The data may be written to disk as soon as it is buffered, so account for it first.
+  stats_.write_total_buffered_.add(data.length());
+  absl::optional<uint64_t> buffered;
+  if (!writer.overflowed_.load(std::memory_order_acquire)) {
+    buffered = writer.ring_.tryWrite(data);
+  }
+  if (buffered.has_value()) {
+    stats_.write_buffered_.inc();
+    if (buffered.value() <= MIN_FLUSH_SIZE && buffered.value() + data.size() > MIN_FLUSH_SIZE) {
+      notifyFlushThread();
+    }
+  } else {
+    writeToOverflow(writer, data);
+  }
+
+  if (!flush_thread_created_.load(std::memory_order_acquire)) {
     createFlushStructures();
   }
+}
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+void AccessLogFileImpl::writeToOverflow(Writer& writer, absl::string_view data) {
+  {
+    Thread::LockGuard lock(writer.overflow_lock_);
+    if (writer.overflow_buffer_.length() + data.size() > MAX_OVERFLOW_SIZE) {
+      stats_.write_dropped_.inc();
+      stats_.write_total_buffered_.sub(data.length());
+      return;
+    }
+    stats_.write_backpressured_.inc();
+    stats_.write_buffered_.inc();
+    writer.overflow_buffer_.add(data.data(), data.size());
+    writer.overflowed_.store(true, std::memory_order_release);
   }
+  notifyFlushThread();
 }
 
 void AccessLogFileImpl::createFlushStructures() {
+  Thread::LockGuard lock(writers_lock_);
+  if (flush_thread_ != nullptr) {
+    return;
+  }
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
+  flush_thread_created_.store(true, std::memory_order_release);
 }
 
 } // namespace AccessLog
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -13,15 +16,19 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_backpressured)                                                                     \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -55,12 +62,59 @@ private:
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
+/**
+ * Single producer, single consumer byte ring which is filled by one thread writing to an
+ * AccessLogFileImpl without taking a lock. The flush thread writes the data straight out of the
+ * ring, and then releases the space.
+ */
+class AccessLogWriteRing {
+public:
+  /**
+   * @param capacity the ring size in bytes, which must be a power of two.
+   */
+  explicit AccessLogWriteRing(uint64_t capacity);
+
+  /**
+   * Producer side. Copies all of the data into the ring, or nothing if it does not fit.
+   * @return the number of bytes buffered in the ring before the data was added, or absl::nullopt
+   *         if the data does not fit.
+   */
+  absl::optional<uint64_t> tryWrite(absl::string_view data);
+
+  /**
+   * Consumer side. Appends up to two slices covering all data written so far to the slices.
+   * @return the number of bytes covered by the slices, which must be passed to release() once the
+   *         slices are no longer used.
+   */
+  uint64_t readableSlices(std::vector<absl::string_view>& slices) const;
+
+  /**
+   * Consumer side. Frees the first length bytes of the ring for the producer.
+   */
+  void release(uint64_t length);
+
+  uint64_t capacity() const { return capacity_; }
+
+private:
+  const std::unique_ptr<char[]> buffer_;
+  const uint64_t capacity_;
+  // Only ever increase, the offsets into buffer_ are the positions modulo the capacity. The
+  // positions are on separate cache lines as they are written by different threads.
+  alignas(ABSL_CACHELINE_SIZE) std::atomic<uint64_t> read_position_{0};
+  alignas(ABSL_CACHELINE_SIZE) std::atomic<uint64_t> write_position_{0};
+};
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
  * This implementation uses a flush thread per file, with the idea there aren't that many
  * files. If this turns out to be a good implementation we can potentially have a single flush
  * thread that flushes all files, but we will start with this.
+ *
+ * Each thread writing to the file has its own AccessLogWriteRing, so that workers do not contend
+ * with each other. Data which does not fit into the ring, e.g. while the disk cannot keep up, is
+ * appended to a per thread overflow buffer under a lock instead, and dropped once that is full.
+ * The flush thread collects the data of all threads and writes it with a single writev().
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
@@ -81,8 +135,35 @@ public:
   void reopen() override;
   void flush() override;
 
+  // Size of the ring of each thread writing to the file.
+  static constexpr uint64_t RING_SIZE = 1024 * 256;
+  // Maximum size of the overflow buffer of each thread, beyond which data is dropped.
+  static constexpr uint64_t MAX_OVERFLOW_SIZE = 1024 * 1024 * 16;
+
 private:
-  void doWrite(Buffer::Instance& buffer);
+  struct Writer {
+    Writer() : ring_(RING_SIZE) {}
+
+    AccessLogWriteRing ring_;
+    // Set by the producer when data was appended to the overflow buffer, and cleared by the
+    // consumer when the overflow buffer was drained. While set, the producer bypasses the ring so
+    // that the data of a thread is written in order.
+    std::atomic<bool> overflowed_{false};
+    Thread::MutexBasicLockable overflow_lock_;
+    Buffer::OwnedImpl overflow_buffer_ ABSL_GUARDED_BY(overflow_lock_);
+    // Only used while flushing, under the flush_lock_ of the file.
+    uint64_t ring_read_length_{0};
+    Buffer::OwnedImpl about_to_write_buffer_; // The overflow buffer is moved here under lock, and
+                                              // then the lock is released so that it can continue
+                                              // to fill. This buffer is then used for the final
+                                              // write to disk.
+  };
+
+  Writer& writerForThisThread();
+  void writeToOverflow(Writer& writer, absl::string_view data);
+  void notifyFlushThread();
+  // Writes all data buffered by the writers, returns whether there was any.
+  bool doWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(flush_lock_);
   void flushThreadFunc();
   Api::IoCallBoolResult open();
   void createFlushStructures();
@@ -93,41 +174,35 @@ private:
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
 
+  // Identifies the file in the thread local writer lookup, as opposed to the address of the file
+  // which may be reused.
+  const uint64_t id_;
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
-  //    3) file_lock_
+  //    1) flush_lock_
+  //    2) writers_lock_ or file_lock_
+  //    3) Writer::overflow_lock_
+  // flush_event_lock_ is never held together with another lock.
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
                                           // the same file during hot-restart.
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
                                           // the flush thread and a synchronous flush. This protects
-                                          // concurrent access to the about_to_write_buffer_, fd_,
-                                          // and all other data used during flushing and file
-                                          // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
+                                          // the consumer side of the writers, fd_, and all other
+                                          // data used during flushing and file re-opening.
+  Thread::MutexBasicLockable writers_lock_; // Protects the list of writers, which grows when a
+                                            // thread first writes to the file.
+  std::vector<std::unique_ptr<Writer>> writers_ ABSL_GUARDED_BY(writers_lock_);
+  Thread::MutexBasicLockable flush_event_lock_; // Used to signal the flush thread.
+  Thread::ThreadPtr flush_thread_ ABSL_GUARDED_BY(writers_lock_);
+  std::atomic<bool> flush_thread_created_{false};
   Thread::CondVar flush_event_;
-  bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){false};
-  bool reopen_file_ ABSL_GUARDED_BY(write_lock_){false};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
-  // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
-  // through the std::make_unique assignment. I do not believe it's possible to annotate this
-  // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  bool flush_thread_exit_ ABSL_GUARDED_BY(flush_event_lock_){false};
+  bool reopen_file_ ABSL_GUARDED_BY(flush_event_lock_){false};
+  bool flush_pending_ ABSL_GUARDED_BY(flush_event_lock_){false};
+  std::vector<absl::string_view> slices_to_write_ ABSL_GUARDED_BY(flush_lock_);
   Event::TimerPtr flush_timer_;
   Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
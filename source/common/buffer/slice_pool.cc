@@ -0,0 +1,357 @@
+#include "source/common/buffer/slice_pool.h"
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace Envoy {
+namespace Buffer {
+
+std::atomic<bool> SlicePool::enabled_{false};
+std::atomic<uint64_t> SlicePool::max_cached_bytes_per_thread_{0};
+std::atomic<uint64_t> SlicePool::max_arena_bytes_per_thread_{0};
+std::atomic<bool> SlicePool::use_huge_pages_{false};
+
+namespace {
+
+constexpr uint32_t NumSizeClasses = SlicePool::max_pooled_size_ / SlicePool::page_size_;
+
+struct FreeBlock {
+  uint8_t* mem_;
+  bool from_arena_;
+};
+
+struct ReturnedBlock {
+  uint8_t* mem_;
+  uint32_t size_;
+};
+
+// The header of an arena, placed in its first page. Arenas are aligned to their size, so the
+// header of the arena that storage was carved from is found from the address of the storage.
+struct Arena {
+  Arena(uint64_t owner_id, bool mapped) : owner_id_(owner_id), mapped_(mapped) {}
+
+  // The id of the ThreadLocalCache that carves storage from the arena.
+  const uint64_t owner_id_;
+  // Whether the arena was mapped with mmap(), rather than allocated from the heap.
+  const bool mapped_;
+  // The number of blocks carved from the arena which are neither in the free lists of the owner
+  // nor in returned_. Only changed by the owner, or with mutex_ held.
+  std::atomic<uint32_t> live_blocks_{};
+  // Set when returned_ is not empty, so that the owner only locks the arena if needed.
+  std::atomic<bool> has_returned_{};
+  absl::Mutex mutex_;
+  // Blocks released by threads other than the owner, which the owner picks up again.
+  std::vector<ReturnedBlock> returned_ ABSL_GUARDED_BY(mutex_);
+  // Set when the owner exited. The arena is freed once live_blocks_ drops to zero.
+  bool owner_exited_ ABSL_GUARDED_BY(mutex_){};
+};
+
+static_assert(sizeof(Arena) <= SlicePool::page_size_, "the arena header must fit in a page");
+
+std::atomic<uint64_t> next_cache_id{1};
+
+struct ThreadLocalCache {
+  ~ThreadLocalCache();
+
+  // Frees the cached heap storage, and hands the arenas over to the threads which still use
+  // storage carved from them.
+  void drain();
+
+  // Changed by drain(), after which the arenas of the thread are no longer its own.
+  uint64_t id_{next_cache_id.fetch_add(1, std::memory_order_relaxed)};
+  std::array<std::vector<FreeBlock>, NumSizeClasses> free_lists_;
+  uint64_t cached_bytes_{};
+  // The arenas owned by this thread.
+  std::vector<Arena*> arenas_;
+  // Unused remainder of the current arena.
+  uint8_t* arena_cursor_{};
+  uint8_t* arena_end_{};
+  uint64_t arena_bytes_{};
+  SlicePoolStats* stats_{};
+};
+
+// Slices may be destroyed by other thread local objects after the cache itself was destroyed at
+// thread exit. This trivially destructible flag remains valid during that time, and is used to
+// release storage directly instead of touching the destroyed cache.
+thread_local bool cache_destroyed = false;
+thread_local ThreadLocalCache cache;
+
+uint32_t sizeClass(uint64_t size) { return size / SlicePool::page_size_ - 1; }
+
+Arena* arenaOf(uint8_t* mem) {
+  return reinterpret_cast<Arena*>(reinterpret_cast<uintptr_t>(mem) &
+                                  ~(SlicePool::arena_size_ - 1));
+}
+
+void freeArena(Arena* arena) {
+  const bool mapped = arena->mapped_;
+  arena->~Arena();
+#ifdef __linux__
+  if (mapped) {
+    ::munmap(arena, SlicePool::arena_size_);
+    return;
+  }
+#endif
+  ASSERT(!mapped);
+  std::free(arena);
+}
+
+Arena* allocateArena(uint64_t owner_id) {
+#ifdef __linux__
+  // Prefer explicitly reserved huge pages, and fall back to transparent huge pages.
+  void* mem = ::mmap(nullptr, SlicePool::arena_size_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (mem != MAP_FAILED) {
+    if (reinterpret_cast<uintptr_t>(mem) % SlicePool::arena_size_ == 0) {
+      return new (mem) Arena(owner_id, true);
+    }
+    // The default huge page size is smaller than an arena.
+    ::munmap(mem, SlicePool::arena_size_);
+  }
+  mem = std::aligned_alloc(SlicePool::arena_size_, SlicePool::arena_size_);
+  if (mem == nullptr) {
+    return nullptr;
+  }
+  ::madvise(mem, SlicePool::arena_size_, MADV_HUGEPAGE);
+  return new (mem) Arena(owner_id, false);
+#else
+  UNREFERENCED_PARAMETER(owner_id);
+  return nullptr;
+#endif
+}
+
+// Releases arena storage on a thread other than the owner of the arena, or after the owner exited.
+void releaseToArena(uint8_t* mem, uint32_t size) {
+  Arena* arena = arenaOf(mem);
+  bool free_arena = false;
+  {
+    absl::MutexLock lock(&arena->mutex_);
+    const uint32_t live_blocks = arena->live_blocks_.fetch_sub(1, std::memory_order_relaxed) - 1;
+    if (arena->owner_exited_) {
+      free_arena = live_blocks == 0;
+    } else {
+      arena->returned_.push_back({mem, size});
+      arena->has_returned_.store(true, std::memory_order_release);
+    }
+  }
+  if (free_arena) {
+    freeArena(arena);
+  }
+}
+
+void ThreadLocalCache::drain() {
+  for (auto& free_list : free_lists_) {
+    for (const FreeBlock& block : free_list) {
+      // Arena storage is dropped, and reclaimed with its arena below.
+      if (!block.from_arena_) {
+        delete[] block.mem_;
+      }
+    }
+    free_list.clear();
+  }
+  cached_bytes_ = 0;
+
+  for (Arena* arena : arenas_) {
+    bool free_arena;
+    {
+      absl::MutexLock lock(&arena->mutex_);
+      arena->owner_exited_ = true;
+      arena->returned_.clear();
+      free_arena = arena->live_blocks_.load(std::memory_order_relaxed) == 0;
+    }
+    if (free_arena) {
+      freeArena(arena);
+    }
+  }
+  arenas_.clear();
+  id_ = next_cache_id.fetch_add(1, std::memory_order_relaxed);
+  arena_cursor_ = nullptr;
+  arena_end_ = nullptr;
+  arena_bytes_ = 0;
+}
+
+ThreadLocalCache::~ThreadLocalCache() {
+  cache_destroyed = true;
+  drain();
+}
+
+// Moves the storage that other threads released back to the arenas of the calling thread into
+// its free lists.
+void reclaimReturned(ThreadLocalCache& local) {
+  for (Arena* arena : local.arenas_) {
+    if (!arena->has_returned_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    absl::MutexLock lock(&arena->mutex_);
+    for (const ReturnedBlock& block : arena->returned_) {
+      local.free_lists_[sizeClass(block.size_)].push_back({block.mem_, true});
+    }
+    arena->returned_.clear();
+    arena->has_returned_.store(false, std::memory_order_relaxed);
+  }
+}
+
+// Carves storage from the current arena of the calling thread, allocating a new arena if the
+// current one is exhausted and the thread is within its arena budget.
+uint8_t* allocateFromArena(ThreadLocalCache& local, uint64_t size, uint64_t max_arena_bytes) {
+  if (static_cast<uint64_t>(local.arena_end_ - local.arena_cursor_) < size) {
+    if (local.arena_bytes_ + SlicePool::arena_size_ > max_arena_bytes) {
+      return nullptr;
+    }
+    Arena* arena = allocateArena(local.id_);
+    if (arena == nullptr) {
+      return nullptr;
+    }
+    local.arenas_.push_back(arena);
+    // The first page holds the header. The unused remainder of the previous arena is abandoned.
+    // As slice sizes are page multiples this is at most max_pooled_size_ - page_size_ bytes per
+    // arena.
+    local.arena_cursor_ = reinterpret_cast<uint8_t*>(arena) + SlicePool::page_size_;
+    local.arena_end_ = reinterpret_cast<uint8_t*>(arena) + SlicePool::arena_size_;
+    local.arena_bytes_ += SlicePool::arena_size_;
+    if (local.stats_ != nullptr) {
+      local.stats_->arena_bytes_.set(local.arena_bytes_);
+    }
+  }
+  uint8_t* mem = local.arena_cursor_;
+  local.arena_cursor_ += size;
+  arenaOf(mem)->live_blocks_.fetch_add(1, std::memory_order_relaxed);
+  return mem;
+}
+
+} // namespace
+
+void SliceStorageDeleter::operator()(uint8_t* mem) const {
+  if (pooled_) {
+    SlicePool::release(mem, size_, from_arena_);
+  } else {
+    delete[] mem;
+  }
+}
+
+void SlicePool::configure(const SlicePoolConfig& config) {
+  max_cached_bytes_per_thread_.store(config.max_cached_bytes_per_thread_);
+  max_arena_bytes_per_thread_.store(config.max_arena_bytes_per_thread_);
+  use_huge_pages_.store(config.use_huge_pages_);
+  enabled_.store(true);
+}
+
+void SlicePool::reset() {
+  enabled_.store(false);
+  use_huge_pages_.store(false);
+  max_arena_bytes_per_thread_.store(0);
+  max_cached_bytes_per_thread_.store(0);
+}
+
+SliceStoragePtr SlicePool::allocate(uint64_t size) {
+  ASSERT(size % page_size_ == 0);
+  if (!enabled() || size == 0 || size > max_pooled_size_ || cache_destroyed) {
+    return SliceStoragePtr{new uint8_t[size]};
+  }
+
+  ThreadLocalCache& local = cache;
+  auto& free_list = local.free_lists_[sizeClass(size)];
+  if (free_list.empty()) {
+    reclaimReturned(local);
+  }
+  if (!free_list.empty()) {
+    const FreeBlock block = free_list.back();
+    free_list.pop_back();
+    if (block.from_arena_) {
+      arenaOf(block.mem_)->live_blocks_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      local.cached_bytes_ -= size;
+    }
+    if (local.stats_ != nullptr) {
+      local.stats_->hit_.inc();
+    }
+    return {block.mem_, SliceStorageDeleter(size, block.from_arena_)};
+  }
+
+  if (local.stats_ != nullptr) {
+    local.stats_->miss_.inc();
+  }
+  if (use_huge_pages_.load(std::memory_order_relaxed)) {
+    uint8_t* mem =
+        allocateFromArena(local, size, max_arena_bytes_per_thread_.load(std::memory_order_relaxed));
+    if (mem != nullptr) {
+      return {mem, SliceStorageDeleter(size, true)};
+    }
+  }
+  return {new uint8_t[size], SliceStorageDeleter(size, false)};
+}
+
+void SlicePool::release(uint8_t* mem, uint32_t size, bool from_arena) {
+  if (cache_destroyed) {
+    if (from_arena) {
+      releaseToArena(mem, size);
+    } else {
+      delete[] mem;
+    }
+    return;
+  }
+
+  ThreadLocalCache& local = cache;
+  if (from_arena) {
+    Arena* arena = arenaOf(mem);
+    if (arena->owner_id_ == local.id_) {
+      local.free_lists_[sizeClass(size)].push_back({mem, true});
+      arena->live_blocks_.fetch_sub(1, std::memory_order_relaxed);
+    } else {
+      releaseToArena(mem, size);
+    }
+    if (local.stats_ != nullptr) {
+      local.stats_->release_.inc();
+    }
+    return;
+  }
+
+  if (enabled() &&
+      local.cached_bytes_ + size <= max_cached_bytes_per_thread_.load(std::memory_order_relaxed)) {
+    local.free_lists_[sizeClass(size)].push_back({mem, false});
+    local.cached_bytes_ += size;
+    if (local.stats_ != nullptr) {
+      local.stats_->release_.inc();
+    }
+    return;
+  }
+
+  delete[] mem;
+  if (local.stats_ != nullptr) {
+    local.stats_->overflow_.inc();
+  }
+}
+
+void SlicePool::setThreadLocalStats(SlicePoolStats* stats) {
+  if (!cache_destroyed) {
+    cache.stats_ = stats;
+    if (stats != nullptr) {
+      stats->arena_bytes_.set(cache.arena_bytes_);
+    }
+  }
+}
+
+uint64_t SlicePool::cachedBytesForTest() { return cache.cached_bytes_; }
+
+void SlicePool::resetForTest() {
+  reset();
+  cache.drain();
+  cache.stats_ = nullptr;
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * All stats for the per-thread buffer slice pool. @see stats_macros.h
+ */
+#define ALL_SLICE_POOL_STATS(COUNTER, GAUGE)                                                       \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  COUNTER(overflow)                                                                                \
+  COUNTER(release)                                                                                 \
+  GAUGE(arena_bytes, NeverImport)
+
+/**
+ * Struct definition for all buffer slice pool stats. @see stats_macros.h
+ */
+struct SlicePoolStats {
+  ALL_SLICE_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Configuration of the buffer slice pool. @see SlicePool::configure().
+ */
+struct SlicePoolConfig {
+  // Upper bound on the bytes of released heap backed slice storage that each thread keeps for
+  // reuse. Storage released beyond this is returned to the heap.
+  uint64_t max_cached_bytes_per_thread_{};
+  // Upper bound on the bytes of huge page arenas that each thread may carve slice storage from.
+  // Only used if use_huge_pages_ is set.
+  uint64_t max_arena_bytes_per_thread_{};
+  // Whether slice storage is carved out of 2 MiB huge page backed arenas.
+  bool use_huge_pages_{};
+};
+
+/**
+ * Deleter for slice storage. Storage allocated by the SlicePool is returned to the pool of the
+ * thread that releases it, everything else is freed with delete[].
+ */
+class SliceStorageDeleter {
+public:
+  SliceStorageDeleter() = default;
+  SliceStorageDeleter(uint32_t size, bool from_arena)
+      : size_(size), pooled_(true), from_arena_(from_arena) {}
+
+  void operator()(uint8_t* mem) const;
+
+private:
+  uint32_t size_{};
+  bool pooled_{};
+  bool from_arena_{};
+};
+
+using SliceStoragePtr = std::unique_ptr<uint8_t[], SliceStorageDeleter>;
+
+/**
+ * A per-thread, size-classed pool of buffer slice storage. Slice sizes are multiples of the page
+ * size, and every multiple up to max_pooled_size_ is a size class of its own, so pooling never
+ * changes the capacity of a slice.
+ *
+ * Each thread keeps free lists of released storage, bounded by a byte budget. Optionally, new
+ * storage is carved out of per-thread 2 MiB arenas backed by huge pages (explicit huge pages if
+ * reserved, transparent huge pages otherwise) to reduce TLB pressure. Arena storage released by
+ * another thread is handed back to the arena, where the owning thread picks it up again, so the
+ * storage cached for an arena never exceeds the arena itself. When the owning thread exits, each
+ * of its arenas is returned to the system once all the storage carved from it is released.
+ *
+ * The pool is disabled by default, in which case allocate() is equivalent to new uint8_t[].
+ */
+class SlicePool {
+public:
+  static constexpr uint64_t page_size_ = 4096;
+  static constexpr uint64_t max_pooled_size_ = 16 * page_size_;
+  static constexpr uint64_t arena_size_ = 2 * 1024 * 1024;
+
+  /**
+   * Enables the pool. This must be called before any worker thread is started.
+   */
+  static void configure(const SlicePoolConfig& config);
+
+  /**
+   * Disables the pool. Storage allocated while the pool was enabled may still be released
+   * afterwards.
+   */
+  static void reset();
+
+  /**
+   * @return whether the pool was enabled with configure().
+   */
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Allocate slice storage.
+   * @param size the size of the storage in bytes. Must be a multiple of page_size_.
+   * @return the storage.
+   */
+  static SliceStoragePtr allocate(uint64_t size);
+
+  /**
+   * Sets the stats that the pool of the calling thread records into. The stats must outlive the
+   * thread, or be unset by passing nullptr before they are destroyed.
+   */
+  static void setThreadLocalStats(SlicePoolStats* stats);
+
+  /**
+   * @return the bytes of heap backed storage cached by the calling thread.
+   */
+  static uint64_t cachedBytesForTest();
+
+  /**
+   * Disables the pool and releases the storage and arenas cached by the calling thread.
+   */
+  static void resetForTest();
+
+private:
+  friend class SliceStorageDeleter;
+
+  static void release(uint8_t* mem, uint32_t size, bool from_arena);
+
+  // The configuration may be read by any thread that allocates or releases storage, so each field
+  // is held separately in an atomic.
+  static std::atomic<bool> enabled_;
+  static std::atomic<uint64_t> max_cached_bytes_per_thread_;
+  static std::atomic<uint64_t> max_arena_bytes_per_thread_;
+  static std::atomic<bool> use_huge_pages_;
+};
+
+} // namespace Buffer
+} // namespace Envoy
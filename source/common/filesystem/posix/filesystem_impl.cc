@@ -1,8 +1,10 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <climits>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -19,6 +21,7 @@
 #include "source/common/filesystem/filesystem_impl.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/fixed_array.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 
@@ -93,6 +96,31 @@ Api::IoCallSizeResult FileImplPosix::write(absl::string_view buffer) {
   return rc != -1 ? resultSuccess(rc) : resultFailure(rc, errno);
 };
 
+Api::IoCallSizeResult FileImplPosix::writev(absl::Span<const absl::string_view> buffers) {
+  ssize_t bytes_written = 0;
+  while (!buffers.empty()) {
+    const size_t num_iov = std::min<size_t>(buffers.size(), IOV_MAX);
+    absl::FixedArray<iovec> iov(num_iov);
+    size_t expected = 0;
+    for (size_t i = 0; i < num_iov; ++i) {
+      iov[i].iov_base = const_cast<char*>(buffers[i].data());
+      iov[i].iov_len = buffers[i].size();
+      expected += buffers[i].size();
+    }
+    const ssize_t rc = ::writev(fd_, iov.data(), num_iov);
+    if (rc == -1) {
+      return resultFailure(rc, errno);
+    }
+    bytes_written += rc;
+    if (static_cast<size_t>(rc) != expected) {
+      // Short write, e.g. the disk is full. Let the caller decide what to do with the rest.
+      break;
+    }
+    buffers.remove_prefix(num_iov);
+  }
+  return resultSuccess(bytes_written);
+}
+
 Api::IoCallBoolResult FileImplPosix::close() {
   ASSERT(isOpen());
   int rc = ::close(fd_);
@@ -76,6 +76,22 @@ Api::IoCallSizeResult FileImplWin32::write(absl::string_view buffer) {
   return resultSuccess<ssize_t>(bytes_written);
 };
 
+Api::IoCallSizeResult FileImplWin32::writev(absl::Span<const absl::string_view> buffers) {
+  // There is no gathering write for files opened without FILE_FLAG_NO_BUFFERING.
+  ssize_t bytes_written = 0;
+  for (absl::string_view buffer : buffers) {
+    Api::IoCallSizeResult result = write(buffer);
+    if (!result.ok()) {
+      return result;
+    }
+    bytes_written += result.return_value_;
+    if (static_cast<size_t>(result.return_value_) != buffer.size()) {
+      break;
+    }
+  }
+  return resultSuccess<ssize_t>(bytes_written);
+}
+
 Api::IoCallBoolResult FileImplWin32::close() {
   ASSERT(isOpen());
 
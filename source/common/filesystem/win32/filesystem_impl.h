@@ -16,6 +16,7 @@ public:
 protected:
   Api::IoCallBoolResult open(FlagSet flag) override;
   Api::IoCallSizeResult write(absl::string_view buffer) override;
+  Api::IoCallSizeResult writev(absl::Span<const absl::string_view> buffers) override;
   Api::IoCallBoolResult close() override;
   Api::IoCallSizeResult pread(void* buf, uint64_t count, uint64_t offset) override;
   Api::IoCallSizeResult pwrite(const void* buf, uint64_t count, uint64_t offset) override;
@@ -221,6 +221,11 @@ public:
     return str_;
   }
 
+  /**
+   * @return the string literal.
+   */
+  const std::string& literal() const { return str_.string_value(); }
+
 private:
   ProtobufWkt::Value str_;
 };
@@ -1,9 +1,13 @@
 #include "source/common/formatter/substitution_format_utility.h"
 
+#include <cmath>
+#include <iterator>
+
 #include "envoy/api/os_sys_calls.h"
 
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/http/utility.h"
+#include "source/common/json/json_sanitizer.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/stream_info/utility.h"
 
@@ -106,5 +110,74 @@ void SubstitutionFormatUtils::parseSubcommandHeaders(const std::string& subcomma
   }
 }
 
+void JsonFormatUtils::appendString(absl::string_view str, std::string& output) {
+  output.push_back('"');
+  appendEscaped(str, output);
+  output.push_back('"');
+}
+
+void JsonFormatUtils::appendEscaped(absl::string_view str, std::string& output) {
+  // The buffer is only used, and allocates, if the string needs escaping.
+  std::string buffer;
+  const absl::string_view sanitized = Json::sanitize(buffer, str);
+  output.append(sanitized.data(), sanitized.size());
+}
+
+void JsonFormatUtils::appendNumber(double number, std::string& output) {
+  if (std::isnan(number)) {
+    output.append("\"NaN\"");
+  } else if (std::isinf(number)) {
+    output.append(number > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+  } else {
+    fmt::format_to(std::back_inserter(output), "{}", number);
+  }
+}
+
+void JsonFormatUtils::appendValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kNumberValue:
+    appendNumber(value.number_value(), output);
+    return;
+  case ProtobufWkt::Value::kStringValue:
+    appendString(value.string_value(), output);
+    return;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    return;
+  case ProtobufWkt::Value::kStructValue: {
+    output.push_back('{');
+    bool first = true;
+    for (const auto& field : value.struct_value().fields()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendString(field.first, output);
+      output.push_back(':');
+      appendValue(field.second, output);
+    }
+    output.push_back('}');
+    return;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendValue(element, output);
+    }
+    output.push_back(']');
+    return;
+  }
+  case ProtobufWkt::Value::kNullValue:
+  case ProtobufWkt::Value::KIND_NOT_SET:
+    break;
+  }
+  output.append("null");
+}
+
 } // namespace Formatter
 } // namespace Envoy
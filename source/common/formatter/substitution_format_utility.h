@@ -104,5 +104,32 @@ public:
   }
 };
 
+/**
+ * Utilities for rendering JSON log lines by appending to a string, without building a Struct.
+ */
+class JsonFormatUtils {
+public:
+  /**
+   * Append a string as a quoted JSON string.
+   */
+  static void appendString(absl::string_view str, std::string& output);
+
+  /**
+   * Append a string escaped for the inside of a JSON string, without the quotes.
+   */
+  static void appendEscaped(absl::string_view str, std::string& output);
+
+  /**
+   * Append a number the way the protobuf JSON printer does, i.e. non finite numbers are
+   * appended as the strings "NaN", "Infinity" and "-Infinity".
+   */
+  static void appendNumber(double number, std::string& output);
+
+  /**
+   * Append a protobuf value as JSON.
+   */
+  static void appendValue(const ProtobufWkt::Value& value, std::string& output);
+};
+
 } // namespace Formatter
 } // namespace Envoy
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <bitset>
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,8 +17,10 @@
 #include "source/common/formatter/http_specific_formatter.h"
 #include "source/common/formatter/stream_info_formatter.h"
 #include "source/common/json/json_loader.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -175,6 +179,119 @@ public:
 
 inline constexpr absl::string_view DefaultUnspecifiedValueStringView = "-";
 
+/**
+ * A format compiled into a flat list of instructions. Adjacent literals, e.g. the text between
+ * the commands of a format string, or the JSON syntax between the values of a JSON format, are
+ * merged into a single instruction at config time. A log line is then rendered by appending each
+ * instruction to a single output string, without intermediate strings or structs.
+ */
+template <class FormatterContext> class FormatPlan {
+public:
+  enum class Operation : uint8_t {
+    // Append the literal.
+    Literal,
+    // Append the string value of the provider, or the empty value if it has none.
+    String,
+    // Like String, but escaped for the inside of a JSON string.
+    JsonString,
+    // Append the typed value of the provider as JSON.
+    JsonValue,
+  };
+
+  void addLiteral(absl::string_view literal) {
+    if (literal.empty()) {
+      return;
+    }
+    if (instructions_.empty() || instructions_.back().operation_ != Operation::Literal) {
+      instructions_.push_back({Operation::Literal, "", nullptr});
+    }
+    instructions_.back().literal_.append(literal.data(), literal.size());
+    literal_size_ += literal.size();
+  }
+
+  void addProvider(Operation operation, FormatterProviderBasePtr<FormatterContext> provider) {
+    ASSERT(operation != Operation::Literal);
+    instructions_.push_back({operation, "", std::move(provider)});
+  }
+
+  /**
+   * Add parsed providers, with the literals among them merged into the plan.
+   * @param operation the operation for the providers which are not literals.
+   * @param providers the providers returned by SubstitutionFormatParser::parse().
+   */
+  void addProviders(Operation operation,
+                    std::vector<FormatterProviderBasePtr<FormatterContext>>&& providers) {
+    for (auto& provider : providers) {
+      const std::string* literal = literalOf(*provider);
+      if (literal == nullptr) {
+        addProvider(operation, std::move(provider));
+      } else if (operation == Operation::JsonString) {
+        std::string escaped;
+        JsonFormatUtils::appendEscaped(*literal, escaped);
+        addLiteral(escaped);
+      } else {
+        addLiteral(*literal);
+      }
+    }
+  }
+
+  /**
+   * @return the literal of a provider, or nullptr if it is not a literal.
+   */
+  static const std::string* literalOf(const FormatterProviderBase<FormatterContext>& provider) {
+    const auto* literal =
+        dynamic_cast<const CommonPlainStringFormatterBase<FormatterContext>*>(&provider);
+    return literal != nullptr ? &literal->literal() : nullptr;
+  }
+
+  /**
+   * @return the total size of the literals, which is a lower bound of the size of the output.
+   */
+  size_t literalSize() const { return literal_size_; }
+
+  void render(const FormatterContext& context, const StreamInfo::StreamInfo& stream_info,
+              absl::string_view empty_value, std::string& output) const {
+    for (const Instruction& instruction : instructions_) {
+      switch (instruction.operation_) {
+      case Operation::Literal:
+        output.append(instruction.literal_);
+        break;
+      case Operation::String: {
+        const absl::optional<std::string> value =
+            instruction.provider_->formatWithContext(context, stream_info);
+        if (value.has_value()) {
+          output.append(value.value());
+        } else {
+          output.append(empty_value.data(), empty_value.size());
+        }
+        break;
+      }
+      case Operation::JsonString: {
+        const absl::optional<std::string> value =
+            instruction.provider_->formatWithContext(context, stream_info);
+        JsonFormatUtils::appendEscaped(
+            value.has_value() ? absl::string_view(value.value()) : empty_value, output);
+        break;
+      }
+      case Operation::JsonValue:
+        JsonFormatUtils::appendValue(
+            instruction.provider_->formatValueWithContext(context, stream_info), output);
+        break;
+      }
+    }
+  }
+
+private:
+  struct Instruction {
+    Operation operation_;
+    std::string literal_;
+    FormatterProviderBasePtr<FormatterContext> provider_;
+  };
+
+  std::vector<Instruction> instructions_;
+  size_t literal_size_{};
+};
+
 /**
  * Composite formatter implementation.
  */
@@ -182,36 +299,34 @@ template <class FormatterContext>
 class CommonFormatterBaseImpl : public FormatterBase<FormatterContext> {
 public:
   using CommandParsers = std::vector<CommandParserBasePtr<FormatterContext>>;
+  using Operation = typename FormatPlan<FormatterContext>::Operation;
 
   CommonFormatterBaseImpl(const std::string& format, bool omit_empty_values = false)
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
-    providers_ = SubstitutionFormatParser::parse<FormatterContext>(format);
+    plan_.addProviders(Operation::String,
+                       SubstitutionFormatParser::parse<FormatterContext>(format));
   }
   CommonFormatterBaseImpl(const std::string& format, bool omit_empty_values,
                           const CommandParsers& command_parsers)
       : empty_value_string_(omit_empty_values ? absl::string_view{}
                                               : DefaultUnspecifiedValueStringView) {
-    providers_ = SubstitutionFormatParser::parse<FormatterContext>(format, command_parsers);
+    plan_.addProviders(Operation::String,
+                       SubstitutionFormatParser::parse<FormatterContext>(format, command_parsers));
   }
 
   // FormatterBase
   std::string formatWithContext(const FormatterContext& context,
                                 const StreamInfo::StreamInfo& stream_info) const override {
     std::string log_line;
-    log_line.reserve(256);
-
-    for (const auto& provider : providers_) {
-      const auto bit = provider->formatWithContext(context, stream_info);
-      log_line += bit.value_or(empty_value_string_);
-    }
-
+    log_line.reserve(std::max<size_t>(256, 2 * plan_.literalSize()));
+    plan_.render(context, stream_info, empty_value_string_, log_line);
     return log_line;
   }
 
 private:
   const std::string empty_value_string_;
-  std::vector<FormatterProviderBasePtr<FormatterContext>> providers_;
+  FormatPlan<FormatterContext> plan_;
 };
 
 template <class FormatterContext>
@@ -430,17 +545,35 @@ template <class FormatterContext>
 class CommonJsonFormatterBaseImpl : public FormatterBase<FormatterContext> {
 public:
   using CommandParsers = std::vector<CommandParserBasePtr<FormatterContext>>;
+  using Operation = typename FormatPlan<FormatterContext>::Operation;
 
   CommonJsonFormatterBaseImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
                               bool omit_empty_values, bool sort_properties,
                               const CommandParsers& commands = {})
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands),
-        sort_properties_(sort_properties) {}
+      : sort_properties_(sort_properties) {
+    // Omitting empty values changes the structure of the output depending on the values, so it
+    // is not compiled into a plan.
+    if (!omit_empty_values && Runtime::runtimeFeatureEnabled(
+                                  "envoy.reloadable_features.logging_with_fast_json_formatter")) {
+      compileStruct(format_mapping, preserve_types, commands);
+      plan_.addLiteral("\n");
+    } else {
+      struct_formatter_ = std::make_unique<const StructFormatterBase<FormatterContext>>(
+          format_mapping, preserve_types, omit_empty_values, commands);
+    }
+  }
 
   // FormatterBase
   std::string formatWithContext(const FormatterContext& context,
                                 const StreamInfo::StreamInfo& info) const override {
-    const ProtobufWkt::Struct output_struct = struct_formatter_.formatWithContext(context, info);
+    if (struct_formatter_ == nullptr) {
+      std::string log_line;
+      log_line.reserve(std::max<size_t>(256, 2 * plan_.literalSize()));
+      plan_.render(context, info, DefaultUnspecifiedValueStringView, log_line);
+      return log_line;
+    }
+
+    const ProtobufWkt::Struct output_struct = struct_formatter_->formatWithContext(context, info);
 
     std::string log_line = "";
 #ifdef ENVOY_ENABLE_YAML
@@ -457,7 +590,82 @@ public:
   }
 
 private:
-  const StructFormatterBase<FormatterContext> struct_formatter_;
+  // The properties of the format are compiled in sorted order, like the struct based formatter
+  // orders them.
+  void compileStruct(const ProtobufWkt::Struct& format, bool preserve_types,
+                     const CommandParsers& commands) {
+    std::vector<const std::string*> keys;
+    keys.reserve(format.fields().size());
+    for (const auto& field : format.fields()) {
+      keys.push_back(&field.first);
+    }
+    std::sort(keys.begin(), keys.end(),
+              [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+
+    plan_.addLiteral("{");
+    for (size_t i = 0; i < keys.size(); ++i) {
+      std::string key = i > 0 ? "," : "";
+      JsonFormatUtils::appendString(*keys[i], key);
+      key.push_back(':');
+      plan_.addLiteral(key);
+      compileValue(format.fields().at(*keys[i]), preserve_types, commands);
+    }
+    plan_.addLiteral("}");
+  }
+
+  void compileValue(const ProtobufWkt::Value& value, bool preserve_types,
+                    const CommandParsers& commands) {
+    switch (value.kind_case()) {
+    case ProtobufWkt::Value::kStringValue:
+      compileString(value.string_value(), preserve_types, commands);
+      return;
+    case ProtobufWkt::Value::kStructValue:
+      compileStruct(value.struct_value(), preserve_types, commands);
+      return;
+    case ProtobufWkt::Value::kListValue:
+      plan_.addLiteral("[");
+      for (int i = 0; i < value.list_value().values_size(); ++i) {
+        if (i > 0) {
+          plan_.addLiteral(",");
+        }
+        compileValue(value.list_value().values(i), preserve_types, commands);
+      }
+      plan_.addLiteral("]");
+      return;
+    case ProtobufWkt::Value::kNumberValue: {
+      std::string number;
+      if (preserve_types) {
+        JsonFormatUtils::appendNumber(value.number_value(), number);
+      } else {
+        JsonFormatUtils::appendString(absl::StrFormat("%g", value.number_value()), number);
+      }
+      plan_.addLiteral(number);
+      return;
+    }
+    default:
+      throw EnvoyException("Only string values, nested structs, list values and number values are "
+                           "supported in structured access log format.");
+    }
+  }
+
+  void compileString(const std::string& format, bool preserve_types,
+                     const CommandParsers& commands) {
+    std::vector<FormatterProviderBasePtr<FormatterContext>> providers =
+        SubstitutionFormatParser::parse<FormatterContext>(format, commands);
+    // A single command keeps the type of its value, multiple ones are concatenated to a string.
+    if (preserve_types && providers.size() == 1 &&
+        FormatPlan<FormatterContext>::literalOf(*providers.front()) == nullptr) {
+      plan_.addProvider(Operation::JsonValue, std::move(providers.front()));
+      return;
+    }
+    plan_.addLiteral("\"");
+    plan_.addProviders(Operation::JsonString, std::move(providers));
+    plan_.addLiteral("\"");
+  }
+
+  // Only set if the format is not compiled into the plan.
+  std::unique_ptr<const StructFormatterBase<FormatterContext>> struct_formatter_;
+  FormatPlan<FormatterContext> plan_;
   const bool sort_properties_;
 };
 
@@ -0,0 +1,177 @@
+#include "source/common/http/character_set_validation.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_CHARACTER_SET_X86_KERNELS
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define ENVOY_CHARACTER_SET_NEON_KERNEL
+#include <arm_neon.h>
+#endif
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Strings shorter than this are checked one character at a time, as most header names are.
+constexpr size_t MinVectorizedLength = 16;
+
+bool containsAllScalar(const std::array<uint32_t, 8>& table, const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (!testCharInTable(table, data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef ENVOY_CHARACTER_SET_X86_KERNELS
+__attribute__((target("sse4.2"))) bool containsAllSse42(const std::array<uint32_t, 8>& table,
+                                                        const CharacterSetNibbleTables& nibbles,
+                                                        const char* data, size_t size) {
+  const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.low_.data()));
+  const __m128i high_table =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.high_.data()));
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(chars, nibble_mask));
+    const __m128i high =
+        _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(chars, 4), nibble_mask));
+    const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+    if (_mm_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+  return containsAllScalar(table, data + i, size - i);
+}
+
+__attribute__((target("avx2"))) bool containsAllAvx2(const std::array<uint32_t, 8>& table,
+                                                     const CharacterSetNibbleTables& nibbles,
+                                                     const char* data, size_t size) {
+  const __m256i low_table = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.low_.data())));
+  const __m256i high_table = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles.high_.data())));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(chars, nibble_mask));
+    const __m256i high =
+        _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble_mask));
+    const __m256i invalid = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+    if (_mm256_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+  }
+  if (i + 16 <= size) {
+    // The remaining 16 byte block, if any. This is not delegated to containsAllSse42(), as
+    // switching from 256 bit to legacy SSE instructions stalls.
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i low =
+        _mm_shuffle_epi8(_mm256_castsi256_si128(low_table),
+                         _mm_and_si128(chars, _mm256_castsi256_si128(nibble_mask)));
+    const __m128i high = _mm_shuffle_epi8(
+        _mm256_castsi256_si128(high_table),
+        _mm_and_si128(_mm_srli_epi16(chars, 4), _mm256_castsi256_si128(nibble_mask)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128())) != 0) {
+      return false;
+    }
+    i += 16;
+  }
+  return containsAllScalar(table, data + i, size - i);
+}
+#endif
+
+#ifdef ENVOY_CHARACTER_SET_NEON_KERNEL
+bool containsAllNeon(const std::array<uint32_t, 8>& table, const CharacterSetNibbleTables& nibbles,
+                     const char* data, size_t size) {
+  const uint8x16_t low_table = vld1q_u8(nibbles.low_.data());
+  const uint8x16_t high_table = vld1q_u8(nibbles.high_.data());
+  const uint8x16_t nibble_mask = vdupq_n_u8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+    const uint8x16_t low = vqtbl1q_u8(low_table, vandq_u8(chars, nibble_mask));
+    const uint8x16_t high = vqtbl1q_u8(high_table, vshrq_n_u8(chars, 4));
+    const uint8x16_t invalid = vceqq_u8(vandq_u8(low, high), vdupq_n_u8(0));
+    if (vmaxvq_u8(invalid) != 0) {
+      return false;
+    }
+  }
+  return containsAllScalar(table, data + i, size - i);
+}
+#endif
+
+CharacterSetKernel detectCharacterSetKernel() {
+#ifdef ENVOY_CHARACTER_SET_X86_KERNELS
+  if (__builtin_cpu_supports("avx2")) {
+    return CharacterSetKernel::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CharacterSetKernel::Sse42;
+  }
+#endif
+#ifdef ENVOY_CHARACTER_SET_NEON_KERNEL
+  return CharacterSetKernel::Neon;
+#endif
+  return CharacterSetKernel::Scalar;
+}
+
+} // namespace
+
+CharacterSetKernel bestCharacterSetKernel() {
+  static const CharacterSetKernel kernel = detectCharacterSetKernel();
+  return kernel;
+}
+
+bool characterSetKernelSupported(CharacterSetKernel kernel) {
+  switch (kernel) {
+  case CharacterSetKernel::Scalar:
+    return true;
+  case CharacterSetKernel::Sse42:
+    return bestCharacterSetKernel() == CharacterSetKernel::Sse42 ||
+           bestCharacterSetKernel() == CharacterSetKernel::Avx2;
+  case CharacterSetKernel::Avx2:
+  case CharacterSetKernel::Neon:
+    return bestCharacterSetKernel() == kernel;
+  }
+  return false;
+}
+
+bool CharacterSet::containsAll(absl::string_view str) const {
+  if (str.size() < MinVectorizedLength) {
+    return containsAllScalar(table_, str.data(), str.size());
+  }
+  return containsAll(str, bestCharacterSetKernel());
+}
+
+bool CharacterSet::containsAll(absl::string_view str, CharacterSetKernel kernel) const {
+  ASSERT(characterSetKernelSupported(kernel));
+  if (!nibble_tables_.representable_) {
+    kernel = CharacterSetKernel::Scalar;
+  }
+  switch (kernel) {
+  case CharacterSetKernel::Scalar:
+    break;
+#ifdef ENVOY_CHARACTER_SET_X86_KERNELS
+  case CharacterSetKernel::Sse42:
+    return containsAllSse42(table_, nibble_tables_, str.data(), str.size());
+  case CharacterSetKernel::Avx2:
+    return containsAllAvx2(table_, nibble_tables_, str.data(), str.size());
+#endif
+#ifdef ENVOY_CHARACTER_SET_NEON_KERNEL
+  case CharacterSetKernel::Neon:
+    return containsAllNeon(table_, nibble_tables_, str.data(), str.size());
+#endif
+  default:
+    break;
+  }
+  return containsAllScalar(table_, str.data(), str.size());
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -3,6 +3,8 @@
 #include <array>
 #include <cstdint>
 
+#include "absl/strings/string_view.h"
+
 // A set of tables for validating that a character is in a specific
 // character set. Used to validate RFC compliance for various HTTP protocol elements.
 
@@ -49,6 +51,36 @@ inline constexpr std::array<uint32_t, 8> kGenericHeaderNameCharTable = {
     0b00000000000000000000000000000000,
 };
 
+// Header value character table.
+// From RFC 9110, https://www.rfc-editor.org/rfc/rfc9110.html#section-5.5:
+//
+// SPELLCHECKER(off)
+// header-field   = field-name ":" OWS field-value OWS
+// field-value    = *field-content
+// field-content  = field-vchar
+//                  [ 1*( SP / HTAB / field-vchar ) field-vchar ]
+// field-vchar    = VCHAR / obs-text
+// obs-text       = %x80-FF
+//
+// VCHAR          =  %x21-7E
+//                   ; visible (printing) characters
+// SPELLCHECKER(on)
+inline constexpr std::array<uint32_t, 8> kGenericHeaderValueCharTable = {
+    // control characters
+    0b00000000010000000000000000000000,
+    // !"#$%&'()*+,-./0123456789:;<=>?
+    0b11111111111111111111111111111111,
+    //@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_
+    0b11111111111111111111111111111111,
+    //`abcdefghijklmnopqrstuvwxyz{|}~
+    0b11111111111111111111111111111110,
+    // extended ascii
+    0b11111111111111111111111111111111,
+    0b11111111111111111111111111111111,
+    0b11111111111111111111111111111111,
+    0b11111111111111111111111111111111,
+};
+
 // A URI query and fragment character table. From RFC 3986:
 // https://datatracker.ietf.org/doc/html/rfc3986#section-3.4
 //
@@ -72,5 +104,116 @@ inline constexpr std::array<uint32_t, 8> kUriQueryAndFragmentCharTable = {
     0b00000000000000000000000000000000,
 };
 
+/**
+ * The vectorized kernels which CharacterSet::containsAll() can use.
+ */
+enum class CharacterSetKernel {
+  // One character at a time, using the bit table.
+  Scalar,
+  // 16 characters at a time, x86-64 with SSE4.2.
+  Sse42,
+  // 32 characters at a time, x86-64 with AVX2.
+  Avx2,
+  // 16 characters at a time, aarch64.
+  Neon,
+};
+
+/**
+ * @return the fastest kernel supported by the CPU. This is detected once per process.
+ */
+CharacterSetKernel bestCharacterSetKernel();
+
+/**
+ * @return whether the CPU supports the kernel.
+ */
+bool characterSetKernelSupported(CharacterSetKernel kernel);
+
+/**
+ * Nibble lookup tables of a character table. A character c is in the table if
+ * (low_[c & 0xf] & high_[c >> 4]) != 0, which a byte shuffle evaluates for a whole vector of
+ * characters at a time. Each of the 8 bits stands for one distinct row of 16 characters that
+ * share their high nibble, so this only works for tables with at most 8 distinct non-empty rows,
+ * as is the case for the header name and value tables.
+ */
+struct CharacterSetNibbleTables {
+  std::array<uint8_t, 16> low_{};
+  std::array<uint8_t, 16> high_{};
+  bool representable_{};
+};
+
+inline constexpr CharacterSetNibbleTables
+buildCharacterSetNibbleTables(const std::array<uint32_t, 8>& table) {
+  CharacterSetNibbleTables result;
+  std::array<uint16_t, 8> rows{};
+  uint32_t num_rows = 0;
+  for (uint32_t high = 0; high < 16; ++high) {
+    uint16_t row = 0;
+    for (uint32_t low = 0; low < 16; ++low) {
+      if (testCharInTable(table, static_cast<char>((high << 4) | low))) {
+        row |= 1 << low;
+      }
+    }
+    if (row == 0) {
+      continue;
+    }
+    uint32_t index = 0;
+    while (index < num_rows && rows[index] != row) {
+      ++index;
+    }
+    if (index == num_rows) {
+      if (num_rows == rows.size()) {
+        return {};
+      }
+      rows[num_rows++] = row;
+    }
+    result.high_[high] |= 1 << index;
+    for (uint32_t low = 0; low < 16; ++low) {
+      if (row & (1 << low)) {
+        result.low_[low] |= 1 << index;
+      }
+    }
+  }
+  result.representable_ = true;
+  return result;
+}
+
+/**
+ * A character table which can check whole strings with vectorized kernels. Short strings and
+ * tables which are not representable as nibble tables are checked one character at a time.
+ */
+class CharacterSet {
+public:
+  constexpr explicit CharacterSet(const std::array<uint32_t, 8>& table)
+      : table_(table), nibble_tables_(buildCharacterSetNibbleTables(table)) {}
+
+  /**
+   * @return whether the character is in the set.
+   */
+  bool test(char c) const { return testCharInTable(table_, c); }
+
+  /**
+   * @return whether all characters of the string are in the set.
+   */
+  bool containsAll(absl::string_view str) const;
+
+  /**
+   * Like containsAll(), using the given kernel, which must be supported by the CPU. For tests
+   * and benchmarks.
+   */
+  bool containsAll(absl::string_view str, CharacterSetKernel kernel) const;
+
+  constexpr const std::array<uint32_t, 8>& table() const { return table_; }
+  constexpr const CharacterSetNibbleTables& nibbleTables() const { return nibble_tables_; }
+
+private:
+  const std::array<uint32_t, 8> table_;
+  const CharacterSetNibbleTables nibble_tables_;
+};
+
+inline constexpr CharacterSet kGenericHeaderNameCharacterSet{kGenericHeaderNameCharTable};
+inline constexpr CharacterSet kGenericHeaderValueCharacterSet{kGenericHeaderValueCharTable};
+static_assert(kGenericHeaderNameCharacterSet.nibbleTables().representable_);
+static_assert(kGenericHeaderValueCharacterSet.nibbleTables().representable_);
+
 } // namespace Http
 } // namespace Envoy
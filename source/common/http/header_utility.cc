@@ -193,8 +193,9 @@ bool HeaderUtility::matchHeaders(const HeaderMap& request_headers, const HeaderD
 }
 
 bool HeaderUtility::headerValueIsValid(const absl::string_view header_value) {
-  return http2::adapter::HeaderValidator::IsValidHeaderValue(header_value,
-                                                             http2::adapter::ObsTextOption::kAllow);
+  // Same character set as http2::adapter::HeaderValidator::IsValidHeaderValue() with obs-text
+  // allowed, checked with vectorized kernels as large cookie and authorization values are common.
+  return kGenericHeaderValueCharacterSet.containsAll(header_value);
 }
 
 bool HeaderUtility::headerNameIsValid(const absl::string_view header_key) {
@@ -209,11 +210,7 @@ bool HeaderUtility::headerNameIsValid(const absl::string_view header_key) {
   // However the HTTP/2 codec will NOT convert these to lowercase when serializing the
   // header map, thus producing an invalid request.
   // TODO(yanavlasov): make validation in HTTP/2 case stricter.
-  bool is_valid = true;
-  for (auto iter = header_key.begin(); iter != header_key.end() && is_valid; ++iter) {
-    is_valid &= testCharInTable(kGenericHeaderNameCharTable, *iter);
-  }
-  return is_valid;
+  return kGenericHeaderNameCharacterSet.containsAll(header_key);
 }
 
 bool HeaderUtility::headerNameContainsUnderscore(const absl::string_view header_name) {
@@ -85,7 +85,7 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
 
   for (unsigned i = 0; i < count; ++i) {
     struct io_uring_cqe* cqe = cqes_[i];
-    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, false);
+    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, cqe->flags, false);
   }
 
   io_uring_cq_advance(&ring_, count);
@@ -96,7 +96,7 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
   // Iterate the injected completion.
   while (!injected_completions_.empty()) {
     auto& completion = injected_completions_.front();
-    completion_cb(completion.user_data_, completion.result_, true);
+    completion_cb(completion.user_data_, completion.result_, 0, true);
     // The socket may closed in the completion_cb and all the related completions are
     // removed.
     if (injected_completions_.empty()) {
@@ -116,7 +116,23 @@ IoUringResult IoUringImpl::prepareAccept(os_fd_t fd, struct sockaddr* remote_add
     return IoUringResult::Failed;
   }
 
-  io_uring_prep_accept(sqe, fd, remote_addr, remote_addr_len, 0);
+  // Like OsSysCallsImpl::accept(), accepted sockets are non-blocking.
+  io_uring_prep_accept(sqe, fd, remote_addr, remote_addr_len, SOCK_NONBLOCK);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareMultishotAccept(os_fd_t fd, Request* user_data) {
+  ENVOY_LOG(trace, "prepare multishot accept for fd = {}", fd);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  // All the completions share the request, so the remote addresses are not reported.
+  io_uring_prep_multishot_accept(sqe, fd, nullptr, nullptr, SOCK_NONBLOCK);
   io_uring_sqe_set_data(sqe, user_data);
   return IoUringResult::Ok;
 }
@@ -152,6 +168,21 @@ IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareReadFixed(os_fd_t fd, void* buf, unsigned nbytes, off_t offset,
+                                            int buf_index, Request* user_data) {
+  ENVOY_LOG(trace, "prepare read fixed for fd = {}, buf index = {}", fd, buf_index);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_read_fixed(sqe, fd, buf, nbytes, offset, buf_index);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                          off_t offset, Request* user_data) {
   ENVOY_LOG(trace, "prepare writev for fd = {}", fd);
@@ -181,12 +212,49 @@ IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareCancel(Request* cancelling_user_data, Request* user_data) {
+  ENVOY_LOG(trace, "prepare cancel for req = {}", fmt::ptr(cancelling_user_data));
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_cancel(sqe, cancelling_user_data, 0);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareShutdown(os_fd_t fd, int how, Request* user_data) {
+  ENVOY_LOG(trace, "prepare shutdown for fd = {}, how = {}", fd, how);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_shutdown(sqe, fd, how);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
   return res == -EBUSY ? IoUringResult::Busy : IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::registerBuffers(const struct iovec* iovecs, unsigned nr_iovecs) {
+  int res = io_uring_register_buffers(&ring_, iovecs, nr_iovecs);
+  if (res != 0) {
+    ENVOY_LOG(debug, "unable to register {} buffers: {}", nr_iovecs, errorDetails(-res));
+    return IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
 void IoUringImpl::injectCompletion(os_fd_t fd, Request* user_data, int32_t result) {
   injected_completions_.emplace_back(fd, user_data, result);
   ENVOY_LOG(trace, "inject completion, fd = {}, req = {}, num injects = {}", fd,
@@ -0,0 +1,39 @@
+#include "source/common/io/io_uring_worker_factory_impl.h"
+
+namespace Envoy {
+namespace Io {
+
+IoUringWorkerFactoryImpl::IoUringWorkerFactoryImpl(uint32_t io_uring_size,
+                                                   bool use_submission_queue_polling,
+                                                   const IoUringWorkerOptions& options,
+                                                   ThreadLocal::SlotAllocator& tls)
+    : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
+      options_(options), tls_(tls) {}
+
+OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
+  if (!currentThreadRegistered()) {
+    return absl::nullopt;
+  }
+  // The worker may not be created yet if the thread did not run the update of the slot.
+  auto worker = tls_.get();
+  if (!worker.has_value()) {
+    return absl::nullopt;
+  }
+  return *worker;
+}
+
+void IoUringWorkerFactoryImpl::onWorkerThreadInitialized() {
+  tls_.set([io_uring_size = io_uring_size_,
+            use_submission_queue_polling = use_submission_queue_polling_,
+            options = options_](Event::Dispatcher& dispatcher) {
+    return std::make_shared<IoUringWorkerImpl>(io_uring_size, use_submission_queue_polling,
+                                               options, dispatcher);
+  });
+}
+
+bool IoUringWorkerFactoryImpl::currentThreadRegistered() {
+  return !tls_.isShutdown() && tls_.currentThreadRegistered();
+}
+
+} // namespace Io
+} // namespace Envoy
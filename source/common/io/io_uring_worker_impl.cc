@@ -1,16 +1,102 @@
 #include "source/common/io/io_uring_worker_impl.h"
 
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/event/deferred_task.h"
+#include "source/common/network/io_socket_error_impl.h"
+
 namespace Envoy {
 namespace Io {
 
-IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent)
-    : fd_(fd), parent_(parent) {}
+ReadBufferPool::ReadBufferPool(uint32_t num_buffers, uint32_t buffer_size)
+    : num_buffers_(num_buffers), buffer_size_(buffer_size),
+      memory_(new uint8_t[uint64_t(num_buffers) * buffer_size]) {
+  free_buffers_.reserve(num_buffers);
+  // Hand out the buffers with the lowest indexes first, which keeps the memory in use compact.
+  for (uint32_t i = num_buffers; i > 0; i--) {
+    free_buffers_.push_back(i - 1);
+  }
+}
+
+absl::optional<uint32_t> ReadBufferPool::acquire() {
+  absl::MutexLock lock(&mutex_);
+  if (free_buffers_.empty()) {
+    return absl::nullopt;
+  }
+  const uint32_t index = free_buffers_.back();
+  free_buffers_.pop_back();
+  return index;
+}
+
+void ReadBufferPool::release(uint32_t index) {
+  ASSERT(index < num_buffers_);
+  absl::MutexLock lock(&mutex_);
+  free_buffers_.push_back(index);
+}
+
+std::vector<struct iovec> ReadBufferPool::iovecs() const {
+  std::vector<struct iovec> iovecs(num_buffers_);
+  for (uint32_t i = 0; i < num_buffers_; i++) {
+    iovecs[i].iov_base = buffer(i);
+    iovecs[i].iov_len = buffer_size_;
+  }
+  return iovecs;
+}
+
+ReadRequest::~ReadRequest() {
+  // The buffer was not handed over, e.g. because the request was cancelled or failed.
+  if (pool_ != nullptr) {
+    pool_->release(index_);
+  }
+}
+
+Buffer::BufferFragmentImpl* ReadRequest::releaseFragment(uint32_t length) {
+  if (pool_ != nullptr) {
+    return new Buffer::BufferFragmentImpl(
+        iov_.iov_base, length,
+        [pool = std::move(pool_), index = index_](const void*, size_t,
+                                                  const Buffer::BufferFragmentImpl* this_fragment) {
+          pool->release(index);
+          delete this_fragment;
+        });
+  }
+  return new Buffer::BufferFragmentImpl(
+      buf_.release(), length,
+      [](const void* data, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+        delete[] static_cast<const uint8_t*>(data);
+        delete this_fragment;
+      });
+}
+
+WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices)
+    : Request(RequestType::Write, socket), iovs_(slices.size()) {
+  for (size_t i = 0; i < slices.size(); i++) {
+    iovs_[i].iov_base = slices[i].mem_;
+    iovs_[i].iov_len = slices[i].len_;
+  }
+}
+
+IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent,
+                                       Event::FileReadyCb cb)
+    : fd_(fd), parent_(parent), cb_(std::move(cb)) {}
 
 void IoUringSocketEntry::cleanup() {
   IoUringSocketEntryPtr socket = parent_.removeSocket(*this);
   parent_.dispatcher().deferredDelete(std::move(socket));
 }
 
+void IoUringSocketEntry::closeAndCleanup() {
+  ASSERT(closed_);
+  if (cleaned_up_) {
+    return;
+  }
+  cleaned_up_ = true;
+  Event::DeferredTaskUtil::deferredRun(parent_.dispatcher(), [this]() {
+    const os_fd_t fd = fd_;
+    cleanup();
+    Api::OsSysCallsSingleton::get().close(fd);
+  });
+}
+
 void IoUringSocketEntry::injectCompletion(Request::RequestType type) {
   // Avoid injecting the same completion type multiple times.
   if (injected_completions_ & static_cast<uint8_t>(type)) {
@@ -24,13 +110,484 @@ void IoUringSocketEntry::injectCompletion(Request::RequestType type) {
   parent_.injectCompletion(*this, type, -EAGAIN);
 }
 
+void IoUringSocketEntry::activateFileEvents(uint32_t events) {
+  if (events & (Event::FileReadyType::Read | Event::FileReadyType::Closed)) {
+    injectCompletion(Request::RequestType::Read);
+  }
+  if (events & Event::FileReadyType::Write) {
+    injectCompletion(Request::RequestType::Write);
+  }
+}
+
+IoUringAcceptSocket::IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringSocketEntry(fd, parent, std::move(cb)) {}
+
+void IoUringAcceptSocket::enableFileEvents(uint32_t events) {
+  IoUringSocketEntry::enableFileEvents(events);
+  if (closed_ || !(events & Event::FileReadyType::Read)) {
+    return;
+  }
+  submitAcceptRequestIfNeeded();
+  // Connections which were accepted while the socket was disabled are delivered right away.
+  if (!accepted_sockets_.empty()) {
+    activateFileEvents(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringAcceptSocket::close() {
+  ENVOY_LOG(trace, "close accept socket, fd = {}", fd_);
+  closed_ = true;
+  cb_ = nullptr;
+  for (const AcceptedSocket& socket : accepted_sockets_) {
+    Api::OsSysCallsSingleton::get().close(socket.fd_);
+  }
+  accepted_sockets_.clear();
+  if (accept_req_ != nullptr && !cancel_pending_) {
+    cancel_pending_ = true;
+    parent_.submitCancelRequest(*this, accept_req_);
+  }
+  closeIfIdle();
+}
+
+os_fd_t IoUringAcceptSocket::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  if (accepted_sockets_.empty()) {
+    return INVALID_SOCKET;
+  }
+  AcceptedSocket& socket = accepted_sockets_.front();
+  const os_fd_t fd = socket.fd_;
+  if (addr != nullptr && addrlen != nullptr) {
+    if (socket.remote_addr_len_ == 0) {
+      // Multishot accepts do not report the remote address.
+      socket.remote_addr_len_ = sizeof(socket.remote_addr_);
+      Api::OsSysCallsSingleton::get().getpeername(
+          fd, reinterpret_cast<struct sockaddr*>(&socket.remote_addr_), &socket.remote_addr_len_);
+    }
+    memcpy(addr, &socket.remote_addr_, std::min(*addrlen, socket.remote_addr_len_));
+    *addrlen = socket.remote_addr_len_;
+  }
+  accepted_sockets_.pop_front();
+  return fd;
+}
+
+void IoUringAcceptSocket::connect(const Network::Address::InstanceConstSharedPtr&) {
+  // Reported through a Write event and connectError(), like a failed non-blocking connect.
+  connect_error_ = EISCONN;
+  injectCompletion(Request::RequestType::Write);
+}
+
+Api::IoCallUint64Result IoUringAcceptSocket::read(Buffer::Instance&, uint64_t) {
+  return {0, Network::IoSocketError::create(ENOTCONN)};
+}
+
+Api::IoCallUint64Result IoUringAcceptSocket::recv(void*, size_t, int) {
+  return {0, Network::IoSocketError::create(ENOTCONN)};
+}
+
+Api::IoCallUint64Result IoUringAcceptSocket::write(Buffer::Instance&) {
+  return {0, Network::IoSocketError::create(ENOTCONN)};
+}
+
+Api::IoCallUint64Result IoUringAcceptSocket::writev(const Buffer::RawSlice*, uint64_t) {
+  return {0, Network::IoSocketError::create(ENOTCONN)};
+}
+
+void IoUringAcceptSocket::shutdown(int how) {
+  Api::OsSysCallsSingleton::get().shutdown(fd_, how);
+}
+
+void IoUringAcceptSocket::onAccept(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onAccept(req, result, injected);
+  if (injected) {
+    return;
+  }
+  ASSERT(req == accept_req_);
+  const AcceptRequest& accept_req = *static_cast<AcceptRequest*>(req);
+  const bool more = accept_req.more_;
+  if (!more) {
+    accept_req_ = nullptr;
+  }
+
+  if (result >= 0) {
+    if (closed_) {
+      Api::OsSysCallsSingleton::get().close(result);
+    } else if (accept_req.multishot_) {
+      accepted_sockets_.push_back({result, {}, 0});
+    } else {
+      accepted_sockets_.push_back(
+          {result, accept_req.remote_addr_, accept_req.remote_addr_len_});
+    }
+  } else if (result == -EINVAL && accept_req.multishot_ && parent_.multishotAccept()) {
+    ENVOY_LOG(debug, "multishot accept is not supported, fall back to single accept requests");
+    parent_.disableMultishotAccept();
+  } else if (result != -ECANCELED) {
+    ENVOY_LOG(debug, "accept request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+  }
+
+  if (closed_) {
+    closeIfIdle();
+    return;
+  }
+  if (enabled_events_ & Event::FileReadyType::Read) {
+    // Submit the next accept before handing out the accepted connection, so it overlaps with the
+    // setup of the connection.
+    submitAcceptRequestIfNeeded();
+    if (!accepted_sockets_.empty()) {
+      deliverFileEvents(Event::FileReadyType::Read);
+    }
+  } else if (accept_req_ != nullptr && !cancel_pending_) {
+    // Stop a multishot request from accepting connections while accepting is disabled.
+    cancel_pending_ = true;
+    parent_.submitCancelRequest(*this, accept_req_);
+  }
+}
+
+void IoUringAcceptSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  if (injected) {
+    return;
+  }
+  cancel_pending_ = false;
+  closeIfIdle();
+}
+
+void IoUringAcceptSocket::submitAcceptRequestIfNeeded() {
+  if (accept_req_ == nullptr) {
+    accept_req_ = parent_.multishotAccept() ? parent_.submitMultishotAcceptRequest(*this)
+                                            : parent_.submitAcceptRequest(*this);
+  }
+}
+
+void IoUringAcceptSocket::closeIfIdle() {
+  if (closed_ && accept_req_ == nullptr && !cancel_pending_) {
+    closeAndCleanup();
+  }
+}
+
+IoUringServerSocket::IoUringServerSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb, bool connected)
+    : IoUringSocketEntry(fd, parent, std::move(cb)), connected_(connected) {}
+
+void IoUringServerSocket::enableFileEvents(uint32_t events) {
+  IoUringSocketEntry::enableFileEvents(events);
+  if (closed_) {
+    return;
+  }
+  if (events & Event::FileReadyType::Read) {
+    // Like an edge triggered readiness event, data which was read ahead is delivered as soon as
+    // reading is enabled.
+    if (read_buf_.length() > 0 || remote_closed_ || read_error_ != 0) {
+      activateFileEvents(Event::FileReadyType::Read);
+    }
+    submitReadRequestIfNeeded();
+  } else if ((events & Event::FileReadyType::Closed) && remote_closed_) {
+    activateFileEvents(Event::FileReadyType::Closed);
+  }
+  if ((events & Event::FileReadyType::Write) && connected_ && write_req_ == nullptr) {
+    activateFileEvents(Event::FileReadyType::Write);
+  }
+}
+
+void IoUringServerSocket::close() {
+  ENVOY_LOG(trace, "close server socket, fd = {}, pending write bytes = {}", fd_,
+            write_buf_.length());
+  closed_ = true;
+  cb_ = nullptr;
+  if (read_req_ != nullptr) {
+    control_reqs_++;
+    parent_.submitCancelRequest(*this, read_req_);
+  }
+  if (connect_req_ != nullptr) {
+    control_reqs_++;
+    parent_.submitCancelRequest(*this, connect_req_);
+  }
+  if (write_req_ != nullptr) {
+    // Pending writes are flushed before the fd is closed, unless the peer does not read them in
+    // time.
+    write_timeout_timer_ = parent_.dispatcher().createTimer([this]() {
+      if (write_req_ != nullptr) {
+        ENVOY_LOG(trace, "cancel pending write of closed socket, fd = {}", fd_);
+        control_reqs_++;
+        parent_.submitCancelRequest(*this, write_req_);
+      }
+    });
+    write_timeout_timer_->enableTimer(parent_.writeTimeout());
+  }
+  closeIfIdle();
+}
+
+os_fd_t IoUringServerSocket::accept(struct sockaddr*, socklen_t*) {
+  errno = EINVAL;
+  return INVALID_SOCKET;
+}
+
+void IoUringServerSocket::connect(const Network::Address::InstanceConstSharedPtr&) {
+  // Reported through a Write event and connectError(), like a failed non-blocking connect.
+  connect_error_ = EISCONN;
+  injectCompletion(Request::RequestType::Write);
+}
+
+Api::IoCallUint64Result IoUringServerSocket::read(Buffer::Instance& buffer, uint64_t max_length) {
+  if (read_buf_.length() > 0) {
+    const uint64_t length = std::min(max_length, read_buf_.length());
+    buffer.move(read_buf_, length);
+    peek_length_ = 0;
+    if (read_buf_.length() == 0) {
+      submitReadRequestIfNeeded();
+    }
+    return {length, Api::IoError::none()};
+  }
+  if (read_error_ != 0) {
+    return {0, Network::IoSocketError::create(read_error_)};
+  }
+  if (remote_closed_) {
+    return {0, Api::IoError::none()};
+  }
+  submitReadRequestIfNeeded();
+  return {0, Network::IoSocketError::getIoSocketEagainError()};
+}
+
+Api::IoCallUint64Result IoUringServerSocket::recv(void* buffer, size_t length, int flags) {
+  ASSERT((flags & ~MSG_PEEK) == 0);
+  const uint64_t copied = std::min<uint64_t>(length, read_buf_.length());
+  if (copied > 0) {
+    read_buf_.copyOut(0, copied, buffer);
+    if (!(flags & MSG_PEEK)) {
+      read_buf_.drain(copied);
+      peek_length_ = 0;
+    } else if (copied < length) {
+      peek_length_ = length;
+    }
+    submitReadRequestIfNeeded();
+    return {copied, Api::IoError::none()};
+  }
+  if (read_error_ != 0) {
+    return {0, Network::IoSocketError::create(read_error_)};
+  }
+  if (remote_closed_) {
+    return {0, Api::IoError::none()};
+  }
+  submitReadRequestIfNeeded();
+  return {0, Network::IoSocketError::getIoSocketEagainError()};
+}
+
+Api::IoCallUint64Result IoUringServerSocket::write(Buffer::Instance& buffer) {
+  if (write_error_ != 0) {
+    return {0, Network::IoSocketError::create(write_error_)};
+  }
+  if (write_req_ != nullptr) {
+    write_blocked_ = true;
+    return {0, Network::IoSocketError::getIoSocketEagainError()};
+  }
+  const uint64_t length = buffer.length();
+  write_buf_.move(buffer);
+  submitWriteRequest();
+  return {length, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringServerSocket::writev(const Buffer::RawSlice* slices,
+                                                    uint64_t num_slice) {
+  if (write_error_ != 0) {
+    return {0, Network::IoSocketError::create(write_error_)};
+  }
+  if (write_req_ != nullptr) {
+    write_blocked_ = true;
+    return {0, Network::IoSocketError::getIoSocketEagainError()};
+  }
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      write_buf_.add(slices[i].mem_, slices[i].len_);
+      length += slices[i].len_;
+    }
+  }
+  if (length > 0) {
+    submitWriteRequest();
+  }
+  return {length, Api::IoError::none()};
+}
+
+void IoUringServerSocket::shutdown(int how) {
+  if (how != SHUT_RD && write_req_ != nullptr) {
+    // Shutting down the write side must not overtake pending writes.
+    pending_shutdown_ = how;
+    return;
+  }
+  control_reqs_++;
+  parent_.submitShutdownRequest(*this, how);
+}
+
+void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onRead(req, result, injected);
+  if (injected) {
+    return;
+  }
+  ASSERT(req == read_req_);
+  read_req_ = nullptr;
+
+  if (result > 0) {
+    // Hand the buffer of the request over to the read buffer instead of copying the data.
+    read_buf_.addBufferFragment(*static_cast<ReadRequest*>(req)->releaseFragment(result));
+  } else if (result == 0) {
+    remote_closed_ = true;
+  } else if (result != -ECANCELED) {
+    read_error_ = -result;
+  }
+
+  if (closed_) {
+    closeIfIdle();
+    return;
+  }
+  if (enabled_events_ & Event::FileReadyType::Read) {
+    deliverFileEvents(Event::FileReadyType::Read);
+  } else if (remote_closed_ && (enabled_events_ & Event::FileReadyType::Closed)) {
+    deliverFileEvents(Event::FileReadyType::Closed);
+  }
+  submitReadRequestIfNeeded();
+}
+
+void IoUringServerSocket::onWrite(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onWrite(req, result, injected);
+  if (injected) {
+    return;
+  }
+  ASSERT(req == write_req_);
+  write_req_ = nullptr;
+
+  if (result >= 0) {
+    write_buf_.drain(result);
+  } else {
+    write_error_ = -result;
+    write_buf_.drain(write_buf_.length());
+  }
+  // Keep writing the remainder of partial writes, also after the socket was closed.
+  if (write_buf_.length() > 0) {
+    submitWriteRequest();
+    return;
+  }
+
+  if (closed_) {
+    closeIfIdle();
+    return;
+  }
+  if (pending_shutdown_.has_value()) {
+    control_reqs_++;
+    parent_.submitShutdownRequest(*this, pending_shutdown_.value());
+    pending_shutdown_.reset();
+  }
+  if ((write_blocked_ || write_error_ != 0) && (enabled_events_ & Event::FileReadyType::Write)) {
+    write_blocked_ = false;
+    deliverFileEvents(Event::FileReadyType::Write);
+  }
+}
+
+void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  if (injected) {
+    return;
+  }
+  ASSERT(control_reqs_ > 0);
+  control_reqs_--;
+  closeIfIdle();
+}
+
+void IoUringServerSocket::onShutdown(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onShutdown(req, result, injected);
+  if (injected) {
+    return;
+  }
+  if (result < 0) {
+    ENVOY_LOG(debug, "shutdown request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+  }
+  ASSERT(control_reqs_ > 0);
+  control_reqs_--;
+  closeIfIdle();
+}
+
+void IoUringServerSocket::submitReadRequestIfNeeded() {
+  // Only read ahead when the previously read data was consumed, or a peek asked for more than
+  // was read, so a slow reader applies backpressure to the peer.
+  if (!closed_ && connected_ && (enabled_events_ & Event::FileReadyType::Read) &&
+      read_req_ == nullptr && read_buf_.length() < std::max<uint64_t>(peek_length_, 1) &&
+      !remote_closed_ && read_error_ == 0) {
+    read_req_ = parent_.submitReadRequest(*this);
+  }
+}
+
+void IoUringServerSocket::submitWriteRequest() {
+  ASSERT(write_req_ == nullptr);
+  // The remainder of a larger buffer is written once this request completed.
+  constexpr uint64_t MaxSlices = 16;
+  write_req_ = parent_.submitWriteRequest(*this, write_buf_.getRawSlices(MaxSlices));
+}
+
+void IoUringServerSocket::closeIfIdle() {
+  if (closed_ && read_req_ == nullptr && write_req_ == nullptr && connect_req_ == nullptr &&
+      control_reqs_ == 0) {
+    write_timeout_timer_.reset();
+    closeAndCleanup();
+  }
+}
+
+IoUringClientSocket::IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringServerSocket(fd, parent, std::move(cb), false) {}
+
+void IoUringClientSocket::connect(const Network::Address::InstanceConstSharedPtr& address) {
+  ASSERT(!connected_ && connect_req_ == nullptr);
+  connect_req_ = parent_.submitConnectRequest(*this, address);
+}
+
+void IoUringClientSocket::onConnect(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onConnect(req, result, injected);
+  if (injected) {
+    return;
+  }
+  ASSERT(req == connect_req_);
+  connect_req_ = nullptr;
+
+  if (result < 0) {
+    connect_error_ = -result;
+  } else {
+    connected_ = true;
+  }
+  if (closed_) {
+    closeIfIdle();
+    return;
+  }
+  submitReadRequestIfNeeded();
+  // The owner of the socket checks the outcome of the connect with connectError() when the
+  // socket becomes writable.
+  if (enabled_events_ & Event::FileReadyType::Write) {
+    deliverFileEvents(Event::FileReadyType::Write);
+  }
+}
+
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                                     const IoUringWorkerOptions& options,
                                      Event::Dispatcher& dispatcher)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        dispatcher) {}
+                        options, dispatcher) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher)
-    : io_uring_(std::move(io_uring)), dispatcher_(dispatcher) {
+    : IoUringWorkerImpl(std::move(io_uring), IoUringWorkerOptions(), dispatcher) {}
+
+IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, const IoUringWorkerOptions& options,
+                                     Event::Dispatcher& dispatcher)
+    : io_uring_(std::move(io_uring)), options_(options), dispatcher_(dispatcher) {
+  if (options_.read_buffer_pool_size_ > 0) {
+    read_buffer_pool_ = std::make_shared<ReadBufferPool>(options_.read_buffer_pool_size_,
+                                                         options_.read_buffer_size_);
+    if (options_.register_read_buffers_) {
+      const std::vector<struct iovec> iovecs = read_buffer_pool_->iovecs();
+      read_buffers_registered_ =
+          io_uring_->registerBuffers(iovecs.data(), iovecs.size()) == IoUringResult::Ok;
+      if (!read_buffers_registered_) {
+        ENVOY_LOG(warn, "unable to register the read buffers with io_uring, reading into "
+                        "unregistered buffers");
+      }
+    }
+  }
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -47,6 +604,21 @@ IoUringWorkerImpl::~IoUringWorkerImpl() {
 
 Event::Dispatcher& IoUringWorkerImpl::dispatcher() { return dispatcher_; }
 
+IoUringSocket& IoUringWorkerImpl::addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add accept socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringAcceptSocket>(fd, *this, std::move(cb)));
+}
+
+IoUringSocket& IoUringWorkerImpl::addServerSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add server socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringServerSocket>(fd, *this, std::move(cb)));
+}
+
+IoUringSocket& IoUringWorkerImpl::addClientSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add client socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringClientSocket>(fd, *this, std::move(cb)));
+}
+
 IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket) {
   LinkedList::moveIntoListBack(std::move(socket), sockets_);
   return *sockets_.back();
@@ -65,10 +637,106 @@ void IoUringWorkerImpl::injectCompletion(IoUringSocket& socket, Request::Request
   file_event_->activate(Event::FileReadyType::Read);
 }
 
+Request* IoUringWorkerImpl::submitAcceptRequest(IoUringSocket& socket) {
+  auto* req = new AcceptRequest(socket, false);
+  ENVOY_LOG(trace, "submit accept request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest([&]() {
+    return io_uring_->prepareAccept(socket.fd(), reinterpret_cast<struct sockaddr*>(
+                                                     &req->remote_addr_),
+                                    &req->remote_addr_len_, req);
+  });
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitMultishotAcceptRequest(IoUringSocket& socket) {
+  auto* req = new AcceptRequest(socket, true);
+  ENVOY_LOG(trace, "submit multishot accept request, fd = {}, req = {}", socket.fd(),
+            fmt::ptr(req));
+  prepareRequest([&]() { return io_uring_->prepareMultishotAccept(socket.fd(), req); });
+  return req;
+}
+
+Request*
+IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
+                                        const Network::Address::InstanceConstSharedPtr& address) {
+  auto* req = new ConnectRequest(socket, address);
+  ENVOY_LOG(trace, "submit connect request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest([&]() { return io_uring_->prepareConnect(socket.fd(), req->address_, req); });
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
+  const absl::optional<uint32_t> index =
+      read_buffer_pool_ != nullptr ? read_buffer_pool_->acquire() : absl::nullopt;
+  ReadRequest* req;
+  if (index.has_value()) {
+    req = new ReadRequest(socket, read_buffer_pool_, index.value());
+  } else {
+    // All the buffers of the pool hold data which was not consumed yet.
+    req = new ReadRequest(socket, options_.read_buffer_size_);
+  }
+  ENVOY_LOG(trace, "submit read request, fd = {}, req = {}", socket.fd(), fmt::ptr(req));
+  if (index.has_value() && read_buffers_registered_) {
+    prepareRequest([&]() {
+      return io_uring_->prepareReadFixed(socket.fd(), req->iov_.iov_base, req->iov_.iov_len, 0,
+                                         index.value(), req);
+    });
+  } else {
+    prepareRequest([&]() { return io_uring_->prepareReadv(socket.fd(), &req->iov_, 1, 0, req); });
+  }
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
+                                               const Buffer::RawSliceVector& slices) {
+  auto* req = new WriteRequest(socket, slices);
+  ENVOY_LOG(trace, "submit write request, fd = {}, req = {}, slices = {}", socket.fd(),
+            fmt::ptr(req), slices.size());
+  prepareRequest([&]() {
+    return io_uring_->prepareWritev(socket.fd(), req->iovs_.data(), req->iovs_.size(), 0, req);
+  });
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitCancelRequest(IoUringSocket& socket,
+                                                Request* request_to_cancel) {
+  auto* req = new Request(Request::RequestType::Cancel, socket);
+  ENVOY_LOG(trace, "submit cancel request, fd = {}, req = {}, request to cancel = {}", socket.fd(),
+            fmt::ptr(req), fmt::ptr(request_to_cancel));
+  prepareRequest([&]() { return io_uring_->prepareCancel(request_to_cancel, req); });
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitShutdownRequest(IoUringSocket& socket, int how) {
+  auto* req = new Request(Request::RequestType::Shutdown, socket);
+  ENVOY_LOG(trace, "submit shutdown request, fd = {}, req = {}, how = {}", socket.fd(),
+            fmt::ptr(req), how);
+  prepareRequest([&]() { return io_uring_->prepareShutdown(socket.fd(), how, req); });
+  return req;
+}
+
+void IoUringWorkerImpl::prepareRequest(absl::FunctionRef<IoUringResult()> prepare) {
+  IoUringResult res = prepare();
+  if (res == IoUringResult::Failed) {
+    // The submission queue is full. Submit the queued requests right away to make room.
+    io_uring_->submit();
+    res = prepare();
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare io_uring request");
+  }
+  if (delay_submit_) {
+    // The request is submitted at the end of the completion handling.
+    return;
+  }
+  if (submit_cb_ == nullptr) {
+    submit_cb_ = dispatcher_.createSchedulableCallback([this]() { submit(); });
+  }
+  submit_cb_->scheduleCallbackCurrentIteration();
+}
+
 void IoUringWorkerImpl::onFileEvent() {
   ENVOY_LOG(trace, "io uring worker, on file event");
   delay_submit_ = true;
-  io_uring_->forEveryCompletion([](Request* req, int32_t result, bool injected) {
+  io_uring_->forEveryCompletion([](Request* req, int32_t result, uint32_t flags, bool injected) {
     ENVOY_LOG(trace, "receive request completion, type = {}, req = {}",
               static_cast<uint8_t>(req->type()), fmt::ptr(req));
     ASSERT(req != nullptr);
@@ -77,7 +745,14 @@ void IoUringWorkerImpl::onFileEvent() {
     case Request::RequestType::Accept:
       ENVOY_LOG(trace, "receive accept request completion, fd = {}, req = {}", req->socket().fd(),
                 fmt::ptr(req));
+      if (!injected) {
+        static_cast<AcceptRequest*>(req)->more_ = flags & IORING_CQE_F_MORE;
+      }
       req->socket().onAccept(req, result, injected);
+      if (!injected && static_cast<AcceptRequest*>(req)->more_) {
+        // The multishot request completes again for the next connection.
+        return;
+      }
       break;
     case Request::RequestType::Connect:
       ENVOY_LOG(trace, "receive connect request completion, fd = {}, req = {}", req->socket().fd(),
@@ -1,25 +1,97 @@
 #pragma once
 
+#include <chrono>
+
 #include "envoy/common/io/io_uring.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/event/timer.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/io/io_uring_impl.h"
 
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Io {
 
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
+struct IoUringWorkerOptions {
+  static constexpr uint32_t DefaultReadBufferSize = 8192;
+  static constexpr uint32_t DefaultReadBufferPoolSize = 128;
+  static constexpr std::chrono::milliseconds DefaultWriteTimeout{1000};
+
+  // The size of the buffer of each read request.
+  uint32_t read_buffer_size_{DefaultReadBufferSize};
+  // The number of read buffers which are reused by the sockets of a worker. Reads fall back to
+  // buffers of their own while all of them hold data which was not consumed yet.
+  uint32_t read_buffer_pool_size_{DefaultReadBufferPoolSize};
+  // Whether the read buffers are registered with the io_uring instance, so the kernel does not
+  // map them for every read.
+  bool register_read_buffers_{false};
+  // Whether connections are accepted with a multishot accept request, which keeps accepting
+  // until it is cancelled instead of being re-submitted for every connection.
+  bool multishot_accept_{true};
+  // How long pending writes of a closed socket are flushed before they are cancelled.
+  std::chrono::milliseconds write_timeout_{DefaultWriteTimeout};
+};
+
+/**
+ * Read buffers of the same size which are carved out of a single allocation, so they can be
+ * registered with an io_uring instance. The data read into a buffer is handed to the read buffer
+ * of the socket without copying, and the buffer returns to the pool once that data was drained,
+ * possibly on another thread. The pool is shared with these buffer fragments, as they may outlive
+ * the worker.
+ */
+class ReadBufferPool {
+public:
+  ReadBufferPool(uint32_t num_buffers, uint32_t buffer_size);
+
+  /**
+   * @return the index of a free buffer, or absl::nullopt if all the buffers are in use.
+   */
+  absl::optional<uint32_t> acquire();
+
+  /**
+   * Return a buffer to the pool.
+   */
+  void release(uint32_t index);
+
+  uint8_t* buffer(uint32_t index) const { return memory_.get() + uint64_t(index) * buffer_size_; }
+  uint32_t bufferSize() const { return buffer_size_; }
+
+  /**
+   * @return the buffers of the pool, in the order of their indexes.
+   */
+  std::vector<struct iovec> iovecs() const;
+
+private:
+  const uint32_t num_buffers_;
+  const uint32_t buffer_size_;
+  const std::unique_ptr<uint8_t[]> memory_;
+  absl::Mutex mutex_;
+  std::vector<uint32_t> free_buffers_ ABSL_GUARDED_BY(mutex_);
+};
+using ReadBufferPoolSharedPtr = std::shared_ptr<ReadBufferPool>;
+
 class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger::Id::io> {
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
-                    Event::Dispatcher& dispatcher);
+                    const IoUringWorkerOptions& options, Event::Dispatcher& dispatcher);
   IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher);
+  IoUringWorkerImpl(IoUringPtr&& io_uring, const IoUringWorkerOptions& options,
+                    Event::Dispatcher& dispatcher);
   ~IoUringWorkerImpl() override;
 
   // IoUringWorker
   Event::Dispatcher& dispatcher() override;
+  IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  IoUringSocket& addServerSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  uint32_t getNumOfSockets() const override { return sockets_.size(); }
 
   // Remove a socket from this worker.
   IoUringSocketEntryPtr removeSocket(IoUringSocketEntry& socket);
@@ -27,21 +99,45 @@ public:
   // Inject a request completion into the iouring instance for a specific socket.
   void injectCompletion(IoUringSocket& socket, Request::RequestType type, int32_t result);
 
-  // Return the number of sockets in this worker.
-  size_t getNumOfSockets() const { return sockets_.size(); }
+  // Submit requests on behalf of a socket. The requests are released by the worker after the
+  // socket handled their completion.
+  Request* submitAcceptRequest(IoUringSocket& socket);
+  Request* submitMultishotAcceptRequest(IoUringSocket& socket);
+  Request* submitConnectRequest(IoUringSocket& socket,
+                                const Network::Address::InstanceConstSharedPtr& address);
+  Request* submitReadRequest(IoUringSocket& socket);
+  Request* submitWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices);
+  Request* submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel);
+  Request* submitShutdownRequest(IoUringSocket& socket, int how);
+
+  std::chrono::milliseconds writeTimeout() const { return options_.write_timeout_; }
+  bool multishotAccept() const { return options_.multishot_accept_; }
+  // Accept with single requests from now on, as the kernel does not support multishot accepts.
+  void disableMultishotAccept() { options_.multishot_accept_ = false; }
 
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
   void onFileEvent();
   void submit();
+  // Prepare a request with the given function, and submit it with the other requests prepared
+  // in the current event loop iteration.
+  void prepareRequest(absl::FunctionRef<IoUringResult()> prepare);
 
   // The iouring instance.
   IoUringPtr io_uring_;
+  IoUringWorkerOptions options_;
+  // The buffers of the read requests, if the pool is enabled.
+  ReadBufferPoolSharedPtr read_buffer_pool_;
+  // Whether the buffers of the pool are registered with the iouring instance.
+  bool read_buffers_registered_{false};
   // The dispatcher of this worker is running on.
   Event::Dispatcher& dispatcher_;
   // The file event of iouring's eventfd.
   Event::FileEventPtr file_event_{nullptr};
+  // Submits the requests which were prepared outside of completion handling at the end of the
+  // current event loop iteration, so they share a single io_uring_enter().
+  Event::SchedulableCallbackPtr submit_cb_;
   // All the sockets in this worker.
   std::list<IoUringSocketEntryPtr> sockets_;
   // This is used to mark whether delay submit is enabled.
@@ -50,12 +146,61 @@ protected:
   bool delay_submit_{false};
 };
 
+struct AcceptRequest : public Request {
+  AcceptRequest(IoUringSocket& socket, bool multishot)
+      : Request(RequestType::Accept, socket), multishot_(multishot) {}
+
+  // A multishot request does not report the remote addresses of the accepted connections.
+  const bool multishot_;
+  // Whether the multishot request keeps accepting after the current completion, in which case
+  // the worker does not release it yet.
+  bool more_{false};
+  sockaddr_storage remote_addr_{};
+  socklen_t remote_addr_len_{sizeof(remote_addr_)};
+};
+
+struct ConnectRequest : public Request {
+  ConnectRequest(IoUringSocket& socket, const Network::Address::InstanceConstSharedPtr& address)
+      : Request(RequestType::Connect, socket), address_(address) {}
+
+  // The address must outlive the request.
+  const Network::Address::InstanceConstSharedPtr address_;
+};
+
+struct ReadRequest : public Request {
+  // Reads into a buffer of the pool.
+  ReadRequest(IoUringSocket& socket, ReadBufferPoolSharedPtr pool, uint32_t index)
+      : Request(RequestType::Read, socket), pool_(std::move(pool)), index_(index),
+        iov_{pool_->buffer(index), pool_->bufferSize()} {}
+  // Reads into a buffer of its own.
+  ReadRequest(IoUringSocket& socket, uint32_t size)
+      : Request(RequestType::Read, socket), buf_(new uint8_t[size]), iov_{buf_.get(), size} {}
+  ~ReadRequest() override;
+
+  /**
+   * Hand the buffer over to a buffer fragment holding the data which was read, which releases
+   * the buffer once it was drained.
+   */
+  Buffer::BufferFragmentImpl* releaseFragment(uint32_t length);
+
+  ReadBufferPoolSharedPtr pool_;
+  uint32_t index_{0};
+  std::unique_ptr<uint8_t[]> buf_;
+  struct iovec iov_;
+};
+
+struct WriteRequest : public Request {
+  WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices);
+
+  std::vector<struct iovec> iovs_;
+};
+
 class IoUringSocketEntry : public IoUringSocket,
                            public LinkedObject<IoUringSocketEntry>,
                            public Event::DeferredDeletable,
                            protected Logger::Loggable<Logger::Id::io> {
 public:
-  IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent);
+  IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb = nullptr);
 
   // IoUringSocket
   IoUringWorker& getIoUringWorker() const override { return parent_; }
@@ -73,11 +218,13 @@ public:
   void onRead(Request*, int32_t, bool injected) override {
     if (injected && (injected_completions_ & static_cast<uint8_t>(Request::RequestType::Read))) {
       injected_completions_ &= ~static_cast<uint8_t>(Request::RequestType::Read);
+      deliverFileEvents(Event::FileReadyType::Read);
     }
   }
   void onWrite(Request*, int32_t, bool injected) override {
     if (injected && (injected_completions_ & static_cast<uint8_t>(Request::RequestType::Write))) {
       injected_completions_ &= ~static_cast<uint8_t>(Request::RequestType::Write);
+      deliverFileEvents(Event::FileReadyType::Write);
     }
   }
   void onClose(Request*, int32_t, bool injected) override {
@@ -97,6 +244,9 @@ public:
     }
   }
   void injectCompletion(Request::RequestType type) override;
+  void setFileReadyCb(Event::FileReadyCb cb) override { cb_ = std::move(cb); }
+  void enableFileEvents(uint32_t events) override { enabled_events_ = events; }
+  void activateFileEvents(uint32_t events) override;
 
 protected:
   /**
@@ -104,11 +254,137 @@ protected:
    */
   void cleanup();
 
+  /**
+   * Remove the socket from the IoUringWorker and close the fd after the current event loop
+   * callback returned. Completions which are handled in the current callback may still refer to
+   * the socket, and the fd must stay open until its injected completions were removed, so that
+   * they cannot be confused with the completions of a new socket reusing the fd.
+   */
+  void closeAndCleanup();
+
+  /**
+   * Invoke the file ready callback with the given events, unless the socket is closed.
+   */
+  void deliverFileEvents(uint32_t events) {
+    if (!closed_ && cb_ != nullptr) {
+      cb_(events);
+    }
+  }
+
   os_fd_t fd_{INVALID_SOCKET};
   IoUringWorkerImpl& parent_;
   // This records already injected completion request type to
   // avoid duplicated injections.
   uint8_t injected_completions_{0};
+  Event::FileReadyCb cb_;
+  uint32_t enabled_events_{0};
+  bool closed_{false};
+  bool cleaned_up_{false};
+};
+
+/**
+ * A listening socket. Connections are accepted with a multishot accept request while accepting is
+ * enabled, or with one accept request at a time, which is re-submitted as soon as it completed.
+ * The data operations fail like on a listening socket.
+ */
+class IoUringAcceptSocket : public IoUringSocketEntry {
+public:
+  IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+
+  // IoUringSocket
+  void enableFileEvents(uint32_t events) override;
+  void close() override;
+  os_fd_t accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  void connect(const Network::Address::InstanceConstSharedPtr& address) override;
+  int32_t connectError() const override { return connect_error_; }
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  void shutdown(int how) override;
+  void onAccept(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+
+private:
+  struct AcceptedSocket {
+    os_fd_t fd_;
+    sockaddr_storage remote_addr_;
+    socklen_t remote_addr_len_;
+  };
+
+  void submitAcceptRequestIfNeeded();
+  void closeIfIdle();
+
+  std::list<AcceptedSocket> accepted_sockets_;
+  Request* accept_req_{nullptr};
+  bool cancel_pending_{false};
+  int32_t connect_error_{0};
+};
+
+/**
+ * A connected stream socket. A single read request is kept in flight while reading is enabled,
+ * and the data is buffered until the owner of the socket reads it. Written data is moved into a
+ * buffer which is written with a single request at a time. Accepting and connecting fail like on
+ * a connected socket.
+ */
+class IoUringServerSocket : public IoUringSocketEntry {
+public:
+  IoUringServerSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
+                      bool connected = true);
+
+  // IoUringSocket
+  void enableFileEvents(uint32_t events) override;
+  void close() override;
+  os_fd_t accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  void connect(const Network::Address::InstanceConstSharedPtr& address) override;
+  int32_t connectError() const override { return connect_error_; }
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  void shutdown(int how) override;
+  void onRead(Request* req, int32_t result, bool injected) override;
+  void onWrite(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+  void onShutdown(Request* req, int32_t result, bool injected) override;
+
+protected:
+  void submitReadRequestIfNeeded();
+  void submitWriteRequest();
+  void closeIfIdle();
+
+  bool connected_;
+  Request* read_req_{nullptr};
+  Buffer::OwnedImpl read_buf_;
+  // The length of the last peek which found less data than requested. Data is read ahead until
+  // the read buffer holds at least this much, as a peeking reader does not consume it.
+  uint64_t peek_length_{0};
+  int32_t read_error_{0};
+  bool remote_closed_{false};
+  Request* write_req_{nullptr};
+  Buffer::OwnedImpl write_buf_;
+  int32_t write_error_{0};
+  // Whether a write was rejected because the previous one is still pending, in which case a
+  // Write event is delivered once it completed.
+  bool write_blocked_{false};
+  absl::optional<int> pending_shutdown_;
+  Request* connect_req_{nullptr};
+  int32_t connect_error_{0};
+  // In-flight cancel and shutdown requests, which refer to the socket until they complete.
+  uint32_t control_reqs_{0};
+  Event::TimerPtr write_timeout_timer_;
+};
+
+/**
+ * A stream socket which is connected through io_uring. Reading starts once the connect completed.
+ */
+class IoUringClientSocket : public IoUringServerSocket {
+public:
+  IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+
+  // IoUringSocket
+  void connect(const Network::Address::InstanceConstSharedPtr& address) override;
+  void onConnect(Request* req, int32_t result, bool injected) override;
 };
 
 } // namespace Io
@@ -30,8 +30,8 @@ public:
                                                 absl::optional<int> domain);
 
 protected:
-  virtual IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
-                                 absl::optional<int> domain) const;
+  virtual IoHandlePtr makeSocket(int socket_fd, bool socket_v6only, absl::optional<int> domain,
+                                 Socket::Type socket_type) const;
 };
 
 DECLARE_FACTORY(SocketInterfaceImpl);
@@ -373,6 +373,24 @@ Address::InstanceConstSharedPtr Utility::getAddressWithPort(const Address::Insta
   PANIC("not handled");
 }
 
+Address::InstanceConstSharedPtr
+Utility::getAddressWithSocketInterface(const Address::InstanceConstSharedPtr& address,
+                                       const SocketInterface& sock_interface) {
+  if (address->ip() == nullptr || &address->socketInterface() == &sock_interface) {
+    return address;
+  }
+  switch (address->ip()->version()) {
+  case Address::IpVersion::v4:
+    return std::make_shared<Address::Ipv4Instance>(
+        reinterpret_cast<const sockaddr_in*>(address->sockAddr()), &sock_interface);
+  case Address::IpVersion::v6:
+    return std::make_shared<Address::Ipv6Instance>(
+        *reinterpret_cast<const sockaddr_in6*>(address->sockAddr()),
+        address->ip()->ipv6()->v6only(), &sock_interface);
+  }
+  PANIC("not handled");
+}
+
 Address::InstanceConstSharedPtr Utility::getOriginalDst(Socket& sock) {
 #ifdef SOL_IP
 
@@ -269,6 +269,17 @@ public:
   static Address::InstanceConstSharedPtr getAddressWithPort(const Address::Instance& address,
                                                             uint32_t port);
 
+  /**
+   * @param address the address to update.
+   * @param sock_interface the socket interface which creates the sockets of the address.
+   * @return Address::InstanceConstSharedPtr a new IP address instance whose sockets are created by
+   *         the socket interface, or the address itself if it is not an IP address or already
+   *         uses the socket interface.
+   */
+  static Address::InstanceConstSharedPtr
+  getAddressWithSocketInterface(const Address::InstanceConstSharedPtr& address,
+                                const SocketInterface& sock_interface);
+
   /**
    * Retrieve the original destination address from an accepted socket.
    * The address (IP and port) may be not local and the port may differ from
@@ -1802,6 +1802,15 @@ VirtualHostImpl::VirtualHostImpl(
                                                   optional_http_filters, factory_context, validator,
                                                   validation_clusters));
     }
+
+    if (global_route_config->compileRouteMatchers()) {
+      auto route_path_index = std::make_unique<RoutePathIndex>();
+      for (const auto& route : routes_) {
+        route_path_index->addRoute(route->matchType(), route->matcher(), route->case_sensitive());
+      }
+      route_path_index->compile();
+      route_path_index_ = std::move(route_path_index);
+    }
   }
 }
 
@@ -1893,10 +1902,39 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  // The path index is only used when no route callback is provided, as route callbacks rely on
+  // observing every route in the table.
+  if (route_path_index_ != nullptr && cb == nullptr && headers.Path() != nullptr) {
+    return getRouteFromPathIndex(headers, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
+RouteConstSharedPtr
+VirtualHostImpl::getRouteFromPathIndex(const Http::RequestHeaderMap& headers,
+                                       const StreamInfo::StreamInfo& stream_info,
+                                       uint64_t random_value) const {
+  // Routes match against the path without query string and fragment, and optionally without
+  // path parameters. See RouteEntryImplBase::sanitizePathBeforePathMatching().
+  absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+  if (shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching()) {
+    path = path.substr(0, path.find(';'));
+  }
+
+  RoutePathIndex::Candidates candidates;
+  route_path_index_->candidates(path, candidates);
+  for (const uint32_t candidate : candidates) {
+    RouteConstSharedPtr route_entry =
+        routes_[candidate]->matches(headers, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
+    }
+  }
+  return nullptr;
+}
+
 const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
     absl::string_view host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
     RouteMatcher::SubstringFunction substring_function) const {
@@ -2057,7 +2095,8 @@ CommonConfigImpl::CommonConfigImpl(const envoy::config::route::v3::RouteConfigur
                                           DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)),
       uses_vhds_(config.has_vhds()),
       most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()),
-      ignore_path_parameters_in_path_matching_(config.ignore_path_parameters_in_path_matching()) {
+      ignore_path_parameters_in_path_matching_(config.ignore_path_parameters_in_path_matching()),
+      compile_route_matchers_(config.compile_route_matchers()) {
   if (!config.request_mirror_policies().empty()) {
     shadow_policies_.reserve(config.request_mirror_policies().size());
     for (const auto& mirror_policy_config : config.request_mirror_policies()) {
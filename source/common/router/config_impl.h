@@ -32,6 +32,7 @@
 #include "source/common/router/header_formatter.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_path_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -381,11 +382,17 @@ private:
 
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
+  RouteConstSharedPtr getRouteFromPathIndex(const Http::RequestHeaderMap& headers,
+                                            const StreamInfo::StreamInfo& stream_info,
+                                            uint64_t random_value) const;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   SslRequirements ssl_requirements_;
 
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Only set if the route configuration enables compile_route_matchers.
+  RoutePathIndexConstPtr route_path_index_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
 };
 
@@ -627,6 +634,7 @@ public:
 
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
+  bool case_sensitive() const { return case_sensitive_; }
   void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
 
   // Router::RouteEntry
@@ -1069,7 +1077,6 @@ protected:
   const std::string host_rewrite_;
   std::unique_ptr<ConnectConfig> connect_config_;
 
-  bool case_sensitive() const { return case_sensitive_; }
   RouteConstSharedPtr clusterEntry(const Http::RequestHeaderMap& headers,
                                    uint64_t random_value) const;
 
@@ -1580,6 +1587,7 @@ public:
   bool ignorePathParametersInPathMatching() const {
     return ignore_path_parameters_in_path_matching_;
   }
+  bool compileRouteMatchers() const { return compile_route_matchers_; }
 
 private:
   std::list<Http::LowerCaseString> internal_only_headers_;
@@ -1596,6 +1604,7 @@ private:
   const bool uses_vhds_ : 1;
   const bool most_specific_header_mutations_wins_ : 1;
   const bool ignore_path_parameters_in_path_matching_ : 1;
+  const bool compile_route_matchers_ : 1;
 };
 
 /**
@@ -0,0 +1,152 @@
+#include "source/common/router/route_path_index.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/logger.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+void RoutePathIndex::PrefixTrie::add(absl::string_view prefix, uint32_t route, bool lower_case) {
+  uint32_t current = 0;
+  for (const char c : prefix) {
+    const uint8_t key = static_cast<uint8_t>(lower_case ? absl::ascii_tolower(c) : c);
+    auto it = nodes_[current].children_.find(key);
+    if (it == nodes_[current].children_.end()) {
+      const uint32_t next = nodes_.size();
+      nodes_.emplace_back();
+      nodes_[current].children_.emplace(key, next);
+      current = next;
+    } else {
+      current = it->second;
+    }
+  }
+  nodes_[current].routes_.push_back(route);
+}
+
+void RoutePathIndex::PrefixTrie::lookup(absl::string_view path, bool lower_case,
+                                        Candidates& candidates) const {
+  uint32_t current = 0;
+  candidates.insert(candidates.end(), nodes_[0].routes_.begin(), nodes_[0].routes_.end());
+  for (const char c : path) {
+    const uint8_t key = static_cast<uint8_t>(lower_case ? absl::ascii_tolower(c) : c);
+    const auto it = nodes_[current].children_.find(key);
+    if (it == nodes_[current].children_.end()) {
+      return;
+    }
+    current = it->second;
+    const auto& routes = nodes_[current].routes_;
+    candidates.insert(candidates.end(), routes.begin(), routes.end());
+  }
+}
+
+void RoutePathIndex::addRoute(PathMatchType type, absl::string_view matcher, bool case_sensitive) {
+  ASSERT(!compiled_);
+  const uint32_t route = size_++;
+  switch (type) {
+  case PathMatchType::Prefix:
+  case PathMatchType::PathSeparatedPrefix:
+    // Path separated prefixes additionally require a '/' or the end of the path after the prefix.
+    // That is checked by the route itself.
+    if (case_sensitive) {
+      prefixes_.add(matcher, route, false);
+    } else {
+      prefixes_ignore_case_.add(matcher, route, true);
+    }
+    return;
+  case PathMatchType::Exact:
+    if (case_sensitive) {
+      exact_paths_[matcher].push_back(route);
+    } else {
+      exact_paths_ignore_case_[absl::AsciiStrToLower(matcher)].push_back(route);
+    }
+    return;
+  case PathMatchType::Regex:
+    regex_patterns_.emplace_back(matcher);
+    regex_routes_.push_back(route);
+    return;
+  case PathMatchType::None:
+  case PathMatchType::Template:
+    break;
+  }
+  always_.push_back(route);
+}
+
+void RoutePathIndex::compile() {
+  ASSERT(!compiled_);
+  compiled_ = true;
+  if (regex_patterns_.empty()) {
+    return;
+  }
+
+  // Route regexes must match the entire path, which RE2::ANCHOR_BOTH provides for every pattern
+  // in the set.
+  re2::RE2::Options options(re2::RE2::Quiet);
+  auto regex_set = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  bool ok = true;
+  for (const std::string& pattern : regex_patterns_) {
+    if (regex_set->Add(pattern, nullptr) < 0) {
+      ok = false;
+      break;
+    }
+  }
+  if (ok && regex_set->Compile()) {
+    regex_set_ = std::move(regex_set);
+  } else {
+    // The individual regexes have already been validated by their routes, so this only happens
+    // when the combined program exceeds RE2's memory budget. Fall back to evaluating every regex
+    // route.
+    ENVOY_LOG_MISC(warn, "unable to compile {} route regexes into a single set, regex routes will "
+                         "be matched linearly",
+                   regex_patterns_.size());
+    always_.insert(always_.end(), regex_routes_.begin(), regex_routes_.end());
+    std::sort(always_.begin(), always_.end());
+  }
+  regex_patterns_.clear();
+  regex_patterns_.shrink_to_fit();
+}
+
+void RoutePathIndex::candidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(compiled_);
+  candidates.insert(candidates.end(), always_.begin(), always_.end());
+
+  prefixes_.lookup(path, false, candidates);
+  if (!prefixes_ignore_case_.empty()) {
+    prefixes_ignore_case_.lookup(path, true, candidates);
+  }
+
+  if (!exact_paths_.empty()) {
+    const auto it = exact_paths_.find(path);
+    if (it != exact_paths_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+  if (!exact_paths_ignore_case_.empty()) {
+    const auto it = exact_paths_ignore_case_.find(absl::AsciiStrToLower(path));
+    if (it != exact_paths_ignore_case_.end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(path, &matches, &error_info)) {
+      for (const int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The DFA ran out of memory for this input. Be conservative and consider every regex route.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  // Every route is stored in exactly one of the structures above, so there are no duplicates.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/router/router.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A load-time index over the path specifiers of an ordered list of routes. Given a request path,
+ * the index returns (in route order) the positions of the only routes whose path specifier may
+ * match that path. Callers still run the full route match against each candidate, so first-match
+ * semantics and all non-path match criteria (headers, query parameters, runtime fractions, ...)
+ * are preserved; the index only skips routes that cannot match.
+ *
+ * - Prefix and path-separated prefix routes are stored in a byte trie.
+ * - Exact path routes are stored in a hash index.
+ * - Regex routes are compiled into a single anchored RE2::Set.
+ * - Every other route (CONNECT, URI templates, ...) is always a candidate.
+ */
+class RoutePathIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  /**
+   * Adds the next route to the index. Routes must be added in route table order.
+   * @param type supplies the kind of path specifier of the route.
+   * @param matcher supplies the prefix, exact path or regex of the route.
+   * @param case_sensitive supplies whether prefix and exact path matching is case sensitive.
+   */
+  void addRoute(PathMatchType type, absl::string_view matcher, bool case_sensitive);
+
+  /**
+   * Compiles the regex set. Must be called once after all routes have been added and before the
+   * first call to candidates().
+   */
+  void compile();
+
+  /**
+   * Collects the positions of the routes whose path specifier may match the path.
+   * @param path supplies the request path, with the query string, fragment and (if configured)
+   *        path parameters already removed.
+   * @param candidates supplies the output list. Positions are appended in ascending order.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of routes added to the index.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  struct TrieNode {
+    absl::flat_hash_map<uint8_t, uint32_t> children_;
+    // Positions of routes whose prefix ends at this node.
+    std::vector<uint32_t> routes_;
+  };
+
+  class PrefixTrie {
+  public:
+    PrefixTrie() : nodes_(1) {}
+    void add(absl::string_view prefix, uint32_t route, bool lower_case);
+    void lookup(absl::string_view path, bool lower_case, Candidates& candidates) const;
+    bool empty() const { return nodes_.size() == 1 && nodes_[0].routes_.empty(); }
+
+  private:
+    std::vector<TrieNode> nodes_;
+  };
+
+  PrefixTrie prefixes_;
+  PrefixTrie prefixes_ignore_case_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_paths_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_paths_ignore_case_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // Maps an RE2::Set pattern index to the position of its route.
+  std::vector<uint32_t> regex_routes_;
+  std::vector<std::string> regex_patterns_;
+  // Routes that are candidates for every path. If the regex set cannot be compiled, regex routes
+  // are added here.
+  std::vector<uint32_t> always_;
+  uint32_t size_{};
+  bool compiled_{};
+};
+
+using RoutePathIndexConstPtr = std::unique_ptr<const RoutePathIndex>;
+
+} // namespace Router
+} // namespace Envoy
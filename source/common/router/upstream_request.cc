@@ -191,6 +191,11 @@ void UpstreamRequest::cleanUp() {
 
   clearRequestEncoder();
 
+  if (awaiting_headers_) {
+    // The request timed out, or was cancelled, before the response headers were received.
+    reportRttToLbPolicy(false);
+  }
+
   // If desired, fire the per-try histogram when the UpstreamRequest
   // completes.
   if (record_timeout_budget_) {
@@ -278,6 +283,7 @@ void UpstreamRequest::decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool e
   }
 
   awaiting_headers_ = false;
+  reportRttToLbPolicy(true);
   if (span_ != nullptr) {
     Tracing::HttpTracerUtility::onUpstreamResponseHeaders(*span_, headers.get());
   }
@@ -440,6 +446,9 @@ void UpstreamRequest::onResetStream(Http::StreamResetReason reason,
     span_->setTag(Tracing::Tags::get().ErrorReason, Http::Utility::resetReasonToString(reason));
   }
   clearRequestEncoder();
+  if (awaiting_headers_) {
+    reportRttToLbPolicy(false);
+  }
   awaiting_headers_ = false;
   if (!calling_encode_headers_) {
     stream_info_.setResponseFlag(Filter::streamResetReasonToResponseFlag(reason));
@@ -692,6 +701,26 @@ void UpstreamRequest::clearRequestEncoder() {
   upstream_.reset();
 }
 
+void UpstreamRequest::reportRttToLbPolicy(bool response_headers_received) {
+  // Latency aware load balancing policies track the time to the response headers, which leaves
+  // out the time spent waiting for a connection as well as the time to stream the response body.
+  if (upstream_host_ == nullptr || !upstreamTiming().first_upstream_tx_byte_sent_.has_value()) {
+    return;
+  }
+  OptRef<Upstream::HostLbPolicyData> lb_policy_data = upstream_host_->lbPolicyData();
+  if (!lb_policy_data.has_value()) {
+    return;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      parent_.callbacks()->dispatcher().timeSource().monotonicTime() -
+      upstreamTiming().first_upstream_tx_byte_sent_.value());
+  if (response_headers_received) {
+    lb_policy_data->onRequestRtt(elapsed);
+  } else {
+    lb_policy_data->onRequestFailure(elapsed);
+  }
+}
+
 void UpstreamRequest::readDisableOrDefer(bool disable) {
   if (!upstream_wait_for_response_headers_before_disabling_read_) {
     if (disable) {
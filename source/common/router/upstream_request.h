@@ -123,6 +123,9 @@ public:
 
   void clearRequestEncoder();
   void onStreamMaxDurationReached();
+  // Tells the load balancing policy of the host the time since the request was sent, either when
+  // the response headers were received or when the request ended without them.
+  void reportRttToLbPolicy(bool response_headers_received);
 
   // Either disable upstream reading immediately or defer it and keep tracking
   // of how many read disabling has happened.
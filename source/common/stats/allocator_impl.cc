@@ -16,6 +16,7 @@
 #include "source/common/stats/stat_merger.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -72,7 +73,13 @@ public:
   StatsSharedImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
                   const StatNameTagVector& stat_name_tags)
       : MetricImpl<BaseClass>(name, tag_extracted_name, stat_name_tags, alloc.symbolTable()),
-        alloc_(alloc) {}
+        alloc_(alloc) {
+    // Stats are only added to the changed stats of the allocator when their changed flag is
+    // clear, so the flag stays set unless changed stats are tracked.
+    if (!alloc.track_changed_stats_) {
+      flags_ = Metric::Flags::Changed;
+    }
+  }
 
   ~StatsSharedImpl() override {
     // MetricImpl must be explicitly cleared() before destruction, otherwise it
@@ -119,7 +126,28 @@ public:
    */
   virtual void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) PURE;
 
+  /**
+   * Adds the stat to the changed stats of the allocator, which are held in distinct sets per stat
+   * type.
+   */
+  virtual void addToChangedSet() PURE;
+
+  /**
+   * Clears the changed flag of the stat before it is visited by forEachChangedSinked*(), so that
+   * its next change adds it to the changed stats again.
+   */
+  void clearChanged() { flags_ &= ~Metric::Flags::Changed; }
+
 protected:
+  // Sets the given flags along with the changed flag, and adds the stat to the changed stats of
+  // the allocator if it had not changed since it was last visited by forEachChangedSinked*().
+  void markChanged(uint16_t flags) {
+    if (ABSL_PREDICT_FALSE(!(flags_.fetch_or(flags | Metric::Flags::Changed) &
+                             Metric::Flags::Changed))) {
+      addToChangedSet();
+    }
+  }
+
   AllocatorImpl& alloc_;
 
   // ref_count_ can be incremented as an atomic, without taking a new lock, as
@@ -146,6 +174,15 @@ public:
     const size_t count = alloc_.counters_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_counters_.erase(this);
+    if (alloc_.track_changed_stats_) {
+      Thread::LockGuard lock(alloc_.changed_mutex_);
+      alloc_.changed_counters_.erase(this);
+    }
+  }
+
+  void addToChangedSet() override {
+    Thread::LockGuard lock(alloc_.changed_mutex_);
+    alloc_.changed_counters_.insert(this);
   }
 
   // Stats::Counter
@@ -154,11 +191,14 @@ public:
     // used(). From a system perspective this should be eventually consistent.
     value_ += amount;
     pending_increment_ += amount;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void inc() override { add(1); }
   uint64_t latch() override { return pending_increment_.exchange(0); }
-  void reset() override { value_ = 0; }
+  void reset() override {
+    value_ = 0;
+    markChanged(0);
+  }
   uint64_t value() const override { return value_; }
 
 private:
@@ -195,23 +235,33 @@ public:
     const size_t count = alloc_.gauges_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_gauges_.erase(this);
+    if (alloc_.track_changed_stats_) {
+      Thread::LockGuard lock(alloc_.changed_mutex_);
+      alloc_.changed_gauges_.erase(this);
+    }
+  }
+
+  void addToChangedSet() override {
+    Thread::LockGuard lock(alloc_.changed_mutex_);
+    alloc_.changed_gauges_.insert(this);
   }
 
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     child_value_ = value;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    markChanged(0);
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
 
@@ -260,7 +310,10 @@ public:
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    parent_value_ = value;
+    markChanged(0);
+  }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -277,14 +330,25 @@ public:
     const size_t count = alloc_.text_readouts_.erase(statName());
     ASSERT(count == 1);
     alloc_.sinked_text_readouts_.erase(this);
+    if (alloc_.track_changed_stats_) {
+      Thread::LockGuard lock(alloc_.changed_mutex_);
+      alloc_.changed_text_readouts_.erase(this);
+    }
+  }
+
+  void addToChangedSet() override {
+    Thread::LockGuard lock(alloc_.changed_mutex_);
+    alloc_.changed_text_readouts_.insert(this);
   }
 
   // Stats::TextReadout
   void set(absl::string_view value) override {
     std::string value_copy(value);
-    absl::MutexLock lock(&mutex_);
-    value_ = std::move(value_copy);
-    flags_ |= Flags::Used;
+    {
+      absl::MutexLock lock(&mutex_);
+      value_ = std::move(value_copy);
+    }
+    markChanged(Flags::Used);
   }
   std::string value() const override {
     absl::MutexLock lock(&mutex_);
@@ -439,6 +503,86 @@ void AllocatorImpl::forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout>
   }
 }
 
+void AllocatorImpl::trackChangedStats() {
+  Thread::LockGuard lock(mutex_);
+  if (track_changed_stats_) {
+    return;
+  }
+  track_changed_stats_ = true;
+  // The existing stats were made with their changed flag set, so they are all visited by the next
+  // forEachChangedSinked*() calls.
+  Thread::LockGuard changed_lock(changed_mutex_);
+  for (Counter* counter : counters_) {
+    // Subclasses may wrap the counters made by makeCounterInternal().
+    CounterImpl* counter_impl = dynamic_cast<CounterImpl*>(counter);
+    if (counter_impl != nullptr) {
+      changed_counters_.insert(counter_impl);
+    }
+  }
+  for (Gauge* gauge : gauges_) {
+    changed_gauges_.insert(static_cast<GaugeImpl*>(gauge));
+  }
+  for (TextReadout* text_readout : text_readouts_) {
+    changed_text_readouts_.insert(static_cast<TextReadoutImpl*>(text_readout));
+  }
+}
+
+template <class ImplType, class StatType>
+void AllocatorImpl::forEachChangedSinked(StatPointerSet<ImplType>& changed_stats,
+                                         const StatPointerSet<StatType>& sinked_stats,
+                                         SizeFn f_size, StatFn<StatType> f_stat) {
+  StatPointerSet<ImplType> stats;
+  {
+    Thread::LockGuard lock(changed_mutex_);
+    stats.swap(changed_stats);
+  }
+  std::vector<ImplType*> stats_to_visit;
+  stats_to_visit.reserve(stats.size());
+  for (ImplType* stat : stats) {
+    // Stats which are not flushed to sinks keep their changed flag, so that their changes do not
+    // add them to the changed stats again.
+    if (sink_predicates_ != nullptr ? sinked_stats.contains(stat) : !stat->hidden()) {
+      stats_to_visit.push_back(stat);
+    }
+  }
+  if (f_size != nullptr) {
+    f_size(stats_to_visit.size());
+  }
+  for (ImplType* stat : stats_to_visit) {
+    // The flag is cleared before the stat is read, so that any change which is not seen by f_stat
+    // adds the stat to the changed stats again.
+    stat->clearChanged();
+    f_stat(*stat);
+  }
+}
+
+void AllocatorImpl::forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) {
+  if (!track_changed_stats_) {
+    forEachSinkedCounter(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  forEachChangedSinked(changed_counters_, sinked_counters_, f_size, f_stat);
+}
+
+void AllocatorImpl::forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) {
+  if (!track_changed_stats_) {
+    forEachSinkedGauge(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  forEachChangedSinked(changed_gauges_, sinked_gauges_, f_size, f_stat);
+}
+
+void AllocatorImpl::forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) {
+  if (!track_changed_stats_) {
+    forEachSinkedTextReadout(f_size, f_stat);
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  forEachChangedSinked(changed_text_readouts_, sinked_text_readouts_, f_size, f_stat);
+}
+
 void AllocatorImpl::setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) {
   Thread::LockGuard lock(mutex_);
   ASSERT(sink_predicates_ == nullptr);
@@ -478,6 +622,10 @@ void AllocatorImpl::markCounterForDeletion(const CounterSharedPtr& counter) {
   deleted_counters_.emplace_back(*iter);
   counters_.erase(iter);
   sinked_counters_.erase(counter.get());
+  if (track_changed_stats_) {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed_counters_.erase(dynamic_cast<CounterImpl*>(counter.get()));
+  }
 }
 
 void AllocatorImpl::markGaugeForDeletion(const GaugeSharedPtr& gauge) {
@@ -492,6 +640,10 @@ void AllocatorImpl::markGaugeForDeletion(const GaugeSharedPtr& gauge) {
   deleted_gauges_.emplace_back(*iter);
   gauges_.erase(iter);
   sinked_gauges_.erase(gauge.get());
+  if (track_changed_stats_) {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed_gauges_.erase(static_cast<GaugeImpl*>(gauge.get()));
+  }
 }
 
 void AllocatorImpl::markTextReadoutForDeletion(const TextReadoutSharedPtr& text_readout) {
@@ -506,6 +658,10 @@ void AllocatorImpl::markTextReadoutForDeletion(const TextReadoutSharedPtr& text_
   deleted_text_readouts_.emplace_back(*iter);
   text_readouts_.erase(iter);
   sinked_text_readouts_.erase(text_readout.get());
+  if (track_changed_stats_) {
+    Thread::LockGuard changed_lock(changed_mutex_);
+    changed_text_readouts_.erase(static_cast<TextReadoutImpl*>(text_readout.get()));
+  }
 }
 
 } // namespace Stats
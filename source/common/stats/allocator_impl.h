@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "envoy/common/optref.h"
@@ -16,6 +17,10 @@
 namespace Envoy {
 namespace Stats {
 
+class CounterImpl;
+class GaugeImpl;
+class TextReadoutImpl;
+
 class AllocatorImpl : public Allocator {
 public:
   static const char DecrementToZeroSyncPoint[];
@@ -44,6 +49,11 @@ public:
   void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const override;
   void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const override;
 
+  void trackChangedStats() override;
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override;
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override;
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override;
+
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
@@ -74,6 +84,13 @@ private:
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
 
+  template <typename StatType> using StatPointerSet = absl::flat_hash_set<StatType*>;
+
+  template <class ImplType, class StatType>
+  void forEachChangedSinked(StatPointerSet<ImplType>& changed_stats,
+                            const StatPointerSet<StatType>& sinked_stats, SizeFn f_size,
+                            StatFn<StatType> f_stat) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // A mutex is needed here to protect both the stats_ object from both
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
   // free() operations are made from the destructors of the individual stat objects, which are not
@@ -84,12 +101,22 @@ private:
   StatSet<Gauge> gauges_ ABSL_GUARDED_BY(mutex_);
   StatSet<TextReadout> text_readouts_ ABSL_GUARDED_BY(mutex_);
 
-  template <typename StatType> using StatPointerSet = absl::flat_hash_set<StatType*>;
   // Stat pointers that participate in the flush to sink process.
   StatPointerSet<Counter> sinked_counters_ ABSL_GUARDED_BY(mutex_);
   StatPointerSet<Gauge> sinked_gauges_ ABSL_GUARDED_BY(mutex_);
   StatPointerSet<TextReadout> sinked_text_readouts_ ABSL_GUARDED_BY(mutex_);
 
+  // Whether changed stats are tracked. This is only ever set, usually before the workers start.
+  std::atomic<bool> track_changed_stats_{false};
+  // Stats which changed since they were last visited by forEachChangedSinked*(), if changed stats
+  // are tracked. Workers add stats on their first change after they were visited, so these have
+  // their own mutex to keep them from contending with the allocation of stats. When both mutexes
+  // are held, mutex_ is acquired first.
+  mutable Thread::MutexBasicLockable changed_mutex_;
+  StatPointerSet<CounterImpl> changed_counters_ ABSL_GUARDED_BY(changed_mutex_);
+  StatPointerSet<GaugeImpl> changed_gauges_ ABSL_GUARDED_BY(changed_mutex_);
+  StatPointerSet<TextReadoutImpl> changed_text_readouts_ ABSL_GUARDED_BY(changed_mutex_);
+
   // Predicates used to filter stats to be flushed.
   std::unique_ptr<SinkPredicates> sink_predicates_;
   SymbolTable& symbol_table_;
@@ -0,0 +1,188 @@
+#include "source/common/stats/fixed_bucket_histogram.h"
+
+namespace Envoy {
+namespace Stats {
+
+// The loops adding up the counts of a group below have a fixed trip count and no dependencies
+// between iterations, so that the compiler turns them into vector operations.
+
+void FixedBucketHistogram::add(const FixedBucketHistogram& other) {
+  for (uint32_t group = 0; group < FixedBuckets::NumGroups; ++group) {
+    const Group* other_group = other.groups_[group].get();
+    if (other_group == nullptr) {
+      continue;
+    }
+    uint64_t* counts = groupCounts(group);
+    for (uint32_t i = 0; i < FixedBuckets::BucketsPerGroup; ++i) {
+      counts[i] += other_group->counts_[i];
+    }
+  }
+  sample_count_ += other.sample_count_;
+}
+
+void FixedBucketHistogram::clear() {
+  for (const std::unique_ptr<Group>& group : groups_) {
+    if (group != nullptr) {
+      group->counts_.fill(0);
+    }
+  }
+  sample_count_ = 0;
+}
+
+uint64_t* FixedBucketHistogram::groupCounts(uint32_t group) {
+  std::unique_ptr<Group>& group_ptr = groups_[group];
+  if (group_ptr == nullptr) {
+    group_ptr = std::make_unique<Group>();
+  }
+  return group_ptr->counts_.data();
+}
+
+template <class Fn> void FixedBucketHistogram::forEachBucket(Fn fn) const {
+  for (uint32_t group = 0; group < FixedBuckets::NumGroups; ++group) {
+    if (groups_[group] == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < FixedBuckets::BucketsPerGroup; ++i) {
+      const uint64_t count = groups_[group]->counts_[i];
+      if (count != 0) {
+        fn((group << FixedBuckets::SubBucketBits) | i, count);
+      }
+    }
+  }
+}
+
+double FixedBucketHistogram::approxSum() const {
+  double sum = 0;
+  forEachBucket([&sum](uint32_t index, uint64_t count) {
+    sum += (FixedBuckets::lowerBound(index) + FixedBuckets::width(index) / 2) * count;
+  });
+  return sum;
+}
+
+void FixedBucketHistogram::approxQuantiles(const std::vector<double>& quantiles,
+                                           std::vector<double>& values) const {
+  values.assign(quantiles.size(), 0.0);
+  if (sample_count_ == 0) {
+    return;
+  }
+  uint64_t count_below = 0;
+  size_t next = 0;
+  double upper_bound = 0;
+  forEachBucket([&](uint32_t index, uint64_t count) {
+    const double lower_bound = FixedBuckets::lowerBound(index);
+    const double width = FixedBuckets::width(index);
+    for (; next < quantiles.size() && quantiles[next] * sample_count_ <= count_below + count;
+         ++next) {
+      values[next] = lower_bound + width * (quantiles[next] * sample_count_ - count_below) / count;
+    }
+    count_below += count;
+    upper_bound = lower_bound + width;
+  });
+  // Rounding may leave the highest quantiles beyond the last bucket.
+  for (; next < quantiles.size(); ++next) {
+    values[next] = upper_bound;
+  }
+}
+
+uint64_t FixedBucketHistogram::approxCountBelow(double threshold) const {
+  uint64_t count_below = 0;
+  forEachBucket([&](uint32_t index, uint64_t count) {
+    if (FixedBuckets::lowerBound(index) + FixedBuckets::width(index) <= threshold) {
+      count_below += count;
+    }
+  });
+  return count_below;
+}
+
+std::vector<ParentHistogram::Bucket> FixedBucketHistogram::detailedBuckets() const {
+  std::vector<ParentHistogram::Bucket> buckets;
+  forEachBucket([&buckets](uint32_t index, uint64_t count) {
+    ParentHistogram::Bucket& bucket = buckets.emplace_back();
+    bucket.lower_bound_ = FixedBuckets::lowerBound(index);
+    bucket.width_ = FixedBuckets::width(index);
+    bucket.count_ = count;
+  });
+  return buckets;
+}
+
+ThreadLocalFixedBucketCounts::~ThreadLocalFixedBucketCounts() {
+  for (std::atomic<Group*>& group : groups_) {
+    delete group.load();
+  }
+}
+
+void ThreadLocalFixedBucketCounts::addNewValuesTo(FixedBucketHistogram& histogram) {
+  // The sample count is written after the counts, so that the counts of all the values it counts
+  // are seen. Counts of values recorded concurrently are added by the next call.
+  const uint64_t sample_count = sample_count_.load(std::memory_order_acquire);
+  if (sample_count == read_sample_count_) {
+    return;
+  }
+  read_sample_count_ = sample_count;
+
+  for (uint32_t group_index = 0; group_index < FixedBuckets::NumGroups; ++group_index) {
+    Group* group = groups_[group_index].load(std::memory_order_acquire);
+    if (group == nullptr) {
+      continue;
+    }
+    std::array<uint64_t, FixedBuckets::BucketsPerGroup> counts;
+    for (uint32_t i = 0; i < FixedBuckets::BucketsPerGroup; ++i) {
+      counts[i] = group->counts_[i].load(std::memory_order_relaxed);
+    }
+    uint64_t* histogram_counts = histogram.groupCounts(group_index);
+    uint64_t new_values = 0;
+    for (uint32_t i = 0; i < FixedBuckets::BucketsPerGroup; ++i) {
+      const uint64_t new_count = counts[i] - group->read_counts_[i];
+      histogram_counts[i] += new_count;
+      new_values += new_count;
+    }
+    group->read_counts_ = counts;
+    histogram.sample_count_ += new_values;
+  }
+}
+
+const std::vector<double>& FixedBucketHistogramStatistics::computedQuantiles() const {
+  compute();
+  return computed_quantiles_;
+}
+
+const std::vector<uint64_t>& FixedBucketHistogramStatistics::computedBuckets() const {
+  compute();
+  return computed_buckets_;
+}
+
+double FixedBucketHistogramStatistics::sampleSum() const {
+  compute();
+  return sample_sum_;
+}
+
+void FixedBucketHistogramStatistics::compute() const {
+  if (computed_) {
+    return;
+  }
+  computed_ = true;
+
+  // Convert to double once to avoid needing to cast it on every use.
+  constexpr double percent_scale = Histogram::PercentScale;
+
+  histogram_.approxQuantiles(supportedQuantiles(), computed_quantiles_);
+  sample_sum_ = histogram_.approxSum();
+  if (unit_ == Histogram::Unit::Percent) {
+    for (double& val : computed_quantiles_) {
+      val /= percent_scale;
+    }
+    sample_sum_ /= percent_scale;
+  }
+
+  computed_buckets_.clear();
+  computed_buckets_.reserve(supported_buckets_.size());
+  for (double bucket : supported_buckets_) {
+    if (unit_ == Histogram::Unit::Percent) {
+      bucket *= percent_scale;
+    }
+    computed_buckets_.push_back(histogram_.approxCountBelow(bucket));
+  }
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/histogram.h"
+
+#include "source/common/common/non_copyable.h"
+#include "source/common/stats/histogram_impl.h"
+
+#include "absl/base/optimization.h"
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Fixed log-linear buckets for uint64_t values. Each value below 16 has a bucket of its own, and
+ * each power of two above is split into 16 buckets of equal width, so a bucket is at most 1/16th as
+ * wide as its lower bound. The buckets of a power of two form a group, whose 16 counts fill two
+ * cache lines; groups are only allocated once they have values.
+ */
+class FixedBuckets {
+public:
+  static constexpr uint32_t SubBucketBits = 4;
+  static constexpr uint32_t BucketsPerGroup = 1 << SubBucketBits;
+  static constexpr uint32_t NumGroups = 64 - SubBucketBits + 1;
+  static constexpr uint32_t NumBuckets = NumGroups * BucketsPerGroup;
+
+  /**
+   * @return the index of the bucket of a value.
+   */
+  static uint32_t index(uint64_t value) {
+    if (value < BucketsPerGroup) {
+      return value;
+    }
+    const uint32_t shift = absl::bit_width(value) - 1 - SubBucketBits;
+    return ((shift + 1) << SubBucketBits) | ((value >> shift) & (BucketsPerGroup - 1));
+  }
+
+  /**
+   * @return the smallest value of a bucket.
+   */
+  static double lowerBound(uint32_t index) {
+    const uint32_t group = index >> SubBucketBits;
+    if (group == 0) {
+      return index;
+    }
+    return std::ldexp(BucketsPerGroup + (index & (BucketsPerGroup - 1)), group - 1);
+  }
+
+  /**
+   * @return the width of a bucket.
+   */
+  static double width(uint32_t index) {
+    const uint32_t group = index >> SubBucketBits;
+    return group == 0 ? 1 : std::ldexp(1, group - 1);
+  }
+};
+
+/**
+ * Counts of values in the fixed buckets, which are only accessed by one thread at a time.
+ */
+class FixedBucketHistogram : NonCopyable {
+public:
+  /**
+   * Adds the counts of another histogram to this one.
+   */
+  void add(const FixedBucketHistogram& other);
+
+  /**
+   * Zeroes the counts, keeping the groups which have been allocated.
+   */
+  void clear();
+
+  uint64_t sampleCount() const { return sample_count_; }
+
+  /**
+   * @return an approximation of the sum of the values, taking the midpoint of the bucket of each.
+   */
+  double approxSum() const;
+
+  /**
+   * Approximates quantiles of the values by linear interpolation within their buckets.
+   * @param quantiles the quantiles to compute, in increasing order.
+   * @param values receives the computed quantiles, or zeros if there are no values.
+   */
+  void approxQuantiles(const std::vector<double>& quantiles, std::vector<double>& values) const;
+
+  /**
+   * @return the number of values in the buckets whose upper bound is at most threshold.
+   */
+  uint64_t approxCountBelow(double threshold) const;
+
+  /**
+   * @return the buckets which have values, in increasing order.
+   */
+  std::vector<ParentHistogram::Bucket> detailedBuckets() const;
+
+private:
+  friend class ThreadLocalFixedBucketCounts;
+
+  struct alignas(ABSL_CACHELINE_SIZE) Group {
+    std::array<uint64_t, FixedBuckets::BucketsPerGroup> counts_{};
+  };
+
+  template <class Fn> void forEachBucket(Fn fn) const;
+  uint64_t* groupCounts(uint32_t group);
+
+  std::array<std::unique_ptr<Group>, FixedBuckets::NumGroups> groups_;
+  uint64_t sample_count_{};
+};
+
+/**
+ * Counts of values in the fixed buckets, which are recorded by one thread and read by another.
+ * The recording thread does not need atomic read-modify-write operations, nor does it ever wait
+ * for the reading thread, which tracks the counts it has read to only add the new values to a
+ * histogram.
+ */
+class ThreadLocalFixedBucketCounts : NonCopyable {
+public:
+  ~ThreadLocalFixedBucketCounts();
+
+  /**
+   * Records a value. Must only be called by one thread.
+   */
+  void record(uint64_t value) {
+    const uint32_t index = FixedBuckets::index(value);
+    std::atomic<Group*>& group_ref = groups_[index >> FixedBuckets::SubBucketBits];
+    Group* group = group_ref.load(std::memory_order_relaxed);
+    if (ABSL_PREDICT_FALSE(group == nullptr)) {
+      group = new Group();
+      group_ref.store(group, std::memory_order_release);
+    }
+    std::atomic<uint64_t>& count = group->counts_[index & (FixedBuckets::BucketsPerGroup - 1)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sample_count_.store(sample_count_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+  }
+
+  /**
+   * Adds the values recorded since the previous call to a histogram. Must only be called by one
+   * thread, which may differ from the recording thread.
+   */
+  void addNewValuesTo(FixedBucketHistogram& histogram);
+
+  bool used() const { return sample_count_.load(std::memory_order_relaxed) > 0; }
+
+private:
+  struct alignas(ABSL_CACHELINE_SIZE) Group {
+    std::array<std::atomic<uint64_t>, FixedBuckets::BucketsPerGroup> counts_{};
+    // The counts as of the previous call to addNewValuesTo(), which are only accessed by the
+    // reading thread, in separate cache lines.
+    alignas(ABSL_CACHELINE_SIZE) std::array<uint64_t, FixedBuckets::BucketsPerGroup> read_counts_{};
+  };
+
+  std::array<std::atomic<Group*>, FixedBuckets::NumGroups> groups_{};
+  std::atomic<uint64_t> sample_count_{0};
+  uint64_t read_sample_count_{0};
+};
+
+/**
+ * Implementation of HistogramStatistics for FixedBucketHistogram. The quantiles and buckets are
+ * only computed when they are first read after a refresh, so that they are not computed for
+ * histograms which are not read by any stats sink. Like the histogram, the statistics must only be
+ * accessed by one thread at a time.
+ */
+class FixedBucketHistogramStatistics final : public HistogramStatisticsHelper, NonCopyable {
+public:
+  /**
+   * @param histogram the histogram of which statistics are computed, which is retained.
+   */
+  FixedBucketHistogramStatistics(const FixedBucketHistogram& histogram, Histogram::Unit unit,
+                                 ConstSupportedBuckets& supported_buckets)
+      : histogram_(histogram), supported_buckets_(supported_buckets), unit_(unit) {}
+
+  /**
+   * Discards the statistics computed from the previous values of the histogram.
+   */
+  void refresh() { computed_ = false; }
+
+  // HistogramStatistics
+  const std::vector<double>& computedQuantiles() const override;
+  ConstSupportedBuckets& supportedBuckets() const override { return supported_buckets_; }
+  const std::vector<uint64_t>& computedBuckets() const override;
+  uint64_t sampleCount() const override { return histogram_.sampleCount(); }
+  double sampleSum() const override;
+
+private:
+  void compute() const;
+
+  const FixedBucketHistogram& histogram_;
+  ConstSupportedBuckets& supported_buckets_;
+  const Histogram::Unit unit_;
+  mutable bool computed_{false};
+  mutable std::vector<double> computed_quantiles_;
+  mutable std::vector<uint64_t> computed_buckets_;
+  mutable double sample_sum_{0};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -25,39 +25,42 @@ HistogramStatisticsImpl::HistogramStatisticsImpl(const histogram_t* histogram_pt
   refresh(histogram_ptr);
 }
 
-const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
+const std::vector<double>& HistogramStatisticsHelper::supportedQuantiles() const {
   CONSTRUCT_ON_FIRST_USE(std::vector<double>,
                          {0, 0.25, 0.5, 0.75, 0.90, 0.95, 0.99, 0.995, 0.999, 1});
 }
 
-std::vector<uint64_t> HistogramStatisticsImpl::computeDisjointBuckets() const {
+std::vector<uint64_t> HistogramStatisticsHelper::computeDisjointBuckets() const {
+  const std::vector<uint64_t>& computed_buckets = computedBuckets();
   std::vector<uint64_t> buckets;
-  buckets.reserve(computed_buckets_.size());
+  buckets.reserve(computed_buckets.size());
   uint64_t previous_computed_bucket = 0;
-  for (uint64_t computed_bucket : computed_buckets_) {
+  for (uint64_t computed_bucket : computed_buckets) {
     buckets.push_back(computed_bucket - previous_computed_bucket);
     previous_computed_bucket = computed_bucket;
   }
   return buckets;
 }
 
-std::string HistogramStatisticsImpl::quantileSummary() const {
+std::string HistogramStatisticsHelper::quantileSummary() const {
   std::vector<std::string> summary;
   const std::vector<double>& supported_quantiles = supportedQuantiles();
+  const std::vector<double>& computed_quantiles = computedQuantiles();
   summary.reserve(supported_quantiles.size());
   for (size_t i = 0; i < supported_quantiles.size(); ++i) {
     summary.push_back(
-        fmt::format("P{:g}: {:g}", 100 * supported_quantiles[i], computed_quantiles_[i]));
+        fmt::format("P{:g}: {:g}", 100 * supported_quantiles[i], computed_quantiles[i]));
   }
   return absl::StrJoin(summary, ", ");
 }
 
-std::string HistogramStatisticsImpl::bucketSummary() const {
+std::string HistogramStatisticsHelper::bucketSummary() const {
   std::vector<std::string> bucket_summary;
   ConstSupportedBuckets& supported_buckets = supportedBuckets();
+  const std::vector<uint64_t>& computed_buckets = computedBuckets();
   bucket_summary.reserve(supported_buckets.size());
   for (size_t i = 0; i < supported_buckets.size(); ++i) {
-    bucket_summary.push_back(fmt::format("B{:g}: {}", supported_buckets[i], computed_buckets_[i]));
+    bucket_summary.push_back(fmt::format("B{:g}: {}", supported_buckets[i], computed_buckets[i]));
   }
   return absl::StrJoin(bucket_summary, ", ");
 }
@@ -107,7 +110,8 @@ HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::S
         }
 
         return configs;
-      }()) {}
+      }()),
+      fixed_bucket_histograms_(config.use_fixed_bucket_histograms()) {}
 
 const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view stat_name) const {
   for (const auto& config : configs_) {
@@ -24,6 +24,7 @@ public:
 
   // HistogramSettings
   const ConstSupportedBuckets& buckets(absl::string_view stat_name) const override;
+  bool fixedBucketHistograms() const override { return fixed_bucket_histograms_; }
 
   static ConstSupportedBuckets& defaultBuckets();
 
@@ -31,12 +32,25 @@ private:
   using Config = std::pair<Matchers::StringMatcherImpl<envoy::type::matcher::v3::StringMatcher>,
                            ConstSupportedBuckets>;
   const std::vector<Config> configs_{};
+  const bool fixed_bucket_histograms_{};
+};
+
+/**
+ * Implements the summaries of HistogramStatistics on top of the computed values.
+ */
+class HistogramStatisticsHelper : public HistogramStatistics {
+public:
+  // HistogramStatistics
+  std::string quantileSummary() const override;
+  std::string bucketSummary() const override;
+  const std::vector<double>& supportedQuantiles() const final;
+  std::vector<uint64_t> computeDisjointBuckets() const override;
 };
 
 /**
  * Implementation of HistogramStatistics for circllhist.
  */
-class HistogramStatisticsImpl final : public HistogramStatistics, NonCopyable {
+class HistogramStatisticsImpl final : public HistogramStatisticsHelper, NonCopyable {
 public:
   HistogramStatisticsImpl();
 
@@ -52,13 +66,9 @@ public:
   void refresh(const histogram_t* new_histogram_ptr);
 
   // HistogramStatistics
-  std::string quantileSummary() const override;
-  std::string bucketSummary() const override;
-  const std::vector<double>& supportedQuantiles() const final;
   const std::vector<double>& computedQuantiles() const override { return computed_quantiles_; }
   ConstSupportedBuckets& supportedBuckets() const override { return supported_buckets_; }
   const std::vector<uint64_t>& computedBuckets() const override { return computed_buckets_; }
-  std::vector<uint64_t> computeDisjointBuckets() const override;
   uint64_t sampleCount() const override { return sample_count_; }
   double sampleSum() const override { return sample_sum_; }
 
@@ -220,6 +220,23 @@ public:
     UNREFERENCED_PARAMETER(f_stat);
   }
 
+  // The isolated store does not track changed stats.
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override {
+    forEachSinkedCounter(f_size, f_stat);
+  }
+
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override {
+    forEachSinkedGauge(f_size, f_stat);
+  }
+
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override {
+    forEachSinkedTextReadout(f_size, f_stat);
+  }
+
+  void forEachChangedSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) override {
+    forEachSinkedHistogram(f_size, f_stat);
+  }
+
   NullCounterImpl& nullCounter() override { return *null_counter_; }
   NullGaugeImpl& nullGauge() override { return *null_gauge_; }
 
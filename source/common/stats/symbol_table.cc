@@ -261,7 +261,7 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   Encoding::decodeTokens(
       stat_name,
       [this, &strings](Symbol symbol)
@@ -312,17 +312,33 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
+  num_lookups_.fetch_add(1, std::memory_order_relaxed);
+  if (recent_lookups_enabled_.load(std::memory_order_relaxed)) {
+    Thread::LockGuard lock(recent_lookups_lock_);
+    recent_lookups_.lookup(name);
+  }
+
   // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // ref-counts in this. Most names are made of tokens which already have
+  // symbols, which only needs the lock held shared, so first try that.
   {
-    Thread::LockGuard lock(lock_);
-    recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+    absl::ReaderMutexLock lock(&lock_);
+    Symbol symbol;
+    while (symbols.size() < tokens.size() && toExistingSymbol(tokens[symbols.size()], symbol)) {
+      symbols.push_back(symbol);
+    }
+  }
+
+  // The symbols found above hold their references, so only the remaining
+  // tokens need the lock held exclusively.
+  if (symbols.size() < tokens.size()) {
+    absl::MutexLock lock(&lock_);
+    for (size_t i = symbols.size(); i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      symbols.push_back(toSymbol(tokens[i]));
     }
   }
 
@@ -331,7 +347,7 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
 }
 
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -344,7 +360,9 @@ void SymbolTable::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
+  // The caller holds a reference to each symbol, so none can be removed
+  // concurrently, and their counts can be bumped with the lock held shared.
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
 
@@ -358,7 +376,7 @@ void SymbolTable::incRefCount(const StatName& stat_name) {
            "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
            "debugging-symbol-table-assertions");
 
-    ++encode_search->second.ref_count_;
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -366,8 +384,36 @@ void SymbolTable::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
+  // Drop the references which are not the last ones to their symbols with the
+  // lock held shared, collecting the others to be dropped with the lock held
+  // exclusively, as their symbols may need to be removed.
+  SymbolVec last_references;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      auto decode_search = decode_map_.find(symbol);
+      ASSERT(decode_search != decode_map_.end());
+
+      auto encode_search = encode_map_.find(decode_search->second->toStringView());
+      ASSERT(encode_search != encode_map_.end());
+
+      std::atomic<uint32_t>& ref_count = encode_search->second.ref_count_;
+      uint32_t count = ref_count.load(std::memory_order_relaxed);
+      while (count > 1 &&
+             !ref_count.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+        // A failed exchange reloads count, which another thread has changed.
+      }
+      if (count <= 1) {
+        last_references.push_back(symbol);
+      }
+    }
+  }
+  if (last_references.empty()) {
+    return;
+  }
+
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : last_references) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
 
@@ -375,12 +421,9 @@ void SymbolTable::free(const StatName& stat_name) {
     ASSERT(encode_search != encode_map_.end());
 
     // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
+    // current mappings and add the now-unused symbol to the reuse pool. Other
+    // references may have been taken since the lock was held shared above.
+    if (encode_search->second.ref_count_.fetch_sub(1, std::memory_order_relaxed) == 1) {
       decode_map_.erase(decode_search);
       encode_map_.erase(encode_search);
       pool_.push(symbol);
@@ -392,14 +435,14 @@ uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   uint64_t total = 0;
   absl::flat_hash_map<std::string, uint64_t> name_count_map;
 
-  // We don't want to hold lock_ while calling the iterator, but we need it to
-  // access recent_lookups_, so we buffer in name_count_map.
+  // We don't want to hold recent_lookups_lock_ while calling the iterator, but
+  // we need it to access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
-    total += recent_lookups_.total();
+    total += num_lookups_.load(std::memory_order_relaxed);
   }
 
   // Now we have the collated name-count map data: we need to vectorize and
@@ -445,17 +488,19 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  recent_lookups_enabled_.store(capacity > 0, std::memory_order_relaxed);
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.clear();
+  num_lookups_.store(0, std::memory_order_relaxed);
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -486,13 +531,24 @@ Symbol SymbolTable::toSymbol(absl::string_view sv) {
     // If the insertion didn't take place, return the actual value at that location and up the
     // refcount at that location
     result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
   return result;
 }
 
+bool SymbolTable::toExistingSymbol(absl::string_view sv, Symbol& symbol)
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
+  auto encode_find = encode_map_.find(sv);
+  if (encode_find == encode_map_.end()) {
+    return false;
+  }
+  symbol = encode_find->second.symbol_;
+  encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
 absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
@@ -513,12 +569,12 @@ bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
   // Proactively take the table lock in anticipation that we'll need to
   // convert at least one symbol to a string_view, and it's easier not to
   // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   return lessThanLockHeld(a, b);
 }
 
 bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -548,7 +604,7 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -557,7 +613,8 @@ void SymbolTable::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
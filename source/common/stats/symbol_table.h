@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -349,7 +350,7 @@ public:
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
     // Grab the lock once before sorting begins, so we don't have to re-take
     // it on every comparison.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -397,13 +398,25 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+    // The encode map only moves its values when rehashing, which happens with
+    // lock_ held exclusively, so no reference count can change concurrently.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
 
     Symbol symbol_;
-    uint32_t ref_count_{1};
+    // Reference counts of existing symbols are changed with lock_ held shared,
+    // so that encoding names made of existing tokens, and copying or freeing
+    // StatNames which do not hold the last reference to a symbol, do not
+    // serialize the threads doing so. A count only drops to zero, removing the
+    // symbol, with lock_ held exclusively, so a symbol found with lock_ held
+    // shared always has a count of at least one. The ordering of the count
+    // updates relative to the maps is provided by lock_.
+    std::atomic<uint32_t> ref_count_{1};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This is held shared to look up existing symbols and change their reference
+  // counts, and exclusively to add and remove symbols.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -428,13 +441,22 @@ private:
    */
   Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  /**
+   * Bumps the reference count of an existing symbol, without adding it.
+   *
+   * @param sv the individual string to be encoded as a symbol.
+   * @param symbol receives the symbol of the string, if it exists.
+   * @return whether the string already had a symbol.
+   */
+  bool toExistingSymbol(absl::string_view sv, Symbol& symbol) ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
   /**
    * Convenience function for decode(), decoding one symbol at a time.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const ABSL_SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -451,7 +473,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -474,7 +496,14 @@ private:
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // Recent lookups have their own lock, which is only taken while tracking is
+  // enabled, so that encoding does not need lock_ held exclusively. The total
+  // number of lookups is counted whether or not tracking is enabled.
+  mutable Thread::MutexBasicLockable recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
+  std::atomic<bool> recent_lookups_enabled_{false};
+  std::atomic<uint64_t> num_lookups_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
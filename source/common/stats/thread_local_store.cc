@@ -678,9 +678,10 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
       if (iter != parent_.histogram_set_.end()) {
         stat = RefcountPtr<ParentHistogramImpl>(*iter);
       } else {
-        stat = new ParentHistogramImpl(final_stat_name, unit, parent_,
-                                       tag_helper.tagExtractedName(), tag_helper.statNameTags(),
-                                       *buckets, parent_.next_histogram_id_++);
+        stat = new ParentHistogramImpl(
+            final_stat_name, unit, parent_, tag_helper.tagExtractedName(),
+            tag_helper.statNameTags(), *buckets,
+            parent_.histogram_settings_->fixedBucketHistograms(), parent_.next_histogram_id_++);
         if (!parent_.shutting_down_) {
           parent_.histogram_set_.insert(stat.get());
           if (parent_.sink_predicates_.has_value() &&
@@ -785,11 +786,8 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   StatNameTagHelper tag_helper(*this, parent.statName(), absl::nullopt);
 
-  TlsHistogramSharedPtr hist_tls_ptr(
-      new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable()));
-
-  parent.addTlsHistogram(hist_tls_ptr);
+  TlsHistogramSharedPtr hist_tls_ptr =
+      parent.createTlsHistogram(tag_helper.tagExtractedName(), tag_helper.statNameTags());
 
   if (tls_histogram != nullptr) {
     *tls_histogram = hist_tls_ptr;
@@ -802,47 +800,168 @@ ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Uni
                                                    StatName tag_extracted_name,
                                                    const StatNameTagVector& stat_name_tags,
                                                    SymbolTable& symbol_table)
-    : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
+    : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table),
+      created_thread_id_(std::this_thread::get_id()), unit_(unit), symbol_table_(symbol_table) {}
+
+ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() { MetricImpl::clear(symbol_table_); }
+
+CircllhistThreadLocalHistogramImpl::CircllhistThreadLocalHistogramImpl(
+    StatName name, Histogram::Unit unit, StatName tag_extracted_name,
+    const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table)
+    : ThreadLocalHistogramImpl(name, unit, tag_extracted_name, stat_name_tags, symbol_table),
+      used_(false) {
   histograms_[0] = hist_alloc();
   histograms_[1] = hist_alloc();
 }
 
-ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
-  MetricImpl::clear(symbol_table_);
+CircllhistThreadLocalHistogramImpl::~CircllhistThreadLocalHistogramImpl() {
   hist_free(histograms_[0]);
   hist_free(histograms_[1]);
 }
 
-void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
+void CircllhistThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
   hist_insert_intscale(histograms_[current_active_], value, 0, 1);
   used_ = true;
 }
 
-void ThreadLocalHistogramImpl::merge(histogram_t* target) {
+void CircllhistThreadLocalHistogramImpl::merge(histogram_t* target) {
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
 }
 
+namespace {
+
+// Merges the thread local histograms into circllhist histograms.
+class CircllhistBackend : public ParentHistogramBackend {
+public:
+  CircllhistBackend(Histogram::Unit unit, ConstSupportedBuckets& supported_buckets)
+      : interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
+        interval_statistics_(interval_histogram_, unit, supported_buckets),
+        cumulative_statistics_(cumulative_histogram_, unit, supported_buckets) {}
+
+  ~CircllhistBackend() override {
+    hist_free(interval_histogram_);
+    hist_free(cumulative_histogram_);
+  }
+
+  // ParentHistogramBackend
+  ThreadLocalHistogramImpl* createTlsHistogram(StatName name, Histogram::Unit unit,
+                                               StatName tag_extracted_name,
+                                               const StatNameTagVector& stat_name_tags,
+                                               SymbolTable& symbol_table) override {
+    return new CircllhistThreadLocalHistogramImpl(name, unit, tag_extracted_name, stat_name_tags,
+                                                  symbol_table);
+  }
+  void mergeInterval(const std::list<TlsHistogramSharedPtr>& tls_histograms) override {
+    hist_clear(interval_histogram_);
+    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms) {
+      static_cast<CircllhistThreadLocalHistogramImpl&>(*tls_histogram).merge(interval_histogram_);
+    }
+  }
+  void completeMerge() override {
+    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+    cumulative_statistics_.refresh(cumulative_histogram_);
+    interval_statistics_.refresh(interval_histogram_);
+  }
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+  std::vector<ParentHistogram::Bucket> detailedIntervalBuckets() const override {
+    return detailedBuckets(*interval_histogram_);
+  }
+  std::vector<ParentHistogram::Bucket> detailedTotalBuckets() const override {
+    return detailedBuckets(*cumulative_histogram_);
+  }
+
+private:
+  static std::vector<ParentHistogram::Bucket> detailedBuckets(const histogram_t& histogram) {
+    const uint32_t num_buckets = hist_num_buckets(&histogram);
+    std::vector<ParentHistogram::Bucket> buckets(num_buckets);
+    hist_bucket_t hist_bucket;
+    for (uint32_t i = 0; i < num_buckets; ++i) {
+      ParentHistogram::Bucket& bucket = buckets[i];
+      hist_bucket_idx_bucket(&histogram, i, &hist_bucket, &bucket.count_);
+      bucket.lower_bound_ = hist_bucket_to_double(hist_bucket);
+      bucket.width_ = hist_bucket_to_double_bin_width(hist_bucket);
+    }
+    return buckets;
+  }
+
+  histogram_t* interval_histogram_;
+  histogram_t* cumulative_histogram_;
+  HistogramStatisticsImpl interval_statistics_;
+  HistogramStatisticsImpl cumulative_statistics_;
+};
+
+// Adds up the fixed bucket counts of the thread local histograms. The statistics are only computed
+// when they are read.
+class FixedBucketBackend : public ParentHistogramBackend {
+public:
+  FixedBucketBackend(Histogram::Unit unit, ConstSupportedBuckets& supported_buckets)
+      : interval_statistics_(interval_histogram_, unit, supported_buckets),
+        cumulative_statistics_(cumulative_histogram_, unit, supported_buckets) {}
+
+  // ParentHistogramBackend
+  ThreadLocalHistogramImpl* createTlsHistogram(StatName name, Histogram::Unit unit,
+                                               StatName tag_extracted_name,
+                                               const StatNameTagVector& stat_name_tags,
+                                               SymbolTable& symbol_table) override {
+    return new FixedBucketThreadLocalHistogramImpl(name, unit, tag_extracted_name, stat_name_tags,
+                                                   symbol_table);
+  }
+  void mergeInterval(const std::list<TlsHistogramSharedPtr>& tls_histograms) override {
+    interval_histogram_.clear();
+    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms) {
+      static_cast<FixedBucketThreadLocalHistogramImpl&>(*tls_histogram)
+          .addNewValuesTo(interval_histogram_);
+    }
+  }
+  void completeMerge() override {
+    cumulative_histogram_.add(interval_histogram_);
+    interval_statistics_.refresh();
+    cumulative_statistics_.refresh();
+  }
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+  std::vector<ParentHistogram::Bucket> detailedIntervalBuckets() const override {
+    return interval_histogram_.detailedBuckets();
+  }
+  std::vector<ParentHistogram::Bucket> detailedTotalBuckets() const override {
+    return cumulative_histogram_.detailedBuckets();
+  }
+
+private:
+  FixedBucketHistogram interval_histogram_;
+  FixedBucketHistogram cumulative_histogram_;
+  FixedBucketHistogramStatistics interval_statistics_;
+  FixedBucketHistogramStatistics cumulative_statistics_;
+};
+
+} // namespace
+
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
                                          const StatNameTagVector& stat_name_tags,
-                                         ConstSupportedBuckets& supported_buckets, uint64_t id)
+                                         ConstSupportedBuckets& supported_buckets,
+                                         bool fixed_buckets, uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
-      unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
-      cumulative_histogram_(hist_alloc()),
-      interval_statistics_(interval_histogram_, unit, supported_buckets),
-      cumulative_statistics_(cumulative_histogram_, unit, supported_buckets), id_(id) {}
+      unit_(unit), thread_local_store_(thread_local_store),
+      backend_(fixed_buckets ? ParentHistogramBackendPtr{std::make_unique<FixedBucketBackend>(
+                                   unit, supported_buckets)}
+                             : ParentHistogramBackendPtr{std::make_unique<CircllhistBackend>(
+                                   unit, supported_buckets)}),
+      id_(id) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   thread_local_store_.releaseHistogramCrossThread(id_);
   ASSERT(ref_count_ == 0);
   MetricImpl::clear(thread_local_store_.symbolTable());
-  hist_free(interval_histogram_);
-  hist_free(cumulative_histogram_);
 }
 
 void ParentHistogramImpl::incRefCount() { ++ref_count_; }
@@ -911,19 +1030,14 @@ bool ParentHistogramImpl::hidden() const { return false; }
 void ParentHistogramImpl::merge() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
-    hist_clear(interval_histogram_);
     // Here we could copy all the pointers to TLS histograms in the tls_histogram_ list,
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
-    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
-    }
+    backend_->mergeInterval(tls_histograms_);
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
+    backend_->completeMerge();
     merged_ = true;
   }
 }
@@ -931,12 +1045,14 @@ void ParentHistogramImpl::merge() {
 std::string ParentHistogramImpl::quantileSummary() const {
   if (used()) {
     std::vector<std::string> summary;
-    const std::vector<double>& supported_quantiles_ref = interval_statistics_.supportedQuantiles();
+    const HistogramStatistics& interval_statistics = intervalStatistics();
+    const HistogramStatistics& cumulative_statistics = cumulativeStatistics();
+    const std::vector<double>& supported_quantiles_ref = interval_statistics.supportedQuantiles();
     summary.reserve(supported_quantiles_ref.size());
     for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
       summary.push_back(fmt::format("P{:g}({},{})", 100 * supported_quantiles_ref[i],
-                                    interval_statistics_.computedQuantiles()[i],
-                                    cumulative_statistics_.computedQuantiles()[i]));
+                                    interval_statistics.computedQuantiles()[i],
+                                    cumulative_statistics.computedQuantiles()[i]));
     }
     return absl::StrJoin(summary, " ");
   } else {
@@ -947,12 +1063,14 @@ std::string ParentHistogramImpl::quantileSummary() const {
 std::string ParentHistogramImpl::bucketSummary() const {
   if (used()) {
     std::vector<std::string> bucket_summary;
-    ConstSupportedBuckets& supported_buckets = interval_statistics_.supportedBuckets();
+    const HistogramStatistics& interval_statistics = intervalStatistics();
+    const HistogramStatistics& cumulative_statistics = cumulativeStatistics();
+    ConstSupportedBuckets& supported_buckets = interval_statistics.supportedBuckets();
     bucket_summary.reserve(supported_buckets.size());
     for (size_t i = 0; i < supported_buckets.size(); ++i) {
       bucket_summary.push_back(fmt::format("B{:g}({},{})", supported_buckets[i],
-                                           interval_statistics_.computedBuckets()[i],
-                                           cumulative_statistics_.computedBuckets()[i]));
+                                           interval_statistics.computedBuckets()[i],
+                                           cumulative_statistics.computedBuckets()[i]));
     }
     return absl::StrJoin(bucket_summary, " ");
   } else {
@@ -960,23 +1078,14 @@ std::string ParentHistogramImpl::bucketSummary() const {
   }
 }
 
-std::vector<Stats::ParentHistogram::Bucket>
-ParentHistogramImpl::detailedlBucketsHelper(const histogram_t& histogram) {
-  const uint32_t num_buckets = hist_num_buckets(&histogram);
-  std::vector<Stats::ParentHistogram::Bucket> buckets(num_buckets);
-  hist_bucket_t hist_bucket;
-  for (uint32_t i = 0; i < num_buckets; ++i) {
-    ParentHistogram::Bucket& bucket = buckets[i];
-    hist_bucket_idx_bucket(&histogram, i, &hist_bucket, &bucket.count_);
-    bucket.lower_bound_ = hist_bucket_to_double(hist_bucket);
-    bucket.width_ = hist_bucket_to_double_bin_width(hist_bucket);
-  }
-  return buckets;
-}
-
-void ParentHistogramImpl::addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr) {
+TlsHistogramSharedPtr
+ParentHistogramImpl::createTlsHistogram(StatName tag_extracted_name,
+                                        const StatNameTagVector& stat_name_tags) {
+  TlsHistogramSharedPtr hist_ptr(backend_->createTlsHistogram(
+      statName(), unit_, tag_extracted_name, stat_name_tags, thread_local_store_.symbolTable()));
   Thread::LockGuard lock(merge_lock_);
   tls_histograms_.emplace_back(hist_ptr);
+  return hist_ptr;
 }
 
 bool ParentHistogramImpl::usedLockHeld() const {
@@ -1075,6 +1184,42 @@ void ThreadLocalStoreImpl::forEachSinkedHistogram(SizeFn f_size,
   }
 }
 
+void ThreadLocalStoreImpl::forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) {
+  alloc_.forEachChangedSinkedCounter(f_size, f_stat);
+}
+
+void ThreadLocalStoreImpl::forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) {
+  alloc_.forEachChangedSinkedGauge(f_size, f_stat);
+}
+
+void ThreadLocalStoreImpl::forEachChangedSinkedTextReadout(SizeFn f_size,
+                                                           StatFn<TextReadout> f_stat) {
+  alloc_.forEachChangedSinkedTextReadout(f_size, f_stat);
+}
+
+void ThreadLocalStoreImpl::forEachChangedSinkedHistogram(SizeFn f_size,
+                                                         StatFn<ParentHistogram> f_stat) {
+  Thread::LockGuard lock(hist_mutex_);
+  const StatSet<ParentHistogramImpl>& histograms =
+      sink_predicates_.has_value() &&
+              Runtime::runtimeFeatureEnabled("envoy.reloadable_features.enable_include_histograms")
+          ? sinked_histograms_
+          : histogram_set_;
+  // The interval statistics hold the values recorded since the previous merge.
+  std::vector<ParentHistogramImpl*> changed_histograms;
+  for (ParentHistogramImpl* histogram : histograms) {
+    if (histogram->intervalStatistics().sampleCount() > 0) {
+      changed_histograms.push_back(histogram);
+    }
+  }
+  if (f_size != nullptr) {
+    f_size(changed_histograms.size());
+  }
+  for (ParentHistogramImpl* histogram : changed_histograms) {
+    f_stat(*histogram);
+  }
+}
+
 void ThreadLocalStoreImpl::setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) {
   ASSERT(sink_predicates != nullptr);
   if (sink_predicates != nullptr) {
@@ -13,6 +13,7 @@
 #include "source/common/common/hash.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/stats/allocator_impl.h"
+#include "source/common/stats/fixed_bucket_histogram.h"
 #include "source/common/stats/histogram_impl.h"
 #include "source/common/stats/null_counter.h"
 #include "source/common/stats/null_gauge.h"
@@ -27,9 +28,8 @@ namespace Envoy {
 namespace Stats {
 
 /**
- * A histogram that is stored in TLS and used to record values per thread. This holds two
- * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * A histogram that is stored in TLS and used to record values per thread. Its values are merged
+ * into its ParentHistogramImpl at every flush.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
@@ -37,17 +37,10 @@ public:
                            const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
   ~ThreadLocalHistogramImpl() override;
 
-  void merge(histogram_t* target);
-
   /**
-   * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
-   * not have to lock the histogram in high throughput TLS writes.
+   * Called in the beginning of merge process, on the thread of the histogram.
    */
-  void beginMerge() {
-    // This switches the current_active_ between 1 and 0.
-    ASSERT(std::this_thread::get_id() == created_thread_id_);
-    current_active_ = otherHistogramIndex();
-  }
+  virtual void beginMerge() PURE;
 
   // Stats::Histogram
   Histogram::Unit unit() const override {
@@ -55,27 +48,120 @@ public:
     // return parent's unit here and not store it separately.
     return unit_;
   }
-  void recordValue(uint64_t value) override;
 
   // Stats::Metric
   SymbolTable& symbolTable() final { return symbol_table_; }
-  bool used() const override { return used_; }
   bool hidden() const override { return false; }
 
+protected:
+  const std::thread::id created_thread_id_;
+
 private:
   Histogram::Unit unit_;
+  SymbolTable& symbol_table_;
+};
+
+/**
+ * A thread local histogram which holds two circllhist histograms, one to collect the values and
+ * other as backup that is used for merge process. The swap happens during the merge process.
+ */
+class CircllhistThreadLocalHistogramImpl : public ThreadLocalHistogramImpl {
+public:
+  CircllhistThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
+                                     StatName tag_extracted_name,
+                                     const StatNameTagVector& stat_name_tags,
+                                     SymbolTable& symbol_table);
+  ~CircllhistThreadLocalHistogramImpl() override;
+
+  void merge(histogram_t* target);
+
+  /**
+   * Swaps the histogram used for collection so that we do not have to lock the histogram in high
+   * throughput TLS writes.
+   */
+  void beginMerge() override {
+    // This switches the current_active_ between 1 and 0.
+    ASSERT(std::this_thread::get_id() == created_thread_id_);
+    current_active_ = otherHistogramIndex();
+  }
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override;
+
+  // Stats::Metric
+  bool used() const override { return used_; }
+
+private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
   histogram_t* histograms_[2];
   std::atomic<bool> used_;
-  std::thread::id created_thread_id_;
-  SymbolTable& symbol_table_;
+};
+
+/**
+ * A thread local histogram which counts values in fixed buckets. The main thread reads the counts
+ * at every flush, without the histogram having to swap them.
+ */
+class FixedBucketThreadLocalHistogramImpl : public ThreadLocalHistogramImpl {
+public:
+  using ThreadLocalHistogramImpl::ThreadLocalHistogramImpl;
+
+  void addNewValuesTo(FixedBucketHistogram& target) { counts_.addNewValuesTo(target); }
+
+  void beginMerge() override {}
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override {
+    ASSERT(std::this_thread::get_id() == created_thread_id_);
+    counts_.record(value);
+  }
+
+  // Stats::Metric
+  bool used() const override { return counts_.used(); }
+
+private:
+  ThreadLocalFixedBucketCounts counts_;
 };
 
 using TlsHistogramSharedPtr = RefcountPtr<ThreadLocalHistogramImpl>;
 
 class ThreadLocalStoreImpl;
 
+/**
+ * The values merged from the thread local histograms of a ParentHistogramImpl, over the last flush
+ * interval and since the histogram was created, in one of the representations of histograms.
+ */
+class ParentHistogramBackend {
+public:
+  virtual ~ParentHistogramBackend() = default;
+
+  /**
+   * @return a new thread local histogram, whose values can be merged by this backend.
+   */
+  virtual ThreadLocalHistogramImpl* createTlsHistogram(StatName name, Histogram::Unit unit,
+                                                       StatName tag_extracted_name,
+                                                       const StatNameTagVector& stat_name_tags,
+                                                       SymbolTable& symbol_table) PURE;
+
+  /**
+   * Replaces the interval values with the values recorded by thread local histograms since the
+   * previous merge.
+   */
+  virtual void mergeInterval(const std::list<TlsHistogramSharedPtr>& tls_histograms) PURE;
+
+  /**
+   * Adds the interval values to the cumulative values, and refreshes the statistics of both.
+   */
+  virtual void completeMerge() PURE;
+
+  virtual const HistogramStatistics& intervalStatistics() const PURE;
+  virtual const HistogramStatistics& cumulativeStatistics() const PURE;
+  virtual std::vector<ParentHistogram::Bucket> detailedIntervalBuckets() const PURE;
+  virtual std::vector<ParentHistogram::Bucket> detailedTotalBuckets() const PURE;
+};
+
+using ParentHistogramBackendPtr = std::unique_ptr<ParentHistogramBackend>;
+
 /**
  * Log Linear Histogram implementation that is stored in the main thread.
  */
@@ -83,10 +169,14 @@ class ParentHistogramImpl : public MetricImpl<ParentHistogram> {
 public:
   ParentHistogramImpl(StatName name, Histogram::Unit unit, ThreadLocalStoreImpl& parent,
                       StatName tag_extracted_name, const StatNameTagVector& stat_name_tags,
-                      ConstSupportedBuckets& supported_buckets, uint64_t id);
+                      ConstSupportedBuckets& supported_buckets, bool fixed_buckets, uint64_t id);
   ~ParentHistogramImpl() override;
 
-  void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
+  /**
+   * @return a new thread local histogram, which is merged into this histogram at every flush.
+   */
+  TlsHistogramSharedPtr createTlsHistogram(StatName tag_extracted_name,
+                                           const StatNameTagVector& stat_name_tags);
 
   // Stats::Histogram
   Histogram::Unit unit() const override;
@@ -100,17 +190,19 @@ public:
    */
   void merge() override;
 
-  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& intervalStatistics() const override {
+    return backend_->intervalStatistics();
+  }
   const HistogramStatistics& cumulativeStatistics() const override {
-    return cumulative_statistics_;
+    return backend_->cumulativeStatistics();
   }
   std::string quantileSummary() const override;
   std::string bucketSummary() const override;
   std::vector<Bucket> detailedTotalBuckets() const override {
-    return detailedlBucketsHelper(*cumulative_histogram_);
+    return backend_->detailedTotalBuckets();
   }
   std::vector<Bucket> detailedIntervalBuckets() const override {
-    return detailedlBucketsHelper(*interval_histogram_);
+    return backend_->detailedIntervalBuckets();
   }
 
   // Stats::Metric
@@ -129,15 +221,10 @@ public:
 
 private:
   bool usedLockHeld() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(merge_lock_);
-  static std::vector<Stats::ParentHistogram::Bucket>
-  detailedlBucketsHelper(const histogram_t& histogram);
 
   Histogram::Unit unit_;
   ThreadLocalStoreImpl& thread_local_store_;
-  histogram_t* interval_histogram_;
-  histogram_t* cumulative_histogram_;
-  HistogramStatisticsImpl interval_statistics_;
-  HistogramStatisticsImpl cumulative_statistics_;
+  const ParentHistogramBackendPtr backend_;
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_{false};
@@ -203,9 +290,14 @@ public:
   void forEachSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) const override;
   void forEachSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) const override;
   void forEachSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) const override;
+  void forEachChangedSinkedCounter(SizeFn f_size, StatFn<Counter> f_stat) override;
+  void forEachChangedSinkedGauge(SizeFn f_size, StatFn<Gauge> f_stat) override;
+  void forEachChangedSinkedTextReadout(SizeFn f_size, StatFn<TextReadout> f_stat) override;
+  void forEachChangedSinkedHistogram(SizeFn f_size, StatFn<ParentHistogram> f_stat) override;
 
   void setSinkPredicates(std::unique_ptr<SinkPredicates>&& sink_predicates) override;
   OptRef<SinkPredicates> sinkPredicates() override { return sink_predicates_; }
+  void trackChangedStats() override { alloc_.trackChangedStats(); }
 
   /**
    * @return a thread synchronizer object used for controlling thread behavior in tests.
@@ -1179,7 +1179,17 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
       addOrUpdateClusterInitializationObjectIfSupported(params, cm_cluster.cluster().info(),
                                                         load_balancer_factory, host_map);
 
-  tls_.runOnAllThreads([info = cm_cluster.cluster().info(), params = std::move(params),
+  // The lists of an existing cluster are updated on the workers in place if possible. Clusters
+  // which are initialized on the workers from the cluster initialization object start from
+  // scratch.
+  if (!add_or_update_cluster &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.incremental_host_set_updates")) {
+    addHostSetDeltas(cm_cluster.cluster().info()->name(), params);
+  }
+
+  // The update is shared, rather than copied, by the workers.
+  auto shared_params = std::make_shared<const ThreadLocalClusterUpdateParams>(std::move(params));
+  tls_.runOnAllThreads([info = cm_cluster.cluster().info(), params = std::move(shared_params),
                         add_or_update_cluster, load_balancer_factory, map = std::move(host_map),
                         cluster_initialization_object = std::move(cluster_initialization_object)](
                            OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
@@ -1238,7 +1248,7 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
             cluster_manager->thread_local_clusters_.size());
       }
 
-      for (const auto& per_priority : params.per_priority_update_params_) {
+      for (const auto& per_priority : params->per_priority_update_params_) {
         cluster_manager->updateClusterMembership(
             info->name(), per_priority.priority_, per_priority.update_hosts_params_,
             per_priority.locality_weights_, per_priority.hosts_added_, per_priority.hosts_removed_,
@@ -1262,6 +1272,25 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
   });
 }
 
+void ClusterManagerImpl::addHostSetDeltas(const std::string& cluster_name,
+                                          ThreadLocalClusterUpdateParams& params) {
+  OptRef<ThreadLocalClusterManagerImpl> cluster_manager = tls_.get();
+  if (!cluster_manager.has_value()) {
+    return;
+  }
+  auto entry = cluster_manager->thread_local_clusters_.find(cluster_name);
+  if (entry == cluster_manager->thread_local_clusters_.end()) {
+    return;
+  }
+  const auto& host_sets = entry->second->prioritySet().hostSetsPerPriority();
+  for (auto& per_priority : params.per_priority_update_params_) {
+    if (per_priority.priority_ < host_sets.size()) {
+      per_priority.update_hosts_params_.delta = HostSetImpl::computeDelta(
+          *host_sets[per_priority.priority_], per_priority.update_hosts_params_);
+    }
+  }
+}
+
 ClusterManagerImpl::ClusterInitializationObjectConstSharedPtr
 ClusterManagerImpl::addOrUpdateClusterInitializationObjectIfSupported(
     const ThreadLocalClusterUpdateParams& params, ClusterInfoConstSharedPtr cluster_info,
@@ -857,6 +857,12 @@ private:
 
   bool deferralIsSupportedForCluster(const ClusterInfoConstSharedPtr& info) const;
 
+  /**
+   * Adds the changes from the host lists of the thread local cluster of the main thread, which
+   * are the lists of the previous update, to the update of each priority.
+   */
+  void addHostSetDeltas(const std::string& cluster_name, ThreadLocalClusterUpdateParams& params);
+
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
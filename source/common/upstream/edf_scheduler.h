@@ -2,11 +2,14 @@
 #include <cstdint>
 #include <iostream>
 #include <queue>
+#include <vector>
 
 #include "envoy/upstream/scheduler.h"
 
 #include "source/common/common/assert.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -64,7 +67,66 @@ public:
 
   bool empty() const override { return queue_.empty(); }
 
+  /**
+   * Removes an entry which was added to the scheduler, without disturbing the deadlines of the
+   * other entries. The entry is dropped lazily when it reaches the head of the queue, unless most
+   * of the queue consists of removed entries, in which case the queue is compacted.
+   *
+   * @param entry the entry to remove. Must be in the scheduler.
+   */
+  void remove(std::shared_ptr<C> entry) {
+    prepick_list_.remove_if([&entry](const std::weak_ptr<C>& prepicked) {
+      return prepicked.lock() == entry;
+    });
+    // The removed entry is kept alive until it is dropped, so that its address can't be reused by
+    // an entry which is added in the meantime.
+    auto& removed = removed_[entry.get()];
+    removed.first = std::move(entry);
+    ++removed.second;
+    ++removed_count_;
+    if (removed_count_ > queue_.size() / 2) {
+      compact();
+    }
+  }
+
 private:
+  /**
+   * Returns true if the entry has been removed, consuming the removal.
+   */
+  bool consumeRemoval(const C* entry) {
+    if (removed_.empty()) {
+      return false;
+    }
+    auto it = removed_.find(entry);
+    if (it == removed_.end()) {
+      return false;
+    }
+    if (--it->second.second == 0) {
+      removed_.erase(it);
+    }
+    --removed_count_;
+    return true;
+  }
+
+  /**
+   * Drops all removed and expired entries from the queue.
+   */
+  void compact() {
+    std::vector<EdfEntry> entries;
+    entries.reserve(queue_.size());
+    while (!queue_.empty()) {
+      const EdfEntry& edf_entry = queue_.top();
+      std::shared_ptr<C> entry = edf_entry.entry_.lock();
+      if (entry != nullptr && !consumeRemoval(entry.get())) {
+        entries.push_back(edf_entry);
+      }
+      queue_.pop();
+    }
+    queue_ = std::priority_queue<EdfEntry>(std::less<EdfEntry>(), std::move(entries));
+    ASSERT(removed_count_ == 0);
+    removed_.clear();
+  }
+
   /**
    * Clears expired entries and pops the next unexpired entry in the queue.
    */
@@ -83,6 +145,11 @@ private:
         queue_.pop();
         continue;
       }
+      if (consumeRemoval(ret.get())) {
+        EDF_TRACE("Entry has been removed, repick.");
+        queue_.pop();
+        continue;
+      }
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
@@ -116,6 +183,10 @@ private:
   // Min priority queue for EDF.
   std::priority_queue<EdfEntry> queue_;
   std::list<std::weak_ptr<C>> prepick_list_;
+  // Entries which have been removed but are still in the queue, with the number of their queue
+  // entries to drop.
+  absl::flat_hash_map<const C*, std::pair<std::shared_ptr<C>, uint32_t>> removed_;
+  size_t removed_count_{};
 };
 
 #undef EDF_DEBUG
@@ -1023,10 +1023,10 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
                                                slow_start_config.value(), min_weight_percent, 10) /
                                                100.0
                                          : 0.1) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
+  // We recompute the schedulers for a given host set here on membership change. If the update
+  // carries a delta of the host lists, the schedulers are updated in place, otherwise they are
+  // fully recomputed, which is consistent with what other LB implementations do (e.g. thread
+  // aware). The downside of a full recompute is that time complexity is O(n * log n) (see
   // https://github.com/envoyproxy/envoy/issues/2874).
   priority_update_cb_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
@@ -1068,8 +1068,43 @@ void EdfLoadBalancerBase::recalculateHostsInSlowStart(const HostVector& hosts) {
   }
 }
 
+bool EdfLoadBalancerBase::applyHostsDelta(const HostsSource& source, const HostVector& hosts,
+                                          const HostListDelta& delta) {
+  auto it = scheduler_.find(source);
+  if (it == scheduler_.end()) {
+    return false;
+  }
+  Scheduler& scheduler = it->second;
+  if (delta.weights_equal) {
+    // As below, EDF creation is skipped if all weights are equal.
+    scheduler.edf_ = nullptr;
+  } else if (scheduler.edf_ != nullptr &&
+             (delta.added.size() + delta.removed.size()) * 2 <= hosts.size()) {
+    // Removing and adding hosts leaves the deadlines of the other hosts untouched, so the offset
+    // of the schedule is kept.
+    for (const auto& host : delta.removed) {
+      scheduler.edf_->remove(host);
+    }
+    for (const auto& host : delta.added) {
+      scheduler.edf_->add(hostWeight(*host), host);
+    }
+  } else {
+    // Rebuilding the schedule is cheaper if most of the hosts changed.
+    return false;
+  }
+  refreshHostSource(source);
+  return true;
+}
+
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
+  const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
+  // Host weights change over time in slow start, so the schedulers are always recomputed.
+  const HostSetDelta* delta = isSlowStartEnabled() ? nullptr : host_set->lastUpdateDelta();
+  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts,
+                                       const HostListDelta* hosts_delta) {
+    if (hosts_delta != nullptr && applyHostsDelta(source, hosts, *hosts_delta)) {
+      return;
+    }
     // Nuke existing scheduler if it exists.
     auto& scheduler = scheduler_[source] = Scheduler{};
     refreshHostSource(source);
@@ -1111,23 +1146,25 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     }
   };
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
-  const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
+  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts(),
+                   delta != nullptr ? &delta->hosts : nullptr);
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
+                   host_set->healthyHosts(), delta != nullptr ? &delta->healthy_hosts : nullptr);
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
+                   host_set->degradedHosts(), delta != nullptr ? &delta->degraded_hosts : nullptr);
   for (uint32_t locality_index = 0;
        locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
+        host_set->healthyHostsPerLocality().get()[locality_index],
+        delta != nullptr ? &delta->healthy_hosts_per_locality[locality_index] : nullptr);
   }
   for (uint32_t locality_index = 0;
        locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
     add_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+        host_set->degradedHostsPerLocality().get()[locality_index],
+        delta != nullptr ? &delta->degraded_hosts_per_locality[locality_index] : nullptr);
   }
 }
 
@@ -1268,10 +1305,10 @@ double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
   // If the value of active requests is the max value, adding +1 will overflow
   // it and cause a divide by zero. This won't happen in normal cases but stops
   // failing fuzz tests
-  const uint64_t active_request_value =
-      host.stats().rq_active_.value() != std::numeric_limits<uint64_t>::max()
-          ? host.stats().rq_active_.value() + 1
-          : host.stats().rq_active_.value();
+  const uint64_t active_requests = activeRequests(host);
+  const uint64_t active_request_value = active_requests != std::numeric_limits<uint64_t>::max()
+                                            ? active_requests + 1
+                                            : active_requests;
 
   if (active_request_bias_ == 1.0) {
     host_weight = static_cast<double>(host.weight()) / active_request_value;
@@ -1310,8 +1347,8 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
       continue;
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
+    const auto candidate_active_rq = activeRequests(*candidate_host);
+    const auto sampled_active_rq = activeRequests(*sampled_host);
     if (sampled_active_rq < candidate_active_rq) {
       candidate_host = sampled_host;
     }
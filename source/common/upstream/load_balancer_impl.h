@@ -548,6 +548,10 @@ protected:
 
 private:
   friend class EdfLoadBalancerBasePeer;
+  // Updates the scheduler of a host source in place with the changes of its host list. Returns
+  // false if the scheduler needs to be recomputed instead.
+  bool applyHostsDelta(const HostsSource& source, const HostVector& hosts,
+                       const HostListDelta& delta);
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) const PURE;
   virtual HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
@@ -730,6 +734,14 @@ protected:
     EdfLoadBalancerBase::refresh(priority);
   }
 
+  /**
+   * @return the number of active requests of a host which picks are based on. Defaults to the
+   *         cluster wide number of active requests of the host.
+   */
+  virtual uint64_t activeRequests(const Host& host) const {
+    return host.stats().rq_active_.value();
+  }
+
 private:
   void refreshHostSource(const HostsSource&) override {}
   double hostWeight(const Host& host) const override;
@@ -23,6 +23,12 @@ namespace Envoy {
 namespace Upstream {
 namespace Outlier {
 
+namespace {
+
+std::atomic<uint64_t> next_detector_id{0};
+
+} // namespace
+
 DetectorSharedPtr DetectorImplFactory::createForCluster(
     Cluster& cluster, const envoy::config::cluster::v3::Cluster& cluster_config,
     Event::Dispatcher& dispatcher, Runtime::Loader& runtime, EventLoggerSharedPtr event_logger,
@@ -38,7 +44,7 @@ DetectorSharedPtr DetectorImplFactory::createForCluster(
 
 DetectorHostMonitorImpl::DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> detector,
                                                  HostSharedPtr host)
-    : detector_(detector), host_(host),
+    : detector_(detector), detector_id_(detector->id()), host_(host),
       // add Success Rate monitors
       external_origin_sr_monitor_(envoy::data::cluster::v3::SUCCESS_RATE),
       local_origin_sr_monitor_(envoy::data::cluster::v3::SUCCESS_RATE_LOCAL_ORIGIN) {
@@ -65,14 +71,55 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
   local_origin_sr_monitor_.updateCurrentSuccessRateBucket();
 }
 
+void DetectorHostMonitorImpl::discardResults(SuccessRateResultBuffer& buffer) {
+  buffer.discard(external_origin_sr_monitor_);
+  buffer.discard(local_origin_sr_monitor_);
+}
+
+void DetectorHostMonitorImpl::addSuccessRateMonitors(
+    absl::flat_hash_set<SuccessRateMonitor*>& monitors) {
+  monitors.insert(&external_origin_sr_monitor_);
+  monitors.insert(&local_origin_sr_monitor_);
+}
+
+SuccessRateResultBufferSharedPtr DetectorHostMonitorImpl::resultBuffer() {
+  // The buffers of the calling thread, by detector id. Looking up the buffer does not touch the
+  // detector, whose reference count would be contended by all the threads reporting results.
+  thread_local absl::flat_hash_map<uint64_t, std::weak_ptr<SuccessRateResultBuffer>> buffers;
+  auto it = buffers.find(detector_id_);
+  if (it != buffers.end()) {
+    if (SuccessRateResultBufferSharedPtr buffer = it->second.lock()) {
+      return buffer;
+    }
+  }
+
+  std::shared_ptr<DetectorImpl> detector = detector_.lock();
+  if (!detector) {
+    // It's possible for the cluster/detector to go away while we still have a host in use.
+    return nullptr;
+  }
+  // The buffers of detectors which have gone away are dropped whenever a buffer is created.
+  absl::erase_if(buffers, [](const auto& entry) { return entry.second.expired(); });
+  SuccessRateResultBufferSharedPtr buffer = detector->createResultBuffer();
+  buffers[detector_id_] = buffer;
+  return buffer;
+}
+
+void DetectorHostMonitorImpl::putSuccessRateResult(SuccessRateMonitor& monitor, bool success) {
+  SuccessRateResultBufferSharedPtr buffer = resultBuffer();
+  if (buffer != nullptr) {
+    buffer->put(monitor, success);
+  }
+}
+
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
-  external_origin_sr_monitor_.incTotalReqCounter();
   if (Http::CodeUtility::is5xx(response_code)) {
     std::shared_ptr<DetectorImpl> detector = detector_.lock();
     if (!detector) {
       // It's possible for the cluster/detector to go away while we still have a host in use.
       return;
     }
+    putSuccessRateResult(external_origin_sr_monitor_, false);
     if (Http::CodeUtility::isGatewayError(response_code)) {
       if (++consecutive_gateway_failure_ ==
           detector->runtime().snapshot().getInteger(
@@ -88,9 +135,15 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
       detector->onConsecutive5xx(host_.lock());
     }
   } else {
-    external_origin_sr_monitor_.incSuccessReqCounter();
-    consecutive_5xx_ = 0;
-    consecutive_gateway_failure_ = 0;
+    putSuccessRateResult(external_origin_sr_monitor_, true);
+    // The counters are only written when they change, as they are shared by all the threads
+    // reporting results for the host.
+    if (consecutive_5xx_.load(std::memory_order_relaxed) != 0) {
+      consecutive_5xx_ = 0;
+    }
+    if (consecutive_gateway_failure_.load(std::memory_order_relaxed) != 0) {
+      consecutive_gateway_failure_ = 0;
+    }
   }
 }
 
@@ -185,7 +238,7 @@ void DetectorHostMonitorImpl::localOriginFailure() {
     // It's possible for the cluster/detector to go away while we still have a host in use.
     return;
   }
-  local_origin_sr_monitor_.incTotalReqCounter();
+  putSuccessRateResult(local_origin_sr_monitor_, false);
   if (++consecutive_local_origin_failure_ ==
       detector->runtime().snapshot().getInteger(
           ConsecutiveLocalOriginFailureRuntime,
@@ -195,16 +248,10 @@ void DetectorHostMonitorImpl::localOriginFailure() {
 }
 
 void DetectorHostMonitorImpl::localOriginNoFailure() {
-  std::shared_ptr<DetectorImpl> detector = detector_.lock();
-  if (!detector) {
-    // It's possible for the cluster/detector to go away while we still have a host in use.
-    return;
+  putSuccessRateResult(local_origin_sr_monitor_, true);
+  if (consecutive_local_origin_failure_.load(std::memory_order_relaxed) != 0) {
+    resetConsecutiveLocalOriginFailure();
   }
-
-  local_origin_sr_monitor_.incTotalReqCounter();
-  local_origin_sr_monitor_.incSuccessReqCounter();
-
-  resetConsecutiveLocalOriginFailure();
 }
 
 DetectorConfig::DetectorConfig(const envoy::config::cluster::v3::OutlierDetection& config)
@@ -266,8 +313,8 @@ DetectorImpl::DetectorImpl(const Cluster& cluster,
                            Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
                            TimeSource& time_source, EventLoggerSharedPtr event_logger,
                            Random::RandomGenerator& random)
-    : config_(config), dispatcher_(dispatcher), runtime_(runtime), time_source_(time_source),
-      stats_(generateStats(cluster.info()->statsScope())),
+    : id_(next_detector_id++), config_(config), dispatcher_(dispatcher), runtime_(runtime),
+      time_source_(time_source), stats_(generateStats(cluster.info()->statsScope())),
       interval_timer_(dispatcher.createTimer([this]() -> void { onIntervalTimer(); })),
       event_logger_(event_logger), random_generator_(random) {
   // Insert success rate initial numbers for each type of SR detector
@@ -342,10 +389,37 @@ void DetectorImpl::initialize(Cluster& cluster) {
 void DetectorImpl::addHostMonitor(HostSharedPtr host) {
   ASSERT(host_monitors_.count(host) == 0);
   DetectorHostMonitorImpl* monitor = new DetectorHostMonitorImpl(shared_from_this(), host);
+  {
+    // The monitor may reuse the address of the monitor of a removed host, whose results may still
+    // be buffered.
+    absl::MutexLock lock(&result_buffers_mutex_);
+    for (const SuccessRateResultBufferSharedPtr& buffer : result_buffers_) {
+      monitor->discardResults(*buffer);
+    }
+  }
   host_monitors_[host] = monitor;
   host->setOutlierDetector(DetectorHostMonitorPtr{monitor});
 }
 
+SuccessRateResultBufferSharedPtr DetectorImpl::createResultBuffer() {
+  auto buffer = std::make_shared<SuccessRateResultBuffer>();
+  absl::MutexLock lock(&result_buffers_mutex_);
+  result_buffers_.push_back(buffer);
+  return buffer;
+}
+
+void DetectorImpl::flushResultBuffers() {
+  absl::flat_hash_set<SuccessRateMonitor*> monitors;
+  monitors.reserve(host_monitors_.size() * 2);
+  for (const auto& host : host_monitors_) {
+    host.second->addSuccessRateMonitors(monitors);
+  }
+  absl::MutexLock lock(&result_buffers_mutex_);
+  for (const SuccessRateResultBufferSharedPtr& buffer : result_buffers_) {
+    buffer->flush(monitors);
+  }
+}
+
 void DetectorImpl::armIntervalTimer() {
   interval_timer_->enableTimer(std::chrono::milliseconds(
       runtime_.snapshot().getInteger(IntervalMsRuntime, config_.intervalMs())));
@@ -742,6 +816,10 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
+  // The results buffered by the threads during the interval are added to the current buckets
+  // before they are swapped below.
+  flushResultBuffers();
+
   for (auto host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
@@ -860,6 +938,31 @@ void EventLoggerImpl::setCommonEventParams(envoy::data::cluster::v3::OutlierDete
   TimestampUtil::systemClockToTimestamp(time_source_.systemTime(), *event.mutable_timestamp());
 }
 
+void SuccessRateResultBuffer::put(SuccessRateMonitor& monitor, bool success) {
+  absl::MutexLock lock(&mutex_);
+  Results& results = results_[&monitor];
+  results.success_ += success;
+  results.total_++;
+}
+
+void SuccessRateResultBuffer::flush(const absl::flat_hash_set<SuccessRateMonitor*>& monitors) {
+  absl::flat_hash_map<SuccessRateMonitor*, Results> results;
+  {
+    absl::MutexLock lock(&mutex_);
+    results.swap(results_);
+  }
+  for (const auto& [monitor, monitor_results] : results) {
+    if (monitors.contains(monitor)) {
+      monitor->addResults(monitor_results.success_, monitor_results.total_);
+    }
+  }
+}
+
+void SuccessRateResultBuffer::discard(SuccessRateMonitor& monitor) {
+  absl::MutexLock lock(&mutex_);
+  results_.erase(&monitor);
+}
+
 SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
   // Right now current is being written to and backup is not. Flush the backup and swap.
   backup_success_rate_bucket_->success_request_counter_ = 0;
@@ -23,7 +23,11 @@
 
 #include "source/common/upstream/upstream_impl.h"
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -100,9 +104,10 @@ public:
   void updateCurrentSuccessRateBucket() {
     success_rate_accumulator_bucket_.store(success_rate_accumulator_.updateCurrentWriter());
   }
-  void incTotalReqCounter() { success_rate_accumulator_bucket_.load()->total_request_counter_++; }
-  void incSuccessReqCounter() {
-    success_rate_accumulator_bucket_.load()->success_request_counter_++;
+  void addResults(uint64_t success, uint64_t total) {
+    SuccessRateAccumulatorBucket* bucket = success_rate_accumulator_bucket_.load();
+    bucket->success_request_counter_ += success;
+    bucket->total_request_counter_ += total;
   }
 
   envoy::data::cluster::v3::OutlierEjectionType getEjectionType() const { return ejection_type_; }
@@ -114,6 +119,40 @@ private:
   double success_rate_{-1};
 };
 
+/**
+ * Success rate results reported by a single thread for the hosts of a detector. Each thread has its
+ * own buffer, so that threads reporting results for the same hosts do not contend on the counters
+ * of the hosts. The buffered results are added to the success rate monitors of the hosts at the
+ * end of each interval, which is the only time the mutex of a buffer is contended.
+ */
+class SuccessRateResultBuffer {
+public:
+  void put(SuccessRateMonitor& monitor, bool success);
+
+  /**
+   * Adds the buffered results to their success rate monitors and clears the buffer.
+   * @param monitors the success rate monitors of the current hosts of the detector. The results of
+   *        other monitors, whose hosts have been removed, are discarded.
+   */
+  void flush(const absl::flat_hash_set<SuccessRateMonitor*>& monitors);
+
+  /**
+   * Discards the buffered results of a success rate monitor.
+   */
+  void discard(SuccessRateMonitor& monitor);
+
+private:
+  struct Results {
+    uint64_t success_{};
+    uint64_t total_{};
+  };
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<SuccessRateMonitor*, Results> results_ ABSL_GUARDED_BY(mutex_);
+};
+
+using SuccessRateResultBufferSharedPtr = std::shared_ptr<SuccessRateResultBuffer>;
+
 class DetectorImpl;
 
 /**
@@ -158,6 +197,8 @@ public:
     return getSRMonitor(type).getSuccessRate();
   }
   void updateCurrentSuccessRateBucket();
+  void discardResults(SuccessRateResultBuffer& buffer);
+  void addSuccessRateMonitors(absl::flat_hash_set<SuccessRateMonitor*>& monitors);
   void successRate(SuccessRateMonitorType type, double new_success_rate) {
     getSRMonitor(type).setSuccessRate(new_success_rate);
   }
@@ -173,7 +214,11 @@ public:
   std::chrono::milliseconds getJitter() const { return jitter_; }
 
 private:
+  void putSuccessRateResult(SuccessRateMonitor& monitor, bool success);
+  SuccessRateResultBufferSharedPtr resultBuffer();
+
   std::weak_ptr<DetectorImpl> detector_;
+  const uint64_t detector_id_;
   std::weak_ptr<Host> host_;
   absl::optional<MonotonicTime> last_ejection_time_;
   absl::optional<MonotonicTime> last_unejection_time_;
@@ -418,6 +463,17 @@ public:
     return host_monitors_;
   }
 
+  /**
+   * @return the id of the detector, which unlike its address is never reused by another detector.
+   */
+  uint64_t id() const { return id_; }
+
+  /**
+   * Creates a buffer for the success rate results reported by the calling thread, which is flushed
+   * at the end of each interval. May be called from any thread.
+   */
+  SuccessRateResultBufferSharedPtr createResultBuffer();
+
 private:
   DetectorImpl(const Cluster& cluster, const envoy::config::cluster::v3::OutlierDetection& config,
                Event::Dispatcher& dispatcher, Runtime::Loader& runtime, TimeSource& time_source,
@@ -434,6 +490,7 @@ private:
   void notifyMainThreadConsecutiveError(HostSharedPtr host,
                                         envoy::data::cluster::v3::OutlierEjectionType type);
   void onIntervalTimer();
+  void flushResultBuffers();
   void runCallbacks(HostSharedPtr host);
   bool enforceEjection(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateEnforcedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
@@ -457,6 +514,7 @@ private:
     Envoy::Stats::Gauge& ejections_active_ref_;
     std::atomic<uint64_t> ejections_active_value_{0};
   };
+  const uint64_t id_;
   DetectorConfig config_;
   Event::Dispatcher& dispatcher_;
   Runtime::Loader& runtime_;
@@ -469,6 +527,9 @@ private:
   EventLoggerSharedPtr event_logger_;
   Common::CallbackHandlePtr member_update_cb_;
   Random::RandomGenerator& random_generator_;
+  absl::Mutex result_buffers_mutex_;
+  std::vector<SuccessRateResultBufferSharedPtr>
+      result_buffers_ ABSL_GUARDED_BY(result_buffers_mutex_);
 
   // EjectionPair for external and local origin events.
   // When external/local origin events are not split, external_origin_sr_num_ are used for
@@ -95,7 +95,9 @@ void ThreadAwareLoadBalancerBase::initialize() {
   // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
   // I will look into doing this in a follow up. Doing everything using a background thread heavily
   // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // think the synchronous/asynchronous split is probably the best option. The Rebuild benchmarks
+  // in test/common/upstream/load_balancer_benchmark.cc measure what an update costs the main
+  // thread today.
   priority_update_cb_ = priority_set_.addPriorityUpdateCb(
       [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
 
@@ -103,6 +105,7 @@ void ThreadAwareLoadBalancerBase::initialize() {
 }
 
 void ThreadAwareLoadBalancerBase::refresh() {
+  built_lbs_.resize(priority_set_.hostSetsPerPriority().size());
   auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
       priority_set_.hostSetsPerPriority().size());
   auto healthy_per_priority_load =
@@ -124,8 +127,26 @@ void ThreadAwareLoadBalancerBase::refresh() {
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight, locality_weighted_balancing_);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+
+    // Every priority is refreshed on an update of any of them, and health changes of hosts which
+    // are not part of the table do not change it either. The tables are immutable once built, so
+    // the table of a priority whose weights and host metadata did not change is shared with the
+    // new state. Metadata updates of existing hosts, which may change their hash keys, are applied
+    // in place, so they do not change the weights.
+    std::vector<MetadataConstSharedPtr> host_metadata;
+    host_metadata.reserve(normalized_host_weights.size());
+    for (const auto& entry : normalized_host_weights) {
+      host_metadata.push_back(entry.first->metadata());
+    }
+    BuiltLoadBalancer& built = built_lbs_[priority];
+    if (built.lb_ == nullptr || built.normalized_host_weights_ != normalized_host_weights ||
+        built.host_metadata_ != host_metadata) {
+      built.lb_ = createLoadBalancer(priority, normalized_host_weights, min_normalized_weight,
+                                     max_normalized_weight);
+      built.normalized_host_weights_ = std::move(normalized_host_weights);
+      built.host_metadata_ = std::move(host_metadata);
+    }
+    per_priority_state->current_lb_ = built.lb_;
   }
 
   {
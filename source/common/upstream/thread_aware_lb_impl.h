@@ -162,13 +162,28 @@ private:
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
   };
 
+  // The weights and host metadata a priority's load balancer was last built from, and the load
+  // balancer. The metadata is kept as it holds the hash keys of the hosts, and is replaced rather
+  // than mutated when a host is updated. Only accessed on the main thread.
+  struct BuiltLoadBalancer {
+    NormalizedHostWeightVector normalized_host_weights_;
+    std::vector<MetadataConstSharedPtr> host_metadata_;
+    HashingLoadBalancerSharedPtr lb_;
+  };
+
+  /**
+   * Builds the hashing load balancer of a priority. Only called when the normalized weights of the
+   * priority changed since the last build, so an implementation may keep the last table it built
+   * for each priority and update it incrementally.
+   */
   virtual HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
   const bool locality_weighted_balancing_{};
+  std::vector<BuiltLoadBalancer> built_lbs_;
   Common::CallbackHandlePtr priority_update_cb_;
 };
 
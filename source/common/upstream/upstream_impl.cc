@@ -1,5 +1,6 @@
 #include "source/common/upstream/upstream_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <limits>
@@ -57,6 +58,7 @@
 #include "source/extensions/filters/network/http_connection_manager/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/str_cat.h"
 
@@ -129,6 +131,17 @@ absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr> parseExten
   return options;
 }
 
+const Network::SocketInterface* upstreamSocketInterface(
+    const absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr>& options) {
+  for (const auto& it : options) {
+    const auto* config = dynamic_cast<const SocketInterfaceProtocolOptionsConfig*>(it.second.get());
+    if (config != nullptr) {
+      return &config->socketInterface();
+    }
+  }
+  return nullptr;
+}
+
 // Updates the EDS health flags for an existing host to match the new host.
 // @param updated_host the new host to read health flag values from.
 // @param existing_host the host to update.
@@ -480,6 +493,16 @@ Host::CreateConnectionData HostImpl::createConnection(
     HostDescriptionConstSharedPtr host) {
   auto source_address_selector = cluster.getUpstreamLocalAddressSelector();
 
+  // The protocol options of the cluster may select the socket interface of its connections,
+  // regardless of how the addresses of the host were resolved.
+  const Network::SocketInterface* sock_interface = cluster.upstreamSocketInterface();
+  const auto connect_address =
+      [sock_interface](const Network::Address::InstanceConstSharedPtr& target) {
+        return sock_interface != nullptr
+                   ? Network::Utility::getAddressWithSocketInterface(target, *sock_interface)
+                   : target;
+      };
+
   Network::ClientConnectionPtr connection;
   // If the transport socket options indicate the connection should be
   // redirected to a proxy, create the TCP connection to the proxy's address not
@@ -490,18 +513,24 @@ Host::CreateConnectionData HostImpl::createConnection(
     ENVOY_LOG(debug, "Connecting to configured HTTP/1.1 proxy at {}",
               transport_socket_options->http11ProxyInfo()->proxy_address->asString());
     connection = dispatcher.createClientConnection(
-        transport_socket_options->http11ProxyInfo()->proxy_address, upstream_local_address.address_,
+        connect_address(transport_socket_options->http11ProxyInfo()->proxy_address),
+        upstream_local_address.address_,
         socket_factory.createTransportSocket(transport_socket_options, host),
         upstream_local_address.socket_options_, transport_socket_options);
   } else if (address_list.size() > 1) {
+    std::vector<Network::Address::InstanceConstSharedPtr> connect_address_list;
+    connect_address_list.reserve(address_list.size());
+    for (const auto& list_address : address_list) {
+      connect_address_list.push_back(connect_address(list_address));
+    }
     connection = std::make_unique<Network::HappyEyeballsConnectionImpl>(
-        dispatcher, address_list, source_address_selector, socket_factory, transport_socket_options,
-        host, options);
+        dispatcher, connect_address_list, source_address_selector, socket_factory,
+        transport_socket_options, host, options);
   } else {
     auto upstream_local_address =
         source_address_selector->getUpstreamLocalAddress(address, options);
     connection = dispatcher.createClientConnection(
-        address, upstream_local_address.address_,
+        connect_address(address), upstream_local_address.address_,
         socket_factory.createTransportSocket(transport_socket_options, host),
         upstream_local_address.socket_options_, transport_socket_options);
   }
@@ -564,6 +593,11 @@ void HostSetImpl::updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_para
     ASSERT(overprovisioning_factor.value() > 0);
     overprovisioning_factor_ = overprovisioning_factor.value();
   }
+  // The delta can only be applied on top of the lists it was computed from.
+  HostSetDeltaConstSharedPtr delta = std::move(update_hosts_params.delta);
+  if (delta != nullptr && !deltaApplies(*delta)) {
+    delta = nullptr;
+  }
   hosts_ = std::move(update_hosts_params.hosts);
   healthy_hosts_ = std::move(update_hosts_params.healthy_hosts);
   degraded_hosts_ = std::move(update_hosts_params.degraded_hosts);
@@ -584,7 +618,88 @@ void HostSetImpl::updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_para
                            hosts_per_locality_, excluded_hosts_per_locality_, locality_weights_,
                            overprovisioning_factor_);
 
+  last_update_delta_ = delta.get();
   runUpdateCallbacks(hosts_added, hosts_removed);
+  last_update_delta_ = nullptr;
+}
+
+bool HostSetImpl::deltaApplies(const HostSetDelta& delta) const {
+  return delta.base_hosts == hosts_ && delta.base_healthy_hosts == healthy_hosts_ &&
+         delta.base_degraded_hosts == degraded_hosts_ &&
+         delta.base_healthy_hosts_per_locality == healthy_hosts_per_locality_ &&
+         delta.base_degraded_hosts_per_locality == degraded_hosts_per_locality_;
+}
+
+namespace {
+
+HostListDelta hostListDelta(const HostVector& base_hosts, const HostVector& hosts) {
+  HostListDelta delta;
+  absl::flat_hash_set<const Host*> base_host_set;
+  base_host_set.reserve(base_hosts.size());
+  for (const auto& host : base_hosts) {
+    base_host_set.insert(host.get());
+  }
+  absl::flat_hash_set<const Host*> host_set;
+  host_set.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    host_set.insert(host.get());
+    if (!base_host_set.contains(host.get())) {
+      delta.added.push_back(host);
+    }
+  }
+  for (const auto& host : base_hosts) {
+    if (!host_set.contains(host.get())) {
+      delta.removed.push_back(host);
+    }
+  }
+  delta.weights_equal =
+      std::all_of(hosts.begin(), hosts.end(), [&hosts](const HostSharedPtr& host) {
+        return host->weight() == hosts[0]->weight();
+      });
+  return delta;
+}
+
+bool hostsPerLocalityDelta(const HostsPerLocalityConstSharedPtr& base_hosts_per_locality,
+                           const HostsPerLocalityConstSharedPtr& hosts_per_locality,
+                           std::vector<HostListDelta>& deltas) {
+  if (base_hosts_per_locality == nullptr || hosts_per_locality == nullptr ||
+      base_hosts_per_locality->get().size() != hosts_per_locality->get().size()) {
+    return false;
+  }
+  deltas.reserve(hosts_per_locality->get().size());
+  for (size_t i = 0; i < hosts_per_locality->get().size(); ++i) {
+    deltas.push_back(
+        hostListDelta(base_hosts_per_locality->get()[i], hosts_per_locality->get()[i]));
+  }
+  return true;
+}
+
+} // namespace
+
+HostSetDeltaConstSharedPtr
+HostSetImpl::computeDelta(const HostSet& host_set,
+                          const PrioritySet::UpdateHostsParams& update_hosts_params) {
+  auto delta = std::make_shared<HostSetDelta>();
+  delta->base_hosts = host_set.hostsPtr();
+  delta->base_healthy_hosts = host_set.healthyHostsPtr();
+  delta->base_degraded_hosts = host_set.degradedHostsPtr();
+  delta->base_healthy_hosts_per_locality = host_set.healthyHostsPerLocalityPtr();
+  delta->base_degraded_hosts_per_locality = host_set.degradedHostsPerLocalityPtr();
+  // Locality indexes are only stable if the number of localities doesn't change.
+  if (!hostsPerLocalityDelta(delta->base_healthy_hosts_per_locality,
+                             update_hosts_params.healthy_hosts_per_locality,
+                             delta->healthy_hosts_per_locality) ||
+      !hostsPerLocalityDelta(delta->base_degraded_hosts_per_locality,
+                             update_hosts_params.degraded_hosts_per_locality,
+                             delta->degraded_hosts_per_locality)) {
+    return nullptr;
+  }
+  delta->hosts = hostListDelta(host_set.hosts(), *update_hosts_params.hosts);
+  delta->healthy_hosts =
+      hostListDelta(host_set.healthyHosts(), update_hosts_params.healthy_hosts->get());
+  delta->degraded_hosts =
+      hostListDelta(host_set.degradedHosts(), update_hosts_params.degraded_hosts->get());
+  return delta;
 }
 
 void HostSetImpl::rebuildLocalityScheduler(
@@ -668,7 +783,8 @@ HostSetImpl::updateHostsParams(HostVectorConstSharedPtr hosts,
                                         std::move(hosts_per_locality),
                                         std::move(healthy_hosts_per_locality),
                                         std::move(degraded_hosts_per_locality),
-                                        std::move(excluded_hosts_per_locality)};
+                                        std::move(excluded_hosts_per_locality),
+                                        nullptr};
 }
 
 PrioritySet::UpdateHostsParams HostSetImpl::updateHostsParams(const HostSet& host_set) {
@@ -1002,6 +1118,7 @@ ClusterInfoImpl::ClusterInfoImpl(
               ? std::make_unique<std::string>(config.eds_cluster_config().service_name())
               : nullptr),
       extension_protocol_options_(parseExtensionProtocolOptions(config, factory_context)),
+      upstream_socket_interface_(upstreamSocketInterface(extension_protocol_options_)),
       http_protocol_options_(
           createOptions(config,
                         extensionProtocolOptionsTyped<HttpProtocolOptionsConfigImpl>(
@@ -249,6 +249,9 @@ public:
     static DetectorHostMonitorNullImpl* null_outlier_detector = new DetectorHostMonitorNullImpl();
     return *null_outlier_detector;
   }
+  OptRef<HostLbPolicyData> lbPolicyData() const override {
+    return makeOptRefFromPtr(lb_policy_data_.get());
+  }
   HostStats& stats() const override { return stats_; }
   LoadMetricStats& loadMetricStats() const override { return load_metric_stats_; }
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
@@ -291,6 +294,10 @@ protected:
     outlier_detector_ = std::move(outlier_detector);
   }
 
+  void setLbPolicyDataImpl(HostLbPolicyDataPtr&& lb_policy_data) {
+    lb_policy_data_ = std::move(lb_policy_data);
+  }
+
   void setLastHcPassTimeImpl(MonotonicTime last_hc_pass_time) {
     last_hc_pass_time_.emplace(std::move(last_hc_pass_time));
   }
@@ -312,6 +319,7 @@ private:
   mutable LoadMetricStatsImpl load_metric_stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
+  HostLbPolicyDataPtr lb_policy_data_;
   std::atomic<uint32_t> priority_;
   std::reference_wrapper<Network::UpstreamTransportSocketFactory>
       socket_factory_ ABSL_GUARDED_BY(metadata_mutex_);
@@ -361,7 +369,15 @@ public:
 
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
   gauges() const override {
-    return stats().gauges();
+    std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges =
+        stats().gauges();
+    OptRef<HostLbPolicyData> lb_policy_data = lbPolicyData();
+    if (lb_policy_data.has_value()) {
+      for (const auto& gauge : lb_policy_data->gauges()) {
+        gauges.push_back(gauge);
+      }
+    }
+    return gauges;
   }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
@@ -375,6 +391,9 @@ public:
   void setOutlierDetector(Outlier::DetectorHostMonitorPtr&& outlier_detector) override {
     setOutlierDetectorImpl(std::move(outlier_detector));
   }
+  void setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) override {
+    setLbPolicyDataImpl(std::move(lb_policy_data));
+  }
 
   void setLastHcPassTime(MonotonicTime last_hc_pass_time) override {
     setLastHcPassTimeImpl(std::move(last_hc_pass_time));
@@ -584,6 +603,16 @@ public:
   uint32_t priority() const override { return priority_; }
   uint32_t overprovisioningFactor() const override { return overprovisioning_factor_; }
   bool weightedPriorityHealth() const override { return weighted_priority_health_; }
+  const HostSetDelta* lastUpdateDelta() const override { return last_update_delta_; }
+
+  /**
+   * Computes the changes from the host lists of a host set to the lists of an update.
+   * @param host_set supplies the host set which the update is applied to.
+   * @param update_hosts_params supplies the lists of the update.
+   * @return the delta, or nullptr if the localities of the lists differ.
+   */
+  static HostSetDeltaConstSharedPtr
+  computeDelta(const HostSet& host_set, const PrioritySet::UpdateHostsParams& update_hosts_params);
 
   static PrioritySet::UpdateHostsParams
   updateHostsParams(HostVectorConstSharedPtr hosts,
@@ -610,6 +639,9 @@ protected:
   }
 
 private:
+  // Whether the delta was computed from the current host lists.
+  bool deltaApplies(const HostSetDelta& delta) const;
+
   // Weight for a locality taking into account health status using the provided eligible hosts per
   // locality.
   static double effectiveLocalityWeight(uint32_t index,
@@ -633,6 +665,8 @@ private:
   // TODO(mattklein123): Remove mutable.
   mutable Common::CallbackManager<uint32_t, const HostVector&, const HostVector&>
       member_update_cb_helper_;
+  // The delta of the update whose callbacks are running, if any.
+  const HostSetDelta* last_update_delta_{};
   // Locality weights (used to build WRR locality_scheduler_);
   LocalityWeightsConstSharedPtr locality_weights_;
   // WRR locality scheduler state.
@@ -940,6 +974,9 @@ public:
     }
     return *upstream_config_;
   }
+  const Network::SocketInterface* upstreamSocketInterface() const override {
+    return upstream_socket_interface_;
+  }
   bool maintenanceMode() const override;
   uint64_t maxRequestsPerConnection() const override { return max_requests_per_connection_; }
   uint32_t maxResponseHeadersCount() const override { return max_response_headers_count_; }
@@ -1094,6 +1131,7 @@ private:
   std::unique_ptr<const std::string> eds_service_name_;
   const absl::flat_hash_map<std::string, ProtocolOptionsConfigConstSharedPtr>
       extension_protocol_options_;
+  const Network::SocketInterface* const upstream_socket_interface_;
   const std::shared_ptr<const HttpProtocolOptionsConfigImpl> http_protocol_options_;
   const std::shared_ptr<const TcpProtocolOptionsConfigImpl> tcp_protocol_options_;
   const uint64_t max_requests_per_connection_;
@@ -0,0 +1,194 @@
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/http/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+using BinaryFileAccessLogProto =
+    envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog;
+
+namespace {
+
+absl::optional<absl::string_view> nonEmpty(absl::string_view value) {
+  if (value.empty()) {
+    return absl::nullopt;
+  }
+  return value;
+}
+
+int64_t toMicros(std::chrono::nanoseconds duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // namespace
+
+BinaryFileAccessLog::BinaryFileAccessLog(AccessLog::FilterPtr&& filter,
+                                         BinaryFileAccessLogConfigConstSharedPtr config,
+                                         ThreadLocal::SlotAllocator& tls)
+    : Common::ImplBase(std::move(filter)),
+      tls_slot_(ThreadLocal::TypedSlot<ThreadLocalLogger>::makeUnique(tls)) {
+  tls_slot_->set([config = std::move(config)](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalLogger>(config, dispatcher);
+  });
+}
+
+ColumnType BinaryFileAccessLog::columnType(ColumnField field) {
+  switch (field) {
+  case BinaryFileAccessLogProto::Column::START_TIME:
+    return ColumnType::Timestamp;
+  case BinaryFileAccessLogProto::Column::DURATION:
+  case BinaryFileAccessLogProto::Column::RESPONSE_CODE:
+  case BinaryFileAccessLogProto::Column::RESPONSE_FLAGS:
+  case BinaryFileAccessLogProto::Column::BYTES_RECEIVED:
+  case BinaryFileAccessLogProto::Column::BYTES_SENT:
+    return ColumnType::Uint64;
+  default:
+    return ColumnType::String;
+  }
+}
+
+void BinaryFileAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const Http::ResponseTrailerMap& response_trailers,
+                                  const StreamInfo::StreamInfo& stream_info,
+                                  AccessLog::AccessLogType access_log_type) {
+  (*tls_slot_)->log({&request_headers, &response_headers, &response_trailers, absl::string_view(),
+                     access_log_type},
+                    stream_info);
+}
+
+BinaryFileAccessLog::ThreadLocalLogger::ThreadLocalLogger(
+    BinaryFileAccessLogConfigConstSharedPtr config, Event::Dispatcher& dispatcher)
+    : config_(std::move(config)),
+      builder_(config_->schema_, config_->block_size_, config_->compression_level_),
+      flush_timer_(dispatcher.createTimer([this]() { writeBlock(); })) {}
+
+BinaryFileAccessLog::ThreadLocalLogger::~ThreadLocalLogger() { writeBlock(); }
+
+void BinaryFileAccessLog::ThreadLocalLogger::log(const Formatter::HttpFormatterContext& context,
+                                                 const StreamInfo::StreamInfo& stream_info) {
+  for (size_t i = 0; i < config_->columns_.size(); ++i) {
+    const ColumnConfig& column = config_->columns_[i];
+    if (column.formatter_ != nullptr) {
+      const std::string value = column.formatter_->formatWithContext(context, stream_info);
+      builder_.appendString(i, nonEmpty(value));
+    } else {
+      appendField(i, column.field_, context, stream_info);
+    }
+  }
+  builder_.finishRecord();
+
+  if (builder_.full()) {
+    writeBlock();
+  } else if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(config_->block_flush_interval_);
+  }
+}
+
+void BinaryFileAccessLog::ThreadLocalLogger::appendField(
+    size_t column, ColumnField field, const Formatter::HttpFormatterContext& context,
+    const StreamInfo::StreamInfo& stream_info) {
+  switch (field) {
+  case BinaryFileAccessLogProto::Column::START_TIME:
+    builder_.appendTimestamp(column, toMicros(stream_info.startTime().time_since_epoch()));
+    return;
+  case BinaryFileAccessLogProto::Column::DURATION: {
+    const auto duration = stream_info.currentDuration();
+    builder_.appendUint64(column, duration.has_value()
+                                      ? absl::make_optional<uint64_t>(toMicros(duration.value()))
+                                      : absl::nullopt);
+    return;
+  }
+  case BinaryFileAccessLogProto::Column::RESPONSE_CODE:
+    builder_.appendUint64(column, stream_info.responseCode());
+    return;
+  case BinaryFileAccessLogProto::Column::RESPONSE_FLAGS:
+    builder_.appendUint64(column, stream_info.responseFlags());
+    return;
+  case BinaryFileAccessLogProto::Column::BYTES_RECEIVED:
+    builder_.appendUint64(column, stream_info.bytesReceived());
+    return;
+  case BinaryFileAccessLogProto::Column::BYTES_SENT:
+    builder_.appendUint64(column, stream_info.bytesSent());
+    return;
+  case BinaryFileAccessLogProto::Column::PROTOCOL: {
+    const auto protocol = stream_info.protocol();
+    builder_.appendString(column, protocol.has_value()
+                                      ? absl::make_optional<absl::string_view>(
+                                            Http::Utility::getProtocolString(protocol.value()))
+                                      : absl::nullopt);
+    return;
+  }
+  case BinaryFileAccessLogProto::Column::REQUEST_METHOD:
+    builder_.appendString(column, nonEmpty(context.requestHeaders().getMethodValue()));
+    return;
+  case BinaryFileAccessLogProto::Column::PATH:
+    builder_.appendString(column, nonEmpty(context.requestHeaders().getPathValue()));
+    return;
+  case BinaryFileAccessLogProto::Column::AUTHORITY:
+    builder_.appendString(column, nonEmpty(context.requestHeaders().getHostValue()));
+    return;
+  case BinaryFileAccessLogProto::Column::USER_AGENT:
+    builder_.appendString(column, nonEmpty(context.requestHeaders().getUserAgentValue()));
+    return;
+  case BinaryFileAccessLogProto::Column::REQUEST_ID:
+    builder_.appendString(column, nonEmpty(context.requestHeaders().getRequestIdValue()));
+    return;
+  case BinaryFileAccessLogProto::Column::DOWNSTREAM_REMOTE_ADDRESS: {
+    const auto& address = stream_info.downstreamAddressProvider().remoteAddress();
+    builder_.appendString(column, address != nullptr
+                                      ? absl::make_optional(address->asStringView())
+                                      : absl::nullopt);
+    return;
+  }
+  case BinaryFileAccessLogProto::Column::UPSTREAM_HOST: {
+    const auto upstream_info = stream_info.upstreamInfo();
+    if (upstream_info.has_value() && upstream_info->upstreamHost() != nullptr) {
+      builder_.appendString(column, upstream_info->upstreamHost()->address()->asStringView());
+    } else {
+      builder_.appendString(column, absl::nullopt);
+    }
+    return;
+  }
+  case BinaryFileAccessLogProto::Column::UPSTREAM_CLUSTER: {
+    const auto cluster_info = stream_info.upstreamClusterInfo();
+    if (cluster_info.has_value() && cluster_info.value() != nullptr) {
+      builder_.appendString(column, nonEmpty(cluster_info.value()->observabilityName()));
+    } else {
+      builder_.appendString(column, absl::nullopt);
+    }
+    return;
+  }
+  case BinaryFileAccessLogProto::Column::ROUTE_NAME:
+    builder_.appendString(column, nonEmpty(stream_info.getRouteName()));
+    return;
+  case BinaryFileAccessLogProto::Column::RESPONSE_CODE_DETAILS: {
+    const auto& details = stream_info.responseCodeDetails();
+    builder_.appendString(column, details.has_value() ? nonEmpty(details.value()) : absl::nullopt);
+    return;
+  }
+  default:
+    break;
+  }
+  // The field is validated by the config, and otherwise encoded as an absent value.
+  builder_.appendString(column, absl::nullopt);
+}
+
+void BinaryFileAccessLog::ThreadLocalLogger::writeBlock() {
+  flush_timer_->disableTimer();
+  if (builder_.empty()) {
+    return;
+  }
+  // Blocks are written with a single call, so that they are not split across files by reopening.
+  config_->log_file_->write(builder_.finishBlock());
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.h"
+#include "envoy/formatter/substitution_formatter.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+using ColumnField = envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog::
+    Column::Field;
+
+/**
+ * A configured column. Columns have either a field, which is encoded directly, or a formatter.
+ */
+struct ColumnConfig {
+  ColumnField field_;
+  Formatter::FormatterPtr formatter_;
+};
+
+/**
+ * The configuration shared by the per-worker loggers.
+ */
+struct BinaryFileAccessLogConfig {
+  std::vector<ColumnConfig> columns_;
+  Schema schema_;
+  AccessLog::AccessLogFileSharedPtr log_file_;
+  uint64_t block_size_;
+  uint32_t compression_level_;
+  std::chrono::milliseconds block_flush_interval_;
+};
+
+using BinaryFileAccessLogConfigConstSharedPtr = std::shared_ptr<const BinaryFileAccessLogConfig>;
+
+/**
+ * Access log Instance that writes records in the columnar block format to a file. Each worker
+ * encodes records into its own block, which is written to the file once it is full, or once the
+ * flush interval elapsed.
+ */
+class BinaryFileAccessLog : public Common::ImplBase {
+public:
+  BinaryFileAccessLog(AccessLog::FilterPtr&& filter,
+                      BinaryFileAccessLogConfigConstSharedPtr config,
+                      ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return the type of the values of a field.
+   */
+  static ColumnType columnType(ColumnField field);
+
+private:
+  /**
+   * Per-thread logger, which owns the block that is being filled.
+   */
+  class ThreadLocalLogger : public ThreadLocal::ThreadLocalObject {
+  public:
+    ThreadLocalLogger(BinaryFileAccessLogConfigConstSharedPtr config,
+                      Event::Dispatcher& dispatcher);
+    ~ThreadLocalLogger() override;
+
+    void log(const Formatter::HttpFormatterContext& context,
+             const StreamInfo::StreamInfo& stream_info);
+
+  private:
+    void appendField(size_t column, ColumnField field,
+                     const Formatter::HttpFormatterContext& context,
+                     const StreamInfo::StreamInfo& stream_info);
+    void writeBlock();
+
+    const BinaryFileAccessLogConfigConstSharedPtr config_;
+    BlockBuilder builder_;
+    const Event::TimerPtr flush_timer_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info,
+               AccessLog::AccessLogType access_log_type) override;
+
+  const ThreadLocal::TypedSlotPtr<ThreadLocalLogger> tls_slot_;
+};
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,331 @@
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+
+#include <limits>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/json/json_streamer.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "zstd.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+void appendVarint(std::string& output, uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+bool readVarint(absl::string_view& input, uint64_t& value) {
+  value = 0;
+  for (uint32_t shift = 0; shift < 64 && !input.empty(); shift += 7) {
+    const uint8_t byte = input[0];
+    input.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void writeLittleEndian32(char* output, uint32_t value) {
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    output[i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+uint32_t readLittleEndian32(const char* input) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    value |= static_cast<uint32_t>(static_cast<uint8_t>(input[i])) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t zigzagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace
+
+BlockBuilder::BlockBuilder(Schema schema, uint64_t block_size, uint32_t compression_level)
+    : schema_(std::move(schema)), block_size_(block_size), compression_level_(compression_level),
+      columns_(schema_.size()),
+      zstd_context_(compression_level > 0 ? ZSTD_createCCtx() : nullptr, ZSTD_freeCCtx) {
+  RELEASE_ASSERT(compression_level == 0 || zstd_context_ != nullptr,
+                 "failed to create zstd context");
+  for (Column& column : columns_) {
+    column.data_.reserve(block_size / schema_.size());
+  }
+  payload_.reserve(block_size);
+}
+
+BlockBuilder::~BlockBuilder() = default;
+
+void BlockBuilder::appendUint64(size_t column, absl::optional<uint64_t> value) {
+  std::string& data = columns_[column].data_;
+  const size_t size = data.size();
+  if (value.has_value()) {
+    appendVarint(data, std::min(value.value(), std::numeric_limits<uint64_t>::max() - 1) + 1);
+  } else {
+    data.push_back(0);
+  }
+  encoded_size_ += data.size() - size;
+}
+
+void BlockBuilder::appendTimestamp(size_t column, absl::optional<int64_t> micros) {
+  Column& state = columns_[column];
+  const size_t size = state.data_.size();
+  if (micros.has_value()) {
+    appendVarint(state.data_, zigzagEncode(micros.value() - state.previous_timestamp_) + 1);
+    state.previous_timestamp_ = micros.value();
+  } else {
+    state.data_.push_back(0);
+  }
+  encoded_size_ += state.data_.size() - size;
+}
+
+void BlockBuilder::appendString(size_t column, absl::optional<absl::string_view> value) {
+  std::string& data = columns_[column].data_;
+  const size_t size = data.size();
+  if (value.has_value()) {
+    appendVarint(data, value->size() + 1);
+    data.append(value->data(), value->size());
+  } else {
+    data.push_back(0);
+  }
+  encoded_size_ += data.size() - size;
+}
+
+absl::string_view BlockBuilder::finishBlock() {
+  payload_.clear();
+  appendVarint(payload_, schema_.size());
+  for (const ColumnSchema& column : schema_) {
+    payload_.push_back(static_cast<char>(column.type_));
+    appendVarint(payload_, column.name_.size());
+    payload_.append(column.name_);
+  }
+  for (Column& column : columns_) {
+    appendVarint(payload_, column.data_.size());
+    payload_.append(column.data_);
+    column.data_.clear();
+    column.previous_timestamp_ = 0;
+  }
+
+  BlockCompression compression;
+  if (zstd_context_ != nullptr) {
+    compression = BlockCompression::Zstd;
+    const size_t bound = ZSTD_compressBound(payload_.size());
+    block_.resize(BlockHeader::Size + bound);
+    const size_t stored_size =
+        ZSTD_compressCCtx(zstd_context_.get(), block_.data() + BlockHeader::Size, bound,
+                          payload_.data(), payload_.size(), compression_level_);
+    // The output buffer is large enough for any input, so this only fails on memory allocation
+    // failures.
+    RELEASE_ASSERT(!ZSTD_isError(stored_size),
+                   fmt::format("zstd compression failed: {}", ZSTD_getErrorName(stored_size)));
+    block_.resize(BlockHeader::Size + stored_size);
+  } else {
+    compression = BlockCompression::None;
+    block_.resize(BlockHeader::Size);
+    block_.append(payload_);
+  }
+
+  char* header = block_.data();
+  BlockHeader::Magic.copy(header, BlockHeader::Magic.size());
+  header[4] = static_cast<char>(BlockHeader::Version);
+  header[5] = static_cast<char>(compression);
+  header[6] = 0;
+  header[7] = 0;
+  writeLittleEndian32(header + 8, record_count_);
+  writeLittleEndian32(header + 12, payload_.size());
+  writeLittleEndian32(header + 16, block_.size() - BlockHeader::Size);
+
+  record_count_ = 0;
+  encoded_size_ = 0;
+  return block_;
+}
+
+absl::StatusOr<bool> BlockReader::next() {
+  if (remaining_.empty()) {
+    return false;
+  }
+  if (remaining_.size() < BlockHeader::Size) {
+    return absl::InvalidArgumentError("truncated block header");
+  }
+  if (!absl::StartsWith(remaining_, BlockHeader::Magic)) {
+    return absl::InvalidArgumentError("invalid block magic");
+  }
+  const uint32_t version = static_cast<uint8_t>(remaining_[4]);
+  if (version != BlockHeader::Version) {
+    return absl::InvalidArgumentError(absl::StrCat("unsupported block version ", version));
+  }
+  const uint32_t compression = static_cast<uint8_t>(remaining_[5]);
+  const uint32_t record_count = readLittleEndian32(remaining_.data() + 8);
+  const uint32_t payload_size = readLittleEndian32(remaining_.data() + 12);
+  const uint32_t stored_size = readLittleEndian32(remaining_.data() + 16);
+  if (remaining_.size() - BlockHeader::Size < stored_size) {
+    return absl::InvalidArgumentError("truncated block");
+  }
+  if (payload_size > BlockHeader::MaxPayloadSize) {
+    return absl::InvalidArgumentError(absl::StrCat("payload too large: ", payload_size));
+  }
+  const absl::string_view stored = remaining_.substr(BlockHeader::Size, stored_size);
+  remaining_.remove_prefix(BlockHeader::Size + stored_size);
+
+  switch (static_cast<BlockCompression>(compression)) {
+  case BlockCompression::None:
+    if (stored_size != payload_size) {
+      return absl::InvalidArgumentError("payload size mismatch");
+    }
+    payload_.assign(stored.data(), stored.size());
+    break;
+  case BlockCompression::Zstd: {
+    // The frame records the size of its content, so a mismatch is detected before allocating.
+    if (ZSTD_getFrameContentSize(stored.data(), stored.size()) != payload_size) {
+      return absl::InvalidArgumentError("payload size mismatch");
+    }
+    payload_.resize(payload_size);
+    const size_t result =
+        ZSTD_decompress(payload_.data(), payload_.size(), stored.data(), stored.size());
+    if (ZSTD_isError(result)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("zstd decompression failed: ", ZSTD_getErrorName(result)));
+    }
+    if (result != payload_size) {
+      return absl::InvalidArgumentError("payload size mismatch");
+    }
+    break;
+  }
+  default:
+    return absl::InvalidArgumentError(absl::StrCat("unsupported block compression ", compression));
+  }
+
+  record_count_ = record_count;
+  const absl::Status status = decodePayload(payload_);
+  if (!status.ok()) {
+    return status;
+  }
+  return true;
+}
+
+absl::Status BlockReader::decodePayload(absl::string_view payload) {
+  schema_.clear();
+  columns_.clear();
+
+  uint64_t column_count;
+  // Each column takes at least 3 bytes, which bounds the count before allocating.
+  if (!readVarint(payload, column_count) || column_count == 0 ||
+      column_count > payload.size() / 3) {
+    return absl::InvalidArgumentError("invalid column count");
+  }
+  for (uint64_t i = 0; i < column_count; ++i) {
+    uint64_t name_size;
+    if (payload.empty()) {
+      return absl::InvalidArgumentError("truncated schema");
+    }
+    const auto type = static_cast<ColumnType>(payload[0]);
+    payload.remove_prefix(1);
+    if (type != ColumnType::Uint64 && type != ColumnType::Timestamp && type != ColumnType::String) {
+      return absl::InvalidArgumentError("invalid column type");
+    }
+    if (!readVarint(payload, name_size) || name_size > payload.size()) {
+      return absl::InvalidArgumentError("truncated schema");
+    }
+    schema_.push_back({std::string(payload.substr(0, name_size)), type});
+    payload.remove_prefix(name_size);
+  }
+
+  columns_.resize(column_count);
+  for (uint64_t i = 0; i < column_count; ++i) {
+    uint64_t size;
+    if (!readVarint(payload, size) || size > payload.size()) {
+      return absl::InvalidArgumentError("truncated column");
+    }
+    absl::string_view data = payload.substr(0, size);
+    payload.remove_prefix(size);
+    // Each value takes at least one byte.
+    if (record_count_ > data.size()) {
+      return absl::InvalidArgumentError("truncated column");
+    }
+
+    std::vector<Value>& values = columns_[i];
+    values.reserve(record_count_);
+    int64_t previous_timestamp = 0;
+    for (uint32_t record = 0; record < record_count_; ++record) {
+      uint64_t encoded;
+      if (!readVarint(data, encoded)) {
+        return absl::InvalidArgumentError("truncated column");
+      }
+      if (encoded == 0) {
+        values.emplace_back(absl::monostate());
+        continue;
+      }
+      switch (schema_[i].type_) {
+      case ColumnType::Uint64:
+        values.emplace_back(encoded - 1);
+        break;
+      case ColumnType::Timestamp:
+        previous_timestamp += zigzagDecode(encoded - 1);
+        values.emplace_back(absl::FromUnixMicros(previous_timestamp));
+        break;
+      case ColumnType::String:
+        if (encoded - 1 > data.size()) {
+          return absl::InvalidArgumentError("truncated column");
+        }
+        values.emplace_back(data.substr(0, encoded - 1));
+        data.remove_prefix(encoded - 1);
+        break;
+      }
+    }
+    if (!data.empty()) {
+      return absl::InvalidArgumentError("trailing column data");
+    }
+  }
+  if (!payload.empty()) {
+    return absl::InvalidArgumentError("trailing payload data");
+  }
+  return absl::OkStatus();
+}
+
+void BlockReader::recordsToJson(Buffer::Instance& output) const {
+  for (uint32_t record = 0; record < record_count_; ++record) {
+    {
+      Json::Streamer streamer(output);
+      Json::Streamer::MapPtr map = streamer.makeRootMap();
+      for (size_t column = 0; column < schema_.size(); ++column) {
+        const Value& value = columns_[column][record];
+        if (absl::holds_alternative<absl::monostate>(value)) {
+          continue;
+        }
+        map->addKey(schema_[column].name_);
+        if (const uint64_t* number = absl::get_if<uint64_t>(&value)) {
+          map->addNumber(*number);
+        } else if (const absl::Time* time = absl::get_if<absl::Time>(&value)) {
+          map->addString(absl::FormatTime("%Y-%m-%dT%H:%M:%E6SZ", *time, absl::UTCTimeZone()));
+        } else {
+          map->addString(absl::get<absl::string_view>(value));
+        }
+      }
+    }
+    output.add("\n", 1);
+  }
+}
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
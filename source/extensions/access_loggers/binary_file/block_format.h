@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
+
+// Forward declared so that users of the block format do not depend on the zstd headers.
+struct ZSTD_CCtx_s;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+/**
+ * The type of the values of a column, which determines how they are encoded. All encodings reserve
+ * a leading zero varint for absent values.
+ */
+enum class ColumnType : uint8_t {
+  // Unsigned integer, encoded as the varint of the value plus one.
+  Uint64 = 1,
+  // Microseconds since the Unix epoch, encoded as the varint of the zigzag encoded difference to
+  // the previous present value of the column in the block, plus one.
+  Timestamp = 2,
+  // Byte string, encoded as the varint of the length plus one, followed by the bytes.
+  String = 3,
+};
+
+struct ColumnSchema {
+  std::string name_;
+  ColumnType type_;
+};
+
+using Schema = std::vector<ColumnSchema>;
+
+/**
+ * An access log file is a sequence of blocks, which each start with a fixed size header:
+ *
+ *   magic "EBAL" | version (1 byte) | compression (1 byte) | reserved (2 bytes) |
+ *   record count (4 bytes) | payload length (4 bytes) | stored payload length (4 bytes)
+ *
+ * All integers are little endian. The header is followed by the stored payload, which is the
+ * payload compressed as a single zstd frame, or the payload itself if compression is disabled.
+ * The payload contains the schema, i.e. the number of columns followed by the type, name length
+ * and name of each column, and then for each column the length of its encoded values followed by
+ * the values of all records. The counts and lengths in the payload are varints.
+ */
+struct BlockHeader {
+  static constexpr absl::string_view Magic = "EBAL";
+  static constexpr uint8_t Version = 1;
+  static constexpr size_t Size = 20;
+  // The largest payload a reader accepts, which bounds the memory a corrupt header can make it
+  // allocate. Blocks are written once they reach the configured size of at most 128KiB, so only a
+  // single record larger than this would exceed it.
+  static constexpr uint32_t MaxPayloadSize = 64 * 1024 * 1024;
+};
+
+enum class BlockCompression : uint8_t {
+  None = 0,
+  Zstd = 1,
+};
+
+/**
+ * Collects records column by column, and encodes them into a block. The buffers are kept and
+ * reused across blocks, so that encoding records does not allocate once the first blocks were
+ * written. Not thread safe.
+ */
+class BlockBuilder {
+public:
+  /**
+   * @param schema the columns of the records.
+   * @param block_size the size of the encoded values at which the block is considered full.
+   * @param compression_level the zstd compression level, or 0 to disable compression.
+   */
+  BlockBuilder(Schema schema, uint64_t block_size, uint32_t compression_level);
+  ~BlockBuilder();
+
+  /**
+   * Append a value of the current record to a column. Exactly one value must be appended to each
+   * column for a record, in any order, and then the record must be finished with finishRecord().
+   */
+  void appendUint64(size_t column, absl::optional<uint64_t> value);
+  void appendTimestamp(size_t column, absl::optional<int64_t> micros);
+  void appendString(size_t column, absl::optional<absl::string_view> value);
+  void finishRecord() { ++record_count_; }
+
+  /**
+   * @return whether the encoded records reached the block size.
+   */
+  bool full() const { return encoded_size_ >= block_size_; }
+  bool empty() const { return record_count_ == 0; }
+  const Schema& schema() const { return schema_; }
+
+  /**
+   * Encode the records into a block, and start a new, empty block.
+   * @return the encoded block, which is valid until the next call to finishBlock().
+   */
+  absl::string_view finishBlock();
+
+private:
+  struct Column {
+    std::string data_;
+    // The previous present value of a timestamp column.
+    int64_t previous_timestamp_{0};
+  };
+
+  const Schema schema_;
+  const uint64_t block_size_;
+  const uint32_t compression_level_;
+  std::vector<Column> columns_;
+  uint64_t encoded_size_{0};
+  uint32_t record_count_{0};
+  std::string payload_;
+  std::string block_;
+  std::unique_ptr<ZSTD_CCtx_s, size_t (*)(ZSTD_CCtx_s*)> zstd_context_;
+};
+
+/**
+ * A decoded value. Absent values are represented by absl::monostate.
+ */
+using Value = absl::variant<absl::monostate, uint64_t, absl::Time, absl::string_view>;
+
+/**
+ * Decodes the blocks of an access log file, one at a time.
+ */
+class BlockReader {
+public:
+  /**
+   * @param data the contents of the file, which must outlive the reader.
+   */
+  explicit BlockReader(absl::string_view data) : remaining_(data) {}
+
+  /**
+   * Decode the next block.
+   * @return true if a block was decoded, false if the end of the data was reached, or an error if
+   *         the data is not a valid block.
+   */
+  absl::StatusOr<bool> next();
+
+  const Schema& schema() const { return schema_; }
+  uint32_t recordCount() const { return record_count_; }
+
+  /**
+   * @return the value of a column of a record of the last decoded block. Strings are valid until
+   *         the next call to next().
+   */
+  const Value& value(uint32_t record, size_t column) const { return columns_[column][record]; }
+
+  /**
+   * Append the records of the last decoded block as JSON objects, one per line. Absent values
+   * are omitted, and timestamps are formatted as RFC 3339 strings.
+   */
+  void recordsToJson(Buffer::Instance& output) const;
+
+private:
+  absl::Status decodePayload(absl::string_view payload);
+
+  absl::string_view remaining_;
+  std::string payload_;
+  Schema schema_;
+  uint32_t record_count_{0};
+  std::vector<std::vector<Value>> columns_;
+};
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,99 @@
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/access_log/access_log_manager_impl.h"
+#include "source/common/formatter/substitution_format_string.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/access_loggers/binary_file/binary_file_access_log_impl.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+
+namespace {
+
+// The largest block_size_bytes the config accepts. Blocks, which are slightly larger than this
+// when not compressed, are written with a single write into the ring of the worker in the access
+// log file, so they must fit alongside the data not flushed yet to avoid its locked overflow path.
+constexpr uint64_t MaxBlockSize = 128 * 1024;
+static_assert(2 * MaxBlockSize <= AccessLog::AccessLogFileImpl::RING_SIZE,
+              "binary access log blocks must fit into the access log file ring");
+
+} // namespace
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::ListenerAccessLogFactoryContext& context) {
+  return createAccessLogInstance(
+      config, std::move(filter),
+      static_cast<Server::Configuration::CommonFactoryContext&>(context));
+}
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::CommonFactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog&>(
+      config, context.messageValidationVisitor());
+
+  auto log_config = std::make_shared<BinaryFileAccessLogConfig>();
+  absl::flat_hash_set<std::string> names;
+  for (const auto& column : proto_config.columns()) {
+    if (!names.insert(column.name()).second) {
+      throw EnvoyException(
+          fmt::format("binary file access log: duplicate column name '{}'", column.name()));
+    }
+    ColumnConfig& column_config = log_config->columns_.emplace_back();
+    column_config.field_ = column.field();
+    if (column.value_specifier_case() == envoy::extensions::access_loggers::binary_file::v3::
+                                             BinaryFileAccessLog::Column::kFormat) {
+      envoy::config::core::v3::SubstitutionFormatString sff_config;
+      sff_config.set_text_format(column.format());
+      sff_config.set_omit_empty_values(true);
+      column_config.formatter_ =
+          Formatter::SubstitutionFormatStringUtils::fromProtoConfig(sff_config, context);
+      log_config->schema_.push_back({column.name(), ColumnType::String});
+    } else {
+      log_config->schema_.push_back(
+          {column.name(), BinaryFileAccessLog::columnType(column.field())});
+    }
+  }
+  log_config->block_size_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, block_size_bytes, 64 * 1024);
+  // Enforced by the proto validation.
+  ASSERT(log_config->block_size_ <= MaxBlockSize);
+  log_config->compression_level_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, compression_level, 3);
+  log_config->block_flush_interval_ = std::chrono::milliseconds(
+      PROTOBUF_GET_MS_OR_DEFAULT(proto_config, block_flush_interval, 1000));
+  log_config->log_file_ = context.accessLogManager().createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, proto_config.path()});
+
+  return std::make_shared<BinaryFileAccessLog>(std::move(filter), std::move(log_config),
+                                               context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr BinaryFileAccessLogFactory::createEmptyConfigProto() {
+  return ProtobufTypes::MessagePtr{
+      new envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog()};
+}
+
+std::string BinaryFileAccessLogFactory::name() const { return "envoy.access_loggers.binary_file"; }
+
+/**
+ * Static registration for the binary file access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(BinaryFileAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
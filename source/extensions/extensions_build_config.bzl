@@ -4,6 +4,7 @@ EXTENSIONS = {
     # Access loggers
     #
 
+    "envoy.access_loggers.binary_file":                 "//source/extensions/access_loggers/binary_file:config",
     "envoy.access_loggers.file":                        "//source/extensions/access_loggers/file:config",
     "envoy.access_loggers.extension_filters.cel":       "//source/extensions/access_loggers/filters/cel:config",
     "envoy.access_loggers.http_grpc":                   "//source/extensions/access_loggers/grpc:http_config",
@@ -421,6 +422,13 @@ EXTENSIONS = {
     # getaddrinfo DNS resolver extension can be used when the system resolver is desired (e.g., Android)
     "envoy.network.dns_resolver.getaddrinfo":          "//source/extensions/network/dns_resolver/getaddrinfo:config",
 
+    #
+    # Socket interface extensions
+    #
+
+    # io_uring socket interface is only supported on Linux.
+    "envoy.extensions.network.socket_interface.io_uring": "//source/extensions/network/socket_interface/io_uring:config",
+
     #
     # Custom matchers
     #
@@ -454,6 +462,8 @@ EXTENSIONS = {
     "envoy.load_balancing_policies.ring_hash":         "//source/extensions/load_balancing_policies/ring_hash:config",
     "envoy.load_balancing_policies.subset":            "//source/extensions/load_balancing_policies/subset:config",
     "envoy.load_balancing_policies.cluster_provided":  "//source/extensions/load_balancing_policies/cluster_provided:config",
+    "envoy.load_balancing_policies.worker_least_request": "//source/extensions/load_balancing_policies/worker_least_request:config",
+    "envoy.load_balancing_policies.peak_ewma":         "//source/extensions/load_balancing_policies/peak_ewma:config",
 
     #
     # HTTP Early Header Mutation
@@ -0,0 +1,181 @@
+#include "source/extensions/filters/http/cache/background_revalidator.h"
+
+#include "envoy/http/async_client.h"
+
+#include "source/common/common/enum_to_int.h"
+#include "source/common/http/message_impl.h"
+#include "source/common/http/utility.h"
+#include "source/extensions/filters/http/cache/cache_custom_headers.h"
+#include "source/extensions/filters/http/cache/cache_insert_queue.h"
+#include "source/extensions/filters/http/cache/cacheability_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+// A validation request in flight. Owns itself until the request completes, as it outlives the
+// stream of the request which found the stale response.
+class BackgroundRevalidator::Revalidation : public Http::AsyncClient::Callbacks,
+                                            public Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  Revalidation(std::shared_ptr<BackgroundRevalidator> revalidator, const Key& key,
+               const Http::ResponseHeaderMap& cached_headers, std::shared_ptr<HttpCache> cache,
+               LookupContextPtr&& lookup_context, InsertContextPtr&& insert_context,
+               Event::Dispatcher& dispatcher)
+      : revalidator_(std::move(revalidator)), key_(key),
+        cached_status_(cached_headers.getStatusValue()),
+        cached_etag_(cached_headers.getInlineValue(CacheCustomHeaders::etag())),
+        cache_(std::move(cache)), lookup_context_(std::move(lookup_context)),
+        insert_context_(std::move(insert_context)), dispatcher_(dispatcher) {}
+
+  ~Revalidation() override {
+    lookup_context_->onDestroy();
+    if (insert_context_ != nullptr) {
+      insert_context_->onDestroy();
+    }
+    revalidator_->complete(key_);
+  }
+
+  void start(Upstream::ThreadLocalCluster& cluster, Http::RequestMessagePtr&& request,
+             absl::optional<std::chrono::milliseconds> timeout,
+             std::unique_ptr<Revalidation> self) {
+    self_ownership_ = std::move(self);
+    // The request may fail inline, which deletes this.
+    cluster.httpAsyncClient().send(std::move(request), *this,
+                                   Http::AsyncClient::RequestOptions().setTimeout(timeout));
+  }
+
+  // Http::AsyncClient::Callbacks
+  void onSuccess(const Http::AsyncClient::Request&, Http::ResponseMessagePtr&& response) override {
+    Http::ResponseHeaderMap& response_headers = response->headers();
+    if (Http::Utility::getResponseStatus(response_headers) ==
+            enumToInt(Http::Code::NotModified) &&
+        etagMatches(response_headers)) {
+      ENVOY_LOG(debug, "background revalidation of {} not modified, updating headers",
+                key_.path());
+      // The cached response keeps its status, as the headers of the 304 response replace the
+      // cached headers.
+      response_headers.setStatus(cached_status_);
+      const ResponseMetadata metadata = {revalidator_->time_source_.systemTime()};
+      cache_->updateHeaders(*lookup_context_, response_headers, metadata,
+                            [](bool updated ABSL_ATTRIBUTE_UNUSED) {});
+      revalidator_->stats_.background_revalidations_not_modified_.inc();
+    } else {
+      ENVOY_LOG(debug, "background revalidation of {} returned {}", key_.path(),
+                response_headers.getStatusValue());
+      revalidator_->stats_.background_revalidations_modified_.inc();
+      if (insert_context_ != nullptr &&
+          CacheabilityUtils::isCacheableResponse(response_headers,
+                                                 revalidator_->vary_allow_list_)) {
+        insert(*response);
+      }
+    }
+    self_ownership_.reset();
+  }
+  void onFailure(const Http::AsyncClient::Request&, Http::AsyncClient::FailureReason) override {
+    ENVOY_LOG(debug, "background revalidation of {} failed", key_.path());
+    revalidator_->stats_.background_revalidations_failed_.inc();
+    self_ownership_.reset();
+  }
+  void onBeforeFinalizeUpstreamSpan(Tracing::Span&, const Http::ResponseHeaderMap*) override {}
+
+private:
+  // Replaces the cached response through the same queue as the inserts of the filter, which
+  // outlives this validation until the cache has received the whole response.
+  void insert(Http::ResponseMessage& response) {
+    const Http::ResponseTrailerMap* trailers = response.trailers();
+    const bool headers_end_stream = response.body().length() == 0 && trailers == nullptr;
+    auto queue =
+        std::make_unique<CacheInsertQueue>(cache_, dispatcher_, std::move(insert_context_));
+    const ResponseMetadata metadata = {revalidator_->time_source_.systemTime()};
+    queue->insertHeaders(response.headers(), metadata, headers_end_stream);
+    if (response.body().length() > 0) {
+      queue->insertBody(response.body(), trailers == nullptr);
+    }
+    if (trailers != nullptr) {
+      queue->insertTrailers(*trailers);
+    }
+    CacheInsertQueue& started = *queue;
+    started.setSelfOwned(std::move(queue));
+    revalidator_->stats_.background_revalidations_inserted_.inc();
+  }
+
+  // According to: https://httpwg.org/specs/rfc7234.html#freshening.responses,
+  // a 304 response with a strong validator that does not match the cached response does not
+  // update it.
+  bool etagMatches(const Http::ResponseHeaderMap& response_headers) const {
+    const Http::HeaderEntry* response_etag = response_headers.getInline(CacheCustomHeaders::etag());
+    return !response_etag || (!cached_etag_.empty() &&
+                              cached_etag_ == response_etag->value().getStringView());
+  }
+
+  const std::shared_ptr<BackgroundRevalidator> revalidator_;
+  const Key key_;
+  const std::string cached_status_;
+  const std::string cached_etag_;
+  const std::shared_ptr<HttpCache> cache_;
+  const LookupContextPtr lookup_context_;
+  InsertContextPtr insert_context_;
+  Event::Dispatcher& dispatcher_;
+  std::unique_ptr<Revalidation> self_ownership_;
+};
+
+BackgroundRevalidator::BackgroundRevalidator(
+    Upstream::ClusterManager& cluster_manager, TimeSource& time_source,
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& allowed_vary_headers,
+    const std::string& stats_prefix, Stats::Scope& scope)
+    : cluster_manager_(cluster_manager), time_source_(time_source),
+      vary_allow_list_(allowed_vary_headers),
+      stats_({ALL_BACKGROUND_REVALIDATION_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix),
+                                                POOL_GAUGE_PREFIX(scope, stats_prefix))}) {}
+
+bool BackgroundRevalidator::revalidate(const Key& key, absl::string_view cluster_name,
+                                       absl::optional<std::chrono::milliseconds> timeout,
+                                       Http::RequestHeaderMapPtr&& request_headers,
+                                       const Http::ResponseHeaderMap& cached_headers,
+                                       std::shared_ptr<HttpCache> cache,
+                                       LookupContextPtr&& lookup_context,
+                                       InsertContextPtr&& insert_context,
+                                       Event::Dispatcher& dispatcher) {
+  Upstream::ThreadLocalCluster* cluster = cluster_manager_.getThreadLocalCluster(cluster_name);
+  if (cluster == nullptr) {
+    lookup_context->onDestroy();
+    if (insert_context != nullptr) {
+      insert_context->onDestroy();
+    }
+    return false;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!in_flight_.insert(key).second) {
+      // The response is already being validated.
+      lookup_context->onDestroy();
+      if (insert_context != nullptr) {
+        insert_context->onDestroy();
+      }
+      return true;
+    }
+  }
+  stats_.background_revalidations_.inc();
+  stats_.background_revalidations_active_.inc();
+
+  auto revalidation = std::make_unique<Revalidation>(
+      shared_from_this(), key, cached_headers, std::move(cache), std::move(lookup_context),
+      std::move(insert_context), dispatcher);
+  Revalidation& started = *revalidation;
+  started.start(*cluster, std::make_unique<Http::RequestMessageImpl>(std::move(request_headers)),
+                timeout, std::move(revalidation));
+  return true;
+}
+
+void BackgroundRevalidator::complete(const Key& key) {
+  stats_.background_revalidations_active_.dec();
+  absl::MutexLock lock(&mutex_);
+  in_flight_.erase(key);
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
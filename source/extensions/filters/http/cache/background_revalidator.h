@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All background revalidation stats. @see stats_macros.h
+ */
+#define ALL_BACKGROUND_REVALIDATION_STATS(COUNTER, GAUGE)                                          \
+  COUNTER(background_revalidations)                                                                \
+  COUNTER(background_revalidations_failed)                                                         \
+  COUNTER(background_revalidations_inserted)                                                       \
+  COUNTER(background_revalidations_modified)                                                       \
+  COUNTER(background_revalidations_not_modified)                                                   \
+  GAUGE(background_revalidations_active, Accumulate)
+
+/**
+ * Struct definition for all background revalidation stats. @see stats_macros.h
+ */
+struct BackgroundRevalidationStats {
+  ALL_BACKGROUND_REVALIDATION_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// Validates stale cached responses which are served while they are being revalidated, as allowed
+// by stale-while-revalidate, see https://httpwg.org/specs/rfc5861.html. Validation requests are
+// sent through the async client of the cluster of the request. A 304 Not Modified response
+// updates the headers of the cached response in place, and a cacheable response replaces it. At
+// most one validation of each key is in flight, across all workers.
+class BackgroundRevalidator : public std::enable_shared_from_this<BackgroundRevalidator> {
+public:
+  BackgroundRevalidator(Upstream::ClusterManager& cluster_manager, TimeSource& time_source,
+                        const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>&
+                            allowed_vary_headers,
+                        const std::string& stats_prefix, Stats::Scope& scope);
+
+  /**
+   * Starts the validation of a stale cached response. Must be called on a worker thread.
+   * @param key the cache key of the response.
+   * @param cluster_name the cluster which the validation request is sent to.
+   * @param timeout the timeout of the validation request, if any.
+   * @param request_headers the headers of the validation request, which include the validators of
+   *        the cached response.
+   * @param cached_headers the headers of the cached response.
+   * @param cache the cache which holds the response.
+   * @param lookup_context a lookup context for the key, which is used to update the response.
+   * @param insert_context an insert context for the key, if the cache made one, which is used to
+   *        replace the response.
+   * @param dispatcher the dispatcher of the worker thread, which runs the insert.
+   * @return true if the response is being validated, including by an earlier call for the same
+   *         key, or false if the cluster does not exist.
+   */
+  bool revalidate(const Key& key, absl::string_view cluster_name,
+                  absl::optional<std::chrono::milliseconds> timeout,
+                  Http::RequestHeaderMapPtr&& request_headers,
+                  const Http::ResponseHeaderMap& cached_headers, std::shared_ptr<HttpCache> cache,
+                  LookupContextPtr&& lookup_context, InsertContextPtr&& insert_context,
+                  Event::Dispatcher& dispatcher);
+
+  // The lookup requests of the contexts passed to revalidate() must refer to this list, as they
+  // outlive the stream which started the validation.
+  const VaryAllowList& varyAllowList() const { return vary_allow_list_; }
+  BackgroundRevalidationStats& stats() { return stats_; }
+
+private:
+  class Revalidation;
+
+  void complete(const Key& key);
+
+  Upstream::ClusterManager& cluster_manager_;
+  TimeSource& time_source_;
+  const VaryAllowList vary_allow_list_;
+  BackgroundRevalidationStats stats_;
+  absl::Mutex mutex_;
+  absl::flat_hash_set<Key, MessageUtil, MessageUtil> in_flight_ ABSL_GUARDED_BY(mutex_);
+};
+
+using BackgroundRevalidatorSharedPtr = std::shared_ptr<BackgroundRevalidator>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -33,6 +33,9 @@ enum class CacheEntryStatus {
   Unusable,
   // This entry is stale, but appropriate for validating
   RequiresValidation,
+  // This entry is stale, but within its stale-while-revalidate window. It may be served, and
+  // should be validated in the background.
+  StaleWhileRevalidate,
   // This entry is fresh, and an appropriate basis for a 304 Not Modified
   // response.
   FoundNotModified,
@@ -5,6 +5,7 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_custom_headers.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
@@ -33,12 +34,20 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
                          const std::string&, Stats::Scope&, TimeSource& time_source,
-                         std::shared_ptr<HttpCache> http_cache)
+                         std::shared_ptr<HttpCache> http_cache,
+                         RequestCoalescerSharedPtr request_coalescer,
+                         BackgroundRevalidatorSharedPtr background_revalidator)
     : time_source_(time_source), cache_(http_cache),
+      request_coalescer_(std::move(request_coalescer)),
+      coalescing_max_wait_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config.request_coalescing(), max_wait, 5000)),
+      background_revalidator_(std::move(background_revalidator)),
       vary_allow_list_(config.allowed_vary_headers()) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  stopWaitingForInFlightFetch();
+  coalesced_request_.reset();
   if (lookup_ != nullptr) {
     lookup_->onDestroy();
   }
@@ -91,6 +100,9 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (request_coalescer_ != nullptr) {
+    coalescing_key_ = lookup_request.key();
+  }
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -114,6 +126,11 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (coalescing_timer_ != nullptr) {
+    // A local reply was generated while the request was waiting for the fetch of another request.
+    stopWaitingForInFlightFetch();
+  }
+
   if (lookup_result_ == nullptr) {
     // Filter chain iteration is paused while a lookup is outstanding, but the filter chain manager
     // can still generate a local reply. One case where this can happen is when a downstream idle
@@ -126,6 +143,16 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (filter_state_ == FilterState::ValidatingCachedResponse && shouldServeStaleOnError(headers)) {
+    serveStaleOnError(headers);
+    // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
+    if (is_head_request_) {
+      return Http::FilterHeadersStatus::Continue;
+    } else {
+      return Http::FilterHeadersStatus::StopIteration;
+    }
+  }
+
   if (filter_state_ == FilterState::ValidatingCachedResponse && isResponseNotModified(headers)) {
     processSuccessfulValidation(headers);
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
@@ -156,6 +183,9 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
                                              });
       // Add metadata associated with the cached response. Right now this is only response_time;
       const ResponseMetadata metadata = {time_source_.systemTime()};
+      // If the request leads the fetch of its key, the fetch completes once the response has been
+      // inserted, or the insert has been aborted.
+      insert_queue_->setCoalescedRequest(std::move(coalesced_request_));
       insert_queue_->insertHeaders(headers, metadata, end_stream);
     }
     if (end_stream) {
@@ -166,6 +196,9 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
   } else {
     insert_status_ = InsertStatus::NoInsertResponseNotCacheable;
   }
+  // If the response is not inserted, requests waiting for its fetch are released to fetch it
+  // themselves.
+  coalesced_request_.reset();
   filter_state_ = FilterState::NotServingFromCache;
   return Http::FilterHeadersStatus::Continue;
 }
@@ -177,6 +210,10 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     return Http::FilterDataStatus::Continue;
   }
   if (filter_state_ == FilterState::EncodeServingFromCache) {
+    if (served_stale_on_error_) {
+      // The body of the error response is replaced by the cached body.
+      data.drain(data.length());
+    }
     // Stop the encoding stream until the cached response is fetched & added to the encoding stream.
     return Http::FilterDataStatus::StopIterationAndBuffer;
   }
@@ -222,6 +259,8 @@ CacheFilter::resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_st
       return LookupStatus::CacheHit;
     case CacheEntryStatus::Unusable:
       return LookupStatus::CacheMiss;
+    case CacheEntryStatus::StaleWhileRevalidate:
+      return LookupStatus::StaleHitWhileRevalidating;
     case CacheEntryStatus::RequiresValidation: {
       // The CacheFilter sent the response upstream for validation; check the
       // filter state to see whether and how the upstream responded. The
@@ -306,10 +345,12 @@ void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
     dispatcher.post(
         [self, &request_headers, status = result.cache_entry_status_,
          headers = std::move(result.headers_), range_details = std::move(result.range_details_),
-         content_length = result.content_length_, has_trailers = result.has_trailers_]() mutable {
+         content_length = result.content_length_, has_trailers = result.has_trailers_,
+         serve_stale_if_error = result.serve_stale_if_error_]() mutable {
           if (CacheFilterSharedPtr cache_filter = self.lock()) {
             cache_filter->onHeaders(LookupResult{status, std::move(headers), content_length,
-                                                 range_details, has_trailers},
+                                                 range_details, has_trailers,
+                                                 serve_stale_if_error},
                                     request_headers);
           }
         });
@@ -387,6 +428,15 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     // and the cache entry will be injected in the response body.
     handleCacheHitWithValidation(request_headers);
     return;
+  case CacheEntryStatus::StaleWhileRevalidate:
+    if (!revalidateInBackground(request_headers)) {
+      // The response can't be validated in the background, so it's validated before being served.
+      lookup_result_->cache_entry_status_ = CacheEntryStatus::RequiresValidation;
+      handleCacheHitWithValidation(request_headers);
+      return;
+    }
+    // The stale response is served while it's validated in the background.
+    ABSL_FALLTHROUGH_INTENDED;
   case CacheEntryStatus::Ok:
     if (lookup_result_->range_details_.has_value()) {
       handleCacheHitWithRangeRequest();
@@ -395,6 +445,9 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     handleCacheHit();
     return;
   case CacheEntryStatus::Unusable:
+    if (joinInFlightFetch(request_headers)) {
+      return;
+    }
     decoder_callbacks_->continueDecoding();
     return;
   case CacheEntryStatus::LookupError:
@@ -409,6 +462,72 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   decoder_callbacks_->continueDecoding();
 }
 
+bool CacheFilter::joinInFlightFetch(Http::RequestHeaderMap& request_headers) {
+  if (request_coalescer_ == nullptr || joined_in_flight_fetch_ || !request_allows_inserts_ ||
+      is_head_request_) {
+    return false;
+  }
+  ASSERT(coalescing_key_.has_value());
+  joined_in_flight_fetch_ = true;
+
+  // The fetch may complete on another worker, in which case the callback is posted to the
+  // dispatcher of this request, where the filter may have been destroyed in the meantime.
+  CacheFilterWeakPtr self = weak_from_this();
+  coalesced_request_ = request_coalescer_->join(
+      *coalescing_key_, decoder_callbacks_->dispatcher(), [self, &request_headers]() {
+        if (CacheFilterSharedPtr cache_filter = self.lock()) {
+          cache_filter->onInFlightFetchComplete(request_headers);
+        }
+      });
+  if (coalesced_request_->leader()) {
+    // No fetch of the key is in flight, so this request fetches the response.
+    return false;
+  }
+
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for in-flight fetch", *decoder_callbacks_);
+  coalescing_timer_ =
+      decoder_callbacks_->dispatcher().createTimer([this]() { onInFlightFetchTimeout(); });
+  coalescing_timer_->enableTimer(coalescing_max_wait_);
+  return true;
+}
+
+void CacheFilter::onInFlightFetchComplete(Http::RequestHeaderMap& request_headers) {
+  if (filter_state_ == FilterState::Destroyed ||
+      filter_state_ == FilterState::NotServingFromCache || coalescing_timer_ == nullptr) {
+    return;
+  }
+  stopWaitingForInFlightFetch();
+
+  // Look the request up again, which is now served by the response of the completed fetch, if it
+  // was inserted into the cache.
+  ENVOY_STREAM_LOG(debug, "CacheFilter in-flight fetch complete, repeating lookup",
+                   *decoder_callbacks_);
+  lookup_->onDestroy();
+  lookup_result_.reset();
+  lookup_ = cache_->makeLookupContext(
+      LookupRequest(request_headers, time_source_.systemTime(), vary_allow_list_),
+      *decoder_callbacks_);
+  ASSERT(lookup_);
+  getHeaders(request_headers);
+}
+
+void CacheFilter::onInFlightFetchTimeout() {
+  ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for in-flight fetch",
+                   *decoder_callbacks_);
+  request_coalescer_->stats().coalesced_wait_timeouts_.inc();
+  stopWaitingForInFlightFetch();
+  decoder_callbacks_->continueDecoding();
+}
+
+void CacheFilter::stopWaitingForInFlightFetch() {
+  if (coalescing_timer_ != nullptr) {
+    coalescing_timer_->disableTimer();
+    coalescing_timer_.reset();
+    // Only a waiting request has a timer; the request of a leader is kept until its fetch ends.
+    coalesced_request_.reset();
+  }
+}
+
 // TODO(toddmgreer): Handle downstream backpressure.
 void CacheFilter::onBody(Buffer::InstancePtr&& body) {
   // Can be called during decoding if a valid cache hit is found,
@@ -465,6 +584,47 @@ void CacheFilter::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   finalizeEncodingCachedResponse();
 }
 
+bool CacheFilter::revalidateInBackground(const Http::RequestHeaderMap& request_headers) {
+  ASSERT(lookup_result_ &&
+             lookup_result_->cache_entry_status_ == CacheEntryStatus::StaleWhileRevalidate,
+         "revalidateInBackground precondition unsatisfied: lookup_result_ does not point to a "
+         "cache lookup result within its stale-while-revalidate window");
+  if (background_revalidator_ == nullptr) {
+    return false;
+  }
+  Router::RouteConstSharedPtr route = decoder_callbacks_->route();
+  const Router::RouteEntry* route_entry = route == nullptr ? nullptr : route->routeEntry();
+  if (route_entry == nullptr) {
+    return false;
+  }
+
+  // The validation request is a copy of this request with the validators of the cached response.
+  // The whole response is validated, even if only a range of it was requested.
+  Http::RequestHeaderMapPtr validation_headers =
+      Http::createHeaderMap<Http::RequestHeaderMapImpl>(request_headers);
+  validation_headers->remove(Http::Headers::get().Range);
+  injectValidationHeaders(*validation_headers);
+  // The contexts outlive this filter, so their lookup requests refer to the allow list of the
+  // revalidator. One updates the cached response on a 304, the other replaces it otherwise, and
+  // owns the lookup context it is made from.
+  const SystemTime now = time_source_.systemTime();
+  LookupRequest lookup_request(request_headers, now, background_revalidator_->varyAllowList());
+  const Key key = lookup_request.key();
+  LookupContextPtr lookup =
+      cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
+  InsertContextPtr insert = cache_->makeInsertContext(
+      cache_->makeLookupContext(
+          LookupRequest(request_headers, now, background_revalidator_->varyAllowList()),
+          *decoder_callbacks_),
+      *encoder_callbacks_);
+  const std::chrono::milliseconds timeout = route_entry->timeout();
+  return background_revalidator_->revalidate(
+      key, route_entry->clusterName(),
+      timeout.count() > 0 ? absl::make_optional(timeout) : absl::nullopt,
+      std::move(validation_headers), *lookup_result_->headers_, cache_, std::move(lookup),
+      std::move(insert), decoder_callbacks_->dispatcher());
+}
+
 void CacheFilter::handleCacheHit() {
   filter_state_ = FilterState::DecodeServingFromCache;
   insert_status_ = InsertStatus::NoInsertCacheHit;
@@ -574,6 +734,46 @@ void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_
   encodeCachedResponse();
 }
 
+bool CacheFilter::shouldServeStaleOnError(const Http::ResponseHeaderMap& response_headers) const {
+  ASSERT(lookup_result_, "shouldServeStaleOnError precondition unsatisfied: lookup_result_ "
+                         "does not point to a cache lookup result");
+  if (!lookup_result_->serve_stale_if_error_) {
+    return false;
+  }
+  // According to: https://httpwg.org/specs/rfc5861.html#rfc.section.4
+  // an error is a 500, 502, 503 or 504 response, which includes local replies to upstream
+  // connection failures.
+  switch (Http::Utility::getResponseStatus(response_headers)) {
+  case enumToInt(Http::Code::InternalServerError):
+  case enumToInt(Http::Code::BadGateway):
+  case enumToInt(Http::Code::ServiceUnavailable):
+  case enumToInt(Http::Code::GatewayTimeout):
+    return true;
+  default:
+    return false;
+  }
+}
+
+void CacheFilter::serveStaleOnError(Http::ResponseHeaderMap& response_headers) {
+  ASSERT(shouldServeStaleOnError(response_headers),
+         "serveStaleOnError must only be called with error responses to validations of responses "
+         "within their stale-if-error window");
+  filter_state_ = FilterState::EncodeServingFromCache;
+  insert_status_ = InsertStatus::NoInsertCacheHit;
+  served_stale_on_error_ = true;
+
+  // Replace the error response headers with the cached response headers, as the cached response
+  // is served in its place.
+  response_headers.clear();
+  lookup_result_->headers_->iterate([&response_headers](const Http::HeaderEntry& cached_header) {
+    response_headers.addCopy(Http::LowerCaseString(cached_header.key().getStringView()),
+                             cached_header.value().getStringView());
+    return Http::HeaderMap::Iterate::Continue;
+  });
+
+  encodeCachedResponse();
+}
+
 // TODO(yosrym93): Write a test that exercises this when SimpleHttpCache implements updateHeaders
 bool CacheFilter::shouldUpdateCachedEntry(const Http::ResponseHeaderMap& response_headers) const {
   ASSERT(isResponseNotModified(response_headers),
@@ -598,7 +798,8 @@ bool CacheFilter::shouldUpdateCachedEntry(const Http::ResponseHeaderMap& respons
 void CacheFilter::injectValidationHeaders(Http::RequestHeaderMap& request_headers) {
   ASSERT(lookup_result_, "injectValidationHeaders precondition unsatisfied: lookup_result_ "
                          "does not point to a cache lookup result");
-  ASSERT(filter_state_ == FilterState::ValidatingCachedResponse,
+  ASSERT(filter_state_ == FilterState::ValidatingCachedResponse ||
+             lookup_result_->cache_entry_status_ == CacheEntryStatus::StaleWhileRevalidate,
          "injectValidationHeaders precondition unsatisfied: the "
          "CacheFilter is not validating a cache lookup result");
 
@@ -677,6 +878,10 @@ LookupStatus CacheFilter::lookupStatus() const {
     return LookupStatus::RequestIncomplete;
   }
 
+  if (served_stale_on_error_) {
+    return LookupStatus::StaleHitWithValidationError;
+  }
+
   if (lookup_result_ != nullptr) {
     return resolveLookupStatus(lookup_result_->cache_entry_status_, filter_state_);
   } else {
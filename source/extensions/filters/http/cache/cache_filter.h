@@ -8,10 +8,12 @@
 #include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
 
 #include "source/common/common/logger.h"
+#include "source/extensions/filters/http/cache/background_revalidator.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/cache_insert_queue.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -55,7 +57,9 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              std::shared_ptr<HttpCache> http_cache);
+              std::shared_ptr<HttpCache> http_cache,
+              RequestCoalescerSharedPtr request_coalescer = nullptr,
+              BackgroundRevalidatorSharedPtr background_revalidator = nullptr);
   // Http::StreamFilterBase
   void onDestroy() override;
   void onStreamComplete() override;
@@ -82,6 +86,20 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Joins the in-flight fetch of the response if request coalescing is enabled. Returns true if
+  // the request waits for the fetch of another request, in which case it is looked up again
+  // once that fetch completes, or sent upstream once the wait times out.
+  bool joinInFlightFetch(Http::RequestHeaderMap& request_headers);
+  void onInFlightFetchComplete(Http::RequestHeaderMap& request_headers);
+  void onInFlightFetchTimeout();
+  void stopWaitingForInFlightFetch();
+
+  // Precondition: lookup_result_ points to a cache lookup result within its stale-while-revalidate
+  //               window.
+  // Starts validating the cached response in the background. Returns false if the response can't
+  // be validated in the background, in which case it should be validated before being served.
+  bool revalidateInBackground(const Http::RequestHeaderMap& request_headers);
+
   // Set required state in the CacheFilter for handling a cache hit.
   void handleCacheHit();
 
@@ -98,13 +116,23 @@ private:
   // Serves a validated cached response after updating it with a 304 response.
   void processSuccessfulValidation(Http::ResponseHeaderMap& response_headers);
 
+  // Precondition: lookup_result_ points to a cache lookup result that requires validation.
+  //               filter_state_ is ValidatingCachedResponse.
+  // Checks if the cached response may be served in place of an error response to its validation,
+  // as allowed by its stale-if-error directive.
+  bool shouldServeStaleOnError(const Http::ResponseHeaderMap& response_headers) const;
+
+  // Precondition: shouldServeStaleOnError(response_headers).
+  // Replaces the error response to a validation with the cached response.
+  void serveStaleOnError(Http::ResponseHeaderMap& response_headers);
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Checks if a cached entry should be updated with a 304 response.
   bool shouldUpdateCachedEntry(const Http::ResponseHeaderMap& response_headers) const;
 
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
-  // Should only be called during onHeaders as it modifies RequestHeaderMap.
+  // Should only be called during onHeaders as it may modify the RequestHeaderMap of the stream.
   // Adds required conditional headers for cache validation to the request headers
   // according to the present cache lookup result headers.
   void injectValidationHeaders(Http::RequestHeaderMap& request_headers);
@@ -133,6 +161,16 @@ private:
   std::unique_ptr<CacheInsertQueue> insert_queue_;
   TimeSource& time_source_;
   std::shared_ptr<HttpCache> cache_;
+  const RequestCoalescerSharedPtr request_coalescer_;
+  const std::chrono::milliseconds coalescing_max_wait_;
+  const BackgroundRevalidatorSharedPtr background_revalidator_;
+  // The key of the request, only kept if request coalescing is enabled.
+  absl::optional<Key> coalescing_key_;
+  // The request's part in coalescing the fetch of its key, if it leads or waits for a fetch.
+  CoalescedRequestPtr coalesced_request_;
+  Event::TimerPtr coalescing_timer_;
+  // True once the request has joined the fetch of its key, which it does at most once.
+  bool joined_in_flight_fetch_ = false;
   LookupContextPtr lookup_;
   LookupResultPtr lookup_result_;
 
@@ -158,6 +196,8 @@ private:
   FilterState filter_state_ = FilterState::Initial;
 
   bool is_head_request_ = false;
+  // True if the cached response was served in place of an error response to its validation.
+  bool served_stale_on_error_ = false;
   // The status of the insert operation or header update, or decision not to insert or update.
   // If it's too early to determine the final status, this is empty.
   absl::optional<InsertStatus> insert_status_;
@@ -26,6 +26,14 @@ enum class LookupStatus {
   // Modified. The CacheFilter forwards 5xx responses from the
   // upstream in this case, instead of sending the stale cache entry.
   StaleHitWithFailedValidation,
+  // The CacheFilter found a stale response within its stale-while-revalidate
+  // window, served it, and sent a validation request to the upstream in the
+  // background.
+  StaleHitWhileRevalidating,
+  // The CacheFilter found a stale response, and sent a validation request to
+  // the upstream; the upstream responded with an error, and the CacheFilter
+  // served the stale response as allowed by its stale-if-error directive.
+  StaleHitWithValidationError,
   // The CacheFilter found a response in cache and served a 304 Not Modified.
   NotModifiedHit,
   // The request wasn't cacheable, and the CacheFilter didn't try to look it up
@@ -108,6 +108,10 @@ ResponseCacheControl::ResponseCacheControl(absl::string_view cache_control_heade
       max_age_ = parseDuration(argument);
     } else if (!max_age_.has_value() && directive == "max-age") {
       max_age_ = parseDuration(argument);
+    } else if (directive == "stale-while-revalidate") {
+      stale_while_revalidate_ = parseDuration(argument);
+    } else if (directive == "stale-if-error") {
+      stale_if_error_ = parseDuration(argument);
     }
   }
 }
@@ -122,7 +126,9 @@ bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs)
 bool operator==(const ResponseCacheControl& lhs, const ResponseCacheControl& rhs) {
   return (lhs.must_validate_ == rhs.must_validate_) && (lhs.no_store_ == rhs.no_store_) &&
          (lhs.no_transform_ == rhs.no_transform_) && (lhs.no_stale_ == rhs.no_stale_) &&
-         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_);
+         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_) &&
+         (lhs.stale_while_revalidate_ == rhs.stale_while_revalidate_) &&
+         (lhs.stale_if_error_ == rhs.stale_if_error_);
 }
 
 SystemTime CacheHeadersUtils::httpTime(const Http::HeaderEntry* header_entry) {
@@ -89,6 +89,16 @@ struct ResponseCacheControl {
   // max_age is set if to 's-maxage' if present, if not it is set to 'max-age' if present.
   // Indicates the maximum time after which this response will be considered stale
   OptionalDuration max_age_;
+
+  // According to: https://httpwg.org/specs/rfc5861.html#rfc.section.3
+  // This response may be served stale for up to stale-while-revalidate after it becomes stale,
+  // while it is validated in the background
+  OptionalDuration stale_while_revalidate_;
+
+  // According to: https://httpwg.org/specs/rfc5861.html#rfc.section.4
+  // This response may be served stale for up to stale-if-error after it becomes stale, if its
+  // validation fails with an error
+  OptionalDuration stale_if_error_;
 };
 
 bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs);
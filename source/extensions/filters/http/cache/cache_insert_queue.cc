@@ -1,5 +1,7 @@
 #include "source/extensions/filters/http/cache/cache_insert_queue.h"
 
+#include <limits>
+
 #include "source/common/buffer/buffer_impl.h"
 
 namespace Envoy {
@@ -74,6 +76,13 @@ CacheInsertQueue::CacheInsertQueue(std::shared_ptr<HttpCache> cache,
       high_watermark_bytes_(encoder_callbacks.encoderBufferLimit()),
       encoder_callbacks_(encoder_callbacks), abort_callback_(abort), cache_(cache) {}
 
+CacheInsertQueue::CacheInsertQueue(std::shared_ptr<HttpCache> cache, Event::Dispatcher& dispatcher,
+                                   InsertContextPtr insert_context)
+    : dispatcher_(dispatcher), insert_context_(std::move(insert_context)),
+      low_watermark_bytes_(std::numeric_limits<size_t>::max()),
+      high_watermark_bytes_(std::numeric_limits<size_t>::max()), abort_callback_([]() {}),
+      cache_(cache) {}
+
 void CacheInsertQueue::insertHeaders(const Http::ResponseHeaderMap& response_headers,
                                      const ResponseMetadata& metadata, bool end_stream) {
   end_stream_queued_ = end_stream;
@@ -132,6 +141,7 @@ void CacheInsertQueue::onFragmentComplete(bool cache_success, bool end_stream, s
     if (aborting_) {
       // Parent filter was destroyed, so we can quit this operation.
       fragments_.clear();
+      coalesced_request_.reset();
       self_ownership_.reset();
       return;
     }
@@ -153,6 +163,7 @@ void CacheInsertQueue::onFragmentComplete(bool cache_success, bool end_stream, s
         watermarked_ = false;
       }
       fragments_.clear();
+      coalesced_request_.reset();
       // Clearing self-ownership might provoke the destructor, so take a copy of the
       // abort callback to avoid reading from 'this' after it may be deleted.
       auto abort_callback = abort_callback_;
@@ -163,6 +174,8 @@ void CacheInsertQueue::onFragmentComplete(bool cache_success, bool end_stream, s
     if (end_stream) {
       ASSERT(fragments_.empty(), "ending a stream with the queue not empty is a bug");
       ASSERT(!watermarked_, "being over the high watermark when the queue is empty makes no sense");
+      // The whole response is in the cache, so the requests waiting for it can be served.
+      coalesced_request_.reset();
       self_ownership_.reset();
       return;
     }
@@ -200,6 +213,10 @@ void CacheInsertQueue::setSelfOwned(std::unique_ptr<CacheInsertQueue> self) {
   self_ownership_ = std::move(self);
 }
 
+void CacheInsertQueue::setCoalescedRequest(CoalescedRequestPtr coalesced_request) {
+  coalesced_request_ = std::move(coalesced_request);
+}
+
 CacheInsertQueue::~CacheInsertQueue() {
   ASSERT(!watermarked_, "should not have a watermarked status when the queue is destroyed");
   ASSERT(fragments_.empty(), "queue should be empty by the time the destructor is run");
@@ -4,6 +4,7 @@
 #include <functional>
 
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -37,11 +38,20 @@ public:
   CacheInsertQueue(std::shared_ptr<HttpCache> cache,
                    Http::StreamEncoderFilterCallbacks& encoder_callbacks,
                    InsertContextPtr insert_context, AbortInsertCallback abort);
+  // Inserts a response which is not streamed through a filter, such as the response of a
+  // background validation. As the whole response is already buffered, no watermark events are
+  // sent, and nothing is told of an abort.
+  CacheInsertQueue(std::shared_ptr<HttpCache> cache, Event::Dispatcher& dispatcher,
+                   InsertContextPtr insert_context);
   void insertHeaders(const Http::ResponseHeaderMap& response_headers,
                      const ResponseMetadata& metadata, bool end_stream);
   void insertBody(const Buffer::Instance& fragment, bool end_stream);
   void insertTrailers(const Http::ResponseTrailerMap& trailers);
   void setSelfOwned(std::unique_ptr<CacheInsertQueue> self);
+  // Hands over the coalesced request which leads the fetch of the inserted response. It is
+  // completed once the cache has received the whole response, or the insert is aborted, so that
+  // the requests waiting for the fetch look the response up in the cache.
+  void setCoalescedRequest(CoalescedRequestPtr coalesced_request);
   ~CacheInsertQueue();
 
 private:
@@ -78,6 +88,7 @@ private:
   // while a cache action is still in flight, which can cause the cache to be
   // deleted prematurely.
   std::shared_ptr<HttpCache> cache_;
+  CoalescedRequestPtr coalesced_request_;
 };
 
 } // namespace Cache
@@ -2,6 +2,8 @@
 
 #include "source/extensions/filters/http/cache/cache_filter.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -26,10 +28,30 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     cache = http_cache_factory->getCache(config, context);
   }
 
-  return [config, stats_prefix, &context,
-          cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  // Stale responses within their stale-while-revalidate window are validated in the background,
+  // through the async client of the cluster of the request. Otherwise they are validated before
+  // being served, like any other stale response.
+  BackgroundRevalidatorSharedPtr background_revalidator;
+  if (cache != nullptr && config.background_revalidation()) {
+    background_revalidator = std::make_shared<BackgroundRevalidator>(
+        context.clusterManager(), context.timeSource(), config.allowed_vary_headers(),
+        absl::StrCat(stats_prefix, "cache."), context.scope());
+  }
+
+  // The coalescer is shared by the workers, so that concurrent misses for the same key wait for a
+  // single fetch whichever worker they are on.
+  RequestCoalescerSharedPtr request_coalescer;
+  if (cache != nullptr && config.has_request_coalescing()) {
+    request_coalescer =
+        std::make_shared<RequestCoalescer>(absl::StrCat(stats_prefix, "cache."), context.scope());
+  }
+
+  return [config, stats_prefix, &context, cache, request_coalescer,
+          background_revalidator](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(), cache));
+                                                            context.timeSource(), cache,
+                                                            request_coalescer,
+                                                            background_revalidator));
   };
 }
 
@@ -50,6 +50,10 @@ struct LookupResult {
   // True if the cached response has trailers.
   bool has_trailers_ = false;
 
+  // True if the cached response is stale, but within its stale-if-error window, so it may be
+  // served if its validation fails with an error.
+  bool serve_stale_if_error_ = false;
+
   // Update the content length of the object and its response headers.
   void setContentLength(uint64_t new_length) {
     content_length_ = new_length;
@@ -106,8 +110,8 @@ public:
 
 private:
   void initializeRequestCacheControl(const Http::RequestHeaderMap& request_headers);
-  bool requiresValidation(const Http::ResponseHeaderMap& response_headers,
-                          SystemTime::duration age) const;
+  // Sets the cache_entry_status_ and serve_stale_if_error_ of a result whose headers_ are set.
+  void setEntryStatus(LookupResult& result, SystemTime::duration response_age) const;
 
   Key key_;
   std::vector<RawByteRange> request_range_spec_;
@@ -0,0 +1,62 @@
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CoalescedRequest::~CoalescedRequest() {
+  if (leader()) {
+    coalescer_->complete(key_);
+  } else {
+    coalescer_->leave(key_, id_);
+  }
+}
+
+RequestCoalescer::RequestCoalescer(const std::string& stats_prefix, Stats::Scope& scope)
+    : stats_({ALL_REQUEST_COALESCING_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix),
+                                           POOL_GAUGE_PREFIX(scope, stats_prefix))}) {}
+
+CoalescedRequestPtr RequestCoalescer::join(const Key& key, Event::Dispatcher& dispatcher,
+                                           std::function<void()> on_complete) {
+  absl::MutexLock lock(&mutex_);
+  auto [iter, inserted] = fetches_.try_emplace(key);
+  if (inserted) {
+    return CoalescedRequestPtr{new CoalescedRequest(shared_from_this(), key, 0)};
+  }
+  const uint64_t id = next_waiter_id_++;
+  iter->second.emplace(id, Waiter{dispatcher, std::move(on_complete)});
+  stats_.coalesced_requests_.inc();
+  stats_.coalesced_requests_waiting_.inc();
+  return CoalescedRequestPtr{new CoalescedRequest(shared_from_this(), key, id)};
+}
+
+void RequestCoalescer::complete(const Key& key) {
+  Waiters waiters;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto iter = fetches_.find(key);
+    ASSERT(iter != fetches_.end());
+    waiters = std::move(iter->second);
+    fetches_.erase(iter);
+  }
+  stats_.coalesced_requests_waiting_.sub(waiters.size());
+  // The waiters may be on other workers, so they are notified through their own dispatchers.
+  for (auto& [id, waiter] : waiters) {
+    waiter.dispatcher_.post(std::move(waiter.on_complete_));
+  }
+}
+
+void RequestCoalescer::leave(const Key& key, uint64_t id) {
+  absl::MutexLock lock(&mutex_);
+  auto iter = fetches_.find(key);
+  // The fetch may have completed, and the waiter been notified, already.
+  if (iter != fetches_.end() && iter->second.erase(id) > 0) {
+    stats_.coalesced_requests_waiting_.dec();
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All request coalescing stats. @see stats_macros.h
+ */
+#define ALL_REQUEST_COALESCING_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(coalesced_requests)                                                                      \
+  COUNTER(coalesced_wait_timeouts)                                                                 \
+  GAUGE(coalesced_requests_waiting, Accumulate)
+
+/**
+ * Struct definition for all request coalescing stats. @see stats_macros.h
+ */
+struct RequestCoalescingStats {
+  ALL_REQUEST_COALESCING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class RequestCoalescer;
+
+// A request which takes part in the coalescing of the fetches of a key. The request either leads
+// the fetch, in which case destroying it completes the fetch, or waits for the fetch of another
+// request, in which case destroying it stops the wait.
+class CoalescedRequest {
+public:
+  ~CoalescedRequest();
+
+  // True if the request leads the fetch, i.e. is sent upstream.
+  bool leader() const { return id_ == 0; }
+
+private:
+  friend class RequestCoalescer;
+
+  CoalescedRequest(std::shared_ptr<RequestCoalescer> coalescer, const Key& key, uint64_t id)
+      : coalescer_(std::move(coalescer)), key_(key), id_(id) {}
+
+  // The request may outlive the filter config which owns the coalescer, e.g. in a self-owned
+  // CacheInsertQueue, so it keeps the coalescer alive.
+  const std::shared_ptr<RequestCoalescer> coalescer_;
+  const Key key_;
+  // The id of a waiting request, or 0 for the leader.
+  const uint64_t id_;
+};
+
+using CoalescedRequestPtr = std::unique_ptr<CoalescedRequest>;
+
+// Tracks the in-flight upstream fetches of cache misses by key, so that concurrent misses for the
+// same key, from any worker, wait for a single fetch. Waiting requests are notified through their
+// own dispatcher once the fetch completes.
+class RequestCoalescer : public std::enable_shared_from_this<RequestCoalescer> {
+public:
+  RequestCoalescer(const std::string& stats_prefix, Stats::Scope& scope);
+
+  /**
+   * Joins the fetch of a key.
+   * @param key the cache key of the request.
+   * @param dispatcher the dispatcher of the request, which on_complete is posted to.
+   * @param on_complete called when the fetch that the request waits for completes. Not called
+   *        for the leader, or once the returned request has been destroyed.
+   * @return the request, which leads the fetch if there was no fetch of the key in flight.
+   */
+  CoalescedRequestPtr join(const Key& key, Event::Dispatcher& dispatcher,
+                           std::function<void()> on_complete);
+
+  RequestCoalescingStats& stats() { return stats_; }
+
+private:
+  friend class CoalescedRequest;
+
+  struct Waiter {
+    Event::Dispatcher& dispatcher_;
+    std::function<void()> on_complete_;
+  };
+  using Waiters = absl::flat_hash_map<uint64_t, Waiter>;
+
+  void complete(const Key& key);
+  void leave(const Key& key, uint64_t id);
+
+  RequestCoalescingStats stats_;
+  absl::Mutex mutex_;
+  // The waiters of each key with a fetch in flight.
+  absl::flat_hash_map<Key, Waiters, MessageUtil, MessageUtil> fetches_ ABSL_GUARDED_BY(mutex_);
+  uint64_t next_waiter_id_ ABSL_GUARDED_BY(mutex_) = 1;
+};
+
+using RequestCoalescerSharedPtr = std::shared_ptr<RequestCoalescer>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -103,6 +103,8 @@ private:
   JwtLocationConstPtr curr_token_;
   // The JWT object.
   std::unique_ptr<::google::jwt_verify::Jwt> owned_jwt_;
+  // The JWT object found in the JWT cache, which is kept alive even if another thread evicts it.
+  JwtConstSharedPtr cached_jwt_;
   // The JWKS data object
   JwksCache::JwksData* jwks_data_{};
   // The HTTP request headers
@@ -120,7 +122,7 @@ private:
   const bool is_allow_failed_;
   const bool is_allow_missing_;
   TimeSource& time_source_;
-  ::google::jwt_verify::Jwt* jwt_{};
+  const ::google::jwt_verify::Jwt* jwt_{};
 };
 
 std::string AuthenticatorImpl::name() const {
@@ -167,7 +169,8 @@ void AuthenticatorImpl::startVerify() {
   Status status;
   if (provider_.has_value()) {
     jwks_data_ = jwks_cache_.findByProvider(*provider_);
-    jwt_ = jwks_data_->getJwtCache().lookup(curr_token_->token());
+    cached_jwt_ = jwks_data_->getJwtCache().lookup(curr_token_->token());
+    jwt_ = cached_jwt_.get();
     if (jwt_ != nullptr) {
       jwks_cache_.stats().jwt_cache_hit_.inc();
       use_jwt_cache = true;
@@ -289,6 +292,8 @@ void AuthenticatorImpl::onDestroy() {
 
 // Verify with a specific public key.
 void AuthenticatorImpl::verifyKey() {
+  // The JWKS object is thread local, so the signature is verified on this thread even if another
+  // thread verifies the same token concurrently. The JWT cache keeps the first one inserted.
   const Status status =
       ::google::jwt_verify::verifyJwtWithoutTimeChecking(*jwt_, *jwks_data_->getJwksObj());
 
@@ -363,8 +368,9 @@ void AuthenticatorImpl::handleGoodJwt(bool cache_hit) {
     }
   }
   if (provider_ && !cache_hit) {
-    // move the ownership of "owned_jwt_" into the function.
-    jwks_data_->getJwtCache().insert(curr_token_->token(), std::move(owned_jwt_));
+    // share the ownership of "owned_jwt_" with the cache.
+    cached_jwt_ = std::move(owned_jwt_);
+    jwks_data_->getJwtCache().insert(curr_token_->token(), cached_jwt_);
   }
   doneWithStatus(Status::Ok);
 }
@@ -30,7 +30,9 @@ public:
   JwksDataImpl(const JwtProvider& jwt_provider, Server::Configuration::FactoryContext& context,
                CreateJwksFetcherCb fetcher_cb, JwtAuthnFilterStats& stats)
       : jwt_provider_(jwt_provider), time_source_(context.timeSource()),
-        tls_(context.threadLocal()) {
+        tls_(context.threadLocal()),
+        jwt_cache_(JwtCache::create(jwt_provider_.has_jwt_cache_config(),
+                                    jwt_provider_.jwt_cache_config(), context.timeSource())) {
 
     if (jwt_provider_.has_remote_jwks()) {
       // remote_jwks.retry_policy has an invalid case that could not be validated by the
@@ -56,11 +58,7 @@ public:
       audiences.push_back(aud);
     }
     audiences_ = std::make_unique<::google::jwt_verify::CheckAudience>(audiences);
-    bool enable_jwt_cache = jwt_provider_.has_jwt_cache_config();
-    const auto& config = jwt_provider_.jwt_cache_config();
-    tls_.set([enable_jwt_cache, config](Envoy::Event::Dispatcher& dispatcher) {
-      return std::make_shared<ThreadLocalCache>(enable_jwt_cache, config, dispatcher.timeSource());
-    });
+    tls_.set([](Envoy::Event::Dispatcher&) { return std::make_shared<ThreadLocalCache>(); });
 
     const auto inline_jwks =
         Config::DataSource::read(jwt_provider_.local_jwks(), true, context.api());
@@ -102,19 +100,12 @@ public:
     return shared_jwks.get();
   }
 
-  JwtCache& getJwtCache() override { return *tls_->jwt_cache_; }
+  JwtCache& getJwtCache() override { return *jwt_cache_; }
 
 private:
   struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
-    ThreadLocalCache(bool enable_jwt_cache,
-                     const envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig& config,
-                     TimeSource& time_source)
-        : jwt_cache_(JwtCache::create(enable_jwt_cache, config, time_source)) {}
-
     // The jwks object.
     JwksConstSharedPtr jwks_;
-    // The JwtCache object
-    const JwtCachePtr jwt_cache_;
     // The pubkey expiration time.
     MonotonicTime expire_;
   };
@@ -136,6 +127,8 @@ private:
   TimeSource& time_source_;
   // the thread local slot for cache
   ThreadLocal::TypedSlot<ThreadLocalCache> tls_;
+  // the JWT cache shared by all the threads
+  const JwtCachePtr jwt_cache_;
   // async fetcher
   JwksAsyncFetcherPtr async_fetcher_;
 };
@@ -1,10 +1,19 @@
 #include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
 
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <vector>
+
 #include "source/common/common/assert.h"
 
-#include "simple_lru_cache/simple_lru_cache_inl.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/sha.h"
 
-using ::google::simple_lru_cache::SimpleLRUCache;
+using ::google::jwt_verify::Status;
 
 namespace Envoy {
 namespace Extensions {
@@ -13,9 +22,15 @@ namespace JwtAuthn {
 namespace {
 
 // The default number of entries in JWT cache is 100.
-constexpr int kJwtCacheDefaultSize = 100;
+constexpr uint32_t kJwtCacheDefaultSize = 100;
 // The maximum size of JWT to be cached.
 constexpr int kMaxJwtSizeForCache = 4 * 1024; // 4KiB
+// The maximum number of shards of the cache. Each shard has its own lock, and holds an equal
+// share of the entries.
+constexpr uint32_t kMaxJwtCacheShards = 16;
+// The minimum number of entries of a shard. Small caches are not split, as the tokens are not
+// spread evenly enough over small shards to fill them before one of them starts evicting.
+constexpr uint32_t kMinJwtCacheShardSize = 64;
 
 class JwtCacheImpl : public JwtCache {
 public:
@@ -23,47 +38,99 @@ public:
       : time_source_(time_source) {
     if (enable_cache) {
       // if cache_size is 0, it is not specified in the config, use default
-      auto cache_size =
+      const uint32_t cache_size =
           config.jwt_cache_size() == 0 ? kJwtCacheDefaultSize : config.jwt_cache_size();
-      jwt_lru_cache_ =
-          std::make_unique<SimpleLRUCache<std::string, ::google::jwt_verify::Jwt>>(cache_size);
+      const uint32_t num_shards =
+          std::clamp(cache_size / kMinJwtCacheShardSize, 1u, kMaxJwtCacheShards);
+      shards_.reserve(num_shards);
+      for (uint32_t i = 0; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>((cache_size + num_shards - 1) / num_shards));
+      }
     }
   }
 
-  ~JwtCacheImpl() override {
-    if (jwt_lru_cache_) {
-      jwt_lru_cache_->clear();
+  JwtConstSharedPtr lookup(const std::string& token) override {
+    if (shards_.empty()) {
+      return nullptr;
     }
-  }
-
-  ::google::jwt_verify::Jwt* lookup(const std::string& token) override {
-    if (!jwt_lru_cache_) {
+    const std::string key = digest(token);
+    Shard& shard = shardOf(key);
+    absl::MutexLock lock(&shard.mutex_);
+    auto it = shard.index_.find(key);
+    if (it == shard.index_.end()) {
       return nullptr;
     }
-    SimpleLRUCache<std::string, ::google::jwt_verify::Jwt>::ScopedLookup lookup(
-        jwt_lru_cache_.get(), token);
-    if (lookup.found()) {
-      ::google::jwt_verify::Jwt* const found_jwt = lookup.value();
-      ASSERT(found_jwt != nullptr);
-      if (found_jwt->verifyTimeConstraint(DateUtil::nowToSeconds(time_source_)) !=
-          ::google::jwt_verify::Status::JwtExpired) {
-        return found_jwt;
-      } else {
-        jwt_lru_cache_->remove(token);
-      }
+    const EntryList::iterator entry = it->second;
+    if (entry->jwt_->verifyTimeConstraint(DateUtil::nowToSeconds(time_source_)) ==
+        Status::JwtExpired) {
+      shard.erase(entry);
+      return nullptr;
     }
-    return nullptr;
+    shard.entries_.splice(shard.entries_.begin(), shard.entries_, entry);
+    return entry->jwt_;
   }
 
-  void insert(const std::string& token, std::unique_ptr<::google::jwt_verify::Jwt>&& jwt) override {
-    if (jwt_lru_cache_ && token.size() <= kMaxJwtSizeForCache) {
-      // pass the ownership of jwt to cache
-      jwt_lru_cache_->insert(token, jwt.release(), 1);
+  void insert(const std::string& token, const JwtConstSharedPtr& jwt) override {
+    if (shards_.empty() || token.size() > kMaxJwtSizeForCache) {
+      return;
+    }
+    ASSERT(jwt != nullptr);
+    const std::string key = digest(token);
+    Shard& shard = shardOf(key);
+    absl::MutexLock lock(&shard.mutex_);
+    auto it = shard.index_.find(key);
+    if (it != shard.index_.end()) {
+      // Another thread verified the same token concurrently, and inserted it first.
+      shard.entries_.splice(shard.entries_.begin(), shard.entries_, it->second);
+      return;
+    }
+    if (shard.entries_.size() >= shard.capacity_) {
+      shard.erase(std::prev(shard.entries_.end()));
     }
+    shard.entries_.push_front({key, jwt});
+    shard.index_.emplace(shard.entries_.front().key_, shard.entries_.begin());
   }
 
 private:
-  std::unique_ptr<SimpleLRUCache<std::string, ::google::jwt_verify::Jwt>> jwt_lru_cache_;
+  struct Entry {
+    // The digest of the token.
+    std::string key_;
+    JwtConstSharedPtr jwt_;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    explicit Shard(uint64_t capacity) : capacity_(capacity) {}
+
+    void erase(EntryList::iterator entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      index_.erase(entry->key_);
+      entries_.erase(entry);
+    }
+
+    const uint64_t capacity_;
+    absl::Mutex mutex_;
+    // The entries, from the most to the least recently used.
+    EntryList entries_ ABSL_GUARDED_BY(mutex_);
+    // The entries by key, which views the key of the entry.
+    absl::flat_hash_map<absl::string_view, EntryList::iterator> index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  // The cache is keyed by the SHA-256 digest of the token, so that the size of its keys does not
+  // depend on the size of the tokens. A collision of the digests of two tokens is not feasible.
+  static std::string digest(const std::string& token) {
+    std::string digest(SHA256_DIGEST_LENGTH, '\0');
+    SHA256(reinterpret_cast<const uint8_t*>(token.data()), token.size(),
+           reinterpret_cast<uint8_t*>(digest.data()));
+    return digest;
+  }
+
+  Shard& shardOf(absl::string_view key) {
+    uint64_t prefix;
+    memcpy(&prefix, key.data(), sizeof(prefix));
+    return *shards_[prefix % shards_.size()];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
   TimeSource& time_source_;
 };
 } // namespace
@@ -17,23 +17,26 @@ namespace Extensions {
 namespace HttpFilters {
 namespace JwtAuthn {
 
-// Cache key is the JWT string, value is parsed JWT struct.
+// Cache key is the digest of the JWT string, value is parsed JWT struct of a verified JWT.
+// The cache is shared by all the worker threads, and is thread safe. Workers which verified the
+// same token concurrently insert it once.
 
 class JwtCache;
 using JwtCachePtr = std::unique_ptr<JwtCache>;
 
+using JwtConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwt>;
+
 class JwtCache {
 public:
   virtual ~JwtCache() = default;
 
-  // Lookup a JWT token in the cache, if found return the pointer to its parsed jwt struct.
+  // Lookup a JWT token in the cache, if found return its parsed jwt struct.
   // If no found, return nullptr.
-  virtual ::google::jwt_verify::Jwt* lookup(const std::string& token) PURE;
+  virtual JwtConstSharedPtr lookup(const std::string& token) PURE;
 
   // Insert a JWT token and its parsed JWT struct to the cache.
-  // The function will take over the ownership of jwt object.
-  virtual void insert(const std::string& token,
-                      std::unique_ptr<::google::jwt_verify::Jwt>&& jwt) PURE;
+  // If the token is cached already, the cached JWT is kept.
+  virtual void insert(const std::string& token, const JwtConstSharedPtr& jwt) PURE;
 
   // JwtCache factory function.
   static JwtCachePtr create(bool enable_cache, const JwtCacheConfig& config,
@@ -55,6 +55,21 @@ public:
                              bool ask_redirection) PURE;
 };
 
+/**
+ * Callbacks for the values a server sends without a request, such as the messages of the channels
+ * a client is subscribed to.
+ */
+class PushCallbacks {
+public:
+  virtual ~PushCallbacks() = default;
+
+  /**
+   * Called when a value is received while there are no pending requests.
+   * @param value supplies the value which is now owned by the callee.
+   */
+  virtual void onPushValue(RespValuePtr&& value) PURE;
+};
+
 /**
  * DoNothingPoolCallbacks is used for internally generated commands whose response is
  * transparently filtered, and redirection never occurs (e.g., "asking", "auth", etc.).
@@ -104,6 +119,13 @@ public:
    * @param auth password for upstream host.
    */
   virtual void initialize(const std::string& auth_username, const std::string& auth_password) PURE;
+
+  /**
+   * Sets the callbacks receiving the values the server sends while there are no pending requests.
+   * Without them, the server must only send responses to requests.
+   * @param callbacks supplies the push callbacks, which must outlive the client.
+   */
+  virtual void setPushCallbacks(PushCallbacks& callbacks) PURE;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
@@ -151,7 +173,8 @@ public:
   virtual uint32_t maxBufferSizeBeforeFlush() const PURE;
 
   /**
-   * @return timeout for batching commands for a single upstream host.
+   * @return timeout for batching commands for a single upstream host. If zero, batched commands
+   * are flushed at the end of the current event loop iteration.
    */
   virtual std::chrono::milliseconds bufferFlushTimeoutInMs() const PURE;
 
@@ -184,6 +207,11 @@ public:
 
   virtual bool connectionRateLimitEnabled() const PURE;
   virtual uint32_t connectionRateLimitPerSec() const PURE;
+
+  /**
+   * @return the number of connections to open to each upstream host per worker thread.
+   */
+  virtual uint32_t connectionsPerHost() const PURE;
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -28,7 +28,8 @@ ConfigImpl::ConfigImpl(
                // as the buffer is flushed on each request immediately.
       max_upstream_unknown_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_upstream_unknown_connections, 100)),
-      enable_command_stats_(config.enable_command_stats()) {
+      enable_command_stats_(config.enable_command_stats()),
+      connections_per_host_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, connections_per_host, 1)) {
   switch (config.read_policy()) {
     PANIC_ON_PROTO_ENUM_SENTINEL_VALUES;
   case envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ConnPoolSettings::MASTER:
@@ -85,6 +86,10 @@ ClientImpl::ClientImpl(Upstream::HostConstSharedPtr host, Event::Dispatcher& dis
       flush_timer_(dispatcher.createTimer([this]() { flushBufferAndResetTimer(); })),
       time_source_(dispatcher.timeSource()), redis_command_stats_(redis_command_stats),
       scope_(scope), is_transaction_client_(is_transaction_client) {
+  if (config.maxBufferSizeBeforeFlush() > 0 &&
+      config.bufferFlushTimeoutInMs() == std::chrono::milliseconds::zero()) {
+    flush_cb_ = dispatcher.createSchedulableCallback([this]() { flushBufferAndResetTimer(); });
+  }
   Upstream::ClusterTrafficStats& traffic_stats = *host->cluster().trafficStats();
   traffic_stats.upstream_cx_total_.inc();
   host->stats().cx_total_.inc();
@@ -103,7 +108,9 @@ ClientImpl::~ClientImpl() {
 void ClientImpl::close() { connection_->close(Network::ConnectionCloseType::NoFlush); }
 
 void ClientImpl::flushBufferAndResetTimer() {
-  if (flush_timer_->enabled()) {
+  if (flush_cb_ != nullptr) {
+    flush_cb_->cancel();
+  } else if (flush_timer_->enabled()) {
     flush_timer_->disableTimer();
   }
   connection_->write(encoder_buffer_, false);
@@ -127,11 +134,16 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, ClientCallbacks&
   pending_requests_.emplace_back(*this, callbacks, command);
   encoder_->encode(request, encoder_buffer_);
 
-  // If buffer is full, flush. If the buffer was empty before the request, start the timer.
+  // If buffer is full, flush. If the buffer was empty before the request, start the timer, or
+  // flush the requests encoded by the end of this event loop iteration if there is no timeout.
   if (encoder_buffer_.length() >= config_.maxBufferSizeBeforeFlush()) {
     flushBufferAndResetTimer();
   } else if (empty_buffer) {
-    flush_timer_->enableTimer(std::chrono::milliseconds(config_.bufferFlushTimeoutInMs()));
+    if (flush_cb_ != nullptr) {
+      flush_cb_->scheduleCallbackCurrentIteration();
+    } else {
+      flush_timer_->enableTimer(std::chrono::milliseconds(config_.bufferFlushTimeoutInMs()));
+    }
   }
 
   // Only boost the op timeout if:
@@ -212,6 +224,10 @@ void ClientImpl::onEvent(Network::ConnectionEvent event) {
 }
 
 void ClientImpl::onRespValue(RespValuePtr&& value) {
+  if (pending_requests_.empty() && push_callbacks_ != nullptr) {
+    push_callbacks_->onPushValue(std::move(value));
+    return;
+  }
   ASSERT(!pending_requests_.empty());
   PendingRequest& request = pending_requests_.front();
   const bool canceled = request.canceled_;
@@ -56,6 +56,7 @@ public:
   ReadPolicy readPolicy() const override { return read_policy_; }
   bool connectionRateLimitEnabled() const override { return connection_rate_limit_enabled_; }
   uint32_t connectionRateLimitPerSec() const override { return connection_rate_limit_per_sec_; }
+  uint32_t connectionsPerHost() const override { return connections_per_host_; }
 
 private:
   const std::chrono::milliseconds op_timeout_;
@@ -68,6 +69,7 @@ private:
   ReadPolicy read_policy_;
   bool connection_rate_limit_enabled_;
   uint32_t connection_rate_limit_per_sec_;
+  const uint32_t connections_per_host_;
 };
 
 class ClientImpl : public Client, public DecoderCallbacks, public Network::ConnectionCallbacks {
@@ -93,6 +95,7 @@ public:
   bool active() override { return !pending_requests_.empty(); }
   void flushBufferAndResetTimer();
   void initialize(const std::string& auth_username, const std::string& auth_password) override;
+  void setPushCallbacks(PushCallbacks& callbacks) override { push_callbacks_ = &callbacks; }
 
 private:
   friend class RedisClientImplTest;
@@ -143,9 +146,13 @@ private:
   DecoderPtr decoder_;
   const Config& config_;
   std::list<PendingRequest> pending_requests_;
+  PushCallbacks* push_callbacks_{};
   Event::TimerPtr connect_or_op_timer_;
   bool connected_{};
   Event::TimerPtr flush_timer_;
+  // Flushes the buffer at the end of the current event loop iteration instead of flush_timer_, if
+  // batching is enabled with a zero flush timeout.
+  Event::SchedulableCallbackPtr flush_cb_;
   Envoy::TimeSource& time_source_;
   const RedisCommandStatsSharedPtr redis_command_stats_;
   Stats::Scope& scope_;
@@ -115,7 +115,8 @@ public:
 
   /**
    * The following are getters and setters for the internal value. A RespValue starts as null,
-   * and must change type via type() before the following methods can be used.
+   * and must change type via type() before the following methods can be used. asString() copies
+   * the contents of a BulkString held in a buffer into a string when it is first called.
    */
   std::vector<RespValue>& asArray();
   const std::vector<RespValue>& asArray() const;
@@ -126,6 +127,19 @@ public:
   CompositeArray& asCompositeArray();
   const CompositeArray& asCompositeArray() const;
 
+  /**
+   * Sets the contents of a BulkString to the data of a buffer, which is shared with the copies of
+   * the value and encoded without copying it.
+   * @param buffer supplies the contents, which must not be modified afterwards.
+   */
+  void buffer(std::shared_ptr<const Buffer::Instance> buffer);
+
+  /**
+   * @return the buffer holding the contents of a BulkString, or nullptr if they are held in a
+   *         string.
+   */
+  std::shared_ptr<const Buffer::Instance> buffer() const;
+
   /**
    * Get/set the type of the RespValue. A RespValue can only be a single type at a time. Each time
    * type() is called the type is changed and then the type specific as* methods can be used.
@@ -136,14 +150,19 @@ public:
 private:
   union {
     std::vector<RespValue> array_;
-    std::string string_;
+    // The contents of a string type are either held in string_, or in buffer_ if
+    // string_buffered_ is set, until asString() copies them into string_.
+    mutable std::string string_;
+    mutable std::shared_ptr<const Buffer::Instance> buffer_;
     int64_t integer_;
     CompositeArray composite_array_;
   };
 
   void cleanup();
+  void copyBufferToString() const;
 
   RespType type_{};
+  mutable bool string_buffered_{};
 };
 
 using RespValuePtr = std::unique_ptr<RespValue>;
@@ -1,15 +1,18 @@
 #include "source/extensions/filters/network/common/redis/codec_impl.h"
 
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "envoy/common/platform.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/utility.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -18,6 +21,29 @@ namespace Extensions {
 namespace NetworkFilters {
 namespace Common {
 namespace Redis {
+namespace {
+
+/**
+ * References a slice of the buffer holding a bulk string, which is kept until the slice has been
+ * written.
+ */
+class BufferedBulkStringFragment : public Buffer::BufferFragment {
+public:
+  BufferedBulkStringFragment(std::shared_ptr<const Buffer::Instance> buffer,
+                             const Buffer::RawSlice& slice)
+      : buffer_(std::move(buffer)), slice_(slice) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return slice_.mem_; }
+  size_t size() const override { return slice_.len_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const Buffer::Instance> buffer_;
+  const Buffer::RawSlice slice_;
+};
+
+} // namespace
 
 std::string RespValue::toString() const {
   switch (type_) {
@@ -68,15 +94,43 @@ const std::vector<RespValue>& RespValue::asArray() const {
 std::string& RespValue::asString() {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  copyBufferToString();
   return string_;
 }
 
 const std::string& RespValue::asString() const {
   ASSERT(type_ == RespType::BulkString || type_ == RespType::Error ||
          type_ == RespType::SimpleString);
+  copyBufferToString();
   return string_;
 }
 
+void RespValue::buffer(std::shared_ptr<const Buffer::Instance> buffer) {
+  ASSERT(type_ == RespType::BulkString);
+  if (string_buffered_) {
+    buffer_ = std::move(buffer);
+    return;
+  }
+  string_.~basic_string<char>();
+  new (&buffer_) std::shared_ptr<const Buffer::Instance>(std::move(buffer));
+  string_buffered_ = true;
+}
+
+std::shared_ptr<const Buffer::Instance> RespValue::buffer() const {
+  return string_buffered_ ? buffer_ : nullptr;
+}
+
+void RespValue::copyBufferToString() const {
+  if (!string_buffered_) {
+    return;
+  }
+  // The buffer of a value which has been moved from is null.
+  std::string string = buffer_ != nullptr ? buffer_->toString() : "";
+  buffer_.~shared_ptr();
+  new (&string_) std::string(std::move(string));
+  string_buffered_ = false;
+}
+
 int64_t& RespValue::asInteger() {
   ASSERT(type_ == RespType::Integer);
   return integer_;
@@ -111,7 +165,12 @@ void RespValue::cleanup() {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    string_.~basic_string<char>();
+    if (string_buffered_) {
+      buffer_.~shared_ptr();
+      string_buffered_ = false;
+    } else {
+      string_.~basic_string<char>();
+    }
     break;
   }
   case RespType::Null:
@@ -162,7 +221,11 @@ RespValue::RespValue(const RespValue& other) : type_(RespType::Null) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    if (other.string_buffered_) {
+      buffer(other.buffer_);
+    } else {
+      asString() = other.asString();
+    }
     break;
   }
   case RespType::Integer: {
@@ -187,7 +250,12 @@ RespValue::RespValue(RespValue&& other) noexcept : type_(other.type_) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    new (&string_) std::string(std::move(other.string_));
+    if (other.string_buffered_) {
+      new (&buffer_) std::shared_ptr<const Buffer::Instance>(std::move(other.buffer_));
+      string_buffered_ = true;
+    } else {
+      new (&string_) std::string(std::move(other.string_));
+    }
     break;
   }
   case RespType::Integer: {
@@ -216,7 +284,11 @@ RespValue& RespValue::operator=(const RespValue& other) {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    asString() = other.asString();
+    if (other.string_buffered_) {
+      buffer(other.buffer_);
+    } else {
+      asString() = other.asString();
+    }
     break;
   }
   case RespType::Integer: {
@@ -247,7 +319,11 @@ RespValue& RespValue::operator=(RespValue&& other) noexcept {
   case RespType::SimpleString:
   case RespType::BulkString:
   case RespType::Error: {
-    string_ = std::move(other.string_);
+    if (other.string_buffered_) {
+      buffer(std::move(other.buffer_));
+    } else {
+      string_ = std::move(other.string_);
+    }
     break;
   }
   case RespType::Integer: {
@@ -329,15 +405,34 @@ RespValue::CompositeArray::CompositeArrayConstIterator::empty() {
   return *instance;
 }
 
+DecoderImpl::DecoderImpl(DecoderCallbacks& callbacks, uint64_t min_buffered_bulk_string_size)
+    : callbacks_(callbacks),
+      min_buffered_bulk_string_size_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.redis_buffered_bulk_strings")
+              ? min_buffered_bulk_string_size
+              : std::numeric_limits<uint64_t>::max()) {}
+
 void DecoderImpl::decode(Buffer::Instance& data) {
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
-    parseSlice(slice);
-  }
+  while (data.length() > 0) {
+    if (state_ == State::BufferedBulkStringBody) {
+      // Whole slices are moved without copying them.
+      const uint64_t length = std::min(pending_integer_.integer_, data.length());
+      pending_buffer_->move(data, length);
+      pending_integer_.integer_ -= length;
+      if (pending_integer_.integer_ == 0) {
+        ENVOY_LOG(trace, "parse slice: BufferedBulkStringBody complete: {} bytes",
+                  pending_buffer_->length());
+        pending_value_stack_.front().value_->buffer(std::move(pending_buffer_));
+        state_ = State::CR;
+      }
+      continue;
+    }
 
-  data.drain(data.length());
+    data.drain(parseSlice(data.frontSlice()));
+  }
 }
 
-void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
+uint64_t DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
   const char* buffer = reinterpret_cast<const char*>(slice.mem_);
   uint64_t remaining = slice.len_;
 
@@ -457,13 +552,16 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
         state_ = State::ValueComplete;
       } else {
         ASSERT(current_value.value_->type() == RespType::BulkString);
-        if (!pending_integer_.negative_) {
-          // TODO(mattklein123): reserve and define max length since we don't stream currently.
-          state_ = State::BulkStringBody;
-        } else {
+        if (pending_integer_.negative_) {
           // Null bulk string. Switch type to null and move to value complete.
           current_value.value_->type(RespType::Null);
           state_ = State::ValueComplete;
+        } else if (pending_integer_.integer_ >= min_buffered_bulk_string_size_) {
+          pending_buffer_ = std::make_shared<Buffer::OwnedImpl>();
+          state_ = State::BufferedBulkStringBody;
+        } else {
+          // TODO(mattklein123): reserve and define max length since we don't stream currently.
+          state_ = State::BulkStringBody;
         }
       }
 
@@ -488,6 +586,11 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       break;
     }
 
+    case State::BufferedBulkStringBody: {
+      // The contents are moved out of the data by decode().
+      return slice.len_ - remaining;
+    }
+
     case State::CR: {
       ENVOY_LOG(trace, "parse slice: CR");
       if (buffer[0] != '\r') {
@@ -547,6 +650,8 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     }
     }
   }
+
+  return slice.len_ - remaining;
 }
 
 void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
@@ -564,7 +669,12 @@ void EncoderImpl::encode(const RespValue& value, Buffer::Instance& out) {
     break;
   }
   case RespType::BulkString: {
-    encodeBulkString(value.asString(), out);
+    std::shared_ptr<const Buffer::Instance> buffer = value.buffer();
+    if (buffer != nullptr) {
+      encodeBulkString(buffer, out);
+    } else {
+      encodeBulkString(value.asString(), out);
+    }
     break;
   }
   case RespType::Error: {
@@ -610,15 +720,28 @@ void EncoderImpl::encodeCompositeArray(const RespValue::CompositeArray& composit
 }
 
 void EncoderImpl::encodeBulkString(const std::string& string, Buffer::Instance& out) {
+  encodeBulkStringLength(string.size(), out);
+  out.add(string);
+  out.add("\r\n", 2);
+}
+
+void EncoderImpl::encodeBulkString(const std::shared_ptr<const Buffer::Instance>& buffer,
+                                   Buffer::Instance& out) {
+  encodeBulkStringLength(buffer->length(), out);
+  for (const Buffer::RawSlice& slice : buffer->getRawSlices()) {
+    out.addBufferFragment(*new BufferedBulkStringFragment(buffer, slice));
+  }
+  out.add("\r\n", 2);
+}
+
+void EncoderImpl::encodeBulkStringLength(uint64_t length, Buffer::Instance& out) {
   char buffer[32];
   char* current = buffer;
   *current++ = '$';
-  current += StringUtil::itoa(current, 21, string.size());
+  current += StringUtil::itoa(current, 21, length);
   *current++ = '\r';
   *current++ = '\n';
   out.add(buffer, current - buffer);
-  out.add(string);
-  out.add("\r\n", 2);
 }
 
 void EncoderImpl::encodeError(const std::string& string, Buffer::Instance& out) {
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <forward_list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,10 +19,17 @@ namespace Redis {
  * Decoder implementation of https://redis.io/topics/protocol
  *
  * This implementation buffers when needed and will always consume all bytes passed for decoding.
+ * The contents of large bulk strings are moved out of the decoded data into a buffer held by the
+ * value, rather than copied into a string, so that they can be encoded again without copies.
  */
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::redis> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  // Bulk strings smaller than this are copied, as moving the slices of small strings would not
+  // avoid copies and would leave them spread over many slices.
+  static constexpr uint64_t DefaultMinBufferedBulkStringSize = 16 * 1024;
+
+  DecoderImpl(DecoderCallbacks& callbacks,
+              uint64_t min_buffered_bulk_string_size = DefaultMinBufferedBulkStringSize);
 
   // RedisProxy::Decoder
   void decode(Buffer::Instance& data) override;
@@ -34,6 +42,7 @@ private:
     Integer,
     IntegerLF,
     BulkStringBody,
+    BufferedBulkStringBody,
     CR,
     LF,
     SimpleString,
@@ -55,13 +64,15 @@ private:
     uint64_t current_array_element_;
   };
 
-  void parseSlice(const Buffer::RawSlice& slice);
+  uint64_t parseSlice(const Buffer::RawSlice& slice);
 
   DecoderCallbacks& callbacks_;
+  const uint64_t min_buffered_bulk_string_size_;
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
   std::forward_list<PendingValue> pending_value_stack_;
+  std::shared_ptr<Buffer::Instance> pending_buffer_;
 };
 
 /**
@@ -87,6 +98,9 @@ private:
   void encodeArray(const std::vector<RespValue>& array, Buffer::Instance& out);
   void encodeCompositeArray(const RespValue::CompositeArray& array, Buffer::Instance& out);
   void encodeBulkString(const std::string& string, Buffer::Instance& out);
+  void encodeBulkString(const std::shared_ptr<const Buffer::Instance>& buffer,
+                        Buffer::Instance& out);
+  void encodeBulkStringLength(uint64_t length, Buffer::Instance& out);
   void encodeError(const std::string& string, Buffer::Instance& out);
   void encodeInteger(int64_t integer, Buffer::Instance& out);
   void encodeSimpleString(const std::string& string, Buffer::Instance& out);
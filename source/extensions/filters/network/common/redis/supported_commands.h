@@ -61,6 +61,11 @@ struct SupportedCommands {
    */
   static const std::string& auth() { CONSTRUCT_ON_FIRST_USE(std::string, "auth"); }
 
+  /**
+   * @return get command
+   */
+  static const std::string& get() { CONSTRUCT_ON_FIRST_USE(std::string, "get"); }
+
   /**
    * @return mget command
    */
@@ -3,6 +3,8 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/network/common/redis/supported_commands.h"
 
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -163,6 +165,16 @@ SplitRequestPtr SimpleRequest::create(Router& router,
       new SimpleRequest(callbacks, command_stats, time_source, delay_command_latency)};
   const auto route = router.upstreamPool(incoming_request->asArray()[1].asString(), stream_info);
   if (route) {
+    const std::string& command = incoming_request->asArray()[0].asString();
+    if (!callbacks.transaction().active_ &&
+        absl::EqualsIgnoreCase(command, Common::Redis::SupportedCommands::get())) {
+      Common::Redis::RespValuePtr cached_response =
+          route->upstream(command)->cachedResponse(incoming_request->asArray()[1].asString());
+      if (cached_response != nullptr) {
+        request_ptr->onResponse(std::move(cached_response));
+        return nullptr;
+      }
+    }
     Common::Redis::RespValueSharedPtr base_request = std::move(incoming_request);
     request_ptr->handle_ = makeSingleServerRequest(
         route, base_request->asArray()[0].asString(), base_request->asArray()[1].asString(),
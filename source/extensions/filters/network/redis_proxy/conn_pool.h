@@ -64,6 +64,14 @@ public:
   virtual Common::Redis::Client::PoolRequest*
   makeRequest(const std::string& hash_key, RespVariant&& request, PoolCallbacks& callbacks,
               Common::Redis::Client::Transaction& transaction) PURE;
+
+  /**
+   * Looks up the response to a GET of a key in the near cache of the pool.
+   * @param key supplies the key read.
+   * @return RespValuePtr the cached response, or nullptr if the key is not cached or the pool has
+   *         no near cache.
+   */
+  virtual Common::Redis::RespValuePtr cachedResponse(const std::string& key) PURE;
 };
 
 using InstanceSharedPtr = std::shared_ptr<Instance>;
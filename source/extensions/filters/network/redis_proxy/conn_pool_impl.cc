@@ -1,5 +1,6 @@
 #include "source/extensions/filters/network/redis_proxy/conn_pool_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -14,8 +15,12 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 #include "source/common/stats/utility.h"
+#include "source/extensions/filters/network/common/redis/supported_commands.h"
 #include "source/extensions/filters/network/redis_proxy/config.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -36,6 +41,28 @@ const Common::Redis::RespValue& getRequest(const RespVariant& request) {
 
 static uint16_t default_port = 6379;
 
+// The backoff after the tracking of the keys of a host for the near cache failed to be set up,
+// doubled on each consecutive failure.
+constexpr std::chrono::milliseconds NearCacheTrackingBaseBackoff{1000};
+constexpr std::chrono::milliseconds NearCacheTrackingMaxBackoff{60000};
+
+// The channel of the invalidation messages of the keys tracked for RESP2 clients.
+const std::string& nearCacheInvalidationChannel() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "__redis__:invalidate");
+}
+
+Common::Redis::RespValue makeCommand(std::vector<std::string>&& args) {
+  std::vector<Common::Redis::RespValue> values(args.size());
+  for (size_t i = 0; i < args.size(); ++i) {
+    values[i].type(Common::Redis::RespType::BulkString);
+    values[i].asString() = std::move(args[i]);
+  }
+  Common::Redis::RespValue command;
+  command.type(Common::Redis::RespType::Array);
+  command.asArray().swap(values);
+  return command;
+}
+
 bool isClusterProvidedLb(const Upstream::ClusterInfo& info) {
   const auto lb_type = info.lbType();
   bool cluster_provided_lb = lb_type == Upstream::LoadBalancerType::ClusterProvided;
@@ -69,7 +96,9 @@ InstanceImpl::InstanceImpl(
       stats_scope_(std::move(stats_scope)),
       redis_command_stats_(redis_command_stats), redis_cluster_stats_{REDIS_CLUSTER_STATS(
                                                      POOL_COUNTER(*stats_scope_))},
-      refresh_manager_(std::move(refresh_manager)), dns_cache_(dns_cache) {}
+      refresh_manager_(std::move(refresh_manager)), dns_cache_(dns_cache),
+      near_cache_config_(config.has_near_cache() ? absl::make_optional(config.near_cache())
+                                                 : absl::nullopt) {}
 
 void InstanceImpl::init() {
   // Note: `this` and `cluster_name` have a a lifetime of the filter.
@@ -104,6 +133,12 @@ InstanceImpl::makeRequestToHost(const std::string& host_address,
   return tls_->getTyped<ThreadLocalPool>().makeRequestToHost(host_address, request, callbacks);
 }
 
+// This method is always called from a InstanceSharedPtr we don't have to worry about tls_->getTyped
+// failing due to InstanceImpl going away.
+Common::Redis::RespValuePtr InstanceImpl::cachedResponse(const std::string& key) {
+  return tls_->getTyped<ThreadLocalPool>().cachedResponse(key);
+}
+
 InstanceImpl::ThreadLocalPool::ThreadLocalPool(
     std::shared_ptr<InstanceImpl> parent, Event::Dispatcher& dispatcher, std::string cluster_name,
     const Extensions::Common::DynamicForwardProxy::DnsCacheSharedPtr& dns_cache)
@@ -114,6 +149,10 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(
       stats_scope_(parent->stats_scope_), redis_command_stats_(parent->redis_command_stats_),
       redis_cluster_stats_(parent->redis_cluster_stats_),
       refresh_manager_(parent->refresh_manager_) {
+  if (parent->near_cache_config_.has_value()) {
+    near_cache_ =
+        std::make_unique<NearCache>(parent->near_cache_config_.value(), dispatcher.timeSource());
+  }
   cluster_update_handle_ = parent->cm_.addThreadLocalClusterUpdateCallbacks(*this);
   Upstream::ThreadLocalCluster* cluster = parent->cm_.getThreadLocalCluster(cluster_name_);
   if (cluster != nullptr) {
@@ -128,12 +167,34 @@ InstanceImpl::ThreadLocalPool::~ThreadLocalPool() {
   while (!pending_requests_.empty()) {
     pending_requests_.pop_front();
   }
+  closeClients();
+}
+
+void InstanceImpl::ThreadLocalPool::closeClients() {
+  // Closing a client removes it from client_map_ or clients_to_drain_.
   while (!client_map_.empty()) {
-    client_map_.begin()->second->redis_client_->close();
+    ThreadLocalActiveClients& clients = client_map_.begin()->second;
+    auto client = std::find_if(clients.begin(), clients.end(),
+                               [](const ThreadLocalActiveClientPtr& client) { return client; });
+    ASSERT(client != clients.end());
+    (*client)->redis_client_->close();
   }
   while (!clients_to_drain_.empty()) {
     (*clients_to_drain_.begin())->redis_client_->close();
   }
+  while (!invalidation_clients_.empty()) {
+    invalidation_clients_.begin()->second->removed_ = true;
+    invalidation_clients_.begin()->second->redis_client_->close();
+  }
+}
+
+void InstanceImpl::ThreadLocalPool::eraseClientsIfEmpty(const Upstream::HostConstSharedPtr& host) {
+  auto it = client_map_.find(host);
+  if (it != client_map_.end() &&
+      std::none_of(it->second.begin(), it->second.end(),
+                   [](const ThreadLocalActiveClientPtr& client) { return client; })) {
+    client_map_.erase(it);
+  }
 }
 
 void InstanceImpl::ThreadLocalPool::onClusterAddOrUpdateNonVirtual(
@@ -192,16 +253,12 @@ void InstanceImpl::ThreadLocalPool::onClusterRemoval(const std::string& cluster_
   // Treat cluster removal as a removal of all hosts. Close all connections and fail all pending
   // requests.
   host_set_member_update_cb_handle_ = nullptr;
-  while (!client_map_.empty()) {
-    client_map_.begin()->second->redis_client_->close();
-  }
-  while (!clients_to_drain_.empty()) {
-    (*clients_to_drain_.begin())->redis_client_->close();
-  }
+  closeClients();
 
   cluster_ = nullptr;
   host_address_map_.clear();
   cx_rate_limiter_map_.clear();
+  near_cache_tracking_backoffs_.clear();
 }
 
 void InstanceImpl::ThreadLocalPool::onHostsAdded(
@@ -229,19 +286,36 @@ void InstanceImpl::ThreadLocalPool::onHostsRemoved(
       cx_rate_limiter_map_.erase(token_bucket);
     }
     auto it = client_map_.find(host);
-    if (it != client_map_.end()) {
-      if (it->second->redis_client_->active()) {
+    const size_t num_clients = it != client_map_.end() ? it->second.size() : 0;
+    for (size_t i = 0; i < num_clients; ++i) {
+      // Closing a client may erase the clients of the host, so look them up each time.
+      it = client_map_.find(host);
+      if (it == client_map_.end()) {
+        break;
+      }
+      ThreadLocalActiveClientPtr& client = it->second[i];
+      if (!client) {
+        continue;
+      }
+      if (client->redis_client_->active()) {
         // Put the ThreadLocalActiveClient to the side to drain.
-        clients_to_drain_.push_back(std::move(it->second));
-        client_map_.erase(it);
+        clients_to_drain_.push_back(std::move(client));
         if (!drain_timer_->enabled()) {
           drain_timer_->enableTimer(std::chrono::seconds(1));
         }
       } else {
         // There are no pending requests so close the connection.
-        it->second->redis_client_->close();
+        client->redis_client_->close();
       }
     }
+    eraseClientsIfEmpty(host);
+    auto invalidation_client = invalidation_clients_.find(host);
+    if (invalidation_client != invalidation_clients_.end()) {
+      // Closing the client erases it, and clears the near cache which holds keys of the host.
+      invalidation_client->second->removed_ = true;
+      invalidation_client->second->redis_client_->close();
+    }
+    near_cache_tracking_backoffs_.erase(host);
     // There is the possibility that multiple hosts with the same address
     // are registered in host_address_map_ given that hosts may be created
     // upon redirection or supplied as part of the cluster's definition.
@@ -262,20 +336,27 @@ void InstanceImpl::ThreadLocalPool::drainClients() {
 }
 
 InstanceImpl::ThreadLocalActiveClientPtr&
-InstanceImpl::ThreadLocalPool::threadLocalActiveClient(Upstream::HostConstSharedPtr host) {
+InstanceImpl::ThreadLocalPool::threadLocalActiveClient(Upstream::HostConstSharedPtr host,
+                                                       uint32_t index) {
   TokenBucketPtr& rate_limiter = cx_rate_limiter_map_[host];
   if (config_->connectionRateLimitEnabled() && !rate_limiter) {
     rate_limiter = std::make_unique<TokenBucketImpl>(config_->connectionRateLimitPerSec(),
                                                      dispatcher_.timeSource(),
                                                      config_->connectionRateLimitPerSec());
   }
-  ThreadLocalActiveClientPtr& client = client_map_[host];
+  ThreadLocalActiveClients& clients = client_map_[host];
+  if (clients.empty()) {
+    clients.resize(config_->connectionsPerHost());
+  }
+  ASSERT(index < clients.size());
+  ThreadLocalActiveClientPtr& client = clients[index];
   if (!client) {
     if (config_->connectionRateLimitEnabled() && rate_limiter->consume(1, false) == 0) {
       redis_cluster_stats_.connection_rate_limited_.inc();
     } else {
       client = std::make_unique<ThreadLocalActiveClient>(*this);
       client->host_ = host;
+      client->index_ = index;
       client->redis_client_ =
           client_factory_.create(host, dispatcher_, *config_, redis_command_stats_, *(stats_scope_),
                                  auth_username_, auth_password_, false);
@@ -285,6 +366,79 @@ InstanceImpl::ThreadLocalPool::threadLocalActiveClient(Upstream::HostConstShared
   return client;
 }
 
+bool InstanceImpl::ThreadLocalPool::nearCacheTracking(const Upstream::HostConstSharedPtr& host) {
+  auto it = invalidation_clients_.find(host);
+  if (it != invalidation_clients_.end()) {
+    return it->second->state_ == NearCacheInvalidationClient::State::Subscribed;
+  }
+  auto backoff = near_cache_tracking_backoffs_.find(host);
+  if (backoff != near_cache_tracking_backoffs_.end() &&
+      dispatcher_.timeSource().monotonicTime() < backoff->second.retry_after_) {
+    return false;
+  }
+  NearCacheInvalidationClientPtr& client = invalidation_clients_[host];
+  client = std::make_unique<NearCacheInvalidationClient>(*this, host);
+  client->redis_client_ =
+      client_factory_.create(host, dispatcher_, *config_, redis_command_stats_, *(stats_scope_),
+                             auth_username_, auth_password_, false);
+  client->redis_client_->addConnectionCallbacks(*client);
+  client->redis_client_->setPushCallbacks(*client);
+  client->redis_client_->makeRequest(makeCommand({"CLIENT", "ID"}), *client);
+  return false;
+}
+
+void InstanceImpl::ThreadLocalPool::onNearCacheTrackingFailure(
+    const Upstream::HostConstSharedPtr& host) {
+  redis_cluster_stats_.near_cache_tracking_failed_.inc();
+  NearCacheTrackingBackoff& backoff = near_cache_tracking_backoffs_[host];
+  backoff.backoff_ = backoff.backoff_ == std::chrono::milliseconds::zero()
+                         ? NearCacheTrackingBaseBackoff
+                         : std::min(2 * backoff.backoff_, NearCacheTrackingMaxBackoff);
+  backoff.retry_after_ = dispatcher_.timeSource().monotonicTime() + backoff.backoff_;
+  ENVOY_LOG(debug, "not tracking keys of host '{}' for the near cache for {}ms",
+            host->address()->asString(), backoff.backoff_.count());
+}
+
+bool InstanceImpl::ThreadLocalPool::nearCacheableRequest(
+    const Common::Redis::RespValue& request) const {
+  if (request.type() != Common::Redis::RespType::Array || request.asArray().size() != 2) {
+    return false;
+  }
+  const Common::Redis::RespValue& command = request.asArray()[0];
+  const Common::Redis::RespValue& key = request.asArray()[1];
+  return command.type() == Common::Redis::RespType::BulkString &&
+         key.type() == Common::Redis::RespType::BulkString &&
+         absl::EqualsIgnoreCase(command.asString(), Common::Redis::SupportedCommands::get()) &&
+         near_cache_->cacheableKey(key.asString());
+}
+
+void InstanceImpl::ThreadLocalPool::cacheResponse(const PendingRequest& request,
+                                                  const Common::Redis::RespValue& response) {
+  // Keys invalidated since the request was made may have been changed after the response was
+  // sent, and the invalidation client of the host may have closed.
+  if (near_cache_->generation() != request.near_cache_generation_ ||
+      (response.type() != Common::Redis::RespType::BulkString &&
+       response.type() != Common::Redis::RespType::Null)) {
+    return;
+  }
+  const uint64_t evicted =
+      near_cache_->insert(getRequest(request.incoming_request_).asArray()[1].asString(), response);
+  redis_cluster_stats_.near_cache_evicted_.add(evicted);
+}
+
+Common::Redis::RespValuePtr InstanceImpl::ThreadLocalPool::cachedResponse(const std::string& key) {
+  if (near_cache_ == nullptr || !near_cache_->cacheableKey(key)) {
+    return nullptr;
+  }
+  Common::Redis::RespValuePtr value = near_cache_->lookup(key);
+  if (value != nullptr) {
+    redis_cluster_stats_.near_cache_hit_.inc();
+  } else {
+    redis_cluster_stats_.near_cache_miss_.inc();
+  }
+  return value;
+}
+
 Common::Redis::Client::PoolRequest*
 InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&& request,
                                            PoolCallbacks& callbacks,
@@ -320,14 +474,25 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&&
   PendingRequest& pending_request = pending_requests_.back();
 
   if (!transaction.active_) {
-    ThreadLocalActiveClientPtr& client = this->threadLocalActiveClient(host);
+    // Spread the requests over the connections to the host by the hash of their key, so that the
+    // requests for a key stay in order on one connection.
+    uint32_t index = 0;
+    if (config_->connectionsPerHost() > 1) {
+      index = lb_context.computeHashKey().value_or(0) % config_->connectionsPerHost();
+    }
+    ThreadLocalActiveClientPtr& client = this->threadLocalActiveClient(host, index);
     if (!client) {
       ENVOY_LOG(debug, "redis connection is rate limited, erasing empty client");
       pending_request.request_handler_ = nullptr;
       onRequestCompleted();
-      client_map_.erase(host);
+      eraseClientsIfEmpty(host);
       return nullptr;
     }
+    if (near_cache_ != nullptr &&
+        nearCacheableRequest(getRequest(pending_request.incoming_request_))) {
+      pending_request.cacheable_ = nearCacheTracking(host);
+      pending_request.near_cache_generation_ = near_cache_->generation();
+    }
     pending_request.request_handler_ = client->redis_client_->makeRequest(
         getRequest(pending_request.incoming_request_), pending_request);
   } else {
@@ -406,10 +571,12 @@ Common::Redis::Client::PoolRequest* InstanceImpl::ThreadLocalPool::makeRequestTo
     it = host_address_map_.find(host_address_map_key);
   }
 
-  ThreadLocalActiveClientPtr& client = threadLocalActiveClient(it->second);
+  // Redirected requests, and the ASKING requests which precede them, all use the first connection
+  // to the host, so that they are sent in order.
+  ThreadLocalActiveClientPtr& client = threadLocalActiveClient(it->second, 0);
   if (!client) {
     ENVOY_LOG(debug, "redis connection is rate limited, erasing empty client");
-    client_map_.erase(it->second);
+    eraseClientsIfEmpty(it->second);
     return nullptr;
   }
 
@@ -429,10 +596,12 @@ void InstanceImpl::ThreadLocalPool::onRequestCompleted() {
 void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
-    auto client_to_delete = parent_.client_map_.find(host_);
-    if (client_to_delete != parent_.client_map_.end()) {
+    auto clients = parent_.client_map_.find(host_);
+    if (clients != parent_.client_map_.end() && clients->second[index_].get() == this) {
+      // Keep this alive until it is done with its members.
+      ThreadLocalActiveClientPtr client_to_delete = std::move(clients->second[index_]);
       parent_.dispatcher_.deferredDelete(std::move(redis_client_));
-      parent_.client_map_.erase(client_to_delete);
+      parent_.eraseClientsIfEmpty(host_);
     } else {
       for (auto it = parent_.clients_to_drain_.begin(); it != parent_.clients_to_drain_.end();
            it++) {
@@ -449,6 +618,93 @@ void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent eve
   }
 }
 
+void InstanceImpl::NearCacheInvalidationClient::onEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::RemoteClose &&
+      event != Network::ConnectionEvent::LocalClose) {
+    return;
+  }
+  auto it = parent_.invalidation_clients_.find(host_);
+  ASSERT(it != parent_.invalidation_clients_.end() && it->second.get() == this);
+  // Keep this alive until it is done with its members.
+  NearCacheInvalidationClientPtr client_to_delete = std::move(it->second);
+  parent_.invalidation_clients_.erase(it);
+  parent_.dispatcher_.deferredDelete(std::move(redis_client_));
+  if (state_ == State::Subscribed) {
+    // The changes of the keys of the host are no longer reported, so cached keys may get stale.
+    parent_.near_cache_->clear();
+    parent_.redis_cluster_stats_.near_cache_cleared_.inc();
+  } else if (!removed_) {
+    // The host couldn't be connected to, or rejected a request, e.g. as it doesn't support
+    // tracking, so back off before trying again.
+    parent_.onNearCacheTrackingFailure(host_);
+  }
+}
+
+void InstanceImpl::NearCacheInvalidationClient::onResponse(Common::Redis::RespValuePtr&& value) {
+  switch (state_) {
+  case State::ClientId: {
+    if (value->type() != Common::Redis::RespType::Integer) {
+      break;
+    }
+    // Broadcasting mode reports the changes of all the keys with the prefixes, whichever client
+    // read them. Subscribing is pipelined, as it is the last request the client can make.
+    std::vector<std::string> tracking{
+        "CLIENT", "TRACKING", "ON", "REDIRECT", absl::StrCat(value->asInteger()), "BCAST"};
+    for (const std::string& prefix : parent_.near_cache_->keyPrefixes()) {
+      tracking.push_back("PREFIX");
+      tracking.push_back(prefix);
+    }
+    state_ = State::Tracking;
+    redis_client_->makeRequest(makeCommand(std::move(tracking)), *this);
+    redis_client_->makeRequest(makeCommand({"SUBSCRIBE", nearCacheInvalidationChannel()}), *this);
+    return;
+  }
+  case State::Tracking:
+    if (value->type() != Common::Redis::RespType::SimpleString) {
+      break;
+    }
+    state_ = State::Subscribe;
+    return;
+  case State::Subscribe:
+    if (value->type() != Common::Redis::RespType::Array) {
+      break;
+    }
+    ENVOY_LOG(debug, "tracking keys of host '{}' for the near cache",
+              host_->address()->asString());
+    state_ = State::Subscribed;
+    parent_.near_cache_tracking_backoffs_.erase(host_);
+    return;
+  case State::Subscribed:
+    // Values received once subscribed are pushed, as no request is made.
+    break;
+  }
+  ENVOY_LOG(debug, "failed to track keys of host '{}' for the near cache: {}",
+            host_->address()->asString(), value->toString());
+  redis_client_->close();
+}
+
+void InstanceImpl::NearCacheInvalidationClient::onPushValue(Common::Redis::RespValuePtr&& value) {
+  // Invalidation messages look like ["message", "__redis__:invalidate", keys], where keys is the
+  // array of the changed keys, or null if all the keys changed, e.g. after FLUSHALL.
+  if (value->type() != Common::Redis::RespType::Array || value->asArray().size() != 3 ||
+      value->asArray()[1].type() != Common::Redis::RespType::BulkString ||
+      value->asArray()[1].asString() != nearCacheInvalidationChannel()) {
+    return;
+  }
+  const Common::Redis::RespValue& keys = value->asArray()[2];
+  if (keys.type() == Common::Redis::RespType::Null) {
+    parent_.near_cache_->clear();
+    parent_.redis_cluster_stats_.near_cache_cleared_.inc();
+  } else if (keys.type() == Common::Redis::RespType::Array) {
+    for (const Common::Redis::RespValue& key : keys.asArray()) {
+      if (key.type() == Common::Redis::RespType::BulkString &&
+          parent_.near_cache_->invalidate(key.asString())) {
+        parent_.redis_cluster_stats_.near_cache_invalidated_.inc();
+      }
+    }
+  }
+}
+
 InstanceImpl::PendingRequest::PendingRequest(InstanceImpl::ThreadLocalPool& parent,
                                              RespVariant&& incoming_request,
                                              PoolCallbacks& pool_callbacks,
@@ -470,6 +726,9 @@ InstanceImpl::PendingRequest::~PendingRequest() {
 
 void InstanceImpl::PendingRequest::onResponse(Common::Redis::RespValuePtr&& response) {
   request_handler_ = nullptr;
+  if (cacheable_) {
+    parent_.cacheResponse(*this, *response);
+  }
   pool_callbacks_.onResponse(std::move(response));
   parent_.onRequestCompleted();
 }
@@ -484,6 +743,8 @@ void InstanceImpl::PendingRequest::onFailure() {
 void InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& value,
                                                  const std::string& host_address,
                                                  bool ask_redirection) {
+  // The host redirected to may not report the changes of the key to the near cache.
+  cacheable_ = false;
   if (!parent_.dns_cache_) {
     doRedirection(std::move(value), host_address, ask_redirection);
     return;
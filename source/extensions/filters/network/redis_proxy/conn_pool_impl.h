@@ -28,8 +28,10 @@
 #include "source/extensions/filters/network/common/redis/codec_impl.h"
 #include "source/extensions/filters/network/common/redis/utility.h"
 #include "source/extensions/filters/network/redis_proxy/conn_pool.h"
+#include "source/extensions/filters/network/redis_proxy/near_cache.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -43,7 +45,13 @@ namespace ConnPool {
 #define REDIS_CLUSTER_STATS(COUNTER)                                                               \
   COUNTER(upstream_cx_drained)                                                                     \
   COUNTER(max_upstream_unknown_connections_reached)                                                \
-  COUNTER(connection_rate_limited)
+  COUNTER(connection_rate_limited)                                                                 \
+  COUNTER(near_cache_hit)                                                                          \
+  COUNTER(near_cache_miss)                                                                         \
+  COUNTER(near_cache_invalidated)                                                                  \
+  COUNTER(near_cache_evicted)                                                                      \
+  COUNTER(near_cache_cleared)                                                                      \
+  COUNTER(near_cache_tracking_failed)
 
 struct RedisClusterStats {
   REDIS_CLUSTER_STATS(GENERATE_COUNTER_STRUCT)
@@ -83,6 +91,7 @@ public:
   Common::Redis::Client::PoolRequest*
   makeRequestToHost(const std::string& host_address, const Common::Redis::RespValue& request,
                     Common::Redis::Client::ClientCallbacks& callbacks);
+  Common::Redis::RespValuePtr cachedResponse(const std::string& key) override;
 
   void init();
 
@@ -102,11 +111,62 @@ private:
 
     ThreadLocalPool& parent_;
     Upstream::HostConstSharedPtr host_;
+    // The index of this client among the clients of host_ in ThreadLocalPool::client_map_.
+    uint32_t index_{};
     Common::Redis::Client::ClientPtr redis_client_;
   };
 
   using ThreadLocalActiveClientPtr = std::unique_ptr<ThreadLocalActiveClient>;
 
+  // The connection to a host over which the host reports the keys changed on it, to invalidate
+  // them in the near cache. Redis only reports them as pub/sub messages to RESP2 clients, so the
+  // connection enables tracking with itself as the redirection target, then subscribes to the
+  // invalidation channel, after which it can't make any other request.
+  struct NearCacheInvalidationClient : public Network::ConnectionCallbacks,
+                                       public Common::Redis::Client::ClientCallbacks,
+                                       public Common::Redis::Client::PushCallbacks,
+                                       public Logger::Loggable<Logger::Id::redis> {
+    enum class State { ClientId, Tracking, Subscribe, Subscribed };
+
+    NearCacheInvalidationClient(ThreadLocalPool& parent, Upstream::HostConstSharedPtr host)
+        : parent_(parent), host_(std::move(host)) {}
+
+    // Network::ConnectionCallbacks
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+    // Common::Redis::Client::ClientCallbacks
+    void onResponse(Common::Redis::RespValuePtr&& value) override;
+    // Requests only fail when the connection closes, which onEvent() handles.
+    void onFailure() override {}
+    void onRedirection(Common::Redis::RespValuePtr&&, const std::string&, bool) override {
+      redis_client_->close();
+    }
+
+    // Common::Redis::Client::PushCallbacks
+    void onPushValue(Common::Redis::RespValuePtr&& value) override;
+
+    ThreadLocalPool& parent_;
+    const Upstream::HostConstSharedPtr host_;
+    // The state of the request whose response is expected next.
+    State state_{State::ClientId};
+    // Whether the client is closed because the host or the pool is gone, which is not a failure.
+    bool removed_{};
+    Common::Redis::Client::ClientPtr redis_client_;
+  };
+
+  // When the tracking of a host may be set up again after it failed, and how long to wait if it
+  // fails again, so that a host which can't track keys isn't reconnected to on every request.
+  struct NearCacheTrackingBackoff {
+    MonotonicTime retry_after_;
+    std::chrono::milliseconds backoff_{};
+  };
+
+  using NearCacheInvalidationClientPtr = std::unique_ptr<NearCacheInvalidationClient>;
+  // The clients of a host, one per connection, which are null until the connection is needed.
+  using ThreadLocalActiveClients = std::vector<ThreadLocalActiveClientPtr>;
+
   struct PendingRequest
       : public Common::Redis::Client::ClientCallbacks,
         public Common::Redis::Client::PoolRequest,
@@ -142,6 +202,9 @@ private:
     bool ask_redirection_;
     Extensions::Common::DynamicForwardProxy::DnsCache::LoadDnsCacheEntryHandlePtr
         cache_load_handle_;
+    // Whether the response may be cached in the near cache, as of near_cache_generation_.
+    bool cacheable_{};
+    uint64_t near_cache_generation_{};
   };
 
   struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject,
@@ -151,7 +214,15 @@ private:
                     std::string cluster_name,
                     const Extensions::Common::DynamicForwardProxy::DnsCacheSharedPtr& dns_cache);
     ~ThreadLocalPool() override;
-    ThreadLocalActiveClientPtr& threadLocalActiveClient(Upstream::HostConstSharedPtr host);
+    ThreadLocalActiveClientPtr& threadLocalActiveClient(Upstream::HostConstSharedPtr host,
+                                                        uint32_t index);
+    void eraseClientsIfEmpty(const Upstream::HostConstSharedPtr& host);
+    void closeClients();
+    bool nearCacheTracking(const Upstream::HostConstSharedPtr& host);
+    void onNearCacheTrackingFailure(const Upstream::HostConstSharedPtr& host);
+    bool nearCacheableRequest(const Common::Redis::RespValue& request) const;
+    void cacheResponse(const PendingRequest& request, const Common::Redis::RespValue& response);
+    Common::Redis::RespValuePtr cachedResponse(const std::string& key);
     Common::Redis::Client::PoolRequest*
     makeRequest(const std::string& key, RespVariant&& request, PoolCallbacks& callbacks,
                 Common::Redis::Client::Transaction& transaction);
@@ -180,7 +251,8 @@ private:
     const Extensions::Common::DynamicForwardProxy::DnsCacheSharedPtr dns_cache_{nullptr};
     Upstream::ClusterUpdateCallbacksHandlePtr cluster_update_handle_;
     Upstream::ThreadLocalCluster* cluster_{};
-    absl::node_hash_map<Upstream::HostConstSharedPtr, ThreadLocalActiveClientPtr> client_map_;
+    // Every host in the map has at least one client.
+    absl::node_hash_map<Upstream::HostConstSharedPtr, ThreadLocalActiveClients> client_map_;
     absl::node_hash_map<Upstream::HostConstSharedPtr, TokenBucketPtr> cx_rate_limiter_map_;
     Envoy::Common::CallbackHandlePtr host_set_member_update_cb_handle_;
     absl::node_hash_map<std::string, Upstream::HostConstSharedPtr> host_address_map_;
@@ -189,6 +261,13 @@ private:
     std::list<Upstream::HostSharedPtr> created_via_redirect_hosts_;
     std::list<ThreadLocalActiveClientPtr> clients_to_drain_;
     std::list<PendingRequest> pending_requests_;
+    // The near cache and its invalidation clients, which are only set if the near cache is
+    // configured.
+    std::unique_ptr<NearCache> near_cache_;
+    absl::node_hash_map<Upstream::HostConstSharedPtr, NearCacheInvalidationClientPtr>
+        invalidation_clients_;
+    absl::node_hash_map<Upstream::HostConstSharedPtr, NearCacheTrackingBackoff>
+        near_cache_tracking_backoffs_;
 
     /* This timer is used to poll the active clients in clients_to_drain_ to determine whether they
      * have been drained (have no active requests) or not. It is only enabled after a client has
@@ -217,6 +296,8 @@ private:
   RedisClusterStats redis_cluster_stats_;
   const Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
   const Extensions::Common::DynamicForwardProxy::DnsCacheSharedPtr dns_cache_{nullptr};
+  const absl::optional<envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::NearCache>
+      near_cache_config_;
 };
 
 } // namespace ConnPool
@@ -0,0 +1,103 @@
+#include "source/extensions/filters/network/redis_proxy/near_cache.h"
+
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+NearCache::NearCache(
+    const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::NearCache& config,
+    TimeSource& time_source)
+    : max_bytes_(config.max_bytes()), ttl_(PROTOBUF_GET_MS_REQUIRED(config, ttl)),
+      key_prefixes_(config.key_prefixes().begin(), config.key_prefixes().end()),
+      time_source_(time_source) {}
+
+bool NearCache::cacheableKey(absl::string_view key) const {
+  if (key_prefixes_.empty()) {
+    return true;
+  }
+  for (const std::string& prefix : key_prefixes_) {
+    if (absl::StartsWith(key, prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Common::Redis::RespValuePtr NearCache::lookup(absl::string_view key) {
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  EntryList::iterator entry = it->second;
+  if (entry->expiry_ <= time_source_.monotonicTime()) {
+    erase(entry);
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, entry);
+  return std::make_unique<Common::Redis::RespValue>(entry->value_);
+}
+
+uint64_t NearCache::insert(absl::string_view key, const Common::Redis::RespValue& value) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  const uint64_t bytes = entryBytes(key, value);
+  if (bytes > max_bytes_) {
+    return 0;
+  }
+  uint64_t evicted = 0;
+  while (bytes_ + bytes > max_bytes_) {
+    erase(std::prev(entries_.end()));
+    ++evicted;
+  }
+  entries_.emplace_front(key, value, time_source_.monotonicTime() + ttl_, bytes);
+  index_.emplace(entries_.front().key_, entries_.begin());
+  bytes_ += bytes;
+  return evicted;
+}
+
+bool NearCache::invalidate(absl::string_view key) {
+  ++generation_;
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  erase(it->second);
+  return true;
+}
+
+void NearCache::clear() {
+  ++generation_;
+  index_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+uint64_t NearCache::entryBytes(absl::string_view key, const Common::Redis::RespValue& value) {
+  uint64_t bytes = sizeof(Entry) + key.size();
+  if (value.type() == Common::Redis::RespType::BulkString) {
+    // Avoid copying a buffered value into a string to get its size.
+    std::shared_ptr<const Buffer::Instance> buffer = value.buffer();
+    bytes += buffer != nullptr ? buffer->length() : value.asString().size();
+  }
+  return bytes;
+}
+
+void NearCache::erase(EntryList::iterator entry) {
+  bytes_ -= entry->bytes_;
+  index_.erase(entry->key_);
+  entries_.erase(entry);
+}
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
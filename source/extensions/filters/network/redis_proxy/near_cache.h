@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+
+#include "source/common/common/non_copyable.h"
+#include "source/extensions/filters/network/common/redis/codec.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+/**
+ * A cache of the responses to reads of keys, bounded by the total size of its entries, which
+ * evicts the least recently used entries first. The cache is owned by one worker thread, and is
+ * not thread safe. It is kept consistent with the upstream by invalidating keys as the upstream
+ * reports their changes.
+ */
+class NearCache : NonCopyable {
+public:
+  NearCache(const envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::NearCache&
+                config,
+            TimeSource& time_source);
+
+  /**
+   * @return whether the responses to reads of a key may be cached, according to its prefix.
+   */
+  bool cacheableKey(absl::string_view key) const;
+
+  /**
+   * @return the prefixes of the keys which may be cached, none meaning all keys.
+   */
+  const std::vector<std::string>& keyPrefixes() const { return key_prefixes_; }
+
+  /**
+   * Looks up the response to a read of a key, and marks it as the most recently used.
+   * @param key supplies the key read.
+   * @return a copy of the cached response, or nullptr if the key is not cached or its entry has
+   *         expired.
+   */
+  Common::Redis::RespValuePtr lookup(absl::string_view key);
+
+  /**
+   * Caches the response to a read of a key, replacing any previous entry of the key.
+   * @param key supplies the key read.
+   * @param value supplies the response.
+   * @return the number of entries evicted to make room for the new one.
+   */
+  uint64_t insert(absl::string_view key, const Common::Redis::RespValue& value);
+
+  /**
+   * Invalidates a key, which has been changed upstream.
+   * @return whether the key was cached.
+   */
+  bool invalidate(absl::string_view key);
+
+  /**
+   * Invalidates all the keys.
+   */
+  void clear();
+
+  /**
+   * @return a number which changes whenever keys are invalidated, so that a response to a read
+   *         made before an invalidation, which may have been changed by the write that caused it,
+   *         is not cached.
+   */
+  uint64_t generation() const { return generation_; }
+
+  /**
+   * @return the total size of the entries.
+   */
+  uint64_t bytes() const { return bytes_; }
+
+  /**
+   * @return the number of entries.
+   */
+  uint64_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    Entry(absl::string_view key, const Common::Redis::RespValue& value, MonotonicTime expiry,
+          uint64_t bytes)
+        : key_(key), value_(value), expiry_(expiry), bytes_(bytes) {}
+
+    const std::string key_;
+    const Common::Redis::RespValue value_;
+    const MonotonicTime expiry_;
+    const uint64_t bytes_;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static uint64_t entryBytes(absl::string_view key, const Common::Redis::RespValue& value);
+  void erase(EntryList::iterator entry);
+
+  const uint64_t max_bytes_;
+  const std::chrono::milliseconds ttl_;
+  const std::vector<std::string> key_prefixes_;
+  TimeSource& time_source_;
+  // The entries, from the most to the least recently used.
+  EntryList entries_;
+  // The entries by key, which views the key of the entry.
+  absl::flat_hash_map<absl::string_view, EntryList::iterator> index_;
+  uint64_t bytes_{};
+  uint64_t generation_{};
+};
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
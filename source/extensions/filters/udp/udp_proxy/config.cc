@@ -1,6 +1,7 @@
 #include "source/extensions/filters/udp/udp_proxy/config.h"
 
 #include "source/common/formatter/substitution_format_string.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -111,6 +112,16 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
     tunneling_config_ = std::make_unique<TunnelingConfigImpl>(config.tunneling_config(), context);
   }
 
+  if (config.has_upstream_packet_writer_config()) {
+    auto& factory_factory = Config::Utility::getAndCheckFactory<
+        Network::UdpPacketWriterFactoryFactory>(config.upstream_packet_writer_config());
+    upstream_packet_writer_factory_ =
+        factory_factory.createUdpPacketWriterFactory(config.upstream_packet_writer_config());
+  }
+  if (upstream_packet_writer_factory_ == nullptr) {
+    upstream_packet_writer_factory_ = std::make_unique<Network::UdpDefaultWriterFactory>();
+  }
+
   for (const auto& filter : config.session_filters()) {
     ENVOY_LOG(debug, "    UDP session filter #{}", filter_factories_.size());
     ENVOY_LOG(debug, "      name: {}", filter.name());
@@ -77,6 +77,9 @@ public:
   const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const override {
     return upstream_socket_config_;
   }
+  Network::UdpPacketWriterFactory& upstreamPacketWriterFactory() const override {
+    return *upstream_packet_writer_factory_;
+  }
   const std::vector<AccessLog::InstanceSharedPtr>& sessionAccessLogs() const override {
     return session_access_logs_;
   }
@@ -111,6 +114,7 @@ private:
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
   const Network::ResolvedUdpSocketConfig upstream_socket_config_;
+  Network::UdpPacketWriterFactoryPtr upstream_packet_writer_factory_;
   std::vector<AccessLog::InstanceSharedPtr> session_access_logs_;
   std::vector<AccessLog::InstanceSharedPtr> proxy_access_logs_;
   UdpTunnelingConfigPtr tunneling_config_;
@@ -295,6 +295,12 @@ UdpProxyFilter::UdpActiveSession::UdpActiveSession(
     : ActiveSession(cluster, std::move(addresses), std::move(host)),
       use_original_src_ip_(cluster.filter_.config_->usingOriginalSrcIp()) {}
 
+UdpProxyFilter::UdpActiveSession::~UdpActiveSession() {
+  if (batched_tx_datagrams_ > 0) {
+    flushUpstream();
+  }
+}
+
 UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
@@ -367,9 +373,13 @@ void UdpProxyFilter::UdpActiveSession::onReadReady() {
   // TODO(mattklein123): We should not be passing *addresses_.local_ to this function as we are
   //                     not trying to populate the local address for received packets.
   uint32_t packets_dropped = 0;
+  rx_batch_datagrams_ = 0;
   const Api::IoErrorPtr result = Network::Utility::readPacketsFromSocket(
       udp_socket_->ioHandle(), *addresses_.local_, *this, cluster_.filter_.config_->timeSource(),
       cluster_.filter_.config_->upstreamSocketConfig().prefer_gro_, packets_dropped);
+  if (rx_batch_datagrams_ > 0) {
+    cluster_.cluster_stats_.sess_rx_batch_size_.recordValue(rx_batch_datagrams_);
+  }
   if (result == nullptr) {
     udp_socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
     return;
@@ -455,14 +465,45 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
             host_->address()->asStringView());
 
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
-      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  // Batching writers copy the datagram from a single slice, which an empty buffer does not have,
+  // so an empty datagram is written on its own, after the datagrams batched before it.
+  const bool batch = flush_upstream_cb_ != nullptr && tx_buffer_length > 0;
+  if (batch) {
+    data.buffer_->linearize(tx_buffer_length);
+  } else if (batched_tx_datagrams_ > 0) {
+    flush_upstream_cb_->cancel();
+    flushUpstream();
+  }
+  Api::IoCallUint64Result rc =
+      batch || flush_upstream_cb_ == nullptr
+          ? upstream_writer_->writePacket(*data.buffer_, local_ip, *host_->address())
+          : Network::Utility::writeToSocket(udp_socket_->ioHandle(), *data.buffer_, local_ip,
+                                            *host_->address());
 
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
-  } else {
-    cluster_.cluster_stats_.sess_tx_datagrams_.inc();
-    cluster_.cluster_.info()->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+    // The upstream socket is not watched for writability, so the datagram is dropped and the
+    // next one is attempted, as with a writer that does not block.
+    upstream_writer_->setWritable();
+    return;
+  }
+
+  cluster_.cluster_stats_.sess_tx_datagrams_.inc();
+  cluster_.cluster_.info()->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+  if (batch) {
+    ++batched_tx_datagrams_;
+    flush_upstream_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void UdpProxyFilter::UdpActiveSession::flushUpstream() {
+  cluster_.cluster_stats_.sess_tx_batch_size_.recordValue(batched_tx_datagrams_);
+  batched_tx_datagrams_ = 0;
+  const Api::IoCallUint64Result rc = upstream_writer_->flush();
+  if (!rc.ok()) {
+    ENVOY_LOG(debug, "cannot flush upstream: {}", rc.err_->getErrorDetails());
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+    upstream_writer_->setWritable();
   }
 }
 
@@ -509,10 +550,15 @@ void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConst
   // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
   //       is bound until the first packet is sent to the upstream host.
   udp_socket_ = cluster_.filter_.createUdpSocket(host);
+  Event::Dispatcher& dispatcher = cluster_.filter_.read_callbacks_->udpListener().dispatcher();
   udp_socket_->ioHandle().initializeFileEvent(
-      cluster_.filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
+      dispatcher, [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
       Event::FileReadyType::Read);
+  upstream_writer_ = cluster_.filter_.config_->upstreamPacketWriterFactory().createUdpPacketWriter(
+      udp_socket_->ioHandle(), cluster_.cluster_.info()->statsScope());
+  if (upstream_writer_->isBatchMode()) {
+    flush_upstream_cb_ = dispatcher.createSchedulableCallback([this]() { flushUpstream(); });
+  }
 
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
@@ -584,6 +630,7 @@ void UdpProxyFilter::UdpActiveSession::processPacket(
             host_ != nullptr ? host_->address()->asStringView() : "unknown");
 
   cluster_.cluster_stats_.sess_rx_datagrams_.inc();
+  ++rx_batch_datagrams_;
   cluster_.cluster_.info()->trafficStats()->upstream_cx_rx_bytes_total_.add(rx_buffer_length);
 
   Network::UdpRecvData recv_data{
@@ -3,10 +3,12 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/http/header_evaluator.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/stream_info/uint32_accessor.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -67,7 +69,7 @@ struct UdpProxyDownstreamStats {
 /**
  * All UDP proxy upstream cluster stats. @see stats_macros.h
  */
-#define ALL_UDP_PROXY_UPSTREAM_STATS(COUNTER)                                                      \
+#define ALL_UDP_PROXY_UPSTREAM_STATS(COUNTER, HISTOGRAM)                                           \
   COUNTER(sess_rx_datagrams)                                                                       \
   COUNTER(sess_rx_datagrams_dropped)                                                               \
   COUNTER(sess_rx_errors)                                                                          \
@@ -75,13 +77,15 @@ struct UdpProxyDownstreamStats {
   COUNTER(sess_tunnel_success)                                                                     \
   COUNTER(sess_tunnel_failure)                                                                     \
   COUNTER(sess_tunnel_buffer_overflow)                                                             \
-  COUNTER(sess_tx_errors)
+  COUNTER(sess_tx_errors)                                                                          \
+  HISTOGRAM(sess_rx_batch_size, Unspecified)                                                       \
+  HISTOGRAM(sess_tx_batch_size, Unspecified)
 
 /**
  * Struct definition for all UDP proxy upstream stats. @see stats_macros.h
  */
 struct UdpProxyUpstreamStats {
-  ALL_UDP_PROXY_UPSTREAM_STATS(GENERATE_COUNTER_STRUCT)
+  ALL_UDP_PROXY_UPSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -121,6 +125,7 @@ public:
   virtual UdpProxyDownstreamStats& stats() const PURE;
   virtual TimeSource& timeSource() const PURE;
   virtual const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const PURE;
+  virtual Network::UdpPacketWriterFactory& upstreamPacketWriterFactory() const PURE;
   virtual const std::vector<AccessLog::InstanceSharedPtr>& sessionAccessLogs() const PURE;
   virtual const std::vector<AccessLog::InstanceSharedPtr>& proxyAccessLogs() const PURE;
   virtual const FilterChainFactory& sessionFilterFactory() const PURE;
@@ -588,7 +593,7 @@ private:
   public:
     UdpActiveSession(ClusterInfo& parent, Network::UdpRecvData::LocalPeerAddresses&& addresses,
                      const Upstream::HostConstSharedPtr& host);
-    ~UdpActiveSession() override = default;
+    ~UdpActiveSession() override;
 
     // ActiveSession
     void createUpstream() override;
@@ -616,6 +621,7 @@ private:
   private:
     void onReadReady();
     void createUdpSocket(const Upstream::HostConstSharedPtr& host);
+    void flushUpstream();
 
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
@@ -624,6 +630,13 @@ private:
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
+    Network::UdpPacketWriterPtr upstream_writer_;
+    // When the writer batches datagrams, they are flushed at the end of the event loop iteration
+    // in which they were written.
+    Event::SchedulableCallbackPtr flush_upstream_cb_;
+    uint64_t batched_tx_datagrams_{};
+    // The number of datagrams received from the upstream during the current read event.
+    uint64_t rx_batch_datagrams_{};
   };
 
   /**
@@ -777,7 +790,8 @@ private:
   private:
     static UdpProxyUpstreamStats generateStats(Stats::Scope& scope) {
       const auto final_prefix = "udp";
-      return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
+      return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
     }
 
     ActiveSession*
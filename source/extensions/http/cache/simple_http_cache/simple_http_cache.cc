@@ -6,6 +6,9 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/http/header_map_impl.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -41,14 +44,24 @@ public:
     body_ = std::move(entry.body_);
     trailers_ = std::move(entry.trailers_);
     cb(entry.response_headers_ ? request_.makeLookupResult(std::move(entry.response_headers_),
-                                                           std::move(entry.metadata_), body_.size(),
-                                                           trailers_ != nullptr)
+                                                           std::move(entry.metadata_),
+                                                           body_->size(), trailers_ != nullptr)
                                : LookupResult{});
   }
 
   void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
-    ASSERT(range.end() <= body_.length(), "Attempt to read past end of body.");
-    cb(std::make_unique<Buffer::OwnedImpl>(&body_[range.begin()], range.length()));
+    ASSERT(range.end() <= body_->length(), "Attempt to read past end of body.");
+    // The buffer references the stored body, which the fragment keeps alive until it is drained.
+    auto buffer = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      auto* fragment = new Buffer::BufferFragmentImpl(
+          body_->data() + range.begin(), range.length(),
+          [body = body_](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+            delete fragment;
+          });
+      buffer->addBufferFragment(*fragment);
+    }
+    cb(std::move(buffer));
   }
 
   // The cache must call cb with the cached trailers.
@@ -63,19 +76,18 @@ public:
 private:
   SimpleHttpCache& cache_;
   const LookupRequest request_;
-  std::string body_;
+  std::shared_ptr<const std::string> body_;
   Http::ResponseTrailerMapPtr trailers_;
 };
 
+// Owns the lookup context it is made from, as the request headers and allow list of its request
+// are read when the response is committed, which may be after the caller is gone.
 class SimpleInsertContext : public InsertContext {
 public:
-  SimpleInsertContext(LookupContext& lookup_context, SimpleHttpCache& cache)
-      : key_(dynamic_cast<SimpleLookupContext&>(lookup_context).request().key()),
-        request_headers_(
-            dynamic_cast<SimpleLookupContext&>(lookup_context).request().requestHeaders()),
-        vary_allow_list_(
-            dynamic_cast<SimpleLookupContext&>(lookup_context).request().varyAllowList()),
-        cache_(cache) {}
+  SimpleInsertContext(std::unique_ptr<SimpleLookupContext> lookup_context, SimpleHttpCache& cache)
+      : lookup_context_(std::move(lookup_context)), key_(lookup_context_->request().key()),
+        request_headers_(lookup_context_->request().requestHeaders()),
+        vary_allow_list_(lookup_context_->request().varyAllowList()), cache_(cache) {}
 
   void insertHeaders(const Http::ResponseHeaderMap& response_headers,
                      const ResponseMetadata& metadata, InsertCallback insert_success,
@@ -110,7 +122,7 @@ public:
     insert_complete(commit());
   }
 
-  void onDestroy() override {}
+  void onDestroy() override { lookup_context_->onDestroy(); }
 
 private:
   bool commit() {
@@ -125,6 +137,7 @@ private:
     }
   }
 
+  const std::unique_ptr<SimpleLookupContext> lookup_context_;
   Key key_;
   const Http::RequestHeaderMap& request_headers_;
   const VaryAllowList& vary_allow_list_;
@@ -137,6 +150,27 @@ private:
 };
 } // namespace
 
+SimpleHttpCache::Shard::Shard(Stats::Scope& scope, const std::string& prefix)
+    : stats_({ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                          POOL_GAUGE_PREFIX(scope, prefix))}) {}
+
+SimpleHttpCache::SimpleHttpCache(
+    const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig& config,
+    Stats::Scope& scope)
+    : max_shard_size_bytes_(config.max_size_bytes() /
+                            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shard_count, 16)) {
+  const uint32_t shard_count = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shard_count, 16);
+  shards_.reserve(shard_count);
+  for (uint32_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>(scope, absl::StrCat("simple_http_cache.shard_", i)));
+  }
+}
+
+size_t SimpleHttpCache::shardIndex(const Key& key) const {
+  // The high bits of the hash select the shard, as the maps of the shards use the low bits.
+  return (stableHashKey(key) >> 32) % shards_.size();
+}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request,
                                                     Http::StreamDecoderFilterCallbacks&) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
@@ -147,88 +181,171 @@ void SimpleHttpCache::updateHeaders(const LookupContext& lookup_context,
                                     const ResponseMetadata& metadata,
                                     std::function<void(bool)> on_complete) {
   const auto& simple_lookup_context = static_cast<const SimpleLookupContext&>(lookup_context);
-  const Key& key = simple_lookup_context.request().key();
-  absl::WriterMutexLock lock(&mutex_);
-  auto iter = map_.find(key);
-  if (iter == map_.end() || !iter->second.response_headers_) {
-    on_complete(false);
-    return;
-  }
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    absl::optional<Key> varied_key =
-        variedRequestKey(simple_lookup_context.request(), *iter->second.response_headers_);
-    if (!varied_key.has_value()) {
-      on_complete(false);
-      return;
+  on_complete(updateEntry(simple_lookup_context.request(), response_headers, metadata));
+}
+
+bool SimpleHttpCache::updateEntry(const LookupRequest& request,
+                                  const Http::ResponseHeaderMap& response_headers,
+                                  const ResponseMetadata& metadata) {
+  absl::optional<Key> varied_key;
+  {
+    Shard& key_shard = shardFor(request.key());
+    absl::MutexLock lock(&key_shard.mutex_);
+    auto iter = key_shard.map_.find(request.key());
+    if (iter == key_shard.map_.end()) {
+      return false;
     }
-    iter = map_.find(varied_key.value());
-    if (iter == map_.end() || !iter->second.response_headers_) {
-      on_complete(false);
-      return;
+    const Http::ResponseHeaderMap& stored_headers = *iter->second->entry_.response_headers_;
+    if (!VaryHeaderUtils::hasVary(stored_headers)) {
+      updateStoredEntry(key_shard, iter->second, response_headers, metadata);
+      return true;
     }
+    varied_key = variedRequestKey(request, stored_headers);
   }
-  Entry& entry = iter->second;
+  // The varied response may be stored in another shard, so the lock of the shard of the request
+  // key is released before it is updated.
+  if (!varied_key.has_value()) {
+    return false;
+  }
+  Shard& varied_shard = shardFor(varied_key.value());
+  absl::MutexLock lock(&varied_shard.mutex_);
+  auto iter = varied_shard.map_.find(varied_key.value());
+  if (iter == varied_shard.map_.end()) {
+    return false;
+  }
+  updateStoredEntry(varied_shard, iter->second, response_headers, metadata);
+  return true;
+}
 
-  applyHeaderUpdate(response_headers, *entry.response_headers_);
-  entry.metadata_ = metadata;
-  on_complete(true);
+void SimpleHttpCache::updateStoredEntry(Shard& shard, StoredEntryList::iterator stored,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const ResponseMetadata& metadata) {
+  applyHeaderUpdate(response_headers, *stored->entry_.response_headers_);
+  stored->entry_.metadata_ = metadata;
+
+  shard.size_bytes_ -= stored->size_;
+  stored->size_ = entrySize(stored->key_, stored->entry_);
+  shard.size_bytes_ += stored->size_;
+  shard.entries_.splice(shard.entries_.begin(), shard.entries_, stored);
+  evict(shard);
+  updateGauges(shard);
 }
 
-SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
+SimpleHttpCache::Entry SimpleHttpCache::lookupEntry(Shard& shard, const Key& key) {
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter == shard.map_.end()) {
     return Entry{};
   }
-  ASSERT(iter->second.response_headers_);
+  shard.entries_.splice(shard.entries_.begin(), shard.entries_, iter->second);
+
+  const Entry& entry = iter->second->entry_;
+  ASSERT(entry.response_headers_);
+  Http::ResponseTrailerMapPtr trailers_map;
+  if (entry.trailers_) {
+    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry.trailers_);
+  }
+  return SimpleHttpCache::Entry{
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+      entry.metadata_, entry.body_, std::move(trailers_map)};
+}
 
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
+SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
+  Shard& key_shard = shardFor(request.key());
+  Entry entry = lookupEntry(key_shard, request.key());
+  if (entry.response_headers_ && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    return varyLookup(request, entry.response_headers_);
+  }
+  if (entry.response_headers_) {
+    key_shard.stats_.lookup_hits_.inc();
   } else {
-    Http::ResponseTrailerMapPtr trailers_map;
-    if (iter->second.trailers_) {
-      trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-    }
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+    key_shard.stats_.lookup_misses_.inc();
   }
+  return entry;
 }
 
 bool SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              ResponseMetadata&& metadata, std::string&& body,
                              Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
-                                     std::move(body), std::move(trailers)};
+  return insertEntry(key,
+                     SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                            std::make_shared<const std::string>(std::move(body)),
+                                            std::move(trailers)},
+                     true);
+}
+
+bool SimpleHttpCache::insertEntry(const Key& key, Entry&& entry, bool replace) {
+  const uint64_t size = entrySize(key, entry);
+  if (max_shard_size_bytes_ > 0 && size > max_shard_size_bytes_) {
+    return false;
+  }
+
+  Shard& key_shard = shardFor(key);
+  absl::MutexLock lock(&key_shard.mutex_);
+  auto iter = key_shard.map_.find(key);
+  if (iter != key_shard.map_.end()) {
+    if (!replace) {
+      return true;
+    }
+    key_shard.size_bytes_ -= iter->second->size_;
+    iter->second->entry_ = std::move(entry);
+    iter->second->size_ = size;
+    key_shard.entries_.splice(key_shard.entries_.begin(), key_shard.entries_, iter->second);
+  } else {
+    key_shard.entries_.push_front(StoredEntry{key, std::move(entry), size});
+    key_shard.map_.emplace(key, key_shard.entries_.begin());
+  }
+  key_shard.size_bytes_ += size;
+  evict(key_shard);
+  updateGauges(key_shard);
   return true;
 }
 
+void SimpleHttpCache::evict(Shard& shard) {
+  // The most recently used entry fits into the shard on its own, so it is never evicted.
+  while (max_shard_size_bytes_ > 0 && shard.size_bytes_ > max_shard_size_bytes_) {
+    const StoredEntry& stored = shard.entries_.back();
+    shard.size_bytes_ -= stored.size_;
+    shard.map_.erase(stored.key_);
+    shard.entries_.pop_back();
+    shard.stats_.evictions_.inc();
+  }
+}
+
+uint64_t SimpleHttpCache::entrySize(const Key& key, const Entry& entry) {
+  uint64_t size = sizeof(StoredEntry) + key.ByteSizeLong() + entry.response_headers_->byteSize();
+  if (entry.body_ != nullptr) {
+    size += entry.body_->size();
+  }
+  if (entry.trailers_ != nullptr) {
+    size += entry.trailers_->byteSize();
+  }
+  return size;
+}
+
+void SimpleHttpCache::updateGauges(Shard& shard) {
+  shard.stats_.entries_.set(shard.entries_.size());
+  shard.stats_.size_bytes_.set(shard.size_bytes_);
+}
+
 SimpleHttpCache::Entry
 SimpleHttpCache::varyLookup(const LookupRequest& request,
                             const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
   absl::optional<Key> varied_key = variedRequestKey(request, *response_headers);
   if (!varied_key.has_value()) {
+    shardFor(request.key()).stats_.lookup_misses_.inc();
     return SimpleHttpCache::Entry{};
   }
-  Key& varied_request_key = varied_key.value();
 
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
-  }
-  ASSERT(iter->second.response_headers_);
-  Http::ResponseTrailerMapPtr trailers_map;
-  if (iter->second.trailers_) {
-    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
+  // The varied response may be stored in another shard than the one of the request key.
+  Shard& varied_shard = shardFor(varied_key.value());
+  Entry entry = lookupEntry(varied_shard, varied_key.value());
+  if (entry.response_headers_) {
+    varied_shard.stats_.lookup_hits_.inc();
+  } else {
+    varied_shard.stats_.lookup_misses_.inc();
   }
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+  return entry;
 }
 
 bool SimpleHttpCache::varyInsert(const Key& request_key,
@@ -237,8 +354,6 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
                                  const Http::RequestHeaderMap& request_headers,
                                  const VaryAllowList& vary_allow_list,
                                  Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-
   absl::btree_set<absl::string_view> vary_header_values =
       VaryHeaderUtils::getVaryValues(*response_headers);
   ASSERT(!vary_header_values.empty());
@@ -252,32 +367,39 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
     return false;
   }
 
+  // The vary values reference the response headers, which are moved into the cache below.
+  const std::string vary_values = absl::StrJoin(vary_header_values, ",");
   varied_request_key.add_custom_fields(vary_identifier.value());
-  map_[varied_request_key] = SimpleHttpCache::Entry{
-      std::move(response_headers), std::move(metadata), std::move(body), std::move(trailers)};
-
-  // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Envoy::Http::ResponseHeaderMapPtr vary_only_map =
-        Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
-    vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
-                           absl::StrJoin(vary_header_values, ","));
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_identifier as the
-    // entry_list; for future entries append vary_identifier to existing list.
-    std::string entry_list;
-    map_[request_key] =
-        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}};
+  if (!insertEntry(varied_request_key,
+                   SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                          std::make_shared<const std::string>(std::move(body)),
+                                          std::move(trailers)},
+                   true)) {
+    return false;
   }
+
+  // Add a special entry to flag that this request generates varied responses, unless there is
+  // one already.
+  Envoy::Http::ResponseHeaderMapPtr vary_only_map =
+      Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary, vary_values);
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_identifier as the
+  // entry_list; for future entries append vary_identifier to existing list.
+  insertEntry(request_key,
+              SimpleHttpCache::Entry{std::move(vary_only_map), {},
+                                     std::make_shared<const std::string>(), {}},
+              false);
   return true;
 }
 
 InsertContextPtr SimpleHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
                                                     Http::StreamEncoderFilterCallbacks&) {
-  ASSERT(lookup_context != nullptr);
-  return std::make_unique<SimpleInsertContext>(*lookup_context, *this);
+  auto simple_lookup_context = std::unique_ptr<SimpleLookupContext>(
+      dynamic_cast<SimpleLookupContext*>(lookup_context.release()));
+  ASSERT(simple_lookup_context != nullptr);
+  return std::make_unique<SimpleInsertContext>(std::move(simple_lookup_context), *this);
 }
 
 constexpr absl::string_view Name = "envoy.extensions.http.cache.simple";
@@ -301,15 +423,16 @@ public:
   }
   // From HttpCacheFactory
   std::shared_ptr<HttpCache>
-  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig&,
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
            Server::Configuration::FactoryContext& context) override {
+    const auto config = MessageUtil::anyConvertAndValidate<
+        envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig>(
+        filter_config.typed_config(), context.messageValidationVisitor());
+    // The cache outlives the listener of the filter, so its stats are in the server scope.
+    Stats::Scope& scope = context.serverScope();
     return context.singletonManager().getTyped<SimpleHttpCache>(
-        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), &createCache);
-  }
-
-private:
-  static std::shared_ptr<Singleton::Instance> createCache() {
-    return std::make_shared<SimpleHttpCache>();
+        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton),
+        [&config, &scope]() { return std::make_shared<SimpleHttpCache>(config, scope); });
   }
 };
 
@@ -1,5 +1,13 @@
 #pragma once
 
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
@@ -12,27 +20,40 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
+/**
+ * All stats of a shard of the simple cache. @see stats_macros.h
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(evictions)                                                                               \
+  COUNTER(lookup_hits)                                                                             \
+  COUNTER(lookup_misses)                                                                           \
+  GAUGE(entries, NeverImport)                                                                      \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for the stats of a shard of the simple cache. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend. Entries are sharded by key across independently locked shards, and
+// each shard evicts its least recently used entries once it exceeds its share of the configured
+// size. Bodies are stored as immutable shared strings, which lookups serve without copying.
 class SimpleHttpCache : public HttpCache, public Singleton::Instance {
-private:
+public:
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
     ResponseMetadata metadata_;
-    std::string body_;
+    // Shared with the lookups that serve it, so that a hit does not copy the body.
+    std::shared_ptr<const std::string> body_;
     Http::ResponseTrailerMapPtr trailers_;
   };
 
-  // Looks for a response that has been varied. Only called from lookup.
-  Entry varyLookup(const LookupRequest& request,
-                   const Http::ResponseHeaderMapPtr& response_headers);
-
-  // A list of headers that we do not want to update upon validation
-  // We skip these headers because either it's updated by other application logic
-  // or they are fall into categories defined in the IETF doc below
-  // https://www.ietf.org/archive/id/draft-ietf-httpbis-cache-18.html s3.2
-  static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
+  SimpleHttpCache(
+      const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig& config,
+      Stats::Scope& scope);
 
-public:
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request,
                                      Http::StreamDecoderFilterCallbacks& callbacks) override;
@@ -55,8 +76,65 @@ public:
                   const Http::RequestHeaderMap& request_headers,
                   const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  size_t shardCount() const { return shards_.size(); }
+  size_t shardIndex(const Key& key) const;
+  const SimpleHttpCacheStats& shardStats(size_t shard) const { return shards_[shard]->stats_; }
+
+private:
+  struct StoredEntry {
+    const Key key_;
+    Entry entry_;
+    uint64_t size_;
+  };
+  using StoredEntryList = std::list<StoredEntry>;
+
+  struct Shard {
+    Shard(Stats::Scope& scope, const std::string& prefix);
+
+    absl::Mutex mutex_;
+    // Ordered from the most to the least recently used entry.
+    StoredEntryList entries_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<Key, StoredEntryList::iterator, MessageUtil, MessageUtil>
+        map_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){};
+    SimpleHttpCacheStats stats_;
+  };
+
+  Shard& shardFor(const Key& key) { return *shards_[shardIndex(key)]; }
+
+  // Returns a copy of the entry, or an empty entry if there is none, and marks it as the most
+  // recently used entry of its shard.
+  static Entry lookupEntry(Shard& shard, const Key& key);
+
+  // Looks for a response that has been varied. Only called from lookup.
+  Entry varyLookup(const LookupRequest& request,
+                   const Http::ResponseHeaderMapPtr& response_headers);
+
+  // Inserts an entry, replacing an existing entry with the same key if replace is true.
+  bool insertEntry(const Key& key, Entry&& entry, bool replace);
+
+  bool updateEntry(const LookupRequest& request, const Http::ResponseHeaderMap& response_headers,
+                   const ResponseMetadata& metadata);
+  void updateStoredEntry(Shard& shard, StoredEntryList::iterator stored,
+                         const Http::ResponseHeaderMap& response_headers,
+                         const ResponseMetadata& metadata)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  // Evicts the least recently used entries of a shard until it fits into its share of the size.
+  void evict(Shard& shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  static uint64_t entrySize(const Key& key, const Entry& entry);
+  static void updateGauges(Shard& shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  // A list of headers that we do not want to update upon validation
+  // We skip these headers because either it's updated by other application logic
+  // or they are fall into categories defined in the IETF doc below
+  // https://www.ietf.org/archive/id/draft-ietf-httpbis-cache-18.html s3.2
+  static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
+
+  // The maximum size of each shard, or 0 if the size is not bounded.
+  const uint64_t max_shard_size_bytes_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 } // namespace Cache
@@ -193,18 +193,18 @@ HeaderValidator::validateGenericHeaderName(const HeaderString& name) {
 
   const bool reject_header_names_with_underscores =
       config_.headers_with_underscores_action() == HeaderValidatorConfig::REJECT_REQUEST;
-  bool is_valid = true;
+  // The underscore is a valid character, so the name is checked as a whole and an underscore is
+  // only looked for if it has to be rejected. Like a scan from the start, the first of an
+  // underscore and an invalid character determines the outcome.
+  bool is_valid = ::Envoy::Http::kGenericHeaderNameCharacterSet.containsAll(key_string_view);
   bool reject_due_to_underscore = false;
-  char c = '\0';
-
-  for (auto iter = key_string_view.begin();
-       iter != key_string_view.end() && is_valid && !reject_due_to_underscore; ++iter) {
-    c = *iter;
-    if (c != '_') {
-      is_valid &= testCharInTable(::Envoy::Http::kGenericHeaderNameCharTable, c);
-    } else {
-      reject_due_to_underscore = reject_header_names_with_underscores;
-    }
+  if (reject_header_names_with_underscores) {
+    const size_t underscore = key_string_view.find('_');
+    reject_due_to_underscore =
+        underscore != absl::string_view::npos &&
+        (is_valid || ::Envoy::Http::kGenericHeaderNameCharacterSet.containsAll(
+                         key_string_view.substr(0, underscore)));
+    is_valid |= reject_due_to_underscore;
   }
 
   if (!is_valid) {
@@ -236,14 +236,7 @@ HeaderValidator::validateGenericHeaderValue(const HeaderString& value) {
   //
   // VCHAR          =  %x21-7E
   //                   ; visible (printing) characters
-  const auto& value_string_view = value.getStringView();
-  bool is_valid = true;
-
-  for (auto iter = value_string_view.begin(); iter != value_string_view.end() && is_valid; ++iter) {
-    is_valid &= testCharInTable(kGenericHeaderValueCharTable, *iter);
-  }
-
-  if (!is_valid) {
+  if (!::Envoy::Http::kGenericHeaderValueCharacterSet.containsAll(value.getStringView())) {
     return {HeaderValueValidationResult::Action::Reject,
             UhvResponseCodeDetail::get().InvalidValueCharacters};
   }
@@ -67,9 +67,13 @@ LegacyMaglevLbConfig::LegacyMaglevLbConfig(const ClusterProto& cluster) {
 TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config) : lb_config_(lb_config) {}
 
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
-MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+MaglevLoadBalancer::createLoadBalancer(uint32_t /* priority */,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
                                        double /* min_normalized_weight */,
                                        double max_normalized_weight) {
+  // Unlike the ring, the table is not updated incrementally: the entries each host fills depend on
+  // the permutations of all the hosts that precede it in the fill order, so any change of the
+  // host set may move entries of any host. Unchanged tables are reused by the base class.
   HashingLoadBalancerSharedPtr maglev_lb =
       MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight, table_size_,
                                        use_hostname_for_hashing_, stats_);
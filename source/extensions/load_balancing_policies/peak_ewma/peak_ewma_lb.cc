@@ -0,0 +1,172 @@
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include <cmath>
+#include <limits>
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+
+// Round trip times are measured in microseconds, so lower estimates are as good as zero.
+constexpr double ZeroRttNs = 1000;
+// The cost of a host with a zero estimate and active requests, on top of its active requests. This
+// is the penalty used by Finagle, which is about 39 hours in nanoseconds, so such hosts cost more
+// than any measured host.
+constexpr double PenaltyNs = std::numeric_limits<int64_t>::max() >> 16;
+
+} // namespace
+
+PeakEwmaHostData::PeakEwmaHostData(std::chrono::nanoseconds decay_time,
+                                   std::chrono::nanoseconds initial_rtt, TimeSource& time_source)
+    : decay_time_ns_(decay_time.count()), time_source_(time_source),
+      rtt_ns_(initial_rtt.count()), updated_at_ns_(toNanos(time_source.monotonicTime())) {
+  stats_.peak_ewma_rtt_us_.set(
+      std::chrono::duration_cast<std::chrono::microseconds>(initial_rtt).count());
+}
+
+void PeakEwmaHostData::onRequestRtt(std::chrono::microseconds rtt) {
+  const double rtt_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(rtt).count();
+  const int64_t now_ns = toNanos(time_source_.monotonicTime());
+
+  absl::MutexLock lock(&update_mutex_);
+  const double estimate_ns = rtt_ns_.load(std::memory_order_relaxed);
+  double updated_ns = rtt_ns;
+  if (rtt_ns < estimate_ns) {
+    // The longer ago the previous round trip time, the more weight the new one gets.
+    const int64_t elapsed_ns = std::max<int64_t>(
+        now_ns - updated_at_ns_.load(std::memory_order_relaxed), 0);
+    const double previous_weight = std::exp(-elapsed_ns / decay_time_ns_);
+    updated_ns = estimate_ns * previous_weight + rtt_ns * (1 - previous_weight);
+  }
+  update(updated_ns, now_ns);
+}
+
+void PeakEwmaHostData::onRequestFailure(std::chrono::microseconds elapsed) {
+  const double elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  const MonotonicTime now = time_source_.monotonicTime();
+
+  absl::MutexLock lock(&update_mutex_);
+  // The round trip time of the request is unknown, but at least the time it took. That is only
+  // a sample if it exceeds the estimate, as a cancelled request says nothing about a faster host.
+  if (elapsed_ns > rtt(now)) {
+    update(elapsed_ns, toNanos(now));
+  }
+}
+
+void PeakEwmaHostData::update(double rtt_ns, int64_t now_ns) {
+  rtt_ns_.store(rtt_ns, std::memory_order_relaxed);
+  updated_at_ns_.store(now_ns, std::memory_order_relaxed);
+  stats_.peak_ewma_rtt_us_.set(static_cast<uint64_t>(rtt_ns / 1000));
+}
+
+double PeakEwmaHostData::rtt(MonotonicTime now) const {
+  // The estimate and its time may be read in the middle of an update. The estimate is then decayed
+  // from the wrong time, which only skews it for a single pick.
+  const double estimate_ns = rtt_ns_.load(std::memory_order_relaxed);
+  const int64_t elapsed_ns = toNanos(now) - updated_at_ns_.load(std::memory_order_relaxed);
+  if (elapsed_ns <= 0) {
+    return estimate_ns;
+  }
+  return estimate_ns * std::exp(-elapsed_ns / decay_time_ns_);
+}
+
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    const PeakEwmaLbProto& config, TimeSource& time_source)
+    : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                healthy_panic_threshold,
+                                LoadBalancerConfigHelper::localityLbConfigFromProto(config)),
+      choice_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, choice_count, 2)),
+      default_rtt_ns_(std::chrono::nanoseconds(std::chrono::milliseconds(
+                          PROTOBUF_GET_MS_OR_DEFAULT(config, default_rtt, 30)))
+                          .count()),
+      time_source_(time_source) {}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(false));
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  HostSharedPtr candidate_host;
+  double candidate_cost = 0;
+  uint64_t candidate_active_rq = 0;
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    const HostSharedPtr& sampled_host = hosts_to_use[random_.random() % hosts_to_use.size()];
+    const uint64_t sampled_active_rq = sampled_host->stats().rq_active_.value();
+    const double sampled_rtt = rtt(*sampled_host, now);
+    const double sampled_cost = sampled_rtt < ZeroRttNs && sampled_active_rq > 0
+                                    ? PenaltyNs + sampled_active_rq
+                                    : sampled_rtt * (sampled_active_rq + 1);
+
+    // Hosts whose estimates have decayed to the same cost, e.g. to zero, are compared by their
+    // active requests.
+    if (candidate_host == nullptr || sampled_cost < candidate_cost ||
+        (sampled_cost == candidate_cost && sampled_active_rq < candidate_active_rq)) {
+      candidate_host = sampled_host;
+      candidate_cost = sampled_cost;
+      candidate_active_rq = sampled_active_rq;
+    }
+  }
+
+  return candidate_host;
+}
+
+double PeakEwmaLoadBalancer::rtt(const Host& host, MonotonicTime now) const {
+  // The data is installed on the main thread before the host is handed to the workers, but may be
+  // missing for hosts which were created before the policy, e.g. by another policy.
+  const auto* host_data = dynamic_cast<const PeakEwmaHostData*>(host.lbPolicyData().ptr());
+  return host_data != nullptr ? host_data->rtt(now) : default_rtt_ns_;
+}
+
+LoadBalancerPtr PeakEwmaLoadBalancerFactory::create(LoadBalancerParams params) {
+  return std::make_unique<PeakEwmaLoadBalancer>(
+      params.priority_set, params.local_priority_set, cluster_info_.lbStats(), runtime_, random_,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info_.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      config_, time_source_);
+}
+
+PeakEwmaThreadAwareLoadBalancer::PeakEwmaThreadAwareLoadBalancer(
+    const PeakEwmaLbProto& config, const ClusterInfo& cluster_info,
+    const PrioritySet& priority_set, Runtime::Loader& runtime, Random::RandomGenerator& random,
+    TimeSource& time_source)
+    : decay_time_(std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, decay_time, 10000))),
+      default_rtt_(std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, default_rtt, 30))),
+      priority_set_(priority_set), time_source_(time_source),
+      factory_(std::make_shared<PeakEwmaLoadBalancerFactory>(config, cluster_info, runtime, random,
+                                                             time_source)) {}
+
+void PeakEwmaThreadAwareLoadBalancer::initialize() {
+  for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+    addHostData(host_set->hosts());
+  }
+  member_update_cb_ = priority_set_.addMemberUpdateCb(
+      [this](const HostVector& hosts_added, const HostVector&) -> void {
+        addHostData(hosts_added);
+      });
+}
+
+void PeakEwmaThreadAwareLoadBalancer::addHostData(const HostVector& hosts) {
+  for (const auto& host : hosts) {
+    // Hosts which are moved between priorities are added again, and keep their estimate. The data
+    // of hosts which are already used by the workers can't be replaced safely.
+    if (!host->lbPolicyData().has_value()) {
+      host->setLbPolicyData(
+          std::make_unique<PeakEwmaHostData>(decay_time_, default_rtt_, time_source_));
+    }
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/callback.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/peak_ewma/v3/peak_ewma.pb.h"
+#include "envoy/stats/primitive_stats_macros.h"
+#include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/upstream/load_balancer_impl.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Upstream {
+
+using PeakEwmaLbProto = envoy::extensions::load_balancing_policies::peak_ewma::v3::PeakEwma;
+
+/**
+ * All peak EWMA host stats. @see stats_macros.h
+ */
+#define ALL_PEAK_EWMA_HOST_STATS(GAUGE) GAUGE(peak_ewma_rtt_us)
+
+/**
+ * Struct definition for all peak EWMA host stats. @see stats_macros.h
+ */
+struct PeakEwmaHostStats {
+  ALL_PEAK_EWMA_HOST_STATS(GENERATE_PRIMITIVE_GAUGE_STRUCT);
+
+  // Provide access to name,gauge pairs.
+  std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges() const {
+    return {ALL_PEAK_EWMA_HOST_STATS(PRIMITIVE_GAUGE_NAME_AND_REFERENCE)};
+  }
+};
+
+/**
+ * The estimated round trip time of a host, which is shared by the load balancers of all workers.
+ * Round trip times above the estimate replace it, while lower round trip times are averaged in with
+ * a weight that grows with the time since the previous one. Requests which failed before their
+ * response, e.g. timed out, are taken as round trip times of at least the time they took, so they
+ * only raise the estimate. The estimate decays towards zero while there are no new round trip
+ * times, so that slow hosts are eventually tried again.
+ */
+class PeakEwmaHostData : public HostLbPolicyData {
+public:
+  PeakEwmaHostData(std::chrono::nanoseconds decay_time, std::chrono::nanoseconds initial_rtt,
+                   TimeSource& time_source);
+
+  // Upstream::HostLbPolicyData
+  void onRequestRtt(std::chrono::microseconds rtt) override;
+  void onRequestFailure(std::chrono::microseconds elapsed) override;
+  std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
+  gauges() const override {
+    return stats_.gauges();
+  }
+
+  /**
+   * @return the estimated round trip time in nanoseconds, decayed to the given time.
+   */
+  double rtt(MonotonicTime now) const;
+
+private:
+  void update(double rtt_ns, int64_t now_ns) ABSL_EXCLUSIVE_LOCKS_REQUIRED(update_mutex_);
+  static int64_t toNanos(MonotonicTime time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+  }
+
+  const double decay_time_ns_;
+  TimeSource& time_source_;
+  // Serializes the updates of the estimate, which is read without locking on every pick.
+  absl::Mutex update_mutex_;
+  std::atomic<double> rtt_ns_;
+  std::atomic<int64_t> updated_at_ns_;
+  PeakEwmaHostStats stats_;
+};
+
+/**
+ * A load balancer which picks the host with the lowest cost out of choice_count random hosts. The
+ * cost of a host is its estimated round trip time times its number of active requests plus one.
+ * As in Finagle, a host whose estimate is zero but which has active requests costs a large
+ * penalty plus its active requests instead, so that a host which was idle for long, or was never
+ * measured with a zero default round trip time, is not sent every request until one completes.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterLbStats& stats, Runtime::Loader& runtime,
+                       Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+                       const PeakEwmaLbProto& config, TimeSource& time_source);
+
+  // Upstream::ZoneAwareLoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+  HostConstSharedPtr peekAnotherHost(LoadBalancerContext*) override { return nullptr; }
+
+private:
+  double rtt(const Host& host, MonotonicTime now) const;
+
+  const uint32_t choice_count_;
+  const double default_rtt_ns_;
+  TimeSource& time_source_;
+};
+
+/**
+ * Creates the peak EWMA load balancers of the workers.
+ */
+class PeakEwmaLoadBalancerFactory : public LoadBalancerFactory {
+public:
+  PeakEwmaLoadBalancerFactory(const PeakEwmaLbProto& config, const ClusterInfo& cluster_info,
+                              Runtime::Loader& runtime, Random::RandomGenerator& random,
+                              TimeSource& time_source)
+      : config_(config), cluster_info_(cluster_info), runtime_(runtime), random_(random),
+        time_source_(time_source) {}
+
+  // Upstream::LoadBalancerFactory
+  LoadBalancerPtr create(LoadBalancerParams params) override;
+  bool recreateOnHostChange() const override { return false; }
+
+private:
+  const PeakEwmaLbProto config_;
+  const ClusterInfo& cluster_info_;
+  Runtime::Loader& runtime_;
+  Random::RandomGenerator& random_;
+  TimeSource& time_source_;
+};
+
+/**
+ * Installs the estimated round trip times on the hosts of the cluster, on the main thread before
+ * the hosts are used by the workers, and hands out the factory of the worker load balancers.
+ */
+class PeakEwmaThreadAwareLoadBalancer : public ThreadAwareLoadBalancer {
+public:
+  PeakEwmaThreadAwareLoadBalancer(const PeakEwmaLbProto& config, const ClusterInfo& cluster_info,
+                                  const PrioritySet& priority_set, Runtime::Loader& runtime,
+                                  Random::RandomGenerator& random, TimeSource& time_source);
+
+  // Upstream::ThreadAwareLoadBalancer
+  LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  void initialize() override;
+
+private:
+  void addHostData(const HostVector& hosts);
+
+  const std::chrono::nanoseconds decay_time_;
+  const std::chrono::nanoseconds default_rtt_;
+  const PrioritySet& priority_set_;
+  TimeSource& time_source_;
+  LoadBalancerFactorySharedPtr factory_;
+  Common::CallbackHandlePtr member_update_cb_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -10,6 +11,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
@@ -143,7 +145,8 @@ using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::Hash
 RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_host_weights,
                                  double min_normalized_weight, uint64_t min_ring_size,
                                  uint64_t max_ring_size, HashFunction hash_function,
-                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats)
+                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats,
+                                 const Ring* previous)
     : stats_(stats) {
   ENVOY_LOG(trace, "ring hash: building ring");
 
@@ -172,18 +175,35 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   //
   // For example, suppose we have 4 hosts, each with a normalized weight of 0.25, and a scale of
   // 6.0 (because the max_ring_size is 6). That means we want to generate 1.5 hashes per host.
-  // We start the outer loop with current_hashes = 0 and target_hashes = 0.
-  //   - For the first host, we set target_hashes = 1.5. After one run of the inner loop,
-  //     current_hashes = 1. After another run, current_hashes = 2, so the inner loop ends.
-  //   - For the second host, target_hashes becomes 3.0, and current_hashes is 2 from before.
-  //     After only one run of the inner loop, current_hashes = 3, so the inner loop ends.
+  // We start with current_hashes = 0 and target_hashes = 0.
+  //   - For the first host, we set target_hashes = 1.5, so it gets two hashes and
+  //     current_hashes = 2.
+  //   - For the second host, target_hashes becomes 3.0, and current_hashes is 2 from before, so
+  //     it gets only one hash and current_hashes = 3.
   //   - Likewise, the third host gets two hashes, and the fourth host gets one hash.
   //
   // For stats reporting, keep track of the minimum and maximum actual number of hashes per host.
   // Users should hopefully pay attention to these numbers and alert if min_hashes_per_host is too
   // low, since that implies an inaccurate request distribution.
-
-  absl::InlinedVector<char, 196> hash_key_buffer;
+  //
+  // The hashes of a host only depend on its key and its number of hashes, so the entries of hosts
+  // which have the same key and number of hashes on the previous ring are copied from it, and only
+  // the other hosts are hashed. As the previous ring is sorted, the new ring is then formed by
+  // merging the copied entries with the new ones, rather than sorting the whole ring again.
+  host_hashes_.reserve(normalized_host_weights.size());
+  const bool use_previous = previous != nullptr && !previous->host_hashes_.empty();
+  bool unique_hosts = true;
+  struct HostToHash {
+    const HostConstSharedPtr& host_;
+    const absl::string_view key_;
+    const uint64_t count_;
+    bool reused_{};
+  };
+  std::vector<HostToHash> hosts;
+  hosts.reserve(normalized_host_weights.size());
+  uint64_t reused_hosts = 0;
+  uint64_t reused_hashes = 0;
+  uint64_t new_hashes = 0;
   double current_hashes = 0.0;
   double target_hashes = 0.0;
   uint64_t min_hashes_per_host = ring_size;
@@ -193,17 +213,44 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
 
-    hash_key_buffer.assign(key_to_hash.begin(), key_to_hash.end());
+    // current_hashes is always a whole number, so this is the number of times current_hashes has
+    // to be incremented to reach target_hashes.
+    target_hashes += scale * entry.second;
+    const double next_hashes = std::max(current_hashes, std::ceil(target_hashes));
+    const uint64_t count = next_hashes - current_hashes;
+    current_hashes = next_hashes;
+    min_hashes_per_host = std::min(count, min_hashes_per_host);
+    max_hashes_per_host = std::max(count, max_hashes_per_host);
+
+    // A host is only in a host set once, but if it were not unique the entries of a host could
+    // not be told apart, so the ring is built from scratch.
+    unique_hosts &=
+        host_hashes_.try_emplace(host.get(), HostHashes{std::string(key_to_hash), count}).second;
+
+    HostToHash& host_to_hash = hosts.emplace_back(HostToHash{host, key_to_hash, count});
+    if (use_previous) {
+      const auto it = previous->host_hashes_.find(host.get());
+      if (it != previous->host_hashes_.end() && it->second.key_ == key_to_hash &&
+          it->second.count_ == count) {
+        host_to_hash.reused_ = true;
+        ++reused_hosts;
+        reused_hashes += count;
+        continue;
+      }
+    }
+    new_hashes += count;
+  }
+
+  absl::InlinedVector<char, 196> hash_key_buffer;
+  const auto add_hashes = [&](const HostToHash& host) {
+    hash_key_buffer.assign(host.key_.begin(), host.key_.end());
     hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
+    const size_t offset_start = hash_key_buffer.size();
 
-    // As noted above: maintain current_hashes and target_hashes as running sums across the entire
-    // host set. `i` is needed only to construct the hash key, and tally min/max hashes per host.
-    target_hashes += scale * entry.second;
-    uint64_t i = 0;
-    while (current_hashes < target_hashes) {
+    // `i` is needed only to construct the hash key.
+    for (uint64_t i = 0; i < host.count_; ++i) {
       const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
+      hash_key_buffer.insert(hash_key_buffer.end(), i_str.begin(), i_str.end());
 
       absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
                                  hash_key_buffer.size());
@@ -214,18 +261,56 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
-      ring_.push_back({hash, host});
-      ++i;
-      ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
+      ring_.push_back({hash, host.host_});
+      hash_key_buffer.erase(hash_key_buffer.begin() + offset_start, hash_key_buffer.end());
     }
-    min_hashes_per_host = std::min(i, min_hashes_per_host);
-    max_hashes_per_host = std::max(i, max_hashes_per_host);
+  };
+  const auto by_hash = [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+    return lhs.hash_ < rhs.hash_;
+  };
+
+  if (use_previous && unique_hosts && reused_hashes >= new_hashes) {
+    ENVOY_LOG(debug, "ring hash: reusing {} hashes of {} hosts, hashing {} hashes of {} hosts",
+              reused_hashes, reused_hosts, new_hashes, hosts.size() - reused_hosts);
+    if (reused_hosts == previous->host_hashes_.size()) {
+      ring_.insert(ring_.end(), previous->ring_.begin(), previous->ring_.end());
+    } else {
+      // Drop the entries of the hosts which were removed, or whose hashes changed.
+      absl::flat_hash_set<const Host*> stale_hosts;
+      for (const auto& [host, host_hashes] : previous->host_hashes_) {
+        const auto it = host_hashes_.find(host);
+        if (it == host_hashes_.end() || it->second.key_ != host_hashes.key_ ||
+            it->second.count_ != host_hashes.count_) {
+          stale_hosts.insert(host);
+        }
+      }
+      for (const auto& entry : previous->ring_) {
+        if (!stale_hosts.contains(entry.host_.get())) {
+          ring_.push_back(entry);
+        }
+      }
+    }
+    ASSERT(ring_.size() == reused_hashes);
+
+    for (const auto& host : hosts) {
+      if (!host.reused_) {
+        add_hashes(host);
+      }
+    }
+    const auto new_entries = ring_.begin() + reused_hashes;
+    std::sort(new_entries, ring_.end(), by_hash);
+    std::inplace_merge(ring_.begin(), new_entries, ring_.end(), by_hash);
+  } else {
+    for (const auto& host : hosts) {
+      add_hashes(host);
+    }
+    std::sort(ring_.begin(), ring_.end(), by_hash);
+  }
+  if (!unique_hosts) {
+    // The next ring can't tell which entries belong to which occurrence of a host.
+    host_hashes_.clear();
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (const auto& entry : ring_) {
       const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
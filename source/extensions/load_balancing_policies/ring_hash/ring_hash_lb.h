@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -13,6 +14,8 @@
 #include "source/common/common/logger.h"
 #include "source/common/upstream/thread_aware_lb_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -94,15 +97,28 @@ private:
     HostConstSharedPtr host_;
   };
 
+  // The hashes a host has on a ring: the hashes of the first count_ suffixed keys of key_.
+  struct HostHashes {
+    std::string key_;
+    uint64_t count_;
+  };
+
   struct Ring : public HashingLoadBalancer {
+    /**
+     * @param previous the last ring built for the same priority, if any. The entries of hosts
+     *        which have the same hashes on both rings are copied from it rather than rehashed.
+     */
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
-         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats);
+         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats,
+         const Ring* previous = nullptr);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
     std::vector<RingEntry> ring_;
+    // Hosts are kept alive by the entries of the ring, so their addresses are stable keys.
+    absl::flat_hash_map<const Host*, HostHashes> host_hashes_;
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -110,11 +126,16 @@ private:
 
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double /* max_normalized_weight */) override {
-    HashingLoadBalancerSharedPtr ring_hash_lb =
-        std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
-                               max_ring_size_, hash_function_, use_hostname_for_hashing_, stats_);
+    if (priority >= rings_.size()) {
+      rings_.resize(priority + 1);
+    }
+    auto ring = std::make_shared<Ring>(normalized_host_weights, min_normalized_weight,
+                                       min_ring_size_, max_ring_size_, hash_function_,
+                                       use_hostname_for_hashing_, stats_, rings_[priority].get());
+    rings_[priority] = ring;
+    HashingLoadBalancerSharedPtr ring_hash_lb = std::move(ring);
     if (hash_balance_factor_ == 0) {
       return ring_hash_lb;
     }
@@ -135,6 +156,8 @@ private:
   const HashFunction hash_function_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  // The last ring built for each priority.
+  std::vector<RingConstSharedPtr> rings_;
 };
 
 } // namespace Upstream
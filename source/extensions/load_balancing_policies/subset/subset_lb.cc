@@ -16,12 +16,25 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
 #include "absl/container/node_hash_set.h"
+#include "absl/hash/hash.h"
 
 namespace Envoy {
 namespace Upstream {
 
 namespace {
 
+// Folds a key-value pair of lexically sorted subset metadata into the fingerprint of the metadata.
+// Values are hashed once, by HashedValue, so finding the subset of a route hashes only the keys.
+uint64_t metadataFingerprint(uint64_t fingerprint, absl::string_view key,
+                             const HashedValue& value) {
+  return absl::HashOf(fingerprint, key, value.hash());
+}
+
+bool localityWeightsEqual(const LocalityWeightsConstSharedPtr& lhs,
+                          const LocalityWeightsConstSharedPtr& rhs) {
+  return lhs == rhs || (lhs != nullptr && rhs != nullptr && *lhs == *rhs);
+}
+
 /**
  * Iterates all the selectors and finds the first one that match_criteria contains all the keys
  * of the selector. Returns nullptr if no selector matches, otherwise returns sub match criteria
@@ -203,13 +216,13 @@ SubsetLoadBalancer::SubsetLoadBalancer(const LoadBalancerSubsetInfo& subsets,
   original_priority_set_callback_handle_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) {
         refreshSubsets(priority);
-        purgeEmptySubsets(subsets_);
+        purgeEmptySubsets();
       });
 }
 
 SubsetLoadBalancer::~SubsetLoadBalancer() {
   // Ensure gauges reflect correct values.
-  forEachSubset(subsets_, [&](LbSubsetEntryPtr entry) {
+  forEachSubset([&](LbSubsetEntryPtr entry) {
     if (entry->active()) {
       stats_.lb_subsets_removed_.inc();
       stats_.lb_subsets_active_.dec();
@@ -491,63 +504,51 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   return entry->lb_subset_->chooseHost(context);
 }
 
-// Iterates over the given metadata match criteria (which must be lexically sorted by key) and
-// find a matching LbSubsetEntryPtr, if any.
+// Finds the LbSubsetEntryPtr matching the given metadata match criteria (which must be lexically
+// sorted by key), if any.
 SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
     const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
-  const LbSubsetMap* subsets = &subsets_;
-
   // Because the match_criteria and the host metadata used to populate subsets_ are sorted in the
-  // same order, we can iterate over the criteria and perform a lookup for each key and value,
-  // starting with the root LbSubsetMap and using the previous iteration's LbSubsetMap thereafter
-  // (tracked in subsets). If ever a criterion's key or value is not found, there is no subset for
-  // this criteria. If we reach the last criterion, we've found the LbSubsetEntry for the
-  // criteria, which may or may not have a subset attached to it.
-  for (uint32_t i = 0; i < match_criteria.size(); i++) {
-    const Router::MetadataMatchCriterion& match_criterion = *match_criteria[i];
-    const auto& subset_it = subsets->find(match_criterion.name());
-    if (subset_it == subsets->end()) {
-      // No subsets with this key (at this level in the hierarchy).
-      break;
-    }
-
-    const ValueSubsetMap& vs_map = subset_it->second;
-    const auto& vs_it = vs_map.find(match_criterion.value());
-    if (vs_it == vs_map.end()) {
-      // No subsets with this value.
-      break;
-    }
+  // same order, the fingerprint of the criteria is the fingerprint of the matching subset.
+  uint64_t fingerprint = 0;
+  for (const auto& match_criterion : match_criteria) {
+    fingerprint =
+        metadataFingerprint(fingerprint, match_criterion->name(), match_criterion->value());
+  }
 
-    const LbSubsetEntryPtr& entry = vs_it->second;
-    if (i + 1 == match_criteria.size()) {
-      // We've reached the end of the criteria, and they all matched.
+  const auto it = subsets_.find(fingerprint);
+  if (it == subsets_.end()) {
+    return nullptr;
+  }
+  for (const LbSubsetEntryPtr& entry : it->second) {
+    if (entry->matches(match_criteria)) {
       return entry;
     }
-
-    subsets = &entry->children_;
   }
-
   return nullptr;
 }
 
-void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& all_hosts) {
-  auto update_func = [priority, &all_hosts](LbSubsetPtr& subset, const HostPredicate& predicate) {
-    for (const auto& host : all_hosts) {
-      if (predicate(*host)) {
-        subset->pushHost(priority, host);
-      }
+bool SubsetLoadBalancer::LbSubsetEntry::matches(
+    const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) const {
+  if (match_criteria.size() != metadata_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < match_criteria.size(); i++) {
+    if (match_criteria[i]->name() != metadata_[i].first ||
+        match_criteria[i]->value() != metadata_[i].second) {
+      return false;
     }
-    subset->finalize(priority);
-  };
+  }
+  return true;
+}
 
+void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority) {
   if (subset_any_ != nullptr) {
-    update_func(subset_any_->lb_subset_, [](const Host&) { return true; });
+    subset_any_->lb_subset_->finalize(priority);
   }
 
   if (subset_default_ != nullptr) {
-    HostPredicate predicate = std::bind(&SubsetLoadBalancer::hostMatches, this,
-                                        default_subset_metadata_, std::placeholders::_1);
-    update_func(subset_default_->lb_subset_, predicate);
+    subset_default_->lb_subset_->finalize(priority);
   }
 
   if (fallback_subset_ == nullptr) {
@@ -578,34 +579,55 @@ void SubsetLoadBalancer::initLbSubsetEntryOnce(LbSubsetEntryPtr& entry, bool sin
   stats_.lb_subsets_created_.inc();
 }
 
-// Iterates all the hosts of specified priority, looking up an LbSubsetEntryPtr for each and add
-// hosts to related entry. Because the metadata of host can be updated inlined, we must evaluate
-// every hosts for every update.
+// Iterates all the hosts of specified priority, looking up the subsets of each and add hosts to
+// related entry. Because the metadata of host can be updated inlined, we must evaluate every hosts
+// for every update, but the subsets of a host are only looked up again if its metadata changed.
 void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all_hosts) {
+  if (host_subsets_.size() <= priority) {
+    host_subsets_.resize(priority + 1);
+  }
+  HostSubsetsMap& previous_host_subsets = host_subsets_[priority];
+  HostSubsetsMap current_host_subsets;
+  current_host_subsets.reserve(all_hosts.size());
+
   absl::flat_hash_set<const LbSubsetEntry*> single_host_entries;
   uint64_t collision_count_of_single_host_entries{};
 
   for (const auto& host : all_hosts) {
-    for (const auto& subset_selector : subset_selectors_) {
-      const auto& keys = subset_selector->selectorKeys();
-      // For each host, for each subset key, attempt to extract the metadata corresponding to the
-      // key from the host.
-      std::vector<SubsetMetadata> all_kvs = extractSubsetMetadata(keys, *host);
-      for (const auto& kvs : all_kvs) {
-        // The host has metadata for each key, find or create its subset.
-        auto entry = findOrCreateLbSubsetEntry(subsets_, kvs, 0);
-        initLbSubsetEntryOnce(entry, subset_selector->singleHostPerSubset());
-
-        if (entry->single_host_subset_) {
-          if (single_host_entries.contains(entry.get())) {
-            collision_count_of_single_host_entries++;
-            continue;
-          }
-          single_host_entries.emplace(entry.get());
-        }
+    auto [it, inserted] = current_host_subsets.try_emplace(host);
+    if (!inserted) {
+      continue;
+    }
+    HostSubsets& host_subsets = it->second;
+
+    MetadataConstSharedPtr metadata = host->metadata();
+    const uint32_t weight = host->weight();
+    bool host_changed = false;
+    auto previous_it = previous_host_subsets.find(host);
+    if (previous_it != previous_host_subsets.end() && previous_it->second.metadata_ == metadata) {
+      host_changed = previous_it->second.weight_ != weight;
+      host_subsets = std::move(previous_it->second);
+    } else {
+      // A new host is reported to the subsets as added, which is enough for the child load
+      // balancers to pick it up.
+      host_changed = previous_it != previous_host_subsets.end();
+      host_subsets = computeHostSubsets(*host, std::move(metadata));
+    }
+    host_subsets.weight_ = weight;
+
+    for (const auto& entry : host_subsets.entries_) {
+      auto& subset = static_cast<PriorityLbSubset&>(*entry->lb_subset_);
+      subset.pushHost(priority, host);
+      subset.hosts_changed_ |= host_changed;
+    }
 
-        entry->lb_subset_->pushHost(priority, host);
+    for (const auto& entry : host_subsets.single_host_entries_) {
+      if (single_host_entries.contains(entry.get())) {
+        collision_count_of_single_host_entries++;
+        continue;
       }
+      single_host_entries.emplace(entry.get());
+      entry->lb_subset_->pushHost(priority, host);
     }
   }
 
@@ -621,18 +643,97 @@ void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all
   }
   single_duplicate_stat_->set(collision_count_of_single_host_entries);
 
+  buildHostLists(priority, current_host_subsets);
+  // The subsets of removed hosts are released here, and purged after the update if empty.
+  previous_host_subsets = std::move(current_host_subsets);
+
   // Finalize updates after all the hosts are evaluated.
-  forEachSubset(subsets_, [priority](LbSubsetEntryPtr entry) {
+  updateFallbackSubset(priority);
+  forEachSubset([priority](LbSubsetEntryPtr entry) {
     if (entry->initialized()) {
       entry->lb_subset_->finalize(priority);
     }
   });
 }
 
+SubsetLoadBalancer::HostSubsets
+SubsetLoadBalancer::computeHostSubsets(const Host& host, MetadataConstSharedPtr&& metadata) {
+  HostSubsets host_subsets;
+  if (subset_any_ != nullptr) {
+    host_subsets.entries_.push_back(subset_any_);
+  }
+  if (subset_default_ != nullptr && hostMatches(default_subset_metadata_, host)) {
+    host_subsets.entries_.push_back(subset_default_);
+  }
+
+  for (const auto& subset_selector : subset_selectors_) {
+    const auto& keys = subset_selector->selectorKeys();
+    // For each host, for each subset key, attempt to extract the metadata corresponding to the
+    // key from the host.
+    std::vector<SubsetMetadata> all_kvs = extractSubsetMetadata(keys, host);
+    for (const auto& kvs : all_kvs) {
+      // The host has metadata for each key, find or create its subset.
+      auto entry = findOrCreateLbSubsetEntry(kvs);
+      initLbSubsetEntryOnce(entry, subset_selector->singleHostPerSubset());
+
+      if (entry->single_host_subset_) {
+        host_subsets.single_host_entries_.push_back(std::move(entry));
+      } else {
+        host_subsets.entries_.push_back(std::move(entry));
+      }
+    }
+  }
+
+  host_subsets.metadata_ = std::move(metadata);
+  return host_subsets;
+}
+
+// Builds the host lists of all subsets with one pass over each list of the original host set,
+// which keeps the order of the original lists. Hosts which are not in the original hosts are not
+// in any subset.
+void SubsetLoadBalancer::buildHostLists(uint32_t priority, const HostSubsetsMap& host_subsets) {
+  const HostSet& original_host_set = *original_priority_set_.hostSetsPerPriority()[priority];
+  const std::array<const HostVector*, SubsetHostLists::NumLists> original_lists = {
+      &original_host_set.hosts(), &original_host_set.healthyHosts().get(),
+      &original_host_set.degradedHosts().get(), &original_host_set.excludedHosts().get()};
+  const std::array<const HostsPerLocality*, SubsetHostLists::NumLists>
+      original_lists_per_locality = {&original_host_set.hostsPerLocality(),
+                                     &original_host_set.healthyHostsPerLocality(),
+                                     &original_host_set.degradedHostsPerLocality(),
+                                     &original_host_set.excludedHostsPerLocality()};
+
+  for (size_t i = 0; i < SubsetHostLists::NumLists; i++) {
+    for (const auto& host : *original_lists[i]) {
+      const auto it = host_subsets.find(host);
+      if (it == host_subsets.end()) {
+        continue;
+      }
+      for (const auto& entry : it->second.entries_) {
+        static_cast<PriorityLbSubset&>(*entry->lb_subset_).host_lists_.hosts_[i].push_back(host);
+      }
+    }
+
+    const auto& original_hosts_per_locality = original_lists_per_locality[i]->get();
+    for (size_t locality = 0; locality < original_hosts_per_locality.size(); locality++) {
+      for (const auto& host : original_hosts_per_locality[locality]) {
+        const auto it = host_subsets.find(host);
+        if (it == host_subsets.end()) {
+          continue;
+        }
+        for (const auto& entry : it->second.entries_) {
+          auto& hosts_per_locality = static_cast<PriorityLbSubset&>(*entry->lb_subset_)
+                                         .host_lists_.hosts_per_locality_[i];
+          hosts_per_locality.resize(original_hosts_per_locality.size());
+          hosts_per_locality[locality].push_back(host);
+        }
+      }
+    }
+  }
+}
+
 // Given the latest all hosts, update all subsets for this priority level, creating new subsets as
 // necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& all_hosts) {
-  updateFallbackSubset(priority, all_hosts);
   processSubsets(priority, all_hosts);
 }
 
@@ -724,89 +825,58 @@ std::string SubsetLoadBalancer::describeMetadata(const SubsetLoadBalancer::Subse
   return buf.str();
 }
 
-// Given a vector of key-values (from extractSubsetMetadata), recursively finds the matching
+// Given a vector of key-values (from extractSubsetMetadata), finds or creates the matching
 // LbSubsetEntryPtr.
 SubsetLoadBalancer::LbSubsetEntryPtr
-SubsetLoadBalancer::findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadata& kvs,
-                                              uint32_t idx) {
-  ASSERT(idx < kvs.size());
-
-  const std::string& name = kvs[idx].first;
-  const ProtobufWkt::Value& pb_value = kvs[idx].second;
-  const HashedValue value(pb_value);
-
-  LbSubsetEntryPtr entry;
-
-  const auto kv_it = subsets.find(name);
-
-  if (kv_it != subsets.end()) {
-    ValueSubsetMap& value_subset_map = kv_it->second;
-    const auto vs_it = value_subset_map.find(value);
-    if (vs_it != value_subset_map.end()) {
-      entry = vs_it->second;
-    }
+SubsetLoadBalancer::findOrCreateLbSubsetEntry(const SubsetMetadata& kvs) {
+  HashedSubsetMetadata metadata;
+  metadata.reserve(kvs.size());
+  uint64_t fingerprint = 0;
+  for (const auto& [name, value] : kvs) {
+    metadata.emplace_back(name, HashedValue(value));
+    fingerprint = metadataFingerprint(fingerprint, name, metadata.back().second);
   }
 
-  if (!entry) {
-    // Not found. Create an uninitialized entry.
-    entry = std::make_shared<LbSubsetEntry>();
-    if (kv_it != subsets.end()) {
-      ValueSubsetMap& value_subset_map = kv_it->second;
-      value_subset_map.emplace(value, entry);
-    } else {
-      ValueSubsetMap value_subset_map = {{value, entry}};
-      subsets.emplace(name, value_subset_map);
+  std::vector<LbSubsetEntryPtr>& entries = subsets_[fingerprint];
+  for (const LbSubsetEntryPtr& entry : entries) {
+    if (entry->metadata_ == metadata) {
+      return entry;
     }
   }
 
-  idx++;
-  if (idx == kvs.size()) {
-    // We've matched all the key-values, return the entry.
-    return entry;
-  }
-
-  return findOrCreateLbSubsetEntry(entry->children_, kvs, idx);
+  // Not found. Create an uninitialized entry.
+  entries.push_back(std::make_shared<LbSubsetEntry>(std::move(metadata)));
+  return entries.back();
 }
 
-// Invokes cb for each LbSubsetEntryPtr in subsets.
-void SubsetLoadBalancer::forEachSubset(LbSubsetMap& subsets,
-                                       std::function<void(LbSubsetEntryPtr&)> cb) {
-  for (auto& vsm : subsets) {
-    for (auto& em : vsm.second) {
-      LbSubsetEntryPtr entry = em.second;
+// Invokes cb for each LbSubsetEntryPtr in subsets_.
+void SubsetLoadBalancer::forEachSubset(std::function<void(LbSubsetEntryPtr&)> cb) {
+  for (auto& [fingerprint, entries] : subsets_) {
+    for (LbSubsetEntryPtr entry : entries) {
       cb(entry);
-      forEachSubset(entry->children_, cb);
     }
   }
 }
 
-void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
-  for (auto subset_it = subsets.begin(); subset_it != subsets.end();) {
-    for (auto it = subset_it->second.begin(); it != subset_it->second.end();) {
-      LbSubsetEntryPtr entry = it->second;
-
-      purgeEmptySubsets(entry->children_);
-
-      if (entry->active() || entry->hasChildren()) {
-        it++;
-        continue;
-      }
-
-      // If it wasn't initialized, it wasn't accounted for.
-      if (entry->initialized()) {
-        stats_.lb_subsets_active_.dec();
-        stats_.lb_subsets_removed_.inc();
-      }
-
-      auto next_it = std::next(it);
-      subset_it->second.erase(it);
-      it = next_it;
-    }
-
-    if (subset_it->second.empty()) {
-      auto next_subset_it = std::next(subset_it);
-      subsets.erase(subset_it);
-      subset_it = next_subset_it;
+void SubsetLoadBalancer::purgeEmptySubsets() {
+  for (auto subset_it = subsets_.begin(); subset_it != subsets_.end();) {
+    std::vector<LbSubsetEntryPtr>& entries = subset_it->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [this](const LbSubsetEntryPtr& entry) {
+                                   if (entry->active()) {
+                                     return false;
+                                   }
+                                   // If it wasn't initialized, it wasn't accounted for.
+                                   if (entry->initialized()) {
+                                     stats_.lb_subsets_active_.dec();
+                                     stats_.lb_subsets_removed_.inc();
+                                   }
+                                   return true;
+                                 }),
+                  entries.end());
+
+    if (entries.empty()) {
+      subsets_.erase(subset_it++);
     } else {
       subset_it++;
     }
@@ -839,74 +909,78 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
   triggerCallbacks();
 }
 
-// Given all hosts that that belong in this subset, hosts_added and hosts_removed, update the
-// underlying HostSet. The hosts_added Hosts and hosts_removed Hosts have been filtered to match
+// Given the lists of the hosts that belong in this subset, hosts_added and hosts_removed, update
+// the underlying HostSet. The hosts_added Hosts and hosts_removed Hosts have been filtered to match
 // hosts that belong in this subset.
-void SubsetLoadBalancer::HostSubsetImpl::update(const HostHashSet& matching_hosts,
+bool SubsetLoadBalancer::HostSubsetImpl::update(SubsetHostLists&& host_lists,
                                                 const HostVector& hosts_added,
-                                                const HostVector& hosts_removed) {
-  auto cached_predicate = [&matching_hosts](const auto& host) {
-    return matching_hosts.count(&host) == 1;
-  };
-
-  // TODO(snowp): If we had a unhealthyHosts() function we could avoid potentially traversing
-  // the list of hosts twice.
-  auto hosts = std::make_shared<HostVector>();
-  hosts->reserve(original_host_set_.hosts().size());
-  for (const auto& host : original_host_set_.hosts()) {
-    if (cached_predicate(*host)) {
-      hosts->emplace_back(host);
-    }
-  }
-
-  auto healthy_hosts = std::make_shared<HealthyHostVector>();
-  healthy_hosts->get().reserve(original_host_set_.healthyHosts().size());
-  for (const auto& host : original_host_set_.healthyHosts()) {
-    if (cached_predicate(*host)) {
-      healthy_hosts->get().emplace_back(host);
-    }
+                                                const HostVector& hosts_removed,
+                                                bool hosts_changed) {
+  const std::array<const HostsPerLocality*, SubsetHostLists::NumLists>
+      original_lists_per_locality = {&original_host_set_.hostsPerLocality(),
+                                     &original_host_set_.healthyHostsPerLocality(),
+                                     &original_host_set_.degradedHostsPerLocality(),
+                                     &original_host_set_.excludedHostsPerLocality()};
+  std::array<HostsPerLocalityConstSharedPtr, SubsetHostLists::NumLists> lists_per_locality;
+  for (size_t i = 0; i < SubsetHostLists::NumLists; i++) {
+    // Localities without hosts in this subset were not touched while building the lists.
+    host_lists.hosts_per_locality_[i].resize(original_lists_per_locality[i]->get().size());
+    lists_per_locality[i] = std::make_shared<HostsPerLocalityImpl>(
+        std::move(host_lists.hosts_per_locality_[i]),
+        original_lists_per_locality[i]->hasLocalLocality());
   }
 
-  auto degraded_hosts = std::make_shared<DegradedHostVector>();
-  degraded_hosts->get().reserve(original_host_set_.degradedHosts().size());
-  for (const auto& host : original_host_set_.degradedHosts()) {
-    if (cached_predicate(*host)) {
-      degraded_hosts->get().emplace_back(host);
-    }
-  }
-
-  auto excluded_hosts = std::make_shared<ExcludedHostVector>();
-  excluded_hosts->get().reserve(original_host_set_.excludedHosts().size());
-  for (const auto& host : original_host_set_.excludedHosts()) {
-    if (cached_predicate(*host)) {
-      excluded_hosts->get().emplace_back(host);
-    }
+  // If we only have one locality we can avoid filtering it by just creating a new
+  // HostsPerLocality from the list of all hosts.
+  if (original_host_set_.hostsPerLocality().get().size() == 1) {
+    lists_per_locality[SubsetHostLists::Hosts] = std::make_shared<HostsPerLocalityImpl>(
+        host_lists.hosts_[SubsetHostLists::Hosts],
+        original_host_set_.hostsPerLocality().hasLocalLocality());
   }
 
-  // If we only have one locality we can avoid the first call to filter() by
-  // just creating a new HostsPerLocality from the list of all hosts.
-  HostsPerLocalityConstSharedPtr hosts_per_locality;
+  const HostsPerLocalityConstSharedPtr& hosts_per_locality =
+      lists_per_locality[SubsetHostLists::Hosts];
+  LocalityWeightsConstSharedPtr locality_weights = determineLocalityWeights(*hosts_per_locality);
 
-  if (original_host_set_.hostsPerLocality().get().size() == 1) {
-    hosts_per_locality = std::make_shared<HostsPerLocalityImpl>(
-        *hosts, original_host_set_.hostsPerLocality().hasLocalLocality());
-  } else {
-    hosts_per_locality = original_host_set_.hostsPerLocality().filter({cached_predicate})[0];
+  const auto hosts_per_locality_equal = [](const HostsPerLocality& lhs,
+                                           const HostsPerLocality& rhs) {
+    return lhs.hasLocalLocality() == rhs.hasLocalLocality() && lhs.get() == rhs.get();
+  };
+  if (updated_ && hosts_added.empty() && hosts_removed.empty() && !hosts_changed &&
+      hosts() == host_lists.hosts_[SubsetHostLists::Hosts] &&
+      healthyHosts().get() == host_lists.hosts_[SubsetHostLists::HealthyHosts] &&
+      degradedHosts().get() == host_lists.hosts_[SubsetHostLists::DegradedHosts] &&
+      excludedHosts().get() == host_lists.hosts_[SubsetHostLists::ExcludedHosts] &&
+      hosts_per_locality_equal(hostsPerLocality(), *hosts_per_locality) &&
+      hosts_per_locality_equal(healthyHostsPerLocality(),
+                            *lists_per_locality[SubsetHostLists::HealthyHosts]) &&
+      hosts_per_locality_equal(degradedHostsPerLocality(),
+                            *lists_per_locality[SubsetHostLists::DegradedHosts]) &&
+      hosts_per_locality_equal(excludedHostsPerLocality(),
+                            *lists_per_locality[SubsetHostLists::ExcludedHosts]) &&
+      localityWeightsEqual(localityWeights(), locality_weights) &&
+      weightedPriorityHealth() == original_host_set_.weightedPriorityHealth() &&
+      overprovisioningFactor() == original_host_set_.overprovisioningFactor()) {
+    return false;
   }
-
-  auto healthy_hosts_per_locality =
-      original_host_set_.healthyHostsPerLocality().filter({cached_predicate})[0];
-  auto degraded_hosts_per_locality =
-      original_host_set_.degradedHostsPerLocality().filter({cached_predicate})[0];
-  auto excluded_hosts_per_locality =
-      original_host_set_.excludedHostsPerLocality().filter({cached_predicate})[0];
+  updated_ = true;
 
   HostSetImpl::updateHosts(
       HostSetImpl::updateHostsParams(
-          hosts, hosts_per_locality, healthy_hosts, healthy_hosts_per_locality, degraded_hosts,
-          degraded_hosts_per_locality, excluded_hosts, excluded_hosts_per_locality),
-      determineLocalityWeights(*hosts_per_locality), hosts_added, hosts_removed,
+          std::make_shared<HostVector>(std::move(host_lists.hosts_[SubsetHostLists::Hosts])),
+          hosts_per_locality,
+          std::make_shared<HealthyHostVector>(
+              std::move(host_lists.hosts_[SubsetHostLists::HealthyHosts])),
+          lists_per_locality[SubsetHostLists::HealthyHosts],
+          std::make_shared<DegradedHostVector>(
+              std::move(host_lists.hosts_[SubsetHostLists::DegradedHosts])),
+          lists_per_locality[SubsetHostLists::DegradedHosts],
+          std::make_shared<ExcludedHostVector>(
+              std::move(host_lists.hosts_[SubsetHostLists::ExcludedHosts])),
+          lists_per_locality[SubsetHostLists::ExcludedHosts]),
+      std::move(locality_weights), hosts_added, hosts_removed,
       original_host_set_.weightedPriorityHealth(), original_host_set_.overprovisioningFactor());
+  return true;
 }
 
 LocalityWeightsConstSharedPtr SubsetLoadBalancer::HostSubsetImpl::determineLocalityWeights(
@@ -960,11 +1034,15 @@ HostSetImplPtr SubsetLoadBalancer::PrioritySubsetImpl::createHostSet(
 }
 
 void SubsetLoadBalancer::PrioritySubsetImpl::update(uint32_t priority,
-                                                    const HostHashSet& matching_hosts,
+                                                    SubsetHostLists&& host_lists,
                                                     const HostVector& hosts_added,
-                                                    const HostVector& hosts_removed) {
+                                                    const HostVector& hosts_removed,
+                                                    bool hosts_changed) {
   const auto& host_subset = getOrCreateHostSet(priority);
-  updateSubset(priority, matching_hosts, hosts_added, hosts_removed);
+  if (!updateSubset(priority, std::move(host_lists), hosts_added, hosts_removed, hosts_changed)) {
+    // The subset did not change, so neither does its load balancer.
+    return;
+  }
 
   if (host_subset.hosts().empty() != empty_) {
     empty_ = true;
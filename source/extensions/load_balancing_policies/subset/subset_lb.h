@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cstdint>
 #include <functional>
@@ -23,6 +24,7 @@
 #include "source/common/upstream/load_balancer_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -170,6 +172,16 @@ private:
 
   HostConstSharedPtr chooseHostIteration(LoadBalancerContext* context);
 
+  // The hosts of a subset for one priority, in the order of each list of the original HostSet.
+  // The lists of all subsets are built together, with one pass over the original lists.
+  struct SubsetHostLists {
+    // The lists are indexed by ListIndex.
+    enum ListIndex { Hosts, HealthyHosts, DegradedHosts, ExcludedHosts, NumLists };
+
+    std::array<HostVector, NumLists> hosts_;
+    std::array<std::vector<HostVector>, NumLists> hosts_per_locality_;
+  };
+
   // Represents a subset of an original HostSet.
   class HostSubsetImpl : public HostSetImpl {
   public:
@@ -180,8 +192,10 @@ private:
           original_host_set_(original_host_set), locality_weight_aware_(locality_weight_aware),
           scale_locality_weight_(scale_locality_weight) {}
 
-    void update(const HostHashSet& matching_hosts, const HostVector& hosts_added,
-                const HostVector& hosts_removed);
+    // Returns false if the lists of the subset, and the weights of its hosts, did not change, in
+    // which case the subset is left as is.
+    bool update(SubsetHostLists&& host_lists, const HostVector& hosts_added,
+                const HostVector& hosts_removed, bool hosts_changed);
     LocalityWeightsConstSharedPtr
     determineLocalityWeights(const HostsPerLocality& hosts_per_locality) const;
 
@@ -189,6 +203,8 @@ private:
     const HostSet& original_host_set_;
     const bool locality_weight_aware_;
     const bool scale_locality_weight_;
+    // The first update always runs, so that the child load balancer sees the host set.
+    bool updated_{};
   };
 
   // Represents a subset of an original PrioritySet.
@@ -197,8 +213,8 @@ private:
     PrioritySubsetImpl(const SubsetLoadBalancer& subset_lb, bool locality_weight_aware,
                        bool scale_locality_weight);
 
-    void update(uint32_t priority, const HostHashSet& matching_hosts, const HostVector& hosts_added,
-                const HostVector& hosts_removed);
+    void update(uint32_t priority, SubsetHostLists&& host_lists, const HostVector& hosts_added,
+                const HostVector& hosts_removed, bool hosts_changed);
 
     bool empty() const { return empty_; }
 
@@ -208,11 +224,15 @@ private:
       }
     }
 
-    void updateSubset(uint32_t priority, const HostHashSet& matching_hosts,
-                      const HostVector& hosts_added, const HostVector& hosts_removed) {
-      reinterpret_cast<HostSubsetImpl*>(host_sets_[priority].get())
-          ->update(matching_hosts, hosts_added, hosts_removed);
+    bool updateSubset(uint32_t priority, SubsetHostLists&& host_lists,
+                      const HostVector& hosts_added, const HostVector& hosts_removed,
+                      bool hosts_changed) {
+      if (!reinterpret_cast<HostSubsetImpl*>(host_sets_[priority].get())
+               ->update(std::move(host_lists), hosts_added, hosts_removed, hosts_changed)) {
+        return false;
+      }
       runUpdateCallbacks(hosts_added, hosts_removed);
+      return true;
     }
 
     // Thread aware LB if applicable.
@@ -242,8 +262,9 @@ private:
 
   using LbSubsetEntryPtr = std::shared_ptr<LbSubsetEntry>;
   using SubsetSelectorMapPtr = std::shared_ptr<SubsetSelectorMap>;
-  using ValueSubsetMap = absl::node_hash_map<HashedValue, LbSubsetEntryPtr>;
-  using LbSubsetMap = absl::node_hash_map<std::string, ValueSubsetMap>;
+  // Subsets by the fingerprint of their metadata, see metadataFingerprint(). Subsets whose
+  // fingerprints collide share a bucket.
+  using LbSubsetMap = absl::flat_hash_map<uint64_t, std::vector<LbSubsetEntryPtr>>;
   using SubsetSelectorFallbackParamsRef = std::reference_wrapper<SubsetSelectorFallbackParams>;
   using MetadataFallbacks = ProtobufWkt::RepeatedPtrField<ProtobufWkt::Value>;
 
@@ -339,8 +360,8 @@ private:
       }
       host_sets_[priority].second.emplace(std::move(host));
     }
-    // Called after pushHost. Update subset by the hosts that pushed in the pushHost. If no any host
-    // is pushed then subset_ will be set to empty.
+    // Called after pushHost and after the host lists are built. Update subset by the hosts that
+    // pushed in the pushHost. If no any host is pushed then subset_ will be set to empty.
     void finalize(uint32_t priority) override {
       while (host_sets_.size() <= priority) {
         host_sets_.push_back({HostHashSet(), HostHashSet()});
@@ -362,7 +383,9 @@ private:
         }
       }
 
-      subset_.update(priority, new_hosts, added, removed);
+      subset_.update(priority, std::move(host_lists_), added, removed, hosts_changed_);
+      host_lists_ = {};
+      hosts_changed_ = false;
 
       old_hosts.swap(new_hosts);
       new_hosts.clear();
@@ -371,6 +394,10 @@ private:
     bool active() const override { return !subset_.empty(); }
 
     std::vector<std::pair<HostHashSet, HostHashSet>> host_sets_;
+    // The lists of the priority being updated.
+    SubsetHostLists host_lists_;
+    // Whether the weight or the metadata of a host of the priority being updated changed.
+    bool hosts_changed_{};
     PrioritySubsetImpl subset_;
   };
 
@@ -409,24 +436,40 @@ private:
     HostConstSharedPtr subset_;
   };
 
-  // Entry in the subset hierarchy.
+  using HashedSubsetMetadata = std::vector<std::pair<std::string, HashedValue>>;
+
+  // Entry in the subset index.
   class LbSubsetEntry {
   public:
     LbSubsetEntry() = default;
+    LbSubsetEntry(HashedSubsetMetadata&& metadata) : metadata_(std::move(metadata)) {}
 
     bool initialized() const { return lb_subset_ != nullptr; }
     bool active() const { return initialized() && lb_subset_->active(); }
-    bool hasChildren() const { return !children_.empty(); }
+    bool matches(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria)
+        const;
 
-    LbSubsetMap children_;
+    // The lexically sorted metadata of the subset. Empty for the fallback subsets.
+    const HashedSubsetMetadata metadata_;
 
-    // Only initialized if a match exists at this level.
     LbSubsetPtr lb_subset_;
 
     // Used to quick check if entry is single host subset entry or not.
     bool single_host_subset_{};
   };
 
+  // The subsets of a host of one priority. They are computed again only when the metadata of the
+  // host changes, which is the common case of an update.
+  struct HostSubsets {
+    MetadataConstSharedPtr metadata_;
+    uint32_t weight_{};
+    // The single host subsets of the host, whose hosts are chosen on every update.
+    std::vector<LbSubsetEntryPtr> single_host_entries_;
+    // The other subsets of the host, including the fallback subsets.
+    std::vector<LbSubsetEntryPtr> entries_;
+  };
+  using HostSubsetsMap = absl::flat_hash_map<HostSharedPtr, HostSubsets>;
+
   void initLbSubsetEntryOnce(LbSubsetEntryPtr& entry, bool single_host_subset);
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
@@ -436,8 +479,10 @@ private:
   // Called by HostSet::MemberUpdateCb
   void update(uint32_t priority, const HostVector& all_hosts);
 
-  void updateFallbackSubset(uint32_t priority, const HostVector& all_hosts);
+  void updateFallbackSubset(uint32_t priority);
   void processSubsets(uint32_t priority, const HostVector& all_hosts);
+  HostSubsets computeHostSubsets(const Host& host, MetadataConstSharedPtr&& metadata);
+  void buildHostLists(uint32_t priority, const HostSubsetsMap& host_subsets);
 
   HostConstSharedPtr tryChooseHostFromContext(LoadBalancerContext* context, bool& host_chosen);
 
@@ -449,10 +494,9 @@ private:
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
 
-  LbSubsetEntryPtr findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadata& kvs,
-                                             uint32_t idx);
-  void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr&)> cb);
-  void purgeEmptySubsets(LbSubsetMap& subsets);
+  LbSubsetEntryPtr findOrCreateLbSubsetEntry(const SubsetMetadata& kvs);
+  void forEachSubset(std::function<void(LbSubsetEntryPtr&)> cb);
+  void purgeEmptySubsets();
 
   std::vector<SubsetMetadata> extractSubsetMetadata(const std::set<std::string>& subset_keys,
                                                     const Host& host);
@@ -488,8 +532,10 @@ private:
   LbSubsetEntryPtr fallback_subset_;
   LbSubsetEntryPtr panic_mode_subset_;
 
-  // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
+  // Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // The subsets of the hosts, by priority.
+  std::vector<HostSubsetsMap> host_subsets_;
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
@@ -0,0 +1,42 @@
+#include "source/extensions/load_balancing_policies/worker_least_request/config.h"
+
+#include "envoy/extensions/load_balancing_policies/worker_least_request/v3/worker_least_request.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace WorkerLeastRequest {
+
+TypedWorkerLeastRequestLbConfig::TypedWorkerLeastRequestLbConfig(
+    const WorkerLeastRequestLbProto& lb_config)
+    : lb_config_(lb_config) {}
+
+Upstream::LoadBalancerPtr WorkerLeastRequestCreator::operator()(
+    Upstream::LoadBalancerParams params, OptRef<const Upstream::LoadBalancerConfig> lb_config,
+    const Upstream::ClusterInfo& cluster_info, const Upstream::PrioritySet&,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, TimeSource& time_source) {
+
+  const auto typed_lb_config =
+      dynamic_cast<const TypedWorkerLeastRequestLbConfig*>(lb_config.ptr());
+
+  // The load balancing policy configuration will be loaded and validated in the main thread when we
+  // load the cluster configuration. So we can assume the configuration is valid here.
+  ASSERT(typed_lb_config != nullptr,
+         "Invalid load balancing policy configuration for worker least request load balancer");
+
+  return std::make_unique<Upstream::WorkerLeastRequestLoadBalancer>(
+      params.priority_set, params.local_priority_set, cluster_info.lbStats(), runtime, random,
+      PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(cluster_info.lbConfig(),
+                                                     healthy_panic_threshold, 100, 50),
+      typed_lb_config->lb_config_, time_source);
+}
+
+/**
+ * Static registration for the Factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(Factory, Upstream::TypedLoadBalancerFactory);
+
+} // namespace WorkerLeastRequest
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
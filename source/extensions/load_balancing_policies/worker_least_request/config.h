@@ -0,0 +1,54 @@
+#pragma once
+
+#include "envoy/extensions/load_balancing_policies/worker_least_request/v3/worker_least_request.pb.h"
+#include "envoy/extensions/load_balancing_policies/worker_least_request/v3/worker_least_request.pb.validate.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/load_balancing_policies/common/factory_base.h"
+#include "source/extensions/load_balancing_policies/worker_least_request/worker_least_request_lb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace WorkerLeastRequest {
+
+using WorkerLeastRequestLbProto = Upstream::WorkerLeastRequestLbProto;
+
+/**
+ * Load balancer config that used to wrap the worker least request config.
+ */
+class TypedWorkerLeastRequestLbConfig : public Upstream::LoadBalancerConfig {
+public:
+  TypedWorkerLeastRequestLbConfig(const WorkerLeastRequestLbProto& lb_config);
+
+  const WorkerLeastRequestLbProto lb_config_;
+};
+
+struct WorkerLeastRequestCreator : public Logger::Loggable<Logger::Id::upstream> {
+  Upstream::LoadBalancerPtr operator()(Upstream::LoadBalancerParams params,
+                                       OptRef<const Upstream::LoadBalancerConfig> lb_config,
+                                       const Upstream::ClusterInfo& cluster_info,
+                                       const Upstream::PrioritySet& priority_set,
+                                       Runtime::Loader& runtime, Random::RandomGenerator& random,
+                                       TimeSource& time_source);
+};
+
+class Factory : public Common::FactoryBase<WorkerLeastRequestLbProto, WorkerLeastRequestCreator> {
+public:
+  Factory() : FactoryBase("envoy.load_balancing_policies.worker_least_request") {}
+
+  Upstream::LoadBalancerConfigPtr loadConfig(const Protobuf::Message& config,
+                                             ProtobufMessage::ValidationVisitor&) override {
+    auto typed_config = dynamic_cast<const WorkerLeastRequestLbProto*>(&config);
+    ASSERT(typed_config != nullptr);
+    return std::make_unique<TypedWorkerLeastRequestLbConfig>(*typed_config);
+  }
+};
+
+DECLARE_FACTORY(Factory);
+
+} // namespace WorkerLeastRequest
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
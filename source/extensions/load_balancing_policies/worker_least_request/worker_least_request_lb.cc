@@ -0,0 +1,46 @@
+#include "source/extensions/load_balancing_policies/worker_least_request/worker_least_request_lb.h"
+
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Upstream {
+
+WorkerLeastRequestLoadBalancer::WorkerLeastRequestLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterLbStats& stats,
+    Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
+    const WorkerLeastRequestLbProto& config, TimeSource& time_source)
+    : LeastRequestLoadBalancer(priority_set, local_priority_set, stats, runtime, random,
+                               healthy_panic_threshold, config.least_request(), time_source),
+      sync_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, sync_interval, 10)),
+      now_(time_source.monotonicTime()) {
+  hosts_removed_cb_ = priority_set.addMemberUpdateCb(
+      [this](const HostVector&, const HostVector& hosts_removed) -> void {
+        for (const auto& host : hosts_removed) {
+          active_requests_.erase(host.get());
+        }
+      });
+}
+
+HostConstSharedPtr WorkerLeastRequestLoadBalancer::chooseHost(LoadBalancerContext* context) {
+  now_ = time_source_.monotonicTime();
+  HostConstSharedPtr host = LeastRequestLoadBalancer::chooseHost(context);
+  if (host != nullptr) {
+    // The request is accounted for by the cluster wide count once the host is synced again.
+    ++active_requests_[host.get()].sent_;
+  }
+  return host;
+}
+
+uint64_t WorkerLeastRequestLoadBalancer::activeRequests(const Host& host) const {
+  ActiveRequests& active_requests = active_requests_[&host];
+  if (!active_requests.synced_at_.has_value() ||
+      now_ - active_requests.synced_at_.value() >= sync_interval_) {
+    active_requests.synced_ = host.stats().rq_active_.value();
+    active_requests.sent_ = 0;
+    active_requests.synced_at_ = now_;
+  }
+  return active_requests.synced_ + active_requests.sent_;
+}
+
+} // namespace Upstream
+} // namespace Envoy
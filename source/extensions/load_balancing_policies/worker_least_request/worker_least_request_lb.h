@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/callback.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/load_balancing_policies/worker_least_request/v3/worker_least_request.pb.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "source/common/upstream/load_balancer_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Upstream {
+
+using WorkerLeastRequestLbProto =
+    envoy::extensions::load_balancing_policies::worker_least_request::v3::WorkerLeastRequest;
+
+/**
+ * A least request load balancer which compares hosts by the number of active requests seen by its
+ * worker. The cluster wide number of active requests of a host, which is updated by every worker,
+ * is read at most once per sync interval, and the requests this worker sent to the host since then
+ * are added to it. Picks in between only touch state owned by the worker. The counters of the hosts
+ * are still updated by the router for every request, as load balancers aren't notified when
+ * requests complete.
+ */
+class WorkerLeastRequestLoadBalancer : public LeastRequestLoadBalancer {
+public:
+  WorkerLeastRequestLoadBalancer(const PrioritySet& priority_set,
+                                 const PrioritySet* local_priority_set, ClusterLbStats& stats,
+                                 Runtime::Loader& runtime, Random::RandomGenerator& random,
+                                 uint32_t healthy_panic_threshold,
+                                 const WorkerLeastRequestLbProto& config, TimeSource& time_source);
+
+  // Upstream::LoadBalancer
+  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+
+protected:
+  // Upstream::LeastRequestLoadBalancer
+  uint64_t activeRequests(const Host& host) const override;
+
+private:
+  struct ActiveRequests {
+    // The cluster wide number of active requests of the host when it was last read.
+    uint64_t synced_{};
+    // The number of requests this worker sent to the host since then.
+    uint64_t sent_{};
+    absl::optional<MonotonicTime> synced_at_;
+  };
+
+  const std::chrono::milliseconds sync_interval_;
+  // The time of the current pick, which is read once per pick rather than once per candidate.
+  MonotonicTime now_;
+  // Hosts are only removed from the map once they are removed from the priority set, so their
+  // addresses are not reused while they are in it.
+  mutable absl::flat_hash_map<const Host*, ActiveRequests> active_requests_;
+  Common::CallbackHandlePtr hosts_removed_cb_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
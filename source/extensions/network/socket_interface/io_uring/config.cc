@@ -0,0 +1,121 @@
+#include "source/extensions/network/socket_interface/io_uring/config.h"
+
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.h"
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+Server::BootstrapExtensionPtr IoUringSocketInterface::createBootstrapExtension(
+    const Protobuf::Message& message, Server::Configuration::ServerFactoryContext& context) {
+  const auto& config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::IoUringSocketInterface&>(
+      message, context.messageValidationVisitor());
+
+  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory;
+  if (Io::isIoUringSupported()) {
+    Io::IoUringWorkerOptions options;
+    options.read_buffer_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        config, read_buffer_size, Io::IoUringWorkerOptions::DefaultReadBufferSize);
+    options.read_buffer_pool_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        config, read_buffer_pool_size, Io::IoUringWorkerOptions::DefaultReadBufferPoolSize);
+    options.register_read_buffers_ = config.register_read_buffers();
+    options.multishot_accept_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, multishot_accept, true);
+    options.write_timeout_ = std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+        config, write_timeout, Io::IoUringWorkerOptions::DefaultWriteTimeout.count()));
+    io_uring_worker_factory = std::make_shared<Io::IoUringWorkerFactoryImpl>(
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, io_uring_size, 1000),
+        config.enable_submission_queue_polling(), options, context.threadLocal());
+  } else {
+    ENVOY_LOG_MISC(warn, "io_uring is not supported by this kernel, {} falls back to the default "
+                         "socket interface",
+                   name());
+  }
+  io_uring_worker_factory_ = io_uring_worker_factory;
+  return std::make_unique<IoUringSocketInterfaceExtension>(*this,
+                                                           std::move(io_uring_worker_factory));
+}
+
+ProtobufTypes::MessagePtr IoUringSocketInterface::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::network::socket_interface::v3::IoUringSocketInterface>();
+}
+
+IoHandlePtr IoUringSocketInterface::makeSocket(int socket_fd, bool socket_v6only,
+                                               absl::optional<int> domain,
+                                               Socket::Type socket_type) const {
+  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory =
+      io_uring_worker_factory_.lock();
+  // Datagram sockets keep using recvmsg and sendmsg.
+  if (io_uring_worker_factory == nullptr || socket_type != Socket::Type::Stream) {
+    return SocketInterfaceImpl::makeSocket(socket_fd, socket_v6only, domain, socket_type);
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(std::move(io_uring_worker_factory), socket_fd,
+                                                   socket_v6only, domain);
+}
+
+void IoUringSocketInterfaceExtension::onServerInitialized() {
+  // This runs on the main thread before the workers start, so every worker owns an io_uring
+  // worker once it runs.
+  if (io_uring_worker_factory_ != nullptr) {
+    io_uring_worker_factory_->onWorkerThreadInitialized();
+  }
+}
+
+REGISTER_FACTORY(IoUringSocketInterface, Server::Configuration::BootstrapExtensionFactory);
+
+Upstream::ProtocolOptionsConfigConstSharedPtr
+IoUringProtocolOptionsFactory::createProtocolOptionsConfig(
+    const Protobuf::Message& config,
+    Server::Configuration::ProtocolOptionsFactoryContext& context) {
+  MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::IoUringProtocolOptions&>(
+      config, context.messageValidationVisitor());
+  const SocketInterface* sock_interface =
+      socketInterface("envoy.extensions.network.socket_interface.io_uring");
+  ASSERT(sock_interface != nullptr);
+  return std::make_shared<IoUringProtocolOptionsConfig>(*sock_interface);
+}
+
+ProtobufTypes::MessagePtr IoUringProtocolOptionsFactory::createEmptyProtocolOptionsProto() {
+  return std::make_unique<
+      envoy::extensions::network::socket_interface::v3::IoUringProtocolOptions>();
+}
+
+ProtobufTypes::MessagePtr IoUringProtocolOptionsFactory::createEmptyConfigProto() {
+  return createEmptyProtocolOptionsProto();
+}
+
+REGISTER_FACTORY(IoUringProtocolOptionsFactory, Server::Configuration::ProtocolOptionsFactory);
+
+namespace Address {
+
+InstanceConstSharedPtr
+IoUringResolver::resolve(const envoy::config::core::v3::SocketAddress& socket_address) {
+  if (socket_address.port_specifier_case() ==
+      envoy::config::core::v3::SocketAddress::PortSpecifierCase::kNamedPort) {
+    throw EnvoyException(fmt::format("io_uring resolver can't handle port specifier type {}",
+                                     socket_address.port_specifier_case()));
+  }
+  const SocketInterface* sock_interface =
+      socketInterface("envoy.extensions.network.socket_interface.io_uring");
+  ASSERT(sock_interface != nullptr);
+  return Network::Utility::getAddressWithSocketInterface(
+      Network::Utility::parseInternetAddress(socket_address.address(), socket_address.port_value(),
+                                             !socket_address.ipv4_compat()),
+      *sock_interface);
+}
+
+REGISTER_FACTORY(IoUringResolver, Resolver);
+
+} // namespace Address
+} // namespace Network
+} // namespace Envoy
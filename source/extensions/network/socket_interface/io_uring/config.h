@@ -0,0 +1,105 @@
+#pragma once
+
+#include "envoy/common/io/io_uring.h"
+#include "envoy/network/resolver.h"
+#include "envoy/server/filter_config.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/network/socket_interface_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Socket interface which creates IoUringSocketHandleImpl for stream sockets. It is selected per
+ * address through the envoy.resolvers.io_uring address resolver.
+ */
+class IoUringSocketInterface : public SocketInterfaceImpl {
+public:
+  // Server::Configuration::BootstrapExtensionFactory
+  Server::BootstrapExtensionPtr
+  createBootstrapExtension(const Protobuf::Message& config,
+                           Server::Configuration::ServerFactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string name() const override {
+    return "envoy.extensions.network.socket_interface.io_uring";
+  };
+
+protected:
+  // SocketInterfaceImpl
+  IoHandlePtr makeSocket(int socket_fd, bool socket_v6only, absl::optional<int> domain,
+                         Socket::Type socket_type) const override;
+
+private:
+  // Owned by the bootstrap extension. Sockets are created with the default handle until the
+  // extension is configured, or if io_uring is not supported.
+  std::weak_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+};
+
+DECLARE_FACTORY(IoUringSocketInterface);
+
+class IoUringSocketInterfaceExtension : public SocketInterfaceExtension {
+public:
+  IoUringSocketInterfaceExtension(
+      SocketInterface& sock_interface,
+      std::shared_ptr<Io::IoUringWorkerFactory>&& io_uring_worker_factory)
+      : SocketInterfaceExtension(sock_interface),
+        io_uring_worker_factory_(std::move(io_uring_worker_factory)) {}
+
+  // Server::BootstrapExtension
+  void onServerInitialized() override;
+
+private:
+  const std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+};
+
+/**
+ * Cluster protocol options which create the upstream connections of the cluster with the io_uring
+ * socket interface.
+ */
+class IoUringProtocolOptionsConfig : public Upstream::SocketInterfaceProtocolOptionsConfig {
+public:
+  explicit IoUringProtocolOptionsConfig(const SocketInterface& sock_interface)
+      : sock_interface_(sock_interface) {}
+
+  // Upstream::SocketInterfaceProtocolOptionsConfig
+  const SocketInterface& socketInterface() const override { return sock_interface_; }
+
+private:
+  const SocketInterface& sock_interface_;
+};
+
+class IoUringProtocolOptionsFactory : public Server::Configuration::ProtocolOptionsFactory {
+public:
+  // Server::Configuration::ProtocolOptionsFactory
+  Upstream::ProtocolOptionsConfigConstSharedPtr createProtocolOptionsConfig(
+      const Protobuf::Message& config,
+      Server::Configuration::ProtocolOptionsFactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyProtocolOptionsProto() override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string category() const override { return "envoy.upstream_options"; }
+  std::string name() const override {
+    return "envoy.extensions.network.socket_interface.v3.IoUringProtocolOptions";
+  }
+};
+
+DECLARE_FACTORY(IoUringProtocolOptionsFactory);
+
+namespace Address {
+
+/**
+ * Resolver for IP addresses whose sockets are created by the io_uring socket interface.
+ */
+class IoUringResolver : public Resolver {
+public:
+  // Network::Address::Resolver
+  InstanceConstSharedPtr
+  resolve(const envoy::config::core::v3::SocketAddress& socket_address) override;
+  std::string name() const override { return "envoy.resolvers.io_uring"; }
+};
+
+DECLARE_FACTORY(IoUringResolver);
+
+} // namespace Address
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,213 @@
+#include "source/extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(
+    std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory, os_fd_t fd,
+    bool socket_v6only, absl::optional<int> domain, bool is_server)
+    : IoSocketHandleImpl(fd, socket_v6only, domain),
+      io_uring_worker_factory_(std::move(io_uring_worker_factory)), is_server_(is_server) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (io_uring_socket_ != nullptr) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::close();
+  }
+  // The io_uring socket closes the fd once its in-flight requests completed.
+  io_uring_socket_->close();
+  io_uring_socket_ = nullptr;
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+  uint64_t capacity = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    capacity += slices[i].len_;
+  }
+  Buffer::OwnedImpl buffer;
+  Api::IoCallUint64Result result = io_uring_socket_->read(buffer, std::min(max_length, capacity));
+  if (!result.ok()) {
+    return result;
+  }
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < num_slice && offset < buffer.length(); i++) {
+    const uint64_t length = std::min<uint64_t>(slices[i].len_, buffer.length() - offset);
+    buffer.copyOut(offset, length, slices[i].mem_);
+    offset += length;
+  }
+  return result;
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      absl::optional<uint64_t> max_length) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::read(buffer, max_length);
+  }
+  if (max_length.has_value() && max_length.value() == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  // The data was read ahead into buffers owned by the socket, and is moved without copying.
+  return io_uring_socket_->read(buffer, max_length.value_or(UINT64_MAX));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::writev(slices, num_slice);
+  }
+  return io_uring_socket_->writev(slices, num_slice);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::write(buffer);
+  }
+  return io_uring_socket_->write(buffer);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+  // Listener filters peek at the data, which was read ahead by the socket already.
+  return io_uring_socket_->recv(buffer, length, flags);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::listen(int backlog) {
+  is_listener_ = true;
+  return IoSocketHandleImpl::listen(backlog);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  os_fd_t fd;
+  if (io_uring_socket_ == nullptr) {
+    fd = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen).return_value_;
+  } else {
+    fd = io_uring_socket_->accept(addr, addrlen);
+  }
+  if (SOCKET_INVALID(fd)) {
+    return nullptr;
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, fd, socket_v6only_,
+                                                   domain_, true);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
+  if (io_uring_socket_ == nullptr) {
+    is_server_ = true;
+    return IoSocketHandleImpl::connect(address);
+  }
+  // The outcome is reported through a Write event and SO_ERROR, like for a non-blocking connect.
+  io_uring_socket_->connect(address);
+  return {-1, SOCKET_ERROR_IN_PROGRESS};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::getOption(int level, int optname, void* optval,
+                                                         socklen_t* optlen) {
+  if (io_uring_socket_ != nullptr && level == SOL_SOCKET && optname == SO_ERROR) {
+    ASSERT(*optlen >= sizeof(int));
+    *static_cast<int*>(optval) = io_uring_socket_->connectError();
+    *optlen = sizeof(int);
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::getOption(level, optname, optval, optlen);
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb,
+                                                  Event::FileTriggerType trigger,
+                                                  uint32_t events) {
+  if (io_uring_socket_ != nullptr) {
+    // The file events were reset, e.g. when the connection is created once the listener filters
+    // completed. The socket keeps the data which was read already.
+    io_uring_socket_->setFileReadyCb(std::move(cb));
+    io_uring_socket_->enableFileEvents(events);
+    return;
+  }
+
+  OptRef<Io::IoUringWorker> worker;
+  if (!use_syscalls_) {
+    worker = io_uring_worker_factory_->getIoUringWorker();
+  }
+  if (!worker.has_value() || &worker->dispatcher() != &dispatcher) {
+    // Sockets which are used on the main thread, or on a dispatcher without io_uring worker,
+    // fall back to readiness events.
+    use_syscalls_ = true;
+    IoSocketHandleImpl::initializeFileEvent(dispatcher, std::move(cb), trigger, events);
+    return;
+  }
+
+  if (is_listener_) {
+    io_uring_socket_ = &worker->addAcceptSocket(fd_, std::move(cb));
+  } else if (is_server_) {
+    io_uring_socket_ = &worker->addServerSocket(fd_, std::move(cb));
+  } else {
+    io_uring_socket_ = &worker->addClientSocket(fd_, std::move(cb));
+  }
+  io_uring_socket_->enableFileEvents(events);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::duplicate() {
+  auto result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.return_value_ != -1,
+                 fmt::format("duplicate failed for '{}': ({}) {}", fd_, result.errno_,
+                             errorDetails(result.errno_)));
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(
+      io_uring_worker_factory_, result.return_value_, socket_v6only_, domain_, is_server_);
+  // Listen sockets are duplicated for each worker.
+  handle->is_listener_ = is_listener_;
+  return handle;
+}
+
+void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
+  if (io_uring_socket_ == nullptr) {
+    IoSocketHandleImpl::activateFileEvents(events);
+    return;
+  }
+  io_uring_socket_->activateFileEvents(events);
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (io_uring_socket_ == nullptr) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+  io_uring_socket_->enableFileEvents(events);
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  if (io_uring_socket_ == nullptr) {
+    IoSocketHandleImpl::resetFileEvents();
+    return;
+  }
+  // The socket stays registered with the worker, so read ahead data is not lost.
+  io_uring_socket_->enableFileEvents(0);
+  io_uring_socket_->setFileReadyCb(nullptr);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (io_uring_socket_ == nullptr) {
+    return IoSocketHandleImpl::shutdown(how);
+  }
+  io_uring_socket_->shutdown(how);
+  return {0, 0};
+}
+
+} // namespace Network
+} // namespace Envoy
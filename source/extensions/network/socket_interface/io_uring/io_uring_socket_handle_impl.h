@@ -0,0 +1,59 @@
+#pragma once
+
+#include "envoy/common/io/io_uring.h"
+
+#include "source/common/network/io_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * IoHandle for stream sockets which drives accept, connect, read, write and close through the
+ * io_uring worker of the thread its file events are initialized on. Sockets which are used on a
+ * thread without io_uring worker behave like IoSocketHandleImpl, i.e. use readiness events and
+ * syscalls.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory,
+                          os_fd_t fd = INVALID_SOCKET, bool socket_v6only = false,
+                          absl::optional<int> domain = absl::nullopt, bool is_server = false);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer,
+                               absl::optional<uint64_t> max_length) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::SysCallIntResult listen(int backlog) override;
+  IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Address::InstanceConstSharedPtr address) override;
+  Api::SysCallIntResult getOption(int level, int optname, void* optval, socklen_t* optlen) override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  IoHandlePtr duplicate() override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+  Api::SysCallIntResult shutdown(int how) override;
+
+private:
+  const std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+  // Whether listen() was called on the socket.
+  bool is_listener_{false};
+  // Whether the socket is connected already, i.e. was accepted or connected with a syscall.
+  bool is_server_;
+  // Whether the file events were initialized without io_uring worker once, in which case the
+  // socket keeps using syscalls.
+  bool use_syscalls_{false};
+  // The io_uring socket is owned by the worker, and outlives the handle until its in-flight
+  // requests completed.
+  Io::IoUringSocket* io_uring_socket_{nullptr};
+};
+
+} // namespace Network
+} // namespace Envoy
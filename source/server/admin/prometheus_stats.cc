@@ -1,5 +1,7 @@
 #include "source/server/admin/prometheus_stats.h"
 
+#include <limits>
+
 #include "source/common/common/empty_string.h"
 #include "source/common/common/macros.h"
 #include "source/common/common/regex.h"
@@ -71,16 +73,97 @@ static bool shouldShowMetric(const StatType& metric, const StatsParams& params)
   return true;
 }
 
-/*
- * Comparator for Stats::Metric that does not require a string representation
- * to make the comparison, for memory efficiency.
+/**
+ * Groups the metrics of a type by their tag-extracted names, and sorts the groups by name.
+ *
+ * From
+ * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+ *
+ * All lines for a given metric must be provided as one single group, with the optional HELP and
+ * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+ * expositions is preferred but not required, i.e. do not sort if the computational cost is
+ * prohibitive.
+ *
+ * @param params captures query parameters indicating which metrics should be included.
+ * @param symbol_table the symbol table of all the metrics.
+ * @param for_each_metric calls the supplied function with each metric of the type.
+ * @return the groups of the metrics to output, sorted by tag-extracted name.
+ */
+template <class StatType>
+PrometheusMetricGroups<StatType>
+groupMetrics(const StatsParams& params, const Stats::SymbolTable& symbol_table,
+             const std::function<void(const Stats::StatFn<StatType>&)>& for_each_metric) {
+  PrometheusMetricGroups<StatType> groups;
+  // The groups are found by hashing the encoded tag-extracted names, which neither takes the
+  // symbol table lock nor builds their strings.
+  Stats::StatNameHashMap<size_t> group_indices;
+  for_each_metric([&params, &groups, &group_indices](StatType& metric) {
+    ASSERT(groups.empty() ||
+           &groups.front().metrics_.front()->constSymbolTable() == &metric.constSymbolTable());
+    if (!shouldShowMetric(metric, params)) {
+      return;
+    }
+    const Stats::StatName tag_extracted_name = metric.tagExtractedStatName();
+    const auto [iter, inserted] = group_indices.try_emplace(tag_extracted_name, groups.size());
+    if (inserted) {
+      groups.push_back({tag_extracted_name, {}});
+    }
+    groups[iter->second].metrics_.emplace_back(&metric);
+  });
+
+  symbol_table.sortByStatNames<PrometheusMetricGroup<StatType>>(
+      groups.begin(), groups.end(),
+      [](const PrometheusMetricGroup<StatType>& group) { return group.tag_extracted_name_; });
+  return groups;
+}
+
+/**
+ * Outputs groups of metrics into response, starting from next_group, until all the groups are
+ * output or the response reaches max_length.
+ *
+ * @param groups the sorted groups of metrics to output. The metrics of each group are released
+ *        once the group is output.
+ * @param next_group the index of the next group to output, which is advanced past the groups
+ *        which are output.
+ * @param generate_output A function which returns the output text for this metric.
+ * @param type The name of the prometheus metric type for used in TYPE annotations.
+ * @param response The buffer to put the output into.
+ * @param max_length the length of the response after which no more groups are output.
+ * @return the number of groups which have a valid prometheus metric name.
  */
-struct MetricLessThan {
-  bool operator()(const Stats::Metric* a, const Stats::Metric* b) const {
-    ASSERT(&a->constSymbolTable() == &b->constSymbolTable());
-    return a->constSymbolTable().lessThan(a->statName(), b->statName());
+template <class StatType>
+uint64_t outputMetricGroups(
+    PrometheusMetricGroups<StatType>& groups, size_t& next_group,
+    const std::function<std::string(
+        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
+    absl::string_view type, const Stats::CustomStatNamespaces& custom_namespaces,
+    const Stats::SymbolTable& symbol_table, Buffer::Instance& response, uint64_t max_length) {
+  uint64_t result = 0;
+  for (; next_group < groups.size() && response.length() < max_length; ++next_group) {
+    PrometheusMetricGroup<StatType>& group = groups[next_group];
+    const absl::optional<std::string> prefixed_tag_extracted_name =
+        PrometheusStatsFormatter::metricName(symbol_table.toString(group.tag_extracted_name_),
+                                             custom_namespaces);
+    if (prefixed_tag_extracted_name.has_value()) {
+      ++result;
+      response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
+
+      // Sort before producing the final output to satisfy the "preferred" ordering from the
+      // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+      // be consistent across calls.
+      symbol_table.sortByStatNames<Stats::RefcountPtr<StatType>>(
+          group.metrics_.begin(), group.metrics_.end(),
+          [](const Stats::RefcountPtr<StatType>& metric) { return metric->statName(); });
+
+      for (const auto& metric : group.metrics_) {
+        response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
+      }
+    }
+    // Release the metrics, which may otherwise be held until the whole response is streamed.
+    group.metrics_ = {};
   }
-};
+  return result;
+}
 
 /**
  * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
@@ -88,8 +171,7 @@ struct MetricLessThan {
  * response.
  *
  * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
+ * @param params captures query parameters indicating which metrics should be included.
  * @param metrics The metrics to output stats for. This must contain all stats of the given type
  *        to be included in the same output.
  * @param generate_output A function which returns the output text for this metric.
@@ -102,24 +184,6 @@ uint64_t outputStatType(
     const std::function<std::string(
         const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
     absl::string_view type, const Stats::CustomStatNamespaces& custom_namespaces) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
   // Return early to avoid crashing when getting the symbol table from the first metric.
   if (metrics.empty()) {
     return 0;
@@ -131,40 +195,16 @@ uint64_t outputStatType(
   // comparison.
   const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
 
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-    if (!shouldShowMetric(*metric, params)) {
-      continue;
-    }
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  auto result = groups.size();
-  for (auto& group : groups) {
-    const absl::optional<std::string> prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first),
-                                             custom_namespaces);
-    if (!prefixed_tag_extracted_name.has_value()) {
-      --result;
-      continue;
-    }
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name.value(), type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name.value()));
-    }
-  }
-  return result;
+  PrometheusMetricGroups<StatType> groups = groupMetrics<StatType>(
+      params, global_symbol_table, [&metrics](const Stats::StatFn<StatType>& f_stat) {
+        for (const auto& metric : metrics) {
+          f_stat(*metric);
+        }
+      });
+  size_t next_group = 0;
+  return outputMetricGroups<StatType>(groups, next_group, generate_output, type, custom_namespaces,
+                                      global_symbol_table, response,
+                                      std::numeric_limits<uint64_t>::max());
 }
 
 /*
@@ -290,5 +330,102 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
   return metric_name_count;
 }
 
+PrometheusStatsRequest::PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                                               const Stats::CustomStatNamespaces& custom_namespaces)
+    : stats_(stats), params_(params), custom_namespaces_(custom_namespaces) {}
+
+Http::Code PrometheusStatsRequest::start(Http::ResponseHeaderMap&) {
+  counter_groups_ = groupMetrics<Stats::Counter>(
+      params_, stats_.constSymbolTable(), [this](const Stats::StatFn<Stats::Counter>& f_stat) {
+        stats_.forEachCounter(nullptr, f_stat);
+      });
+  return Http::Code::OK;
+}
+
+bool PrometheusStatsRequest::nextChunk(Buffer::Instance& response) {
+  // nextChunk's contract is to add up to chunk_size_ additional bytes. The
+  // caller is not required to drain the bytes after each call to nextChunk.
+  const uint64_t max_length = response.length() + chunk_size_;
+  const Stats::SymbolTable& symbol_table = stats_.constSymbolTable();
+  while (response.length() < max_length) {
+    size_t num_groups = 0;
+    switch (phase_) {
+    case Phase::Counters:
+      outputMetricGroups<Stats::Counter>(counter_groups_, next_group_,
+                                         generateNumericOutput<Stats::Counter>, "counter",
+                                         custom_namespaces_, symbol_table, response, max_length);
+      num_groups = counter_groups_.size();
+      break;
+    case Phase::Gauges:
+      outputMetricGroups<Stats::Gauge>(gauge_groups_, next_group_,
+                                       generateNumericOutput<Stats::Gauge>, "gauge",
+                                       custom_namespaces_, symbol_table, response, max_length);
+      num_groups = gauge_groups_.size();
+      break;
+    case Phase::TextReadouts:
+      // TextReadout stats are returned in gauge format, so "gauge" type is set intentionally.
+      outputMetricGroups<Stats::TextReadout>(text_readout_groups_, next_group_,
+                                             generateTextReadoutOutput, "gauge",
+                                             custom_namespaces_, symbol_table, response,
+                                             max_length);
+      num_groups = text_readout_groups_.size();
+      break;
+    case Phase::Histograms:
+      outputMetricGroups<Stats::ParentHistogram>(histogram_groups_, next_group_,
+                                                 generateHistogramOutput, "histogram",
+                                                 custom_namespaces_, symbol_table, response,
+                                                 max_length);
+      num_groups = histogram_groups_.size();
+      break;
+    case Phase::Done:
+      return false;
+    }
+    if (next_group_ == num_groups) {
+      startNextPhase();
+    }
+  }
+  return phase_ != Phase::Done;
+}
+
+void PrometheusStatsRequest::startNextPhase() {
+  const Stats::SymbolTable& symbol_table = stats_.constSymbolTable();
+  next_group_ = 0;
+  switch (phase_) {
+  case Phase::Counters:
+    counter_groups_.clear();
+    phase_ = Phase::Gauges;
+    gauge_groups_ = groupMetrics<Stats::Gauge>(
+        params_, symbol_table, [this](const Stats::StatFn<Stats::Gauge>& f_stat) {
+          stats_.forEachGauge(nullptr, f_stat);
+        });
+    break;
+  case Phase::Gauges:
+    gauge_groups_.clear();
+    if (params_.prometheus_text_readouts_) {
+      phase_ = Phase::TextReadouts;
+      text_readout_groups_ = groupMetrics<Stats::TextReadout>(
+          params_, symbol_table, [this](const Stats::StatFn<Stats::TextReadout>& f_stat) {
+            stats_.forEachTextReadout(nullptr, f_stat);
+          });
+      break;
+    }
+    FALLTHRU;
+  case Phase::TextReadouts:
+    text_readout_groups_.clear();
+    phase_ = Phase::Histograms;
+    histogram_groups_ = groupMetrics<Stats::ParentHistogram>(
+        params_, symbol_table, [this](const Stats::StatFn<Stats::ParentHistogram>& f_stat) {
+          stats_.forEachHistogram(nullptr, f_stat);
+        });
+    break;
+  case Phase::Histograms:
+    histogram_groups_.clear();
+    phase_ = Phase::Done;
+    break;
+  case Phase::Done:
+    break;
+  }
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -4,14 +4,30 @@
 #include <string>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/server/admin.h"
 #include "envoy/stats/custom_stat_namespaces.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/store.h"
 
 #include "source/server/admin/stats_params.h"
 
 namespace Envoy {
 namespace Server {
+
+/**
+ * Metrics of one type sharing a tag-extracted name, which the exposition format requires to be
+ * rendered together, after a single TYPE line.
+ */
+template <class StatType> struct PrometheusMetricGroup {
+  // Refers to the storage of the metrics, which are held by the group.
+  Stats::StatName tag_extracted_name_;
+  std::vector<Stats::RefcountPtr<StatType>> metrics_;
+};
+
+template <class StatType>
+using PrometheusMetricGroups = std::vector<PrometheusMetricGroup<StatType>>;
+
 /**
  * Formatter for metric/labels exported to Prometheus.
  *
@@ -47,5 +63,47 @@ public:
              const Stats::CustomStatNamespaces& custom_namespace_factory);
 };
 
+/**
+ * Streams stats in the Prometheus exposition format, implementing the AdminHandler interface.
+ *
+ * The metrics of one type at a time are grouped by tag-extracted name, and the groups are sorted
+ * by their tag-extracted StatNames, taking the symbol table lock once for the whole sort. The
+ * text of each group is generated as the group is reached, up to the chunk size per call to
+ * nextChunk(), so that the response is never buffered as a whole, and the references to the
+ * metrics of a group are dropped once it is rendered.
+ */
+class PrometheusStatsRequest : public Admin::Request {
+public:
+  static constexpr uint64_t DefaultChunkSize = 2 * 1000 * 1000;
+
+  PrometheusStatsRequest(Stats::Store& stats, const StatsParams& params,
+                         const Stats::CustomStatNamespaces& custom_namespaces);
+
+  // Admin::Request
+  Http::Code start(Http::ResponseHeaderMap& response_headers) override;
+  bool nextChunk(Buffer::Instance& response) override;
+
+  // Sets the chunk size.
+  void setChunkSize(uint64_t chunk_size) { chunk_size_ = chunk_size; }
+
+private:
+  // Ordered as the types are rendered by PrometheusStatsFormatter::statsAsPrometheus().
+  enum class Phase { Counters, Gauges, TextReadouts, Histograms, Done };
+
+  // Advances to the next phase with metrics to render, and groups its metrics.
+  void startNextPhase();
+
+  Stats::Store& stats_;
+  const StatsParams params_;
+  const Stats::CustomStatNamespaces& custom_namespaces_;
+  Phase phase_{Phase::Counters};
+  size_t next_group_{0};
+  PrometheusMetricGroups<Stats::Counter> counter_groups_;
+  PrometheusMetricGroups<Stats::Gauge> gauge_groups_;
+  PrometheusMetricGroups<Stats::TextReadout> text_readout_groups_;
+  PrometheusMetricGroups<Stats::ParentHistogram> histogram_groups_;
+  uint64_t chunk_size_{DefaultChunkSize};
+};
+
 } // namespace Server
 } // namespace Envoy
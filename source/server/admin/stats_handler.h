@@ -33,42 +33,6 @@ public:
                                               Buffer::Instance& response, AdminStream&);
   Http::Code handlerStatsRecentLookupsEnable(Http::ResponseHeaderMap& response_headers,
                                              Buffer::Instance& response, AdminStream&);
-  Http::Code handlerPrometheusStats(Http::ResponseHeaderMap& response_headers,
-                                    Buffer::Instance& response, AdminStream&);
-
-  /**
-   * Parses and executes a prometheus stats request.
-   *
-   * @param path_and_query the URL path and query
-   * @param response buffer into which to write response
-   * @return http response code
-   */
-  Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response);
-
-  /**
-   * Checks the server_ to see if a flush is needed, and then renders the
-   * prometheus stats request.
-   *
-   * @params params the already-parsed parameters.
-   * @param response buffer into which to write response
-   */
-  void prometheusFlushAndRender(const StatsParams& params, Buffer::Instance& response);
-
-  /**
-   * Renders the stats as prometheus. This is broken out as a separately
-   * callable API to facilitate the benchmark
-   * (test/server/admin/stats_handler_speed_test.cc) which does not have a
-   * server object.
-   *
-   * @params stats the stats store to read
-   * @param custom_namespaces namespace mappings used for prometheus
-   * @params params the already-parsed parameters.
-   * @param response buffer into which to write response
-   */
-  static void prometheusRender(Stats::Store& stats,
-                               const Stats::CustomStatNamespaces& custom_namespaces,
-                               const StatsParams& params, Buffer::Instance& response);
-
   Http::Code handlerContention(Http::ResponseHeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
 
@@ -86,14 +50,37 @@ public:
    */
   Admin::UrlHandler statsHandler(bool active_mode);
 
+  /**
+   * @return a URL handler for /stats/prometheus, which streams the stats in the
+   *         prometheus format.
+   */
+  Admin::UrlHandler prometheusStatsHandler();
+
   static Admin::RequestPtr makeRequest(Stats::Store& stats, const StatsParams& params,
                                        StatsRequest::UrlHandlerFn url_handler_fn = nullptr);
   Admin::RequestPtr makeRequest(AdminStream&);
 
+  /**
+   * Makes a request streaming the stats in the prometheus format. This is
+   * broken out as a separately callable API to facilitate the benchmark
+   * (test/server/admin/stats_handler_speed_test.cc) which does not have a
+   * server object.
+   *
+   * @params stats the stats store to read
+   * @params params the already-parsed parameters.
+   * @param custom_namespaces namespace mappings used for prometheus
+   */
+  static Admin::RequestPtr
+  makePrometheusRequest(Stats::Store& stats, const StatsParams& params,
+                        const Stats::CustomStatNamespaces& custom_namespaces);
+
 private:
-  static Http::Code prometheusStats(absl::string_view path_and_query, Buffer::Instance& response,
-                                    Stats::Store& stats,
-                                    Stats::CustomStatNamespaces& custom_namespaces);
+  // Parses the prometheus stats request parameters from the URL, flushes the
+  // stats if needed, and makes the request.
+  Admin::RequestPtr makePrometheusRequest(AdminStream& admin_stream);
+
+  // Flushes the stats if needed, and makes the request.
+  Admin::RequestPtr makePrometheusRequest(const StatsParams& params);
 };
 
 } // namespace Server
@@ -46,7 +46,7 @@ Http::Code StatsRequest::start(Http::ResponseHeaderMap& response_headers) {
   }
 #endif
   case StatsFormat::Prometheus:
-    // TODO(#16139): once Prometheus shares this algorithm here, this becomes a legitimate choice.
+    // Prometheus groups stats by tag-extracted name, so it is streamed by PrometheusStatsRequest.
     IS_ENVOY_BUG("reached Prometheus case in switch unexpectedly");
     return Http::Code::BadRequest;
   }
@@ -26,6 +26,7 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/utility.h"
@@ -162,6 +163,9 @@ InstanceImpl::~InstanceImpl() {
   ENVOY_LOG(debug, "destroyed listener manager");
   dispatcher_->shutdown();
 
+  // All the worker threads have exited, so the pool can be disabled for a later server instance.
+  Buffer::SlicePool::reset();
+
 #ifdef ENVOY_PERFETTO
   if (tracing_session_ != nullptr) {
     // Flush the trace data.
@@ -196,57 +200,66 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(live_.load());
 }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source) {
-  store.forEachSinkedCounter(
-      [this](std::size_t size) {
-        snapped_counters_.reserve(size);
-        counters_.reserve(size);
-      },
-      [this](Stats::Counter& counter) {
-        snapped_counters_.push_back(Stats::CounterSharedPtr(&counter));
-        counters_.push_back({counter.latch(), counter});
-      });
-
-  store.forEachSinkedGauge(
-      [this](std::size_t size) {
-        snapped_gauges_.reserve(size);
-        gauges_.reserve(size);
-      },
-      [this](Stats::Gauge& gauge) {
-        snapped_gauges_.push_back(Stats::GaugeSharedPtr(&gauge));
-        gauges_.push_back(gauge);
-      });
-
-  store.forEachSinkedHistogram(
-      [this](std::size_t size) {
-        snapped_histograms_.reserve(size);
-        histograms_.reserve(size);
-      },
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source,
+                                       bool changed_only) {
+  const Stats::SizeFn counters_size = [this](std::size_t size) {
+    snapped_counters_.reserve(size);
+    counters_.reserve(size);
+  };
+  const Stats::StatFn<Stats::Counter> counter_fn = [this](Stats::Counter& counter) {
+    snapped_counters_.push_back(Stats::CounterSharedPtr(&counter));
+    counters_.push_back({counter.latch(), counter});
+  };
+  const Stats::SizeFn gauges_size = [this](std::size_t size) {
+    snapped_gauges_.reserve(size);
+    gauges_.reserve(size);
+  };
+  const Stats::StatFn<Stats::Gauge> gauge_fn = [this](Stats::Gauge& gauge) {
+    snapped_gauges_.push_back(Stats::GaugeSharedPtr(&gauge));
+    gauges_.push_back(gauge);
+  };
+  const Stats::SizeFn histograms_size = [this](std::size_t size) {
+    snapped_histograms_.reserve(size);
+    histograms_.reserve(size);
+  };
+  const Stats::StatFn<Stats::ParentHistogram> histogram_fn =
       [this](Stats::ParentHistogram& histogram) {
         snapped_histograms_.push_back(Stats::ParentHistogramSharedPtr(&histogram));
         histograms_.push_back(histogram);
-      });
-
-  store.forEachSinkedTextReadout(
-      [this](std::size_t size) {
-        snapped_text_readouts_.reserve(size);
-        text_readouts_.reserve(size);
-      },
+      };
+  const Stats::SizeFn text_readouts_size = [this](std::size_t size) {
+    snapped_text_readouts_.reserve(size);
+    text_readouts_.reserve(size);
+  };
+  const Stats::StatFn<Stats::TextReadout> text_readout_fn =
       [this](Stats::TextReadout& text_readout) {
         snapped_text_readouts_.push_back(Stats::TextReadoutSharedPtr(&text_readout));
         text_readouts_.push_back(text_readout);
-      });
+      };
+
+  if (changed_only) {
+    // Counters which did not change since the previous snapshot have nothing to latch.
+    store.forEachChangedSinkedCounter(counters_size, counter_fn);
+    store.forEachChangedSinkedGauge(gauges_size, gauge_fn);
+    store.forEachChangedSinkedHistogram(histograms_size, histogram_fn);
+    store.forEachChangedSinkedTextReadout(text_readouts_size, text_readout_fn);
+  } else {
+    store.forEachSinkedCounter(counters_size, counter_fn);
+    store.forEachSinkedGauge(gauges_size, gauge_fn);
+    store.forEachSinkedHistogram(histograms_size, histogram_fn);
+    store.forEachSinkedTextReadout(text_readouts_size, text_readout_fn);
+  }
 
   snapshot_time_ = time_source.systemTime();
 }
 
 void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
-                                       TimeSource& time_source) {
+                                       TimeSource& time_source, bool changed_only) {
   // Create a snapshot and flush to all sinks.
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
-  MetricSnapshotImpl snapshot(store, time_source);
+  MetricSnapshotImpl snapshot(store, time_source, changed_only);
   for (const auto& sink : sinks) {
     sink->flush(snapshot);
   }
@@ -305,7 +318,8 @@ void InstanceImpl::updateServerStats() {
 void InstanceImpl::flushStatsInternal() {
   updateServerStats();
   auto& stats_config = config_.statsConfig();
-  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource());
+  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource(),
+                                    stats_config.flushChangedOnly());
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
     stat_flush_timer_->enableTimer(stats_config.flushInterval());
@@ -428,6 +442,15 @@ void InstanceImpl::initialize(Network::Address::InstanceConstSharedPtr local_add
     THROW_IF_NOT_OK(Utility::maybeSetApplicationLogFormat(bootstrap_.application_log_config()));
   }
 
+  // The buffer slice pool must be configured before any worker thread is started.
+  if (bootstrap_.has_buffer_slice_pool()) {
+    const auto& slice_pool = bootstrap_.buffer_slice_pool();
+    Buffer::SlicePool::configure(Buffer::SlicePoolConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(slice_pool, max_cached_bytes_per_thread, 4 * 1024 * 1024),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(slice_pool, max_arena_bytes_per_thread, 64 * 1024 * 1024),
+        slice_pool.use_huge_pages()});
+  }
+
 #ifdef ENVOY_PERFETTO
   perfetto::TracingInitArgs args;
   // Include in-process events only.
@@ -486,6 +509,9 @@ void InstanceImpl::initialize(Network::Address::InstanceConstSharedPtr local_add
   stats_store_.setStatsMatcher(
       Config::Utility::createStatsMatcher(bootstrap_, stats_store_.symbolTable()));
   stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
+  if (bootstrap_.stats_flush_changed_only()) {
+    stats_store_.trackChangedStats();
+  }
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -131,9 +131,11 @@ public:
    * flush() on each sink.
    * @param sinks supplies the list of sinks.
    * @param store provides the store being flushed.
+   * @param time_source provides the time of the snapshot.
+   * @param changed_only whether to only flush the stats which changed since the previous flush.
    */
   static void flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
-                                  TimeSource& time_source);
+                                  TimeSource& time_source, bool changed_only = false);
 
   /**
    * Load a bootstrap config and perform validation.
@@ -426,7 +428,11 @@ private:
 //                     copying and probably be a cleaner API in general.
 class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
-  explicit MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source);
+  /**
+   * @param changed_only whether to only snapshot the stats which changed since the previous
+   *        snapshot, @see Stats::Store::forEachChangedSinkedCounter().
+   */
+  MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source, bool changed_only = false);
 
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
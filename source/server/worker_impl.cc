@@ -146,6 +146,13 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog, const std::function<void()>&
     cb();
     watch_dog_ = guard_dog.createWatchDog(api_.threadFactory().currentThreadId(),
                                           dispatcher_->name(), *dispatcher_);
+    if (Buffer::SlicePool::enabled()) {
+      const std::string prefix = absl::StrCat(dispatcher_->name(), ".buffer_slice_pool.");
+      slice_pool_stats_ = std::make_unique<Buffer::SlicePoolStats>(Buffer::SlicePoolStats{
+          ALL_SLICE_POOL_STATS(POOL_COUNTER_PREFIX(api_.rootScope(), prefix),
+                               POOL_GAUGE_PREFIX(api_.rootScope(), prefix))});
+      Buffer::SlicePool::setThreadLocalStats(slice_pool_stats_.get());
+    }
   });
   dispatcher_->run(Event::Dispatcher::RunType::Block);
   ENVOY_LOG(debug, "worker exited dispatch loop");
@@ -158,6 +165,7 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog, const std::function<void()>&
   handler_.reset();
   tls_.shutdownThread();
   watch_dog_.reset();
+  Buffer::SlicePool::setThreadLocalStats(nullptr);
 }
 
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
@@ -10,6 +10,7 @@
 #include "envoy/server/worker.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/logger.h"
 #include "source/server/listener_hooks.h"
 
@@ -81,6 +82,8 @@ private:
   Stats::Counter& reset_streams_counter_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
+  // Only set if the buffer slice pool is enabled.
+  std::unique_ptr<Buffer::SlicePoolStats> slice_pool_stats_;
 };
 
 } // namespace Server
@@ -11,6 +11,10 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -501,6 +505,128 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, WritesFromMultipleThreadsAreNotInterleaved) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  absl::Mutex mutex;
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        absl::MutexLock lock(&mutex);
+        absl::StrAppend(&written, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t lines_per_thread = 2000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (uint32_t j = 0; j < lines_per_thread; ++j) {
+        log_file->write(absl::StrCat(i, " ", j, "\n"));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  // The lines of the threads may be mixed, but each line is complete and the lines of each thread
+  // are in order.
+  std::vector<uint32_t> next_line(num_threads, 0);
+  {
+    absl::MutexLock lock(&mutex);
+    for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+      std::vector<absl::string_view> parts = absl::StrSplit(line, ' ');
+      ASSERT_EQ(2UL, parts.size());
+      uint32_t thread;
+      uint32_t line_number;
+      ASSERT_TRUE(absl::SimpleAtoi(parts[0], &thread));
+      ASSERT_TRUE(absl::SimpleAtoi(parts[1], &line_number));
+      ASSERT_LT(thread, num_threads);
+      EXPECT_EQ(next_line[thread]++, line_number);
+    }
+  }
+  for (uint32_t lines : next_line) {
+    EXPECT_EQ(lines_per_thread, lines);
+  }
+  EXPECT_EQ(num_threads * lines_per_thread, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_backpressured").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, FullRingIsBackpressuredThenDropped) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  // Block the flush thread while it writes the first data, so that the ring is not drained.
+  absl::Notification writing;
+  absl::Notification unblock;
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        if (!writing.HasBeenNotified()) {
+          writing.Notify();
+          unblock.WaitForNotification();
+        }
+        absl::StrAppend(&written, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write("a");
+  writing.WaitForNotification();
+
+  // Fills the ring, as "a" is only released once written.
+  log_file->write(std::string(AccessLogFileImpl::RING_SIZE - 1, 'b'));
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_backpressured").value());
+  log_file->write("c");
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_backpressured").value());
+  log_file->write(std::string(AccessLogFileImpl::MAX_OVERFLOW_SIZE, 'd'));
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  log_file->write("e");
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_backpressured").value());
+  EXPECT_EQ(4UL, store_.counter("filesystem.write_buffered").value());
+
+  unblock.Notify();
+  log_file->flush();
+  EXPECT_EQ(absl::StrCat("a", std::string(AccessLogFileImpl::RING_SIZE - 1, 'b'), "ce"), written);
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST(AccessLogWriteRingTest, WrapsAround) {
+  AccessLogWriteRing ring(8);
+  std::vector<absl::string_view> slices;
+
+  EXPECT_EQ(0UL, ring.tryWrite("abcde"));
+  EXPECT_EQ(absl::nullopt, ring.tryWrite("fghi"));
+  EXPECT_EQ(5UL, ring.tryWrite("fgh"));
+  EXPECT_EQ(absl::nullopt, ring.tryWrite("i"));
+  EXPECT_EQ(8UL, ring.readableSlices(slices));
+  EXPECT_THAT(slices, testing::ElementsAre("abcdefgh"));
+  ring.release(6);
+
+  // The data which was not released is returned again, followed by the wrapped data.
+  EXPECT_EQ(2UL, ring.tryWrite("ijkl"));
+  slices.clear();
+  EXPECT_EQ(6UL, ring.readableSlices(slices));
+  EXPECT_THAT(slices, testing::ElementsAre("gh", "ijkl"));
+  ring.release(6);
+
+  slices.clear();
+  EXPECT_EQ(0UL, ring.readableSlices(slices));
+  EXPECT_TRUE(slices.empty());
+  EXPECT_EQ(0UL, ring.tryWrite(""));
+  EXPECT_EQ(absl::nullopt, ring.tryWrite("123456789"));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
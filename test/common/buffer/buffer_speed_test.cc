@@ -2,6 +2,7 @@
 #include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/assert.h"
 
@@ -558,4 +559,40 @@ BENCHMARK(bufferAddVsAddFragments)
     ->Args({1, 1, 64, 5})
     ->Args({1, 1, 4096, 5});
 
+
+// Test the allocation of slices for small bodies, such as request or response bodies of a few
+// KiB, with and without the buffer slice pool.
+static void bufferSmallBodySlicePool(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+  const bool use_pool = (state.range(1) != 0);
+  const bool use_huge_pages = (state.range(1) == 2);
+  if (use_pool) {
+    Buffer::SlicePool::configure({4 * 1024 * 1024, 64 * 1024 * 1024, use_huge_pages});
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl buffer;
+    buffer.add(data);
+    Buffer::OwnedImpl other;
+    other.move(buffer);
+    benchmark::DoNotOptimize(other.length());
+  }
+
+  Buffer::SlicePool::resetForTest();
+}
+BENCHMARK(bufferSmallBodySlicePool)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({1, 2})
+    ->Args({4096, 0})
+    ->Args({4096, 1})
+    ->Args({4096, 2})
+    ->Args({16384, 0})
+    ->Args({16384, 1})
+    ->Args({16384, 2})
+    ->Args({65536, 0})
+    ->Args({65536, 1})
+    ->Args({65536, 2});
+
 } // namespace Envoy
@@ -0,0 +1,165 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolTest()
+      : stats_{ALL_SLICE_POOL_STATS(POOL_COUNTER_PREFIX(*store_.rootScope(), "slice_pool."),
+                                    POOL_GAUGE_PREFIX(*store_.rootScope(), "slice_pool."))} {}
+  ~SlicePoolTest() override { SlicePool::resetForTest(); }
+
+  void configure(uint64_t max_cached_bytes, bool use_huge_pages = false) {
+    SlicePool::configure({max_cached_bytes, 4 * SlicePool::arena_size_, use_huge_pages});
+    SlicePool::setThreadLocalStats(&stats_);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  SlicePoolStats stats_;
+};
+
+TEST_F(SlicePoolTest, DisabledByDefault) {
+  EXPECT_FALSE(SlicePool::enabled());
+  {
+    SliceStoragePtr storage = SlicePool::allocate(SlicePool::page_size_);
+    EXPECT_NE(nullptr, storage);
+  }
+  EXPECT_EQ(0, SlicePool::cachedBytesForTest());
+}
+
+TEST_F(SlicePoolTest, ReusesReleasedStorageOfSameSize) {
+  configure(64 * 1024);
+
+  uint8_t* first;
+  {
+    SliceStoragePtr storage = SlicePool::allocate(8192);
+    first = storage.get();
+  }
+  EXPECT_EQ(8192, SlicePool::cachedBytesForTest());
+  EXPECT_EQ(1, stats_.miss_.value());
+  EXPECT_EQ(1, stats_.release_.value());
+
+  // A different size class does not reuse the storage.
+  {
+    SliceStoragePtr storage = SlicePool::allocate(4096);
+    EXPECT_NE(first, storage.get());
+  }
+  EXPECT_EQ(2, stats_.miss_.value());
+
+  SliceStoragePtr storage = SlicePool::allocate(8192);
+  EXPECT_EQ(first, storage.get());
+  EXPECT_EQ(1, stats_.hit_.value());
+  EXPECT_EQ(4096, SlicePool::cachedBytesForTest());
+}
+
+TEST_F(SlicePoolTest, CachedBytesAreBounded) {
+  configure(8192);
+
+  {
+    SliceStoragePtr a = SlicePool::allocate(4096);
+    SliceStoragePtr b = SlicePool::allocate(4096);
+    SliceStoragePtr c = SlicePool::allocate(4096);
+  }
+  EXPECT_EQ(8192, SlicePool::cachedBytesForTest());
+  EXPECT_EQ(2, stats_.release_.value());
+  EXPECT_EQ(1, stats_.overflow_.value());
+}
+
+TEST_F(SlicePoolTest, LargeStorageIsNotPooled) {
+  configure(1024 * 1024);
+
+  { SliceStoragePtr storage = SlicePool::allocate(SlicePool::max_pooled_size_ + 4096); }
+  EXPECT_EQ(0, SlicePool::cachedBytesForTest());
+  EXPECT_EQ(0, stats_.miss_.value());
+  EXPECT_EQ(0, stats_.release_.value());
+}
+
+TEST_F(SlicePoolTest, HugePageArena) {
+  configure(0, true);
+
+  uint8_t* first;
+  {
+    SliceStoragePtr a = SlicePool::allocate(4096);
+    SliceStoragePtr b = SlicePool::allocate(8192);
+    if (stats_.arena_bytes_.value() == 0) {
+      // Arenas are not supported on this platform, so storage comes from the heap.
+      return;
+    }
+    EXPECT_EQ(SlicePool::arena_size_, stats_.arena_bytes_.value());
+    // Storage is carved out of the arena in order.
+    EXPECT_EQ(a.get() + 4096, b.get());
+    first = a.get();
+  }
+  // Arena storage is always cached, regardless of the byte budget of heap storage.
+  EXPECT_EQ(0, SlicePool::cachedBytesForTest());
+  EXPECT_EQ(2, stats_.release_.value());
+  EXPECT_EQ(0, stats_.overflow_.value());
+
+  SliceStoragePtr storage = SlicePool::allocate(4096);
+  EXPECT_EQ(first, storage.get());
+}
+
+// Arena storage released by another thread goes back to the thread that carved it, and is not
+// cached by the releasing thread.
+TEST_F(SlicePoolTest, ForeignReleaseOfArenaStorage) {
+  configure(0, true);
+
+  SliceStoragePtr storage = SlicePool::allocate(4096);
+  if (stats_.arena_bytes_.value() == 0) {
+    // Arenas are not supported on this platform.
+    return;
+  }
+  uint8_t* mem = storage.get();
+  Thread::threadFactoryForTest().createThread([&storage]() { storage.reset(); })->join();
+  EXPECT_EQ(0, stats_.release_.value());
+
+  SliceStoragePtr reused = SlicePool::allocate(4096);
+  EXPECT_EQ(mem, reused.get());
+  EXPECT_EQ(1, stats_.hit_.value());
+}
+
+// Arena storage may outlive the thread that carved it. The arena is freed once the storage is
+// released.
+TEST_F(SlicePoolTest, ArenaStorageOutlivesOwner) {
+  configure(0, true);
+
+  SliceStoragePtr storage;
+  Thread::threadFactoryForTest()
+      .createThread([&storage]() {
+        storage = SlicePool::allocate(8192);
+        SliceStoragePtr released = SlicePool::allocate(4096);
+      })
+      ->join();
+  ASSERT_NE(nullptr, storage);
+  memset(storage.get(), 'a', 8192);
+  storage.reset();
+  EXPECT_EQ(0, SlicePool::cachedBytesForTest());
+}
+
+TEST_F(SlicePoolTest, OwnedImplUsesPool) {
+  configure(1024 * 1024);
+
+  {
+    OwnedImpl buffer;
+    buffer.add(std::string(100, 'a'));
+    EXPECT_EQ(1, stats_.miss_.value());
+  }
+  {
+    OwnedImpl buffer;
+    buffer.add(std::string(100, 'a'));
+    EXPECT_EQ(1, stats_.hit_.value());
+    EXPECT_EQ(std::string(100, 'a'), buffer.toString());
+  }
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
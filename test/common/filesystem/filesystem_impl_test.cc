@@ -2,6 +2,7 @@
 #include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "source/common/common/assert.h"
 #include "source/common/common/cleanup.h"
@@ -353,6 +354,30 @@ TEST_F(FileSystemImplTest, PwriteWritesTheSpecifiedRange) {
   EXPECT_EQ(contents, "01BOOPS789");
 }
 
+TEST_F(FileSystemImplTest, WritevAppendsAllBuffersInOrder) {
+  const std::string file_path = TestEnvironment::writeStringToFileForTest("test_envoy", "0123");
+  {
+    FilePathAndType file_info{Filesystem::DestinationType::File, file_path};
+    FilePtr file = file_system_.createFile(file_info);
+    const Api::IoCallBoolResult open_result = file->open(FlagSet{
+        (1 << Filesystem::File::Operation::Write) | (1 << Filesystem::File::Operation::Append)});
+    EXPECT_TRUE(open_result.return_value_) << open_result.err_->getErrorDetails();
+    // More buffers than fit into a single system call on any platform.
+    std::vector<absl::string_view> buffers(2000, "ab");
+    buffers.push_back("");
+    buffers.push_back("c");
+    const Api::IoCallSizeResult write_result = file->writev(buffers);
+    EXPECT_EQ(write_result.return_value_, 4001);
+    EXPECT_THAT(write_result.err_, ::testing::IsNull());
+  }
+  std::string expected = "0123";
+  for (int i = 0; i < 2000; ++i) {
+    expected += "ab";
+  }
+  expected += "c";
+  EXPECT_EQ(TestEnvironment::readFileToStringForTest(file_path), expected);
+}
+
 TEST_F(FileSystemImplTest, StatOnDirectoryReturnsDirectoryType) {
   const std::string new_dir_path = TestEnvironment::temporaryPath("envoy_test_dir");
   TestEnvironment::createPath(new_dir_path);
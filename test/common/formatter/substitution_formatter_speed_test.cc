@@ -3,6 +3,7 @@
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "benchmark/benchmark.h"
 
@@ -151,6 +152,25 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// Measures the struct based JSON formatter, which the compiled formatters above are compared to.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StructJsonAccessLogFormatter(benchmark::State& state) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.logging_with_fast_json_formatter", "false"}});
+  std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> json_formatter =
+      makeJsonFormatter(state.range(0) != 0);
+
+  size_t output_bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += json_formatter->formatWithContext({}, *stream_info).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_StructJsonAccessLogFormatter)->Arg(0)->Arg(1);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "Listener:namespace:key";
@@ -3809,6 +3809,76 @@ TEST(SubstitutionFormatterTest, JsonFormatterWithOrderedPropertiesTest) {
   EXPECT_EQ(out_json, expected);
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterCompiledPlanTest) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header;
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  MockTimeSystem time_system;
+  EXPECT_CALL(time_system, monotonicTime)
+      .WillOnce(Return(MonotonicTime(std::chrono::nanoseconds(5000000))));
+  stream_info.downstream_timing_.onLastDownstreamRxByteReceived(time_system);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    request_duration_multi: '%REQUEST_DURATION%ms'
+    escaped: 'a"b\c'
+    header: '%REQ(X-MISSING)%'
+    number: 1.5
+    list:
+      - '%PROTOCOL%'
+      - plain
+      - 2
+  )EOF",
+                            key_mapping);
+
+  {
+    JsonFormatterImpl formatter(key_mapping, false, false, false);
+    EXPECT_EQ("{\"escaped\":\"a\\\"b\\\\c\",\"header\":\"-\","
+              "\"list\":[\"HTTP/1.1\",\"plain\",\"2\"],\"number\":\"1.5\","
+              "\"request_duration\":\"5\",\"request_duration_multi\":\"5ms\"}\n",
+              formatter.formatWithContext(formatter_context, stream_info));
+  }
+  {
+    JsonFormatterImpl formatter(key_mapping, true, false, false);
+    EXPECT_EQ("{\"escaped\":\"a\\\"b\\\\c\",\"header\":null,"
+              "\"list\":[\"HTTP/1.1\",\"plain\",2],\"number\":1.5,"
+              "\"request_duration\":5,\"request_duration_multi\":\"5ms\"}\n",
+              formatter.formatWithContext(formatter_context, stream_info));
+  }
+
+  // The compiled plan renders the same JSON as the struct based formatter.
+  for (const bool preserve_types : {false, true}) {
+    const std::string compiled = JsonFormatterImpl(key_mapping, preserve_types, false, false)
+                                     .formatWithContext(formatter_context, stream_info);
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues(
+        {{"envoy.reloadable_features.logging_with_fast_json_formatter", "false"}});
+    const std::string legacy = JsonFormatterImpl(key_mapping, preserve_types, false, false)
+                                   .formatWithContext(formatter_context, stream_info);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(compiled, legacy)) << compiled << legacy;
+  }
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterCompiledPlanUnsupportedValueTest) {
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    bool_value: true
+  )EOF",
+                            key_mapping);
+  EXPECT_THROW_WITH_MESSAGE(JsonFormatterImpl(key_mapping, false, false, false), EnvoyException,
+                            "Only string values, nested structs, list values and number values "
+                            "are supported in structured access log format.");
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
@@ -0,0 +1,76 @@
+#include <string>
+#include <vector>
+
+#include "source/common/http/character_set_validation.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+
+// A request header set of a browser with a large cookie and a bearer token.
+const std::vector<std::pair<std::string, std::string>>& realisticHeaders() {
+  static const auto* headers = [] {
+    std::string cookie;
+    while (cookie.size() < 4096) {
+      cookie += "_ga_session=GA1.2.1234567890.1234567890; ";
+    }
+    std::string jwt = "Bearer eyJhbGciOiJSUzI1NiIsInR5cCI6IkpXVCJ9.";
+    while (jwt.size() < 1024) {
+      jwt += "eyJzdWIiOiIxMjM0NTY3ODkwIiwibmFtZSI6IkpvaG4gRG9lIiwiaWF0IjoxNTE2MjM5MDIyfQ";
+    }
+    return new std::vector<std::pair<std::string, std::string>>{
+        {"host", "www.example.com"},
+        {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+                       "Chrome/116.0.0.0 Safari/537.36"},
+        {"accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"},
+        {"accept-encoding", "gzip, deflate, br"},
+        {"accept-language", "en-US,en;q=0.9"},
+        {"cookie", cookie},
+        {"authorization", jwt},
+        {"x-request-id", "8c0b5a7e-6f1d-4a9b-9d3e-2f6c7b8a9d0e"},
+    };
+  }();
+  return *headers;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ValidateHeaders(benchmark::State& state) {
+  const auto kernel = static_cast<CharacterSetKernel>(state.range(0));
+  if (!characterSetKernelSupported(kernel)) {
+    state.SkipWithError("kernel is not supported by the CPU");
+    return;
+  }
+  const auto& headers = realisticHeaders();
+  size_t bytes = 0;
+  for (const auto& header : headers) {
+    bytes += header.first.size() + header.second.size();
+  }
+  for (auto _ : state) { // NOLINT
+    bool valid = true;
+    for (const auto& header : headers) {
+      valid &= kGenericHeaderNameCharacterSet.containsAll(header.first, kernel);
+      valid &= kGenericHeaderValueCharacterSet.containsAll(header.second, kernel);
+    }
+    benchmark::DoNotOptimize(valid);
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ValidateHeaders)
+    ->Arg(static_cast<int>(CharacterSetKernel::Scalar))
+    ->Arg(static_cast<int>(CharacterSetKernel::Sse42))
+    ->Arg(static_cast<int>(CharacterSetKernel::Avx2))
+    ->Arg(static_cast<int>(CharacterSetKernel::Neon));
+
+// Short header values, which are checked one character at a time with the default dispatch.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ValidateShortHeaderValue(benchmark::State& state) {
+  const std::string value = "gzip, br";
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(kGenericHeaderValueCharacterSet.containsAll(value));
+  }
+}
+BENCHMARK(BM_ValidateShortHeaderValue);
+
+} // namespace Http
+} // namespace Envoy
@@ -1,3 +1,6 @@
+#include <random>
+#include <string>
+
 #include "source/common/http/character_set_validation.h"
 
 #include "gtest/gtest.h"
@@ -33,5 +36,89 @@ TEST(CharacterSetValidationTest, Test) {
   }
 }
 
+std::vector<CharacterSetKernel> supportedKernels() {
+  std::vector<CharacterSetKernel> kernels;
+  for (CharacterSetKernel kernel : {CharacterSetKernel::Scalar, CharacterSetKernel::Sse42,
+                                    CharacterSetKernel::Avx2, CharacterSetKernel::Neon}) {
+    if (characterSetKernelSupported(kernel)) {
+      kernels.push_back(kernel);
+    }
+  }
+  return kernels;
+}
+
+void expectNibbleTablesMatch(const CharacterSet& character_set) {
+  const CharacterSetNibbleTables& nibbles = character_set.nibbleTables();
+  ASSERT_TRUE(nibbles.representable_);
+  for (unsigned c = 0; c < 256; ++c) {
+    EXPECT_EQ(character_set.test(static_cast<char>(c)),
+              (nibbles.low_[c & 0xf] & nibbles.high_[c >> 4]) != 0)
+        << c;
+  }
+}
+
+TEST(CharacterSetValidationTest, NibbleTables) {
+  expectNibbleTablesMatch(kGenericHeaderNameCharacterSet);
+  expectNibbleTablesMatch(kGenericHeaderValueCharacterSet);
+  expectNibbleTablesMatch(CharacterSet(kUriQueryAndFragmentCharTable));
+}
+
+TEST(CharacterSetValidationTest, KernelsMatchScalar) {
+  const std::vector<CharacterSetKernel> kernels = supportedKernels();
+  EXPECT_TRUE(characterSetKernelSupported(bestCharacterSetKernel()));
+  std::mt19937 random(42);
+
+  for (const CharacterSet* character_set :
+       {&kGenericHeaderNameCharacterSet, &kGenericHeaderValueCharacterSet}) {
+    // Cover the vector loops as well as the remainders of every length.
+    for (size_t length = 0; length < 100; ++length) {
+      std::string str(length, '\0');
+      for (char& c : str) {
+        do {
+          c = static_cast<char>(random());
+        } while (!character_set->test(c));
+      }
+      for (const CharacterSetKernel kernel : kernels) {
+        EXPECT_TRUE(character_set->containsAll(str, kernel)) << length;
+      }
+      EXPECT_TRUE(character_set->containsAll(str));
+
+      // Each invalid character at each position is found.
+      for (size_t position = 0; position < length; ++position) {
+        for (unsigned invalid = 0; invalid < 256; ++invalid) {
+          if (character_set->test(static_cast<char>(invalid))) {
+            continue;
+          }
+          std::string invalid_str = str;
+          invalid_str[position] = static_cast<char>(invalid);
+          for (const CharacterSetKernel kernel : kernels) {
+            ASSERT_FALSE(character_set->containsAll(invalid_str, kernel))
+                << static_cast<int>(kernel) << " " << length << " " << position << " " << invalid;
+          }
+          ASSERT_FALSE(character_set->containsAll(invalid_str));
+        }
+      }
+    }
+  }
+}
+
+TEST(CharacterSetValidationTest, NotRepresentableTableUsesScalar) {
+  // Each of the 16 rows has a distinct pattern, which needs more than 8 bits of nibble tables.
+  std::array<uint32_t, 8> table{};
+  for (unsigned c = 0; c < 256; c += 0x11) {
+    table[c >> 5] |= 0x80000000 >> (c & 0x1f);
+  }
+  const CharacterSet character_set(table);
+  EXPECT_FALSE(character_set.nibbleTables().representable_);
+
+  const std::string valid(64, static_cast<char>(0x33));
+  std::string invalid = valid;
+  invalid[40] = 0x34;
+  for (const CharacterSetKernel kernel : supportedKernels()) {
+    EXPECT_TRUE(character_set.containsAll(valid, kernel));
+    EXPECT_FALSE(character_set.containsAll(invalid, kernel));
+  }
+}
+
 } // namespace Http
 } // namespace Envoy
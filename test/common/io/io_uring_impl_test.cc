@@ -64,6 +64,9 @@ INSTANTIATE_TEST_SUITE_P(InvalidPrepareMethodParamsTest, IoUringImplParamTest,
                              [](IoUring& uring, os_fd_t fd) -> IoUringResult {
                                return uring.prepareAccept(fd, nullptr, nullptr, nullptr);
                              },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareMultishotAccept(fd, nullptr);
+                             },
                              [](IoUring& uring, os_fd_t fd) -> IoUringResult {
                                auto address =
                                    std::make_shared<Network::Address::EnvoyInternalInstance>(
@@ -73,6 +76,9 @@ INSTANTIATE_TEST_SUITE_P(InvalidPrepareMethodParamsTest, IoUringImplParamTest,
                              [](IoUring& uring, os_fd_t fd) -> IoUringResult {
                                return uring.prepareReadv(fd, nullptr, 0, 0, nullptr);
                              },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareReadFixed(fd, nullptr, 0, 0, 0, nullptr);
+                             },
                              [](IoUring& uring, os_fd_t fd) -> IoUringResult {
                                return uring.prepareWritev(fd, nullptr, 0, 0, nullptr);
                              },
@@ -91,7 +97,7 @@ TEST_P(IoUringImplParamTest, InvalidParams) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, uint32_t, bool) {
           EXPECT_TRUE(res < 0);
           completions_nr++;
         });
@@ -128,7 +134,7 @@ TEST_F(IoUringImplTest, InjectCompletion) {
       event_fd,
       [this, &completions_nr](uint32_t) {
         io_uring_->forEveryCompletion(
-            [&completions_nr](Request* user_data, int32_t res, bool injected) {
+            [&completions_nr](Request* user_data, int32_t res, uint32_t, bool injected) {
               EXPECT_TRUE(injected);
               EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
               EXPECT_EQ(-11, res);
@@ -161,8 +167,9 @@ TEST_F(IoUringImplTest, NestInjectCompletion) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &fd2, &completions_nr, &request2](uint32_t) {
-        io_uring_->forEveryCompletion([this, &fd2, &completions_nr,
-                                       &request2](Request* user_data, int32_t res, bool injected) {
+        io_uring_->forEveryCompletion([this, &fd2, &completions_nr, &request2](
+                                          Request* user_data, int32_t res, uint32_t,
+                                          bool injected) {
           EXPECT_TRUE(injected);
           if (completions_nr == 0) {
             EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
@@ -203,7 +210,7 @@ TEST_F(IoUringImplTest, RemoveInjectCompletion) {
       event_fd,
       [this, &completions_nr](uint32_t) {
         io_uring_->forEveryCompletion(
-            [&completions_nr](Request* user_data, int32_t res, bool injected) {
+            [&completions_nr](Request* user_data, int32_t res, uint32_t, bool injected) {
               EXPECT_TRUE(injected);
               EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
               EXPECT_EQ(-11, res);
@@ -239,7 +246,8 @@ TEST_F(IoUringImplTest, NestRemoveInjectCompletion) {
       event_fd,
       [this, &fd2, &completions_nr, &data2](uint32_t) {
         io_uring_->forEveryCompletion(
-            [this, &fd2, &completions_nr, &data2](Request* user_data, int32_t res, bool injected) {
+            [this, &fd2, &completions_nr, &data2](Request* user_data, int32_t res, uint32_t,
+                                                  bool injected) {
               EXPECT_TRUE(injected);
               if (completions_nr == 0) {
                 EXPECT_EQ(1, dynamic_cast<TestRequest*>(user_data)->data_);
@@ -291,7 +299,7 @@ TEST_F(IoUringImplTest, PrepareReadvAllDataFitsOneChunk) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr, d = dispatcher.get()](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, bool) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, uint32_t, bool) {
           completions_nr++;
           EXPECT_EQ(res, strlen("test text"));
         });
@@ -311,6 +319,46 @@ TEST_F(IoUringImplTest, PrepareReadvAllDataFitsOneChunk) {
   EXPECT_STREQ(static_cast<char*>(iov.iov_base), "test text");
 }
 
+TEST_F(IoUringImplTest, PrepareReadFixedIntoRegisteredBuffer) {
+  std::string test_file =
+      TestEnvironment::writeStringToFileForTest("prepare_read_fixed", "test text", true);
+  os_fd_t fd = open(test_file.c_str(), O_RDONLY);
+  ASSERT_TRUE(fd >= 0);
+
+  auto dispatcher = api_->allocateDispatcher("test_thread");
+
+  uint8_t buffer[4096]{};
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = 4096;
+  if (io_uring_->registerBuffers(&iov, 1) != IoUringResult::Ok) {
+    GTEST_SKIP() << "registered buffers are not supported";
+  }
+
+  os_fd_t event_fd = io_uring_->registerEventfd();
+
+  const Event::FileTriggerType trigger = Event::PlatformDefaultTriggerType;
+  int32_t completions_nr = 0;
+  auto file_event = dispatcher->createFileEvent(
+      event_fd,
+      [this, &completions_nr, d = dispatcher.get()](uint32_t) {
+        io_uring_->forEveryCompletion([&completions_nr](Request*, int32_t res, uint32_t, bool) {
+          completions_nr++;
+          EXPECT_EQ(res, strlen("test text"));
+        });
+        d->exit();
+      },
+      trigger, Event::FileReadyType::Read);
+
+  EXPECT_EQ(io_uring_->prepareReadFixed(fd, buffer, 4096, 0, 0, nullptr), IoUringResult::Ok);
+  io_uring_->submit();
+
+  dispatcher->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(completions_nr, 1);
+  EXPECT_STREQ(reinterpret_cast<char*>(buffer), "test text");
+}
+
 TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   std::string test_file =
       TestEnvironment::writeStringToFileForTest("prepare_readv_overflow", "abcdefhg", true);
@@ -338,7 +386,8 @@ TEST_F(IoUringImplTest, PrepareReadvQueueOverflow) {
   auto file_event = dispatcher->createFileEvent(
       event_fd,
       [this, &completions_nr](uint32_t) {
-        io_uring_->forEveryCompletion([&completions_nr](Request* user_data, int32_t res, bool) {
+        io_uring_->forEveryCompletion([&completions_nr](Request* user_data, int32_t res, uint32_t,
+                                                        bool) {
           EXPECT_TRUE(user_data != nullptr);
           EXPECT_EQ(res, 2);
           completions_nr++;
@@ -3,6 +3,7 @@
 #include <queue>
 
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
 
@@ -15,9 +16,11 @@ namespace Envoy {
 namespace Io {
 namespace {
 
-class IoUringSocketTestImpl : public IoUringSocketEntry {
+// Records the completions instead of handling them like a server socket.
+class IoUringSocketTestImpl : public IoUringServerSocket {
 public:
-  IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent) : IoUringSocketEntry(fd, parent) {}
+  IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent)
+      : IoUringServerSocket(fd, parent, nullptr) {}
 
   void onAccept(Request* req, int32_t result, bool injected) override {
     IoUringSocketEntry::onAccept(req, result, injected);
@@ -83,8 +86,9 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, const IoUringWorkerOptions& options,
+                        Event::Dispatcher& dispatcher)
+      : IoUringWorkerImpl(std::move(io_uring_instance), options, dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -103,11 +107,11 @@ protected:
     }
   }
 
-  void initialize() {
+  void initialize(const IoUringWorkerOptions& options = {}) {
     api_ = Api::createApiForTest(time_system_);
     dispatcher_ = api_->allocateDispatcher("test_thread");
     io_uring_worker_ = std::make_unique<IoUringWorkerTestImpl>(
-        std::make_unique<IoUringImpl>(20, false), *dispatcher_);
+        std::make_unique<IoUringImpl>(20, false), options, *dispatcher_);
   }
 
   void createServerListenerAndClientSocket() {
@@ -268,6 +272,279 @@ TEST_F(IoUringWorkerIntegrationTest, MergeInjection) {
   socket.cleanupForTest();
 }
 
+TEST_F(IoUringWorkerIntegrationTest, AcceptSocket) {
+  initialize();
+  socket(true, true);
+  listen();
+
+  uint32_t events = 0;
+  auto& accept_socket = io_uring_worker_->addAcceptSocket(
+      listen_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  accept_socket.enableFileEvents(Event::FileReadyType::Read);
+  connect();
+  while (events == 0) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(Event::FileReadyType::Read, events);
+
+  sockaddr_storage remote_addr;
+  socklen_t remote_addr_len = sizeof(remote_addr);
+  server_socket_ =
+      accept_socket.accept(reinterpret_cast<struct sockaddr*>(&remote_addr), &remote_addr_len);
+  EXPECT_TRUE(SOCKET_VALID(server_socket_));
+  EXPECT_EQ(AF_INET, remote_addr.ss_family);
+  EXPECT_EQ(sizeof(sockaddr_in), remote_addr_len);
+  // Accepted sockets are non-blocking.
+  EXPECT_TRUE(fcntl(server_socket_, F_GETFL) & O_NONBLOCK);
+  EXPECT_EQ(INVALID_SOCKET, accept_socket.accept(nullptr, nullptr));
+
+  // Closing cancels the pending accept request before the fd is closed.
+  accept_socket.close();
+  runToClose(listen_socket_);
+  EXPECT_EQ(0, io_uring_worker_->getNumOfSockets());
+  listen_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, AcceptSocketMultipleConnections) {
+  IoUringWorkerOptions options;
+  options.multishot_accept_ = true;
+  initialize(options);
+  socket(true, true);
+  listen();
+
+  uint32_t events = 0;
+  auto& accept_socket = io_uring_worker_->addAcceptSocket(
+      listen_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  accept_socket.enableFileEvents(Event::FileReadyType::Read);
+
+  // Every connection is accepted, whether by a multishot request or by single requests on kernels
+  // which do not support multishot accepts.
+  std::vector<os_fd_t> accepted;
+  for (int i = 0; i < 3; i++) {
+    os_fd_t client = Api::OsSysCallsSingleton::get()
+                         .socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP)
+                         .return_value_;
+    struct sockaddr_in listen_addr = getListenSocketAddress();
+    Api::OsSysCallsSingleton::get().connect(
+        client, reinterpret_cast<struct sockaddr*>(&listen_addr), sizeof(listen_addr));
+    os_fd_t fd = INVALID_SOCKET;
+    while (!SOCKET_VALID(fd)) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      sockaddr_storage remote_addr;
+      socklen_t remote_addr_len = sizeof(remote_addr);
+      fd = accept_socket.accept(reinterpret_cast<struct sockaddr*>(&remote_addr),
+                                &remote_addr_len);
+      if (SOCKET_VALID(fd)) {
+        // The remote address is also reported for connections of multishot accepts.
+        EXPECT_EQ(AF_INET, remote_addr.ss_family);
+        EXPECT_EQ(sizeof(sockaddr_in), remote_addr_len);
+      }
+    }
+    accepted.push_back(fd);
+    Api::OsSysCallsSingleton::get().close(client);
+  }
+  EXPECT_EQ(Event::FileReadyType::Read, events);
+
+  accept_socket.close();
+  runToClose(listen_socket_);
+  EXPECT_EQ(0, io_uring_worker_->getNumOfSockets());
+  listen_socket_ = INVALID_SOCKET;
+  for (os_fd_t fd : accepted) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, AcceptSocketSingleAcceptRequests) {
+  IoUringWorkerOptions options;
+  options.multishot_accept_ = false;
+  initialize(options);
+  socket(true, true);
+  listen();
+
+  uint32_t events = 0;
+  auto& accept_socket = io_uring_worker_->addAcceptSocket(
+      listen_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  accept_socket.enableFileEvents(Event::FileReadyType::Read);
+  connect();
+  while (events == 0) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  sockaddr_storage remote_addr;
+  socklen_t remote_addr_len = sizeof(remote_addr);
+  server_socket_ =
+      accept_socket.accept(reinterpret_cast<struct sockaddr*>(&remote_addr), &remote_addr_len);
+  EXPECT_TRUE(SOCKET_VALID(server_socket_));
+  EXPECT_EQ(AF_INET, remote_addr.ss_family);
+
+  // The data operations of a listening socket fail instead of crashing.
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(ENOTCONN, accept_socket.read(buffer, UINT64_MAX).err_->getSystemErrorCode());
+
+  accept_socket.close();
+  runToClose(listen_socket_);
+  listen_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, ClientSocketConnect) {
+  initialize();
+  socket(true, true);
+  listen();
+
+  uint32_t events = 0;
+  auto& client_socket = io_uring_worker_->addClientSocket(
+      client_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  client_socket.enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  // The socket is not writable before it is connected.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, events);
+
+  struct sockaddr_in listen_addr = getListenSocketAddress();
+  client_socket.connect(std::make_shared<Network::Address::Ipv4Instance>(&listen_addr));
+  while (!(events & Event::FileReadyType::Write)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(0, client_socket.connectError());
+  accept();
+
+  // Reading starts once the socket is connected.
+  const std::string data = "hello";
+  EXPECT_EQ(static_cast<ssize_t>(data.size()), ::send(server_socket_, data.data(), data.size(), 0));
+  while (!(events & Event::FileReadyType::Read)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(data.size(), client_socket.read(buffer, UINT64_MAX).return_value_);
+  EXPECT_EQ(data, buffer.toString());
+
+  client_socket.close();
+  runToClose(client_socket_);
+  client_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, ServerSocketReadWrite) {
+  initialize();
+  createServerListenerAndClientSocket();
+
+  uint32_t events = 0;
+  auto& server_socket = io_uring_worker_->addServerSocket(
+      server_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  server_socket.enableFileEvents(Event::FileReadyType::Read);
+
+  const std::string data = "hello";
+  EXPECT_EQ(static_cast<ssize_t>(data.size()), ::send(client_socket_, data.data(), data.size(), 0));
+  while (!(events & Event::FileReadyType::Read)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(2, server_socket.read(buffer, 2).return_value_);
+  EXPECT_EQ(3, server_socket.read(buffer, UINT64_MAX).return_value_);
+  EXPECT_EQ(data, buffer.toString());
+  EXPECT_TRUE(server_socket.read(buffer, UINT64_MAX).wouldBlock());
+
+  Buffer::OwnedImpl write_buffer(data);
+  EXPECT_EQ(data.size(), server_socket.write(write_buffer).return_value_);
+  EXPECT_EQ(0, write_buffer.length());
+  std::string received;
+  while (received.size() < data.size()) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    char buf[16];
+    const ssize_t rc = ::recv(client_socket_, buf, sizeof(buf), 0);
+    if (rc > 0) {
+      received.append(buf, rc);
+    }
+  }
+  EXPECT_EQ(data, received);
+
+  // The end of stream is delivered as a read of 0 bytes.
+  events = 0;
+  ::shutdown(client_socket_, SHUT_WR);
+  while (!(events & Event::FileReadyType::Read)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  auto result = server_socket.read(buffer, UINT64_MAX);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.return_value_);
+
+  server_socket.close();
+  runToClose(server_socket_);
+  server_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, ServerSocketReadIntoPoolBuffers) {
+  IoUringWorkerOptions options;
+  options.read_buffer_pool_size_ = 1;
+  // Reads use unregistered buffers if the registration fails, e.g. due to the memlock limit.
+  options.register_read_buffers_ = true;
+  initialize(options);
+  createServerListenerAndClientSocket();
+
+  uint32_t events = 0;
+  auto& server_socket = io_uring_worker_->addServerSocket(
+      server_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  server_socket.enableFileEvents(Event::FileReadyType::Read);
+
+  // The data keeps referring to the only buffer of the pool until it is drained, so the next read
+  // falls back to a buffer of its own.
+  Buffer::OwnedImpl buffer;
+  for (const std::string data : {"hello", "world"}) {
+    events = 0;
+    EXPECT_EQ(static_cast<ssize_t>(data.size()),
+              ::send(client_socket_, data.data(), data.size(), 0));
+    while (!(events & Event::FileReadyType::Read)) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+    EXPECT_EQ(data.size(), server_socket.read(buffer, UINT64_MAX).return_value_);
+  }
+  EXPECT_EQ("helloworld", buffer.toString());
+
+  server_socket.close();
+  runToClose(server_socket_);
+  server_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
+TEST_F(IoUringWorkerIntegrationTest, ServerSocketPeek) {
+  initialize();
+  createServerListenerAndClientSocket();
+
+  uint32_t events = 0;
+  auto& server_socket = io_uring_worker_->addServerSocket(
+      server_socket_, [&events](uint32_t ready_events) { events |= ready_events; });
+  server_socket.enableFileEvents(Event::FileReadyType::Read);
+
+  EXPECT_EQ(2, ::send(client_socket_, "he", 2, 0));
+  while (!(events & Event::FileReadyType::Read)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  char buf[5];
+  EXPECT_EQ(2, server_socket.recv(buf, sizeof(buf), MSG_PEEK).return_value_);
+  EXPECT_EQ("he", absl::string_view(buf, 2));
+
+  // Peeking at less data than requested keeps reading ahead, although the data is not consumed.
+  events = 0;
+  EXPECT_EQ(3, ::send(client_socket_, "llo", 3, 0));
+  while (!(events & Event::FileReadyType::Read)) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(5, server_socket.recv(buf, sizeof(buf), MSG_PEEK).return_value_);
+  EXPECT_EQ("hello", absl::string_view(buf, 5));
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, server_socket.read(buffer, UINT64_MAX).return_value_);
+  EXPECT_EQ("hello", buffer.toString());
+
+  server_socket.close();
+  runToClose(server_socket_);
+  server_socket_ = INVALID_SOCKET;
+  cleanup();
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
@@ -10,6 +10,7 @@
 using testing::DoAll;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 using testing::ReturnNew;
 using testing::SaveArg;
 
@@ -17,9 +18,10 @@ namespace Envoy {
 namespace Io {
 namespace {
 
-class IoUringSocketTestImpl : public IoUringSocketEntry {
+class IoUringSocketTestImpl : public IoUringServerSocket {
 public:
-  IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent) : IoUringSocketEntry(fd, parent) {}
+  IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent)
+      : IoUringServerSocket(fd, parent, nullptr) {}
   void cleanupForTest() { cleanup(); }
 };
 
@@ -27,6 +29,9 @@ class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
   IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
       : IoUringWorkerImpl(std::move(io_uring_instance), dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, const IoUringWorkerOptions& options,
+                        Event::Dispatcher& dispatcher)
+      : IoUringWorkerImpl(std::move(io_uring_instance), options, dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -93,6 +98,133 @@ TEST(IoUringWorkerImplTest, DelaySubmit) {
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
 }
 
+TEST(ReadBufferPoolTest, AcquireAndRelease) {
+  ReadBufferPool pool(2, 16);
+  EXPECT_EQ(16, pool.bufferSize());
+  EXPECT_EQ(pool.buffer(0) + 16, pool.buffer(1));
+
+  const std::vector<struct iovec> iovecs = pool.iovecs();
+  ASSERT_EQ(2, iovecs.size());
+  EXPECT_EQ(pool.buffer(1), iovecs[1].iov_base);
+  EXPECT_EQ(16, iovecs[1].iov_len);
+
+  EXPECT_EQ(0, pool.acquire());
+  EXPECT_EQ(1, pool.acquire());
+  EXPECT_EQ(absl::nullopt, pool.acquire());
+  pool.release(1);
+  EXPECT_EQ(1, pool.acquire());
+}
+
+TEST(IoUringWorkerImplTest, ReadIntoRegisteredPoolBuffers) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  EXPECT_CALL(mock_io_uring, registerBuffers(_, 1)).WillOnce(Return(IoUringResult::Ok));
+  IoUringWorkerOptions options;
+  options.read_buffer_pool_size_ = 1;
+  options.register_read_buffers_ = true;
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), options, dispatcher);
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+  uint32_t events = 0;
+  auto& socket =
+      worker.addServerSocket(fd, [&events](uint32_t ready_events) { events |= ready_events; });
+
+  // The read uses the registered buffer of the pool.
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadFixed(fd, _, IoUringWorkerOptions::DefaultReadBufferSize,
+                                              0, 0, _))
+      .WillOnce(DoAll(SaveArg<5>(&read_req), Return(IoUringResult::Ok)));
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher);
+  socket.enableFileEvents(Event::FileReadyType::Read);
+  ASSERT_NE(nullptr, read_req);
+
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_)).WillOnce(Invoke([&read_req](CompletionCb cb) {
+    memcpy(static_cast<ReadRequest*>(read_req)->iov_.iov_base, "hello", 5);
+    cb(read_req, 5, 0, false);
+  }));
+  EXPECT_CALL(mock_io_uring, submit());
+  file_event_callback(Event::FileReadyType::Read);
+  EXPECT_EQ(Event::FileReadyType::Read, events);
+
+  // The data which was read still refers to the buffer of the pool, so the next read falls back
+  // to a buffer of its own.
+  Request* fallback_read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(fd, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&fallback_read_req), Return(IoUringResult::Ok)));
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, socket.read(buffer, UINT64_MAX).return_value_);
+  EXPECT_EQ("hello", buffer.toString());
+  ASSERT_NE(nullptr, fallback_read_req);
+  buffer.drain(buffer.length());
+
+  // The end of stream completes the last read request.
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(
+          Invoke([&fallback_read_req](CompletionCb cb) { cb(fallback_read_req, 0, 0, false); }));
+  EXPECT_CALL(mock_io_uring, submit());
+  file_event_callback(Event::FileReadyType::Read);
+  EXPECT_EQ(0, socket.read(buffer, UINT64_MAX).return_value_);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
+TEST(IoUringWorkerImplTest, MultishotAcceptFallsBackToSingleRequests) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher);
+  EXPECT_TRUE(worker.multishotAccept());
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+  auto& socket = worker.addAcceptSocket(fd, [](uint32_t) {});
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareMultishotAccept(fd, _))
+      .WillOnce(DoAll(SaveArg<1>(&accept_req), Return(IoUringResult::Ok)));
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher);
+  socket.enableFileEvents(Event::FileReadyType::Read);
+  ASSERT_NE(nullptr, accept_req);
+
+  // The kernel rejects multishot accepts, so the socket keeps accepting with single requests.
+  Request* single_accept_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareAccept(fd, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&single_accept_req), Return(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_)).WillOnce(Invoke([&accept_req](CompletionCb cb) {
+    cb(accept_req, -EINVAL, 0, false);
+  }));
+  EXPECT_CALL(mock_io_uring, submit());
+  file_event_callback(Event::FileReadyType::Read);
+  EXPECT_FALSE(worker.multishotAccept());
+  ASSERT_NE(nullptr, single_accept_req);
+
+  // Disabling the socket leaves the pending request, which is completed here to release it.
+  socket.enableFileEvents(0);
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke(
+          [&single_accept_req](CompletionCb cb) { cb(single_accept_req, -ECANCELED, 0, false); }));
+  EXPECT_CALL(mock_io_uring, submit());
+  file_event_callback(Event::FileReadyType::Read);
+
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
@@ -556,6 +556,29 @@ TEST(NetworkUtility, LoopbackAddress) {
   EXPECT_EQ("[::1]:0", Utility::getIpv6LoopbackAddress()->asString());
 }
 
+TEST(NetworkUtility, GetAddressWithSocketInterface) {
+  MockSocketInterface sock_interface({Address::IpVersion::v4, Address::IpVersion::v6});
+  {
+    auto address = Utility::parseInternetAddressAndPort("10.0.0.1:80");
+    auto updated = Utility::getAddressWithSocketInterface(address, sock_interface);
+    EXPECT_EQ(&sock_interface, &updated->socketInterface());
+    EXPECT_EQ(*address, *updated);
+    // Addresses which already use the socket interface are not copied.
+    EXPECT_EQ(updated, Utility::getAddressWithSocketInterface(updated, sock_interface));
+  }
+  {
+    auto address = Utility::parseInternetAddressAndPort("[::1]:80", false);
+    auto updated = Utility::getAddressWithSocketInterface(address, sock_interface);
+    EXPECT_EQ(&sock_interface, &updated->socketInterface());
+    EXPECT_EQ(*address, *updated);
+    EXPECT_FALSE(updated->ip()->ipv6()->v6only());
+  }
+  {
+    Address::InstanceConstSharedPtr address = std::make_shared<Address::PipeInstance>("/foo");
+    EXPECT_EQ(address, Utility::getAddressWithSocketInterface(address, sock_interface));
+  }
+}
+
 TEST(NetworkUtility, AnyAddress) {
   {
     Address::InstanceConstSharedPtr any = Utility::getIpv4AnyAddress();
@@ -39,9 +39,11 @@ static Http::TestRequestHeaderMapImpl genRequestHeaders(int route_num) {
  * Generates the route config for the type of matcher being tested.
  */
 static RouteConfiguration genRouteConfig(benchmark::State& state,
-                                         RouteMatch::PathSpecifierCase match_type) {
+                                         RouteMatch::PathSpecifierCase match_type,
+                                         bool compile_route_matchers) {
   // Create the base route config.
   RouteConfiguration route_config;
+  route_config.set_compile_route_matchers(compile_route_matchers);
   VirtualHost* v_host = route_config.add_virtual_hosts();
   v_host->set_name("default");
   v_host->add_domains("*");
@@ -59,7 +61,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -85,7 +87,8 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             bool compile_route_matchers = false) {
   // Setup router for benchmarking.
   Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
@@ -93,7 +96,8 @@ static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierC
   ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
 
   // Create router config.
-  ConfigImpl config(genRouteConfig(state, match_type), OptionalHttpFilters(), factory_context,
+  ConfigImpl config(genRouteConfig(state, match_type, compile_route_matchers),
+                    OptionalHttpFilters(), factory_context,
                     ProtobufMessage::getNullValidationVisitor(), true);
 
   for (auto _ : state) { // NOLINT
@@ -136,9 +140,46 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
-BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
-BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
-BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+/**
+ * Same as the benchmarks above, with compile_route_matchers enabled so that only the routes whose
+ * path specifier can match the request are evaluated.
+ */
+static void bmCompiledRouteTableSizeWithPathPrefixMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, true);
+}
+
+static void bmCompiledRouteTableSizeWithExactPathMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath, true);
+}
+
+static void bmCompiledRouteTableSizeWithRegexMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex, true);
+}
+
+BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmRouteTableSizeWithExactPathMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmRouteTableSizeWithRegexMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmCompiledRouteTableSizeWithPathPrefixMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmCompiledRouteTableSizeWithExactPathMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
+BENCHMARK(bmCompiledRouteTableSizeWithRegexMatch)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 2 << 13}})
+    ->Arg(10000);
 
 } // namespace
 } // namespace Router
@@ -2303,6 +2303,76 @@ virtual_hosts:
   }
 }
 
+// Tests that compiled route matchers keep first-match semantics across all path specifiers and
+// still evaluate the non-path match criteria of every candidate route.
+TEST_F(RouteMatcherTest, CompiledRouteMatchers) {
+  const std::string yaml = R"EOF(
+compile_route_matchers: true
+ignore_path_parameters_in_path_matching: true
+virtual_hosts:
+- name: local_service
+  domains: ["*"]
+  routes:
+  - match:
+      prefix: "/api"
+      headers:
+      - name: x-canary
+        string_match:
+          exact: "true"
+    name: "canary"
+    route:
+      cluster: canary
+  - match:
+      path: "/api/users"
+    name: "exact"
+    route:
+      cluster: exact
+  - match:
+      safe_regex:
+        regex: "/api/users/[0-9]+"
+    name: "regex"
+    route:
+      cluster: regex
+  - match:
+      prefix: "/API/"
+      case_sensitive: false
+    name: "prefix"
+    route:
+      cluster: prefix
+  - match:
+      path_separated_prefix: "/static"
+    name: "path-separated-prefix"
+    route:
+      cluster: prefix
+  - match:
+      prefix: "/"
+    name: "catchall"
+    route:
+      cluster: catchall
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "exact", "regex", "prefix", "catchall"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  EXPECT_EQ("exact", config.route(genHeaders("www.lyft.com", "/api/users", "GET"), 0)->routeName());
+  EXPECT_EQ("exact",
+            config.route(genHeaders("www.lyft.com", "/api/users;v=1?a=b", "GET"), 0)->routeName());
+  EXPECT_EQ("regex",
+            config.route(genHeaders("www.lyft.com", "/api/users/12", "GET"), 0)->routeName());
+  EXPECT_EQ("prefix",
+            config.route(genHeaders("www.lyft.com", "/api/users/x", "GET"), 0)->routeName());
+  EXPECT_EQ("path-separated-prefix",
+            config.route(genHeaders("www.lyft.com", "/static/a", "GET"), 0)->routeName());
+  EXPECT_EQ("catchall",
+            config.route(genHeaders("www.lyft.com", "/staticfoo", "GET"), 0)->routeName());
+  EXPECT_EQ("catchall", config.route(genHeaders("www.lyft.com", "/other", "GET"), 0)->routeName());
+
+  Http::TestRequestHeaderMapImpl canary_headers = genHeaders("www.lyft.com", "/api/users", "GET");
+  canary_headers.addCopy("x-canary", "true");
+  EXPECT_EQ("canary", config.route(canary_headers, 0)->routeName());
+}
+
 // Tests that when 'ignore_port_in_host_matching' is true, port from host header
 // is ignored in host matching.
 TEST_F(RouteMatcherTest, IgnorePortInHostMatching) {
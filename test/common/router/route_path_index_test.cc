@@ -0,0 +1,110 @@
+#include "source/common/router/route_path_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+std::vector<uint32_t> candidates(const RoutePathIndex& index, absl::string_view path) {
+  RoutePathIndex::Candidates candidates;
+  index.candidates(path, candidates);
+  return {candidates.begin(), candidates.end()};
+}
+
+TEST(RoutePathIndexTest, Empty) {
+  RoutePathIndex index;
+  index.compile();
+  EXPECT_EQ(0, index.size());
+  EXPECT_THAT(candidates(index, "/foo"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, Prefix) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Prefix, "/foo/bar", true);
+  index.addRoute(PathMatchType::Prefix, "/foo", true);
+  index.addRoute(PathMatchType::Prefix, "/baz", true);
+  index.addRoute(PathMatchType::Prefix, "/", true);
+  index.addRoute(PathMatchType::Prefix, "", true);
+  index.compile();
+
+  EXPECT_EQ(5, index.size());
+  EXPECT_THAT(candidates(index, "/foo/bar/baz"), ElementsAre(0, 1, 3, 4));
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(1, 3, 4));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(3, 4));
+  EXPECT_THAT(candidates(index, "/bazz"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(candidates(index, ""), ElementsAre(4));
+}
+
+TEST(RoutePathIndexTest, PrefixIgnoreCase) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Prefix, "/Foo", false);
+  index.addRoute(PathMatchType::Prefix, "/foo", true);
+  index.addRoute(PathMatchType::PathSeparatedPrefix, "/foo/Bar", false);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo/bar"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/FOO/BAR"), ElementsAre(0, 2));
+  EXPECT_THAT(candidates(index, "/fo"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, Exact) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Exact, "/foo", true);
+  index.addRoute(PathMatchType::Exact, "/Foo", false);
+  index.addRoute(PathMatchType::Exact, "/foo", true);
+  index.addRoute(PathMatchType::Exact, "/bar", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/foo/"), IsEmpty());
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(3));
+}
+
+TEST(RoutePathIndexTest, Regex) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Regex, "/shelves/[^/]+/route_1", true);
+  index.addRoute(PathMatchType::Regex, "/shelves/.*", true);
+  index.addRoute(PathMatchType::Regex, "/books/[0-9]+", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/shelves/a/route_1"), ElementsAre(0, 1));
+  // Regexes must match the full path.
+  EXPECT_THAT(candidates(index, "/shelves/a/route_10"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/books/12"), ElementsAre(2));
+  EXPECT_THAT(candidates(index, "/books/12/"), IsEmpty());
+}
+
+TEST(RoutePathIndexTest, AlwaysCandidates) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Exact, "/foo", true);
+  index.addRoute(PathMatchType::None, "", true);
+  index.addRoute(PathMatchType::Template, "/{foo}", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(1, 2));
+}
+
+TEST(RoutePathIndexTest, MixedOrder) {
+  RoutePathIndex index;
+  index.addRoute(PathMatchType::Regex, "/api/v[0-9]/users", true);
+  index.addRoute(PathMatchType::Prefix, "/api/v1", true);
+  index.addRoute(PathMatchType::Exact, "/api/v1/users", true);
+  index.addRoute(PathMatchType::None, "", true);
+  index.addRoute(PathMatchType::Prefix, "/", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/api/v1/users"), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(candidates(index, "/api/v2/users"), ElementsAre(0, 3, 4));
+  EXPECT_THAT(candidates(index, "/other"), ElementsAre(3, 4));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
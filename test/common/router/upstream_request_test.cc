@@ -5,6 +5,7 @@
 
 #include "test/common/http/common.h"
 #include "test/mocks/router/router_filter_interface.h"
+#include "test/mocks/upstream/host.h"
 #include "test/test_common/test_runtime.h"
 
 #include "gmock/gmock.h"
@@ -79,6 +80,56 @@ TEST_F(UpstreamRequestTest, TestAccessors) {
   upstream_request_->decodeHeaders(std::move(response_headers), false);
 }
 
+// The load balancing policy of the host is told the time from sending the request to receiving the
+// response headers.
+TEST_F(UpstreamRequestTest, ReportsRttToLbPolicy) {
+  initialize();
+  auto host = std::make_shared<NiceMock<Upstream::MockHostDescription>>();
+  NiceMock<Upstream::MockHostLbPolicyData> lb_policy_data;
+  ON_CALL(*host, lbPolicyData())
+      .WillByDefault(Return(makeOptRef<Upstream::HostLbPolicyData>(lb_policy_data)));
+  upstream_request_->upstreamHost() = host;
+
+  Event::MockDispatcher& dispatcher = router_filter_interface_.callbacks_.dispatcher_;
+  upstream_request_->streamInfo().upstreamInfo()->upstreamTiming().onFirstUpstreamTxByteSent(
+      dispatcher.timeSource());
+  dispatcher.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(5));
+
+  auto response_headers = std::make_unique<Http::TestResponseHeaderMapImpl>(
+      Http::TestResponseHeaderMapImpl({{":status", "200"}}));
+  EXPECT_CALL(lb_policy_data, onRequestRtt(std::chrono::microseconds(5000)));
+  EXPECT_CALL(router_filter_interface_, onUpstreamHeaders(_, _, _, _));
+  upstream_request_->decodeHeaders(std::move(response_headers), false);
+}
+
+// The load balancing policy of the host is told how long a request was outstanding when it was
+// reset, or ended otherwise, e.g. timed out, before the response headers were received.
+TEST_F(UpstreamRequestTest, ReportsFailureToLbPolicy) {
+  auto host = std::make_shared<NiceMock<Upstream::MockHostDescription>>();
+  NiceMock<Upstream::MockHostLbPolicyData> lb_policy_data;
+  ON_CALL(*host, lbPolicyData())
+      .WillByDefault(Return(makeOptRef<Upstream::HostLbPolicyData>(lb_policy_data)));
+  Event::MockDispatcher& dispatcher = router_filter_interface_.callbacks_.dispatcher_;
+
+  initialize();
+  upstream_request_->upstreamHost() = host;
+  upstream_request_->streamInfo().upstreamInfo()->upstreamTiming().onFirstUpstreamTxByteSent(
+      dispatcher.timeSource());
+  dispatcher.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(5));
+  EXPECT_CALL(lb_policy_data, onRequestFailure(std::chrono::microseconds(5000)));
+  upstream_request_->onResetStream(Http::StreamResetReason::RemoteReset, "");
+  // The reset was already reported.
+  upstream_request_.reset();
+
+  initialize();
+  upstream_request_->upstreamHost() = host;
+  upstream_request_->streamInfo().upstreamInfo()->upstreamTiming().onFirstUpstreamTxByteSent(
+      dispatcher.timeSource());
+  dispatcher.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(7));
+  EXPECT_CALL(lb_policy_data, onRequestFailure(std::chrono::microseconds(7000)));
+  upstream_request_.reset();
+}
+
 // UpstreamRequest is responsible for adding proper gRPC annotations to spans.
 TEST_F(UpstreamRequestTest, DecodeHeadersGrpcSpanAnnotations) {
   envoy::extensions::filters::http::router::v3::Router router_proto;
@@ -626,6 +626,93 @@ TEST_F(AllocatorImplTest, ForEachSinkedTextReadout) {
   EXPECT_EQ(num_iterations, 0);
 }
 
+TEST_F(AllocatorImplTest, ForEachChangedSinkedStats) {
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("counter"), StatName(), {});
+  GaugeSharedPtr gauge =
+      alloc_.makeGauge(makeStat("gauge"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  GaugeSharedPtr hidden_gauge = alloc_.makeGauge(makeStat("hidden.gauge"), StatName(), {},
+                                                 Gauge::ImportMode::HiddenAccumulate);
+  TextReadoutSharedPtr text_readout =
+      alloc_.makeTextReadout(makeStat("text_readout"), StatName(), {});
+
+  size_t num_stats = 0;
+  size_t num_iterations = 0;
+  auto size_fn = [&num_stats](std::size_t size) { num_stats = size; };
+  auto visit_counters = [&]() {
+    num_stats = 0;
+    num_iterations = 0;
+    alloc_.forEachChangedSinkedCounter(size_fn, [&num_iterations](Counter&) { ++num_iterations; });
+  };
+  auto visit_gauges = [&]() {
+    num_stats = 0;
+    num_iterations = 0;
+    alloc_.forEachChangedSinkedGauge(size_fn, [&num_iterations, &gauge](Gauge& visited) {
+      EXPECT_EQ(gauge->statName(), visited.statName());
+      ++num_iterations;
+    });
+  };
+  auto visit_text_readouts = [&]() {
+    num_stats = 0;
+    num_iterations = 0;
+    alloc_.forEachChangedSinkedTextReadout(size_fn,
+                                           [&num_iterations](TextReadout&) { ++num_iterations; });
+  };
+
+  // Without tracking, all the sinked stats are visited every time.
+  visit_counters();
+  EXPECT_EQ(1, num_iterations);
+  visit_counters();
+  EXPECT_EQ(1, num_iterations);
+
+  // Once tracking starts, the existing stats are visited once.
+  alloc_.trackChangedStats();
+  visit_counters();
+  EXPECT_EQ(1, num_stats);
+  EXPECT_EQ(1, num_iterations);
+  visit_gauges();
+  EXPECT_EQ(1, num_stats);
+  EXPECT_EQ(1, num_iterations);
+  visit_text_readouts();
+  EXPECT_EQ(1, num_iterations);
+
+  visit_counters();
+  EXPECT_EQ(0, num_stats);
+  EXPECT_EQ(0, num_iterations);
+  visit_gauges();
+  EXPECT_EQ(0, num_iterations);
+  visit_text_readouts();
+  EXPECT_EQ(0, num_iterations);
+
+  // Changed stats are visited once per change, however many times they changed.
+  counter->inc();
+  counter->inc();
+  gauge->set(5);
+  hidden_gauge->set(5);
+  text_readout->set("value");
+  visit_counters();
+  EXPECT_EQ(1, num_iterations);
+  visit_gauges();
+  EXPECT_EQ(1, num_iterations);
+  visit_text_readouts();
+  EXPECT_EQ(1, num_iterations);
+  visit_counters();
+  EXPECT_EQ(0, num_iterations);
+
+  // Stats made after tracking starts are only visited once they change.
+  CounterSharedPtr new_counter = alloc_.makeCounter(makeStat("new_counter"), StatName(), {});
+  visit_counters();
+  EXPECT_EQ(0, num_iterations);
+  new_counter->inc();
+  visit_counters();
+  EXPECT_EQ(1, num_iterations);
+
+  // Stats which are freed are no longer visited.
+  counter->inc();
+  counter.reset();
+  visit_counters();
+  EXPECT_EQ(0, num_iterations);
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
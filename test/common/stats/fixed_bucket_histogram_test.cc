@@ -0,0 +1,185 @@
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "source/common/stats/fixed_bucket_histogram.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+TEST(FixedBucketsTest, SmallValuesHaveBucketsOfTheirOwn) {
+  for (uint64_t value = 0; value < FixedBuckets::BucketsPerGroup; ++value) {
+    EXPECT_EQ(value, FixedBuckets::index(value));
+    EXPECT_EQ(value, FixedBuckets::lowerBound(value));
+    EXPECT_EQ(1, FixedBuckets::width(value));
+  }
+}
+
+TEST(FixedBucketsTest, BucketsContainTheirValues) {
+  EXPECT_EQ(16, FixedBuckets::index(16));
+  EXPECT_EQ(31, FixedBuckets::index(31));
+  EXPECT_EQ(32, FixedBuckets::index(32));
+  EXPECT_EQ(32, FixedBuckets::index(33));
+  EXPECT_EQ(33, FixedBuckets::index(34));
+  EXPECT_EQ(FixedBuckets::NumBuckets - 1,
+            FixedBuckets::index(std::numeric_limits<uint64_t>::max()));
+
+  uint64_t previous_index = 0;
+  for (uint64_t value = 1; value < (uint64_t(1) << 20); value = value * 9 / 8 + 1) {
+    const uint32_t index = FixedBuckets::index(value);
+    EXPECT_LE(previous_index, index);
+    EXPECT_LE(FixedBuckets::lowerBound(index), value);
+    EXPECT_GT(FixedBuckets::lowerBound(index) + FixedBuckets::width(index), value);
+    EXPECT_LE(FixedBuckets::width(index), FixedBuckets::lowerBound(index) / 16 + 1);
+    previous_index = index;
+  }
+}
+
+TEST(FixedBucketHistogramTest, Empty) {
+  FixedBucketHistogram histogram;
+  std::vector<double> values;
+  histogram.approxQuantiles({0, 0.5, 1}, values);
+  EXPECT_EQ(std::vector<double>({0, 0, 0}), values);
+  EXPECT_EQ(0, histogram.sampleCount());
+  EXPECT_EQ(0, histogram.approxSum());
+  EXPECT_EQ(0, histogram.approxCountBelow(100));
+  EXPECT_TRUE(histogram.detailedBuckets().empty());
+}
+
+TEST(FixedBucketHistogramTest, Statistics) {
+  ThreadLocalFixedBucketCounts counts;
+  for (uint64_t value = 0; value < 10; ++value) {
+    counts.record(value);
+  }
+  FixedBucketHistogram histogram;
+  counts.addNewValuesTo(histogram);
+
+  EXPECT_EQ(10, histogram.sampleCount());
+  EXPECT_EQ(50, histogram.approxSum());
+  EXPECT_EQ(5, histogram.approxCountBelow(5));
+  EXPECT_EQ(10, histogram.approxCountBelow(100));
+  std::vector<double> values;
+  histogram.approxQuantiles({0, 0.5, 1}, values);
+  EXPECT_EQ(std::vector<double>({0, 5, 10}), values);
+
+  const std::vector<ParentHistogram::Bucket> buckets = histogram.detailedBuckets();
+  ASSERT_EQ(10, buckets.size());
+  EXPECT_EQ(9, buckets[9].lower_bound_);
+  EXPECT_EQ(1, buckets[9].width_);
+  EXPECT_EQ(1, buckets[9].count_);
+}
+
+TEST(FixedBucketHistogramTest, AddAndClear) {
+  ThreadLocalFixedBucketCounts counts;
+  counts.record(3);
+  counts.record(1000);
+  FixedBucketHistogram interval;
+  counts.addNewValuesTo(interval);
+  FixedBucketHistogram cumulative;
+  cumulative.add(interval);
+  cumulative.add(interval);
+  EXPECT_EQ(4, cumulative.sampleCount());
+  EXPECT_EQ(2, cumulative.approxCountBelow(4));
+
+  interval.clear();
+  EXPECT_EQ(0, interval.sampleCount());
+  EXPECT_TRUE(interval.detailedBuckets().empty());
+  EXPECT_EQ(4, cumulative.sampleCount());
+}
+
+TEST(ThreadLocalFixedBucketCountsTest, AddsOnlyNewValues) {
+  ThreadLocalFixedBucketCounts counts;
+  EXPECT_FALSE(counts.used());
+
+  counts.record(3);
+  EXPECT_TRUE(counts.used());
+  FixedBucketHistogram first;
+  counts.addNewValuesTo(first);
+  EXPECT_EQ(1, first.sampleCount());
+
+  counts.record(3);
+  counts.record(100);
+  FixedBucketHistogram second;
+  counts.addNewValuesTo(second);
+  EXPECT_EQ(2, second.sampleCount());
+  EXPECT_EQ(1, second.approxCountBelow(4));
+
+  counts.addNewValuesTo(second);
+  EXPECT_EQ(2, second.sampleCount());
+  EXPECT_EQ(1, first.sampleCount());
+}
+
+// Reads the counts while another thread records values, and checks that every value is added to
+// the histogram once.
+TEST(ThreadLocalFixedBucketCountsTest, ConcurrentRecordAndRead) {
+  const uint64_t num_values = 100000;
+  ThreadLocalFixedBucketCounts counts;
+  FixedBucketHistogram histogram;
+  absl::Notification done;
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&]() {
+    for (uint64_t value = 0; value < num_values; ++value) {
+      counts.record(value);
+    }
+    done.Notify();
+  });
+  while (!done.HasBeenNotified()) {
+    counts.addNewValuesTo(histogram);
+    EXPECT_LE(histogram.sampleCount(), num_values);
+  }
+  thread->join();
+  counts.addNewValuesTo(histogram);
+
+  EXPECT_EQ(num_values, histogram.sampleCount());
+  EXPECT_EQ(num_values, histogram.approxCountBelow(num_values * 2));
+}
+
+// Statistics are computed from the values of the histogram when first read after a refresh.
+TEST(FixedBucketHistogramStatisticsTest, ComputedOnRead) {
+  FixedBucketHistogram histogram;
+  const ConstSupportedBuckets supported_buckets{4, 100};
+  FixedBucketHistogramStatistics statistics(histogram, Histogram::Unit::Unspecified,
+                                            supported_buckets);
+  EXPECT_EQ(0, statistics.sampleCount());
+  EXPECT_EQ(std::vector<uint64_t>({0, 0}), statistics.computedBuckets());
+
+  ThreadLocalFixedBucketCounts counts;
+  counts.record(3);
+  counts.addNewValuesTo(histogram);
+  EXPECT_EQ(std::vector<uint64_t>({0, 0}), statistics.computedBuckets());
+
+  statistics.refresh();
+  EXPECT_EQ(1, statistics.sampleCount());
+  EXPECT_EQ(std::vector<uint64_t>({1, 1}), statistics.computedBuckets());
+  EXPECT_EQ(3.5, statistics.sampleSum());
+  EXPECT_EQ(statistics.supportedQuantiles().size(), statistics.computedQuantiles().size());
+  EXPECT_EQ(3.5, statistics.computedQuantiles()[2]);
+  EXPECT_EQ("P0: 3, P25: 3.25, P50: 3.5, P75: 3.75, P90: 3.9, P95: 3.95, P99: 3.99, "
+            "P99.5: 3.995, P99.9: 3.999, P100: 4",
+            statistics.quantileSummary());
+  EXPECT_EQ("B4: 1, B100: 1", statistics.bucketSummary());
+}
+
+TEST(FixedBucketHistogramStatisticsTest, Percent) {
+  FixedBucketHistogram histogram;
+  const ConstSupportedBuckets supported_buckets{0.25, 1};
+  FixedBucketHistogramStatistics statistics(histogram, Histogram::Unit::Percent, supported_buckets);
+
+  ThreadLocalFixedBucketCounts counts;
+  counts.record(Histogram::PercentScale / 2);
+  counts.addNewValuesTo(histogram);
+  statistics.refresh();
+
+  EXPECT_NEAR(0.5, statistics.computedQuantiles()[2], 0.5 / 16);
+  EXPECT_NEAR(0.5, statistics.sampleSum(), 0.5 / 16);
+  EXPECT_EQ(std::vector<uint64_t>({0, 1}), statistics.computedBuckets());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
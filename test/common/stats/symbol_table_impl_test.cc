@@ -531,20 +531,10 @@ TEST_F(StatNameTest, RacingSymbolCreation) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // Encoding names whose symbols already exist only takes the symbol table
+  // lock shared, so the symbol table adds no contentions after latching
+  // 'create_contentions' above. We cannot check that the total is unchanged,
+  // though, as the threads waking up from 'access' may contend on its mutex.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -599,20 +589,10 @@ TEST_F(StatNameTest, MutexContentionOnExistingSymbols) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // Encoding names whose symbols already exist only takes the symbol table
+  // lock shared, so the symbol table adds no contentions after latching
+  // 'create_contentions' above. We cannot check that the total is unchanged,
+  // though, as the threads waking up from 'access' may contend on its mutex.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -623,6 +603,35 @@ TEST_F(StatNameTest, MutexContentionOnExistingSymbols) {
   }
 }
 
+// Races threads encoding, copying and freeing names which share symbols, so
+// that the last reference to a symbol is often freed while other threads take
+// new references to it.
+TEST_F(StatNameTest, RacingSymbolFree) {
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  constexpr int num_threads = 16;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer start;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([this, i, &start]() {
+      const std::string stat_name_string = absl::StrCat("shared.symbol", i % 4, ".shared");
+      start.wait();
+      for (int count = 0; count < 1000; ++count) {
+        StatNameStorage storage(stat_name_string, table_);
+        StatNameStorage copy(storage.statName(), table_);
+        EXPECT_EQ(stat_name_string, table_.toString(copy.statName()));
+        storage.free(table_);
+        copy.free(table_);
+      }
+    }));
+  }
+  start.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(0, table_.numSymbols());
+}
+
 TEST_F(StatNameTest, SharedStatNameStorageSetInsertAndFind) {
   StatNameStorageSet set;
   const int iters = 10;
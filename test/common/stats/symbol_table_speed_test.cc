@@ -63,6 +63,64 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Encodes, copies and frees a name made of existing symbols from every
+// benchmark thread, as workers do when creating stats from strings. None of
+// these take the symbol table lock exclusively, so this should scale with the
+// number of threads.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeExistingSymbols(benchmark::State& state) {
+  static std::unique_ptr<Envoy::Stats::SymbolTableImpl> table;
+  static std::unique_ptr<Envoy::Stats::StatNameStorage> initial;
+  const absl::string_view stat_name_string = "here.is.a.stat.name";
+
+  // The other threads only access the table once the benchmark loop starts,
+  // which all threads enter together.
+  if (state.thread_index() == 0) {
+    table = std::make_unique<Envoy::Stats::SymbolTableImpl>();
+    initial = std::make_unique<Envoy::Stats::StatNameStorage>(stat_name_string, *table);
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::Stats::StatNameStorage storage(stat_name_string, *table);
+    Envoy::Stats::StatNameStorage copy(storage.statName(), *table);
+    storage.free(*table);
+    copy.free(*table);
+  }
+
+  // All threads have left the benchmark loop once one of them has.
+  if (state.thread_index() == 0) {
+    initial->free(*table);
+    initial.reset();
+    table.reset();
+  }
+}
+BENCHMARK(bmEncodeExistingSymbols)->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+
+// Decodes a name from every benchmark thread, as stats sinks and admin do.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmDecodeSymbols(benchmark::State& state) {
+  static std::unique_ptr<Envoy::Stats::SymbolTableImpl> table;
+  static std::unique_ptr<Envoy::Stats::StatNameStorage> stat_name;
+
+  if (state.thread_index() == 0) {
+    table = std::make_unique<Envoy::Stats::SymbolTableImpl>();
+    stat_name = std::make_unique<Envoy::Stats::StatNameStorage>("here.is.a.stat.name", *table);
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    benchmark::DoNotOptimize(table->toString(stat_name->statName()));
+  }
+
+  if (state.thread_index() == 0) {
+    stat_name->free(*table);
+    stat_name.reset();
+    table.reset();
+  }
+}
+BENCHMARK(bmDecodeSymbols)->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
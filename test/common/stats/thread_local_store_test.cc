@@ -1797,6 +1797,47 @@ TEST_F(HistogramTest, ParentHistogramBucketSummaryAndDetail) {
   EXPECT_THAT(parent_histogram->detailedIntervalBuckets(), UnorderedElementsAre(Bucket{10, 1, 1}));
 }
 
+// Validates the merge of histograms which count their values in fixed buckets.
+TEST_F(HistogramTest, FixedBucketHistogramMerge) {
+  envoy::config::metrics::v3::StatsConfig config;
+  config.set_use_fixed_bucket_histograms(true);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(config));
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+
+  for (uint64_t i = 0; i < 50; ++i) {
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), i));
+    h1.recordValue(i);
+  }
+  store_->mergeHistograms([]() -> void {});
+  for (uint64_t i = 50; i < 100; ++i) {
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), i));
+    h1.recordValue(i);
+  }
+  store_->mergeHistograms([]() -> void {});
+
+  ASSERT_EQ(1, store_->histograms().size());
+  ParentHistogramSharedPtr parent_histogram = store_->histograms()[0];
+  EXPECT_TRUE(parent_histogram->used());
+  EXPECT_EQ(50, parent_histogram->intervalStatistics().sampleCount());
+  EXPECT_EQ(100, parent_histogram->cumulativeStatistics().sampleCount());
+  EXPECT_EQ("P0: 0, P25: 25, P50: 50, P75: 75, P90: 90, P95: 95, P99: 99, P99.5: 99.5, "
+            "P99.9: 99.9, P100: 100",
+            parent_histogram->cumulativeStatistics().quantileSummary());
+  // Unlike circllhist, the buckets of values below 16 are exact, so no value is below 0.5.
+  EXPECT_EQ("B0.5: 0, B1: 1, B5: 5, B10: 10, B25: 25, B50: 50, B100: 100, B250: 100, "
+            "B500: 100, B1000: 100, B2500: 100, B5000: 100, B10000: 100, B30000: 100, "
+            "B60000: 100, B300000: 100, B600000: 100, B1.8e+06: 100, B3.6e+06: 100",
+            parent_histogram->cumulativeStatistics().bucketSummary());
+  // Buckets of width 1 up to 32, of width 2 up to 64 and of width 4 up to 100.
+  EXPECT_EQ(32 + 16 + 9, parent_histogram->detailedTotalBuckets().size());
+  EXPECT_EQ(7 + 9, parent_histogram->detailedIntervalBuckets().size());
+
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(0, parent_histogram->intervalStatistics().sampleCount());
+  EXPECT_EQ(100, parent_histogram->cumulativeStatistics().sampleCount());
+  EXPECT_TRUE(parent_histogram->detailedIntervalBuckets().empty());
+}
+
 TEST_F(HistogramTest, ForEachHistogram) {
   std::vector<std::reference_wrapper<Histogram>> histograms;
 
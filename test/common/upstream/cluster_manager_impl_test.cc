@@ -4437,6 +4437,73 @@ TEST_P(ClusterManagerLifecycleTest, CrossPriorityHostMapSyncTest) {
       cluster.prioritySet().crossPriorityHostMap());
 }
 
+// Test that host set updates of an existing cluster carry the changes since the previous update to
+// the worker threads.
+TEST_P(ClusterManagerLifecycleTest, HostSetDeltaSyncTest) {
+  std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      load_assignment:
+        cluster_name: cluster_1
+        endpoints:
+        - lb_endpoints:
+          - endpoint:
+              address:
+                socket_address:
+                  address: 127.0.0.1
+                  port_value: 11001
+          - endpoint:
+              address:
+                socket_address:
+                  address: 127.0.0.1
+                  port_value: 11002
+      common_lb_config:
+        update_merge_window: 0s
+  )EOF";
+  create(parseBootstrapFromV3Yaml(yaml));
+
+  Cluster& cluster = cluster_manager_->activeClusters().begin()->second;
+  const PrioritySet& tls_priority_set =
+      cluster_manager_->getThreadLocalCluster("cluster_1")->prioritySet();
+  absl::optional<HostListDelta> tls_delta;
+  auto priority_update_cb = tls_priority_set.addPriorityUpdateCb(
+      [&](uint32_t priority, const HostVector&, const HostVector&) {
+        const HostSetDelta* delta =
+            tls_priority_set.hostSetsPerPriority()[priority]->lastUpdateDelta();
+        tls_delta = delta != nullptr ? absl::make_optional(delta->hosts) : absl::nullopt;
+      });
+
+  const HostVector all_hosts = cluster.prioritySet().hostSetsPerPriority()[0]->hosts();
+  const auto update_hosts = [&cluster](const HostVector& hosts, const HostVector& hosts_added,
+                                       const HostVector& hosts_removed) {
+    HostVectorSharedPtr hosts_ptr(new HostVector(hosts));
+    HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+    cluster.prioritySet().updateHosts(
+        0,
+        updateHostsParams(hosts_ptr, hosts_per_locality,
+                          std::make_shared<const HealthyHostVector>(hosts), hosts_per_locality),
+        {}, hosts_added, hosts_removed, absl::nullopt, absl::nullopt);
+  };
+
+  // The localities of the hosts change, so the update carries no delta.
+  update_hosts({all_hosts[1]}, {}, {all_hosts[0]});
+  EXPECT_FALSE(tls_delta.has_value());
+
+  update_hosts(all_hosts, {all_hosts[0]}, {});
+  ASSERT_TRUE(tls_delta.has_value());
+  EXPECT_EQ(HostVector({all_hosts[0]}), tls_delta->added);
+  EXPECT_TRUE(tls_delta->removed.empty());
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.incremental_host_set_updates", "false"}});
+  update_hosts({all_hosts[1]}, {}, {all_hosts[0]});
+  EXPECT_FALSE(tls_delta.has_value());
+}
+
 class TestUpstreamNetworkFilter : public Network::WriteFilter {
 public:
   Network::FilterStatus onWrite(Buffer::Instance&, bool) override {
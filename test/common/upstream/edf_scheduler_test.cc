@@ -134,6 +134,91 @@ TEST(EdfSchedulerTest, ManyPeekahead) {
   }
 }
 
+// Validate that removed entries are not picked, and the schedule of the other entries is kept.
+TEST(EdfSchedulerTest, Remove) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 4;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  sched.remove(entries[1]);
+
+  for (uint32_t rounds = 0; rounds < 3; ++rounds) {
+    for (uint32_t i : {0, 2, 3}) {
+      EXPECT_EQ(i, *sched.peekAgain([](const double&) { return 1; }));
+      EXPECT_EQ(i, *sched.pickAndAdd([](const double&) { return 1; }));
+    }
+  }
+}
+
+// Validate that a removed entry which has been peeked is not picked.
+TEST(EdfSchedulerTest, RemovePeeked) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 4;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  EXPECT_EQ(0, *sched.peekAgain([](const double&) { return 1; }));
+  sched.remove(entries[0]);
+
+  for (uint32_t rounds = 0; rounds < 3; ++rounds) {
+    for (uint32_t i : {1, 2, 3}) {
+      EXPECT_EQ(i, *sched.pickAndAdd([](const double&) { return 1; }));
+    }
+  }
+}
+
+// Validate that an entry can be added back after it has been removed.
+TEST(EdfSchedulerTest, RemoveAndAdd) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 4;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  sched.remove(entries[1]);
+  sched.add(1, entries[1]);
+
+  for (uint32_t rounds = 0; rounds < 3; ++rounds) {
+    for (uint32_t i : {0, 2, 3, 1}) {
+      EXPECT_EQ(i, *sched.pickAndAdd([](const double&) { return 1; }));
+    }
+  }
+}
+
+// Validate that removing most entries compacts the queue, without affecting the picks.
+TEST(EdfSchedulerTest, RemoveMany) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 8;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(i + 1, entries[i]);
+  }
+  for (uint32_t i = 0; i < num_entries - 2; ++i) {
+    sched.remove(entries[i]);
+  }
+
+  uint32_t pick_count[num_entries] = {};
+  for (uint32_t i = 0; i < 15 * 10; ++i) {
+    ++pick_count[*sched.pickAndAdd([](const double& orig) { return orig + 1; })];
+  }
+  for (uint32_t i = 0; i < num_entries - 2; ++i) {
+    EXPECT_EQ(0, pick_count[i]);
+  }
+  EXPECT_EQ(70, pick_count[6]);
+  EXPECT_EQ(80, pick_count[7]);
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
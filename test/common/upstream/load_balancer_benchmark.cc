@@ -5,10 +5,12 @@
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "source/common/common/random_generator.h"
+#include "source/common/common/utility.h"
 #include "source/common/memory/stats.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
+#include "source/extensions/load_balancing_policies/worker_least_request/worker_least_request_lb.h"
 
 #include "test/benchmark/main.h"
 #include "test/common/upstream/utility.h"
@@ -245,6 +247,72 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(::benchmark::kMillisecond);
 
+// Removes the last host of priority 0, and then adds it back. Each of the updates refreshes the
+// table of the load balancer on the calling thread, which is the main thread in Envoy, so each
+// call times two table rebuilds.
+class HostChurn {
+public:
+  explicit HostChurn(PrioritySetImpl& priority_set)
+      : priority_set_(priority_set), hosts_(priority_set.hostSetsPerPriority()[0]->hosts()),
+        remaining_hosts_(hosts_.begin(), hosts_.end() - 1), last_host_{hosts_.back()} {}
+
+  void removeAndAddLastHost(::benchmark::State& state) {
+    updateHosts(state, remaining_hosts_, {}, last_host_);
+    updateHosts(state, hosts_, last_host_, {});
+  }
+
+private:
+  void updateHosts(::benchmark::State& state, const HostVector& hosts,
+                   const HostVector& hosts_added, const HostVector& hosts_removed) {
+    state.PauseTiming();
+    auto params = HostSetImpl::partitionHosts(std::make_shared<HostVector>(hosts),
+                                              makeHostsPerLocality({hosts}));
+    state.ResumeTiming();
+    priority_set_.updateHosts(0, std::move(params), {}, hosts_added, hosts_removed,
+                              absl::nullopt);
+  }
+
+  PrioritySetImpl& priority_set_;
+  const HostVector hosts_;
+  const HostVector remaining_hosts_;
+  const HostVector last_host_;
+};
+
+void benchmarkRingHashLoadBalancerRebuildRing(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  RingHashTester tester(num_hosts, min_ring_size);
+  tester.ring_hash_lb_->initialize();
+  HostChurn churn(tester.priority_set_);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    churn.removeAndAddLastHost(state);
+  }
+}
+BENCHMARK(benchmarkRingHashLoadBalancerRebuildRing)
+    ->Args({100, 65536})
+    ->Args({500, 65536})
+    ->Args({100, 256000})
+    ->Args({500, 256000})
+    ->Args({5000, 1024000})
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkMaglevLoadBalancerRebuildTable(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+  HostChurn churn(tester.priority_set_);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    churn.removeAndAddLastHost(state);
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerRebuildTable)
+    ->Arg(100)
+    ->Arg(500)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -315,6 +383,71 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// One load balancer per simulated worker, all picking from the same hosts.
+class ConcurrentLeastRequestTester : public BaseTester {
+public:
+  ConcurrentLeastRequestTester(uint64_t num_hosts, uint32_t num_workers, bool worker_counts)
+      : BaseTester(num_hosts) {
+    envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
+    WorkerLeastRequestLbProto worker_lr_lb_config;
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      // No local priority set, so that picks don't update the shared zone routing stats.
+      if (worker_counts) {
+        lbs_.push_back(std::make_unique<WorkerLeastRequestLoadBalancer>(
+            priority_set_, nullptr, stats_, runtime_, random_, 50, worker_lr_lb_config,
+            time_source_));
+      } else {
+        lbs_.push_back(std::make_unique<LeastRequestLoadBalancer>(
+            priority_set_, nullptr, stats_, runtime_, random_, common_config_, lr_lb_config,
+            simTime()));
+      }
+    }
+  }
+
+  // The simulated time system serializes reads of the time, so the worker counts use real time.
+  RealTimeSource time_source_;
+  std::vector<LoadBalancerPtr> lbs_;
+};
+
+// Picks hosts from every benchmark thread, each acting as a worker with its own load balancer.
+// Like the connection pools of a worker, each thread accounts for the requests it sends in the
+// active request counts of the hosts, and keeps a fixed number of requests in flight.
+void benchmarkLeastRequestLoadBalancerConcurrentChooseHost(::benchmark::State& state) {
+  static std::unique_ptr<ConcurrentLeastRequestTester> tester;
+  const uint64_t num_hosts = state.range(0);
+  const bool worker_counts = state.range(1) != 0;
+  const uint64_t requests_in_flight = state.range(2);
+
+  // The other threads only access the tester once the benchmark loop starts, which all threads
+  // enter together.
+  if (state.thread_index() == 0) {
+    tester =
+        std::make_unique<ConcurrentLeastRequestTester>(num_hosts, state.threads(), worker_counts);
+  }
+
+  std::vector<const Host*> in_flight(requests_in_flight, nullptr);
+  uint64_t next = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    HostConstSharedPtr host = tester->lbs_[state.thread_index()]->chooseHost(nullptr);
+    host->stats().rq_active_.inc();
+    if (in_flight[next] != nullptr) {
+      in_flight[next]->stats().rq_active_.dec();
+    }
+    in_flight[next] = host.get();
+    next = (next + 1) % requests_in_flight;
+  }
+
+  // All threads have left the benchmark loop once one of them has.
+  if (state.thread_index() == 0) {
+    tester.reset();
+  }
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerConcurrentChooseHost)
+    ->Args({100, 0, 16})
+    ->Args({100, 1, 16})
+    ->Threads(64)
+    ->UseRealTime();
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
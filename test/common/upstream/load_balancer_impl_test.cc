@@ -28,6 +28,7 @@
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -1140,6 +1141,52 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Validate that a host set delta is applied to the schedule in place.
+TEST_P(RoundRobinLoadBalancerTest, WeightedDelta) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2),
+                              makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3),
+                              makeTestHost(info_, "tcp://127.0.0.1:83", simTime(), 1)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  // Replace the second host with a new one.
+  HostSharedPtr removed_host = hostSet().healthy_hosts_[1];
+  HostSharedPtr added_host = makeTestHost(info_, "tcp://127.0.0.1:84", simTime(), 4);
+  hostSet().healthy_hosts_ = {hostSet().healthy_hosts_[0], hostSet().healthy_hosts_[2],
+                              hostSet().healthy_hosts_[3], added_host};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  HostSetDelta delta;
+  delta.hosts = {{added_host}, {removed_host}, false};
+  delta.healthy_hosts = delta.hosts;
+  delta.degraded_hosts.weights_equal = true;
+  hostSet().last_update_delta_ = &delta;
+  hostSet().runCallbacks({added_host}, {removed_host});
+  hostSet().last_update_delta_ = nullptr;
+
+  absl::flat_hash_map<HostConstSharedPtr, uint32_t> picks;
+  for (uint32_t i = 0; i < 90; ++i) {
+    ++picks[lb_->chooseHost(nullptr)];
+  }
+  EXPECT_EQ(0, picks[removed_host]);
+  EXPECT_NEAR(10, picks[hostSet().healthy_hosts_[0]], 1);
+  EXPECT_NEAR(30, picks[hostSet().healthy_hosts_[1]], 1);
+  EXPECT_NEAR(10, picks[hostSet().healthy_hosts_[2]], 1);
+  EXPECT_NEAR(40, picks[added_host], 1);
+
+  // Once all weights are equal, the schedule is dropped.
+  HostVector removed_hosts = {hostSet().healthy_hosts_[0], hostSet().healthy_hosts_[1],
+                              added_host};
+  hostSet().healthy_hosts_ = {hostSet().healthy_hosts_[2]};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  delta.hosts = {{}, removed_hosts, true};
+  delta.healthy_hosts = delta.hosts;
+  hostSet().last_update_delta_ = &delta;
+  hostSet().runCallbacks({}, delta.hosts.removed);
+  hostSet().last_update_delta_ = nullptr;
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
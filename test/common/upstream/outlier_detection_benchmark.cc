@@ -0,0 +1,84 @@
+// Usage: bazel run //test/common/upstream:outlier_detection_benchmark
+
+#include <memory>
+
+#include "envoy/config/cluster/v3/outlier_detection.pb.h"
+
+#include "source/common/upstream/outlier_detection_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+class OutlierDetectorTester : public Event::TestUsingSimulatedTime {
+public:
+  OutlierDetectorTester(uint64_t num_hosts) {
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts_.push_back(makeTestHost(cluster_.info_,
+                                    fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256),
+                                    simTime()));
+    }
+    cluster_.prioritySet().getMockHostSet(0)->hosts_ = hosts_;
+    // Owned by the detector.
+    new NiceMock<Event::MockTimer>(&dispatcher_);
+    detector_ = DetectorImpl::create(cluster_, outlier_detection_, dispatcher_, runtime_,
+                                     simTime(), nullptr, random_);
+  }
+
+  HostVector hosts_;
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  envoy::config::cluster::v3::OutlierDetection outlier_detection_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+// Reports successful responses from every benchmark thread, each acting as a worker sending
+// requests to the same hosts. The fewer the hosts, the more the threads contend on them.
+void benchmarkOutlierDetectorConcurrentPutResult(::benchmark::State& state) {
+  static std::unique_ptr<OutlierDetectorTester> tester;
+  const uint64_t num_hosts = state.range(0);
+
+  // The other threads only access the tester once the benchmark loop starts, which all threads
+  // enter together.
+  if (state.thread_index() == 0) {
+    tester = std::make_unique<OutlierDetectorTester>(num_hosts);
+  }
+
+  uint64_t next = state.thread_index() % num_hosts;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester->hosts_[next]->outlierDetector().putResult(Result::ExtOriginRequestSuccess);
+    next = (next + 1) % num_hosts;
+  }
+
+  // All threads have left the benchmark loop once one of them has.
+  if (state.thread_index() == 0) {
+    tester.reset();
+  }
+}
+BENCHMARK(benchmarkOutlierDetectorConcurrentPutResult)
+    ->Arg(1)
+    ->Arg(100)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
@@ -1414,6 +1414,43 @@ TEST_F(HostImplTest, CreateConnection) {
   EXPECT_EQ(connection, connection_data.connection_.get());
 }
 
+TEST_F(HostImplTest, CreateConnectionWithClusterSocketInterface) {
+  MockClusterMockPrioritySet cluster;
+  Network::MockSocketInterface sock_interface({Network::Address::IpVersion::v4});
+  ON_CALL(*cluster.info_, upstreamSocketInterface()).WillByDefault(Return(&sock_interface));
+  Network::Address::InstanceConstSharedPtr address =
+      Network::Utility::resolveUrl("tcp://10.0.0.1:1234");
+  auto host = std::make_shared<HostImpl>(
+      cluster.info_, "lyft.com", address, nullptr, 1,
+      envoy::config::core::v3::Locality().default_instance(),
+      envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 1,
+      envoy::config::core::v3::UNKNOWN, simTime());
+
+  testing::StrictMock<Event::MockDispatcher> dispatcher;
+  Network::TransportSocketOptionsConstSharedPtr transport_socket_options;
+  Network::ConnectionSocket::OptionsSharedPtr options;
+
+  // The connection is created with the socket interface of the cluster, not of the host address.
+  auto connection = new testing::StrictMock<Network::MockClientConnection>();
+  EXPECT_CALL(*connection, setBufferLimits(0));
+  EXPECT_CALL(dispatcher, createClientConnection_(_, _, _, _))
+      .WillOnce(Invoke([&](Network::Address::InstanceConstSharedPtr connect_address,
+                           Network::Address::InstanceConstSharedPtr,
+                           Network::TransportSocketPtr&,
+                           const Network::ConnectionSocket::OptionsSharedPtr&)
+                           -> Network::ClientConnection* {
+        EXPECT_EQ(*address, *connect_address);
+        EXPECT_EQ(&sock_interface, &connect_address->socketInterface());
+        return connection;
+      }));
+  EXPECT_CALL(*connection, connectionInfoSetter());
+  Envoy::Upstream::Host::CreateConnectionData connection_data =
+      host->createConnection(dispatcher, options, transport_socket_options);
+  EXPECT_EQ(connection, connection_data.connection_.get());
+  // The address of the host is unchanged.
+  EXPECT_NE(&sock_interface, &host->address()->socketInterface());
+}
+
 TEST_F(HostImplTest, CreateConnectionHappyEyeballs) {
   MockClusterMockPrioritySet cluster;
   envoy::config::core::v3::Metadata metadata;
@@ -5466,6 +5503,64 @@ TEST_F(HostSetImplLocalityTest, UnhealthyFailover) {
   expectPicks(0, 100);
 }
 
+// The update callbacks see the delta of an update only if it was computed from the current lists.
+TEST_F(HostSetImplLocalityTest, UpdateDelta) {
+  envoy::config::core::v3::Locality zone_a;
+  zone_a.set_zone("A");
+  envoy::config::core::v3::Locality zone_b;
+  zone_b.set_zone("B");
+  HostVector hosts{makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), zone_a, 1),
+                   makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), zone_a, 2),
+                   makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), zone_b, 1)};
+  HostSharedPtr new_host = makeTestHost(info_, "tcp://127.0.0.1:83", simTime(), zone_b, 2);
+
+  const auto partition = [](std::vector<HostVector>&& locality_hosts) {
+    HostsPerLocalitySharedPtr hosts_per_locality = makeHostsPerLocality(std::move(locality_hosts));
+    return HostSetImpl::partitionHosts(makeHostsFromHostsPerLocality(hosts_per_locality),
+                                       hosts_per_locality);
+  };
+  const HostSetDelta* seen_delta = nullptr;
+  auto cb = host_set_.addPriorityUpdateCb(
+      [&](uint32_t, const HostVector&, const HostVector&) {
+        seen_delta = host_set_.lastUpdateDelta();
+      });
+
+  host_set_.updateHosts(partition({{hosts[0], hosts[1]}, {hosts[2]}}), nullptr, hosts, {});
+  EXPECT_EQ(nullptr, seen_delta);
+
+  PrioritySet::UpdateHostsParams params = partition({{hosts[0], hosts[1]}, {new_host}});
+  HostSetDeltaConstSharedPtr delta = HostSetImpl::computeDelta(host_set_, params);
+  ASSERT_NE(nullptr, delta);
+  EXPECT_EQ(HostVector({new_host}), delta->hosts.added);
+  EXPECT_EQ(HostVector({hosts[2]}), delta->hosts.removed);
+  EXPECT_FALSE(delta->hosts.weights_equal);
+  EXPECT_EQ(HostVector({new_host}), delta->healthy_hosts.added);
+  EXPECT_EQ(HostVector({hosts[2]}), delta->healthy_hosts.removed);
+  EXPECT_TRUE(delta->degraded_hosts.added.empty());
+  EXPECT_TRUE(delta->degraded_hosts.removed.empty());
+  ASSERT_EQ(2, delta->healthy_hosts_per_locality.size());
+  EXPECT_TRUE(delta->healthy_hosts_per_locality[0].added.empty());
+  EXPECT_TRUE(delta->healthy_hosts_per_locality[0].removed.empty());
+  EXPECT_FALSE(delta->healthy_hosts_per_locality[0].weights_equal);
+  EXPECT_EQ(HostVector({new_host}), delta->healthy_hosts_per_locality[1].added);
+  EXPECT_EQ(HostVector({hosts[2]}), delta->healthy_hosts_per_locality[1].removed);
+  EXPECT_TRUE(delta->healthy_hosts_per_locality[1].weights_equal);
+
+  params.delta = delta;
+  host_set_.updateHosts(std::move(params), nullptr, {new_host}, {hosts[2]});
+  EXPECT_EQ(delta.get(), seen_delta);
+  EXPECT_EQ(nullptr, host_set_.lastUpdateDelta());
+
+  // The delta no longer applies to the current lists.
+  params = partition({{hosts[0]}, {new_host}});
+  params.delta = delta;
+  host_set_.updateHosts(std::move(params), nullptr, {}, {hosts[1]});
+  EXPECT_EQ(nullptr, seen_delta);
+
+  // Locality indexes can't be tracked if the number of localities changes.
+  EXPECT_EQ(nullptr, HostSetImpl::computeDelta(host_set_, partition({{hosts[0], new_host}})));
+}
+
 TEST(OverProvisioningFactorTest, LocalityPickChanges) {
   auto setUpHostSetWithOPFAndTestPicks = [](const uint32_t overprovisioning_factor,
                                             const uint32_t pick_0, const uint32_t pick_1) {
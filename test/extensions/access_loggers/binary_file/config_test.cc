@@ -0,0 +1,199 @@
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/binary_file/v3/binary_file.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+#include "source/extensions/access_loggers/binary_file/config.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace BinaryFile {
+namespace {
+
+TEST(BinaryFileAccessLogNegativeTest, ValidateFail) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+
+  EXPECT_THROW(BinaryFileAccessLogFactory().createAccessLogInstance(
+                   envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog(),
+                   nullptr, context),
+               ProtoValidationException);
+}
+
+TEST(BinaryFileAccessLogNegativeTest, DuplicateColumnName) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog config;
+  TestUtility::loadFromYaml(R"EOF(
+path: /foo
+columns:
+- name: code
+  field: RESPONSE_CODE
+- name: code
+  format: "%RESPONSE_CODE%"
+)EOF",
+                            config);
+
+  EXPECT_THROW_WITH_MESSAGE(
+      BinaryFileAccessLogFactory().createAccessLogInstance(config, nullptr, context),
+      EnvoyException, "binary file access log: duplicate column name 'code'");
+}
+
+TEST(BinaryFileAccessLogNegativeTest, BlockSizeLargerThanFileRing) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog config;
+  TestUtility::loadFromYaml(R"EOF(
+path: /foo
+columns:
+- name: code
+  field: RESPONSE_CODE
+block_size_bytes: 262144
+)EOF",
+                            config);
+
+  EXPECT_THROW(BinaryFileAccessLogFactory().createAccessLogInstance(config, nullptr, context),
+               ProtoValidationException);
+}
+
+class BinaryFileAccessLogTest : public testing::Test {
+public:
+  void initialize(const std::string& yaml) {
+    envoy::extensions::access_loggers::binary_file::v3::BinaryFileAccessLog proto_config;
+    TestUtility::loadFromYaml(yaml, proto_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.set_name("envoy.access_loggers.binary_file");
+    config.mutable_typed_config()->PackFrom(proto_config);
+
+    Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, proto_config.path()};
+    EXPECT_CALL(context_.access_log_manager_, createAccessLog(file_info)).WillOnce(Return(file_));
+    ON_CALL(*file_, write(_)).WillByDefault(Invoke([this](absl::string_view data) {
+      written_.append(data.data(), data.size());
+    }));
+
+    flush_timer_ = new NiceMock<Event::MockTimer>(&context_.thread_local_.dispatcher_);
+    logger_ = AccessLog::AccessLogFactory::fromProto(config, context_);
+
+    stream_info_.start_time_ = absl::ToChronoTime(absl::FromUnixMicros(1545097834000000));
+    stream_info_.setResponseCode(200);
+  }
+
+  void log() {
+    logger_->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_,
+                 AccessLog::AccessLogType::NotSet);
+  }
+
+  std::string decodeToJson() {
+    Buffer::OwnedImpl json;
+    BlockReader reader(written_);
+    for (absl::StatusOr<bool> result = reader.next(); result.value_or(false);
+         result = reader.next()) {
+      reader.recordsToJson(json);
+    }
+    return json.toString();
+  }
+
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":path", "/bar/foo"}, {"x-foo", "bar"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  std::shared_ptr<AccessLog::MockAccessLogFile> file_{
+      std::make_shared<NiceMock<AccessLog::MockAccessLogFile>>()};
+  std::string written_;
+  Event::MockTimer* flush_timer_{};
+  AccessLog::InstanceSharedPtr logger_;
+};
+
+TEST_F(BinaryFileAccessLogTest, WritesBlockOnFlushTimer) {
+  initialize(R"EOF(
+path: /foo
+columns:
+- name: start
+  field: START_TIME
+- name: code
+  field: RESPONSE_CODE
+- name: method
+  field: REQUEST_METHOD
+- name: path
+  field: PATH
+- name: user_agent
+  field: USER_AGENT
+- name: foo
+  format: "%REQ(X-FOO)%"
+- name: baz
+  format: "%REQ(X-BAZ)%"
+block_flush_interval: 5s
+)EOF");
+
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(5000), _));
+  log();
+  // The timer is only armed for the first record of a block.
+  EXPECT_CALL(*flush_timer_, enableTimer(_, _)).Times(0);
+  log();
+  EXPECT_TRUE(written_.empty());
+
+  flush_timer_->invokeCallback();
+  const std::string record = "{\"start\":\"2018-12-18T01:50:34.000000Z\",\"code\":200,"
+                             "\"method\":\"GET\",\"path\":\"/bar/foo\",\"foo\":\"bar\"}\n";
+  EXPECT_EQ(record + record, decodeToJson());
+}
+
+TEST_F(BinaryFileAccessLogTest, WritesFullBlock) {
+  initialize(R"EOF(
+path: /foo
+columns:
+- name: path
+  field: PATH
+block_size_bytes: 1024
+compression_level: 0
+)EOF");
+
+  request_headers_.setPath(std::string(510, 'a'));
+  log();
+  EXPECT_TRUE(written_.empty());
+  log();
+  EXPECT_FALSE(written_.empty());
+
+  const std::string record = absl::StrCat("{\"path\":\"", std::string(510, 'a'), "\"}\n");
+  EXPECT_EQ(record + record, decodeToJson());
+}
+
+TEST_F(BinaryFileAccessLogTest, WritesPendingRecordsOnDestruction) {
+  initialize(R"EOF(
+path: /foo
+columns:
+- name: code
+  field: RESPONSE_CODE
+- name: duration
+  field: DURATION
+)EOF");
+
+  EXPECT_CALL(stream_info_, currentDuration())
+      .WillOnce(Return(absl::optional<std::chrono::nanoseconds>()));
+  log();
+  EXPECT_TRUE(written_.empty());
+
+  logger_.reset();
+  EXPECT_EQ("{\"code\":200}\n", decodeToJson());
+}
+
+} // namespace
+} // namespace BinaryFile
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
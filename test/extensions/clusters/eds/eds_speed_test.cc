@@ -13,6 +13,7 @@
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
 #include "source/common/singleton/manager_impl.h"
+#include "source/common/upstream/load_balancer_impl.h"
 #include "source/extensions/clusters/eds/eds.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
 #include "source/extensions/config_subscription/grpc/grpc_subscription_impl.h"
@@ -163,6 +164,92 @@ public:
            num_hosts);
   }
 
+  // Sends an EDS update with num_hosts weighted hosts, starting with the host at first_host, in a
+  // single locality of priority 0.
+  void sendWeightedHosts(size_t first_host, size_t num_hosts) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    auto* locality = endpoints->mutable_locality();
+    locality->set_region("region");
+    locality->set_zone("zone");
+    locality->set_sub_zone("sub_zone");
+    endpoints->mutable_load_balancing_weight()->set_value(1);
+    for (size_t i = first_host; i < first_host + num_hosts; ++i) {
+      auto* lb_endpoint = endpoints->add_lb_endpoints();
+      lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
+      lb_endpoint->mutable_load_balancing_weight()->set_value(1 + i % 5);
+      auto* socket_address =
+          lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+      socket_address->set_address(
+          fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff));
+      socket_address->set_port_value(80);
+    }
+
+    validation_visitor_.setSkipValidation(true);
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url_);
+    response->set_version_info(fmt::format("version-{}", version_++));
+    auto* resource = response->mutable_resources()->Add();
+    resource->PackFrom(cluster_load_assignment);
+    if (use_unified_mux_) {
+      dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
+          .grpcStreamForTest()
+          .onReceiveMessage(std::move(response));
+    } else {
+      dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_)
+          .grpcStreamForTest()
+          .onReceiveMessage(std::move(response));
+    }
+  }
+
+  // Propagates EDS updates which each replace num_changed_hosts of the hosts of the cluster to the
+  // host set and weighted round robin load balancer of a worker the way the cluster manager does,
+  // and measures the cost of the updates on the worker only. If incremental is set, the updates
+  // carry the delta from the previous update, which is computed against the host set of the main
+  // thread.
+  void workerUpdateHelper(size_t num_hosts, size_t num_changed_hosts, size_t num_updates,
+                          bool incremental) {
+    state_.PauseTiming();
+    bool measure = false;
+    PrioritySetImpl main_priority_set;
+    PrioritySetImpl worker_priority_set;
+    ClusterLbStatNames lb_stat_names(stats_.symbolTable());
+    ClusterLbStats lb_stats(lb_stat_names, scope_);
+    auto update_cb = cluster_->prioritySet().addPriorityUpdateCb(
+        [&](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
+          const auto& host_set = cluster_->prioritySet().hostSetsPerPriority()[priority];
+          PrioritySet::UpdateHostsParams params = HostSetImpl::updateHostsParams(*host_set);
+          if (incremental && priority < main_priority_set.hostSetsPerPriority().size()) {
+            params.delta = HostSetImpl::computeDelta(
+                *main_priority_set.hostSetsPerPriority()[priority], params);
+          }
+          main_priority_set.updateHosts(priority, PrioritySet::UpdateHostsParams(params),
+                                        host_set->localityWeights(), hosts_added, hosts_removed,
+                                        absl::nullopt, absl::nullopt);
+          if (measure) {
+            state_.ResumeTiming();
+          }
+          worker_priority_set.updateHosts(priority, std::move(params),
+                                          host_set->localityWeights(), hosts_added,
+                                          hosts_removed, absl::nullopt, absl::nullopt);
+          if (measure) {
+            state_.PauseTiming();
+          }
+        });
+    envoy::config::cluster::v3::Cluster::CommonLbConfig common_config;
+    RoundRobinLoadBalancer lb(worker_priority_set, nullptr, lb_stats, runtime_, random_,
+                              common_config, absl::nullopt, server_context_.timeSystem());
+
+    sendWeightedHosts(0, num_hosts);
+    measure = true;
+    for (size_t update = 1; update <= num_updates; ++update) {
+      sendWeightedHosts(update * num_changed_hosts, num_hosts);
+    }
+    ASSERT(worker_priority_set.hostSetsPerPriority()[0]->hosts().size() == num_hosts);
+    state_.ResumeTiming();
+  }
+
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
   Stats::TestUtil::TestStore& stats_ = server_context_.store_;
 
@@ -181,6 +268,7 @@ public:
       Config::OpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>>(
       validation_visitor_, "cluster_name")};
   NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
   ProtobufMessage::MockValidationVisitor validation_visitor_;
   Grpc::MockAsyncClient* async_client_;
@@ -241,3 +329,22 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures the cost of 10 EDS updates which each replace 100 of the weighted hosts of a cluster on
+// a worker, with and without host set deltas.
+static void workerMembershipUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    const uint32_t endpoints = skipExpensiveBenchmarks() ? 200 : state.range(0);
+
+    speed_test.workerUpdateHelper(endpoints, 100, 10, state.range(1));
+  }
+}
+
+BENCHMARK(workerMembershipUpdate)
+    ->Args({50000, false})
+    ->Args({50000, true})
+    ->Unit(benchmark::kMillisecond);
@@ -14,6 +14,8 @@ TEST(Coverage, CacheEntryStatusString) {
   EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::Ok), "Ok");
   EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::Unusable), "Unusable");
   EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::RequiresValidation), "RequiresValidation");
+  EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::StaleWhileRevalidate),
+            "StaleWhileRevalidate");
   EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::FoundNotModified), "FoundNotModified");
   EXPECT_EQ(cacheEntryStatusString(CacheEntryStatus::LookupError), "LookupError");
   EXPECT_ENVOY_BUG(cacheEntryStatusString(static_cast<CacheEntryStatus>(99)),
@@ -18,6 +18,10 @@ TEST(Coverage, LookupStatusToString) {
             "StaleHitWithSuccessfulValidation");
   EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitWithFailedValidation),
             "StaleHitWithFailedValidation");
+  EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitWhileRevalidating),
+            "StaleHitWhileRevalidating");
+  EXPECT_EQ(lookupStatusToString(LookupStatus::StaleHitWithValidationError),
+            "StaleHitWithValidationError");
   EXPECT_EQ(lookupStatusToString(LookupStatus::NotModifiedHit), "NotModifiedHit");
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestNotCacheable), "RequestNotCacheable");
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestIncomplete), "RequestIncomplete");
@@ -1,13 +1,17 @@
 #include "envoy/event/dispatcher.h"
 
 #include "source/common/http/headers.h"
+#include "source/common/http/message_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_filter.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
 
 #include "test/extensions/filters/http/cache/common.h"
 #include "test/extensions/filters/http/cache/mocks.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/server/factory_context.h"
+#include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/status_utility.h"
 #include "test/test_common/utility.h"
@@ -23,6 +27,8 @@ namespace Cache {
 namespace {
 
 using ::Envoy::StatusHelpers::IsOkAndHolds;
+using ::testing::_;
+using ::testing::Invoke;
 using ::testing::IsNull;
 using ::testing::NotNull;
 
@@ -30,10 +36,13 @@ class CacheFilterTest : public ::testing::Test {
 protected:
   // The filter has to be created as a shared_ptr to enable shared_from_this() which is used in the
   // cache callbacks.
-  CacheFilterSharedPtr makeFilter(std::shared_ptr<HttpCache> cache, bool auto_destroy = true) {
+  CacheFilterSharedPtr makeFilter(std::shared_ptr<HttpCache> cache, bool auto_destroy = true,
+                                  RequestCoalescerSharedPtr request_coalescer = nullptr,
+                                  BackgroundRevalidatorSharedPtr background_revalidator = nullptr) {
     std::shared_ptr<CacheFilter> filter(new CacheFilter(config_, /*stats_prefix=*/"",
                                                         context_.scope(), context_.timeSource(),
-                                                        cache),
+                                                        cache, std::move(request_coalescer),
+                                                        std::move(background_revalidator)),
                                         [auto_destroy](CacheFilter* f) {
                                           if (auto_destroy) {
                                             f->onDestroy();
@@ -162,7 +171,10 @@ protected:
 
   void waitBeforeSecondRequest() { time_source_.advanceTimeWait(delay_); }
 
-  std::shared_ptr<SimpleHttpCache> simple_cache_ = std::make_shared<SimpleHttpCache>();
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<SimpleHttpCache> simple_cache_ = std::make_shared<SimpleHttpCache>(
+      envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig(),
+      *stats_store_.rootScope());
   envoy::extensions::filters::http::cache::v3::CacheConfig config_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_ =
       std::make_shared<StreamInfo::FilterStateImpl>(StreamInfo::FilterState::LifeSpan::FilterChain);
@@ -220,7 +232,7 @@ TEST_F(CacheFilterTest, UncacheableResponse) {
   request_headers_.setHost("UncacheableResponse");
 
   // Responses with "Cache-Control: no-store" are uncacheable
-  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "no-store");
 
   for (int request = 1; request <= 2; request++) {
     // Create filter for the request.
@@ -1098,6 +1110,383 @@ TEST_F(CacheFilterTest, LocalReplyDuringLookup) {
   }
 }
 
+class CacheFilterCoalescingTest : public CacheFilterTest {
+protected:
+  void SetUp() override {
+    CacheFilterTest::SetUp();
+    ON_CALL(waiter_decoder_callbacks_, dispatcher())
+        .WillByDefault(::testing::ReturnRef(*dispatcher_));
+    ON_CALL(waiter_decoder_callbacks_.stream_info_, filterState())
+        .WillByDefault(::testing::ReturnRef(filter_state_));
+  }
+
+  // Starts a request which misses the cache while the request of leader_ is in flight.
+  CacheFilterSharedPtr makeWaiter() {
+    CacheFilterSharedPtr waiter = makeFilter(simple_cache_, true, coalescer_);
+    waiter->setDecoderFilterCallbacks(waiter_decoder_callbacks_);
+    EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    // The request waits for the fetch of the leader rather than going upstream.
+    EXPECT_CALL(waiter_decoder_callbacks_, continueDecoding).Times(0);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    ::testing::Mock::VerifyAndClearExpectations(&waiter_decoder_callbacks_);
+    return waiter;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(stats_store_, name)->value();
+  }
+
+  RequestCoalescerSharedPtr coalescer_ =
+      std::make_shared<RequestCoalescer>("cache.", *stats_store_.rootScope());
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_decoder_callbacks_;
+};
+
+TEST_F(CacheFilterCoalescingTest, WaiterServedFromCacheAfterFetch) {
+  request_headers_.setHost("WaiterServedFromCacheAfterFetch");
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_, true, coalescer_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeWaiter();
+  EXPECT_EQ(1, counter("cache.coalesced_requests"));
+
+  // Once the response of the leader has been inserted, the waiter is served from the cache.
+  EXPECT_CALL(waiter_decoder_callbacks_,
+              encodeHeaders_(IsSupersetOfHeaders(response_headers_), true));
+  EXPECT_CALL(waiter_decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  waiter->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  EXPECT_EQ(0, counter("cache.coalesced_wait_timeouts"));
+}
+
+TEST_F(CacheFilterCoalescingTest, WaiterFetchesUncacheableResponse) {
+  request_headers_.setHost("WaiterFetchesUncacheableResponse");
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_, true, coalescer_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeWaiter();
+
+  // The response of the leader is not inserted, so the waiter goes upstream itself.
+  EXPECT_CALL(waiter_decoder_callbacks_, continueDecoding);
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "no-store");
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+TEST_F(CacheFilterCoalescingTest, WaiterTimesOut) {
+  request_headers_.setHost("WaiterTimesOut");
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_, true, coalescer_);
+  testDecodeRequestMiss(leader);
+
+  CacheFilterSharedPtr waiter = makeWaiter();
+
+  // The default maximum wait is 5 seconds, after which the waiter goes upstream itself.
+  EXPECT_CALL(waiter_decoder_callbacks_, continueDecoding);
+  time_source_.advanceTimeAndRun(std::chrono::seconds(5), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, counter("cache.coalesced_wait_timeouts"));
+  ::testing::Mock::VerifyAndClearExpectations(&waiter_decoder_callbacks_);
+
+  // Completing the fetch no longer affects the waiter.
+  EXPECT_CALL(waiter_decoder_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+class CacheFilterStaleTest : public CacheFilterTest {
+protected:
+  void SetUp() override {
+    CacheFilterTest::SetUp();
+    cluster_manager_.initializeThreadLocalClusters({"fake_cluster"});
+    response_headers_.setReferenceKey(Http::CustomHeaders::get().Etag, etag_);
+  }
+
+  // Inserts response_headers_ with the given body, and waits until the response is stale.
+  void insertStaleResponse(const std::string& body) {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    Buffer::OwnedImpl buffer(body);
+    response_headers_.setContentLength(body.size());
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, false), Http::FilterHeadersStatus::Continue);
+    EXPECT_EQ(filter->encodeData(buffer, true), Http::FilterDataStatus::Continue);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    filter->onStreamComplete();
+    // The responses of these tests have a max-age of 10 seconds.
+    time_source_.advanceTimeWait(Seconds(20));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(stats_store_, name)->value();
+  }
+  uint64_t gauge(const std::string& name) {
+    return TestUtility::findGauge(stats_store_, name)->value();
+  }
+
+  const std::string etag_ = "abc123";
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  Http::MockAsyncClient& async_client_ = cluster_manager_.thread_local_cluster_.async_client_;
+  BackgroundRevalidatorSharedPtr revalidator_ = std::make_shared<BackgroundRevalidator>(
+      cluster_manager_, time_source_, config_.allowed_vary_headers(), "cache.",
+      *stats_store_.rootScope());
+};
+
+TEST_F(CacheFilterStaleTest, StaleWhileRevalidate) {
+  request_headers_.setHost("StaleWhileRevalidate");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-while-revalidate=60");
+  const std::string body = "abc";
+  insertStaleResponse(body);
+
+  Http::AsyncClient::Callbacks* revalidation_callbacks = nullptr;
+  NiceMock<Http::MockAsyncClientRequest> revalidation_request(&async_client_);
+  EXPECT_CALL(async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::RequestMessagePtr& request,
+                           Http::AsyncClient::Callbacks& callbacks,
+                           const Http::AsyncClient::RequestOptions&)
+                           -> Http::AsyncClient::Request* {
+        EXPECT_THAT(request->headers(),
+                    HeaderHasValueRef(Http::CustomHeaders::get().IfNoneMatch, etag_));
+        revalidation_callbacks = &callbacks;
+        return &revalidation_request;
+      }));
+  {
+    // The stale response is served without waiting for its validation.
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeHeaders_(HeaderHasValueRef(Http::CustomHeaders::get().Age, "20"), false));
+    EXPECT_CALL(
+        decoder_callbacks_,
+        encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+    EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWhileRevalidating));
+  }
+  ASSERT_NE(revalidation_callbacks, nullptr);
+  EXPECT_EQ(1, counter("cache.background_revalidations"));
+  EXPECT_EQ(1, gauge("cache.background_revalidations_active"));
+
+  // A 304 response freshens the cached response in place, once the stream which served it has
+  // completed.
+  Http::ResponseMessagePtr not_modified(new Http::ResponseMessageImpl(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{
+          {":status", "304"}, {"etag", etag_}, {"date", formatter_.now(time_source_)}}}));
+  revalidation_callbacks->onSuccess(revalidation_request, std::move(not_modified));
+  EXPECT_EQ(1, counter("cache.background_revalidations_not_modified"));
+  EXPECT_EQ(0, gauge("cache.background_revalidations_active"));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_CALL(async_client_, send_(_, _, _)).Times(0);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeHeaders_(IsSupersetOfHeaders(Http::TestResponseHeaderMapImpl{
+                                   {":status", "200"}, {"etag", etag_}}),
+                               false));
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  }
+}
+
+TEST_F(CacheFilterStaleTest, StaleWhileRevalidateModified) {
+  request_headers_.setHost("StaleWhileRevalidateModified");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-while-revalidate=60");
+  insertStaleResponse("abc");
+
+  Http::AsyncClient::Callbacks* revalidation_callbacks = nullptr;
+  NiceMock<Http::MockAsyncClientRequest> revalidation_request(&async_client_);
+  EXPECT_CALL(async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                           const Http::AsyncClient::RequestOptions&)
+                           -> Http::AsyncClient::Request* {
+        revalidation_callbacks = &callbacks;
+        return &revalidation_request;
+      }));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWhileRevalidating));
+  }
+  ASSERT_NE(revalidation_callbacks, nullptr);
+
+  // A modified response which is cacheable replaces the cached response.
+  const std::string new_body = "abcdef";
+  Http::ResponseMessagePtr modified(new Http::ResponseMessageImpl(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{
+          {":status", "200"},
+          {"etag", "def456"},
+          {"cache-control", "public,max-age=10"},
+          {"content-length", std::to_string(new_body.size())},
+          {"date", formatter_.now(time_source_)}}}));
+  modified->body().add(new_body);
+  revalidation_callbacks->onSuccess(revalidation_request, std::move(modified));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(1, counter("cache.background_revalidations_modified"));
+  EXPECT_EQ(1, counter("cache.background_revalidations_inserted"));
+  EXPECT_EQ(0, gauge("cache.background_revalidations_active"));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_CALL(async_client_, send_(_, _, _)).Times(0);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeHeaders_(IsSupersetOfHeaders(Http::TestResponseHeaderMapImpl{
+                                   {":status", "200"}, {"etag", "def456"}}),
+                               false));
+    EXPECT_CALL(
+        decoder_callbacks_,
+        encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(new_body)), true));
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  }
+}
+
+// The insert of a varied response reads the request headers of its lookup once the response is
+// complete, after the stream which started the validation is gone.
+TEST_F(CacheFilterStaleTest, StaleWhileRevalidateModifiedWithVary) {
+  config_.add_allowed_vary_headers()->set_exact("accept");
+  revalidator_ = std::make_shared<BackgroundRevalidator>(
+      cluster_manager_, time_source_, config_.allowed_vary_headers(), "cache.",
+      *stats_store_.rootScope());
+  request_headers_.setHost("StaleWhileRevalidateModifiedWithVary");
+  request_headers_.setCopy(Http::CustomHeaders::get().Accept, "text/plain");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-while-revalidate=60");
+  response_headers_.setCopy(Http::CustomHeaders::get().Vary, "accept");
+  insertStaleResponse("abc");
+
+  Http::AsyncClient::Callbacks* revalidation_callbacks = nullptr;
+  NiceMock<Http::MockAsyncClientRequest> revalidation_request(&async_client_);
+  EXPECT_CALL(async_client_, send_(_, _, _))
+      .WillOnce(Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                           const Http::AsyncClient::RequestOptions&)
+                           -> Http::AsyncClient::Request* {
+        revalidation_callbacks = &callbacks;
+        return &revalidation_request;
+      }));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWhileRevalidating));
+  }
+  ASSERT_NE(revalidation_callbacks, nullptr);
+
+  const std::string new_body = "abcdef";
+  Http::ResponseMessagePtr modified(new Http::ResponseMessageImpl(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{
+          {":status", "200"},
+          {"etag", "def456"},
+          {"vary", "accept"},
+          {"cache-control", "public,max-age=10"},
+          {"content-length", std::to_string(new_body.size())},
+          {"date", formatter_.now(time_source_)}}}));
+  modified->body().add(new_body);
+  revalidation_callbacks->onSuccess(revalidation_request, std::move(modified));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(1, counter("cache.background_revalidations_inserted"));
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_, true, nullptr, revalidator_);
+    EXPECT_CALL(async_client_, send_(_, _, _)).Times(0);
+    EXPECT_CALL(decoder_callbacks_,
+                encodeHeaders_(IsSupersetOfHeaders(Http::TestResponseHeaderMapImpl{
+                                   {":status", "200"}, {"etag", "def456"}}),
+                               false));
+    EXPECT_CALL(
+        decoder_callbacks_,
+        encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq(new_body)), true));
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+    filter->onStreamComplete();
+    EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  }
+}
+
+TEST_F(CacheFilterStaleTest, StaleWhileRevalidateWithoutRevalidator) {
+  request_headers_.setHost("StaleWhileRevalidateWithoutRevalidator");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-while-revalidate=60");
+  insertStaleResponse("abc");
+
+  // Without a revalidator, the stale response is validated before being served.
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filter);
+  EXPECT_THAT(request_headers_, HeaderHasValueRef(Http::CustomHeaders::get().IfNoneMatch, etag_));
+}
+
+TEST_F(CacheFilterStaleTest, StaleIfError) {
+  request_headers_.setHost("StaleIfError");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-if-error=60");
+  const std::string body = "abc";
+  insertStaleResponse(body);
+
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+  // The stale response is validated first.
+  testDecodeRequestMiss(filter);
+
+  // The validation fails with an error, so the stale response is served instead.
+  Http::TestResponseHeaderMapImpl error_response_headers = {{":status", "503"}};
+  EXPECT_EQ(filter->encodeHeaders(error_response_headers, false),
+            Http::FilterHeadersStatus::StopIteration);
+  EXPECT_THAT(error_response_headers, IsSupersetOfHeaders(response_headers_));
+
+  // The body of the error response is dropped.
+  Buffer::OwnedImpl error_body("upstream error");
+  EXPECT_EQ(filter->encodeData(error_body, true), Http::FilterDataStatus::StopIterationAndBuffer);
+  EXPECT_EQ(0, error_body.length());
+
+  EXPECT_CALL(
+      encoder_callbacks_,
+      addEncodedData(testing::Property(&Buffer::Instance::toString, testing::Eq(body)), true));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&encoder_callbacks_);
+
+  filter->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWithValidationError));
+}
+
+TEST_F(CacheFilterStaleTest, StaleIfErrorIgnoresNonErrorResponse) {
+  request_headers_.setHost("StaleIfErrorIgnoresNonErrorResponse");
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public,max-age=10,stale-if-error=60");
+  insertStaleResponse("abc");
+
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filter);
+
+  // A 404 is not an error per rfc5861, so it's passed through.
+  Http::TestResponseHeaderMapImpl not_found_response_headers = {{":status", "404"}};
+  EXPECT_EQ(filter->encodeHeaders(not_found_response_headers, true),
+            Http::FilterHeadersStatus::Continue);
+  EXPECT_EQ(not_found_response_headers.getStatusValue(), "404");
+
+  filter->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::StaleHitWithFailedValidation));
+}
+
 // Mark tests with EXPECT_ENVOY_BUG as death tests:
 // https://google.github.io/googletest/advanced.html#death-test-naming
 using CacheFilterDeathTest = CacheFilterTest;
@@ -1197,6 +1586,9 @@ TEST(LookupStatusTest, ResolveLookupStatusReturnsCorrectStatuses) {
   EXPECT_EQ(CacheFilter::resolveLookupStatus(CacheEntryStatus::RequiresValidation,
                                              FilterState::NotServingFromCache),
             LookupStatus::StaleHitWithFailedValidation);
+  EXPECT_EQ(CacheFilter::resolveLookupStatus(CacheEntryStatus::StaleWhileRevalidate,
+                                             FilterState::ResponseServedFromCache),
+            LookupStatus::StaleHitWhileRevalidating);
   EXPECT_EQ(
       CacheFilter::resolveLookupStatus(CacheEntryStatus::FoundNotModified, FilterState::Destroyed),
       LookupStatus::CacheHit);
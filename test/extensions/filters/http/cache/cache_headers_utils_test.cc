@@ -157,13 +157,17 @@ TEST_P(RequestCacheControlTest, RequestCacheControlTest) {
 
 struct TestResponseCacheControl : public ResponseCacheControl {
   TestResponseCacheControl(bool must_validate, bool no_store, bool no_transform, bool no_stale,
-                           bool is_public, OptionalDuration max_age) {
+                           bool is_public, OptionalDuration max_age,
+                           OptionalDuration stale_while_revalidate = absl::nullopt,
+                           OptionalDuration stale_if_error = absl::nullopt) {
     must_validate_ = must_validate;
     no_store_ = no_store;
     no_transform_ = no_transform;
     no_stale_ = no_stale;
     is_public_ = is_public;
     max_age_ = max_age;
+    stale_while_revalidate_ = stale_while_revalidate;
+    stale_if_error_ = stale_if_error;
   }
 };
 
@@ -286,6 +290,19 @@ public:
           // {must_validate_, no_store_, no_transform_, no_stale_, is_public_, max_age_}
           {true, true, false, false, false, Seconds(10)}
         },
+        // Stale response extensions: https://httpwg.org/specs/rfc5861.html
+        {
+          "max-age=600, stale-while-revalidate=30, stale-if-error=86400",
+          // {must_validate_, no_store_, no_transform_, no_stale_, is_public_, max_age_,
+          //  stale_while_revalidate_, stale_if_error_}
+          {false, false, false, false, false, Seconds(600), Seconds(30), Seconds(86400)}
+        },
+        {
+          "max-age=600, stale-while-revalidate=\"30\", stale-if-error=forever",
+          // {must_validate_, no_store_, no_transform_, no_stale_, is_public_, max_age_,
+          //  stale_while_revalidate_, stale_if_error_}
+          {false, false, false, false, false, Seconds(600), Seconds(30), absl::nullopt}
+        },
     );
     // clang-format on
   }
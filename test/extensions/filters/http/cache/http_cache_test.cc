@@ -165,6 +165,42 @@ public:
                             /*response_date=*/currentTime(),
                             /*expected_result=*/CacheEntryStatus::Ok,
                             /*expected_age=*/"999"},
+                           {"expired_stale_while_revalidate_satisfied",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1500),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::StaleWhileRevalidate,
+                            /*expected_age=*/"1500"},
+                           {"expired_stale_while_revalidate_unsatisfied",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1501),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1501"},
+                           {"expired_stale_while_revalidate_satisfied_but_must_revalidate",
+                            /*request_cache_control=*/"",
+                            /*response_cache_control=*/
+                            "max-age=1000, stale-while-revalidate=500, must-revalidate",
+                            /*request_time=*/currentTime() + Seconds(1001),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1001"},
+                           {"expired_stale_while_revalidate_satisfied_but_request_no_cache",
+                            /*request_cache_control=*/"no-cache",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1001),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::RequiresValidation,
+                            /*expected_age=*/"1001"},
+                           {"expired_max_stale_and_stale_while_revalidate_satisfied",
+                            /*request_cache_control=*/"max-stale=500",
+                            /*response_cache_control=*/"max-age=1000, stale-while-revalidate=500",
+                            /*request_time=*/currentTime() + Seconds(1001),
+                            /*response_date=*/currentTime(),
+                            /*expected_result=*/CacheEntryStatus::Ok,
+                            /*expected_age=*/"1001"},
 
     );
   }
@@ -224,6 +260,46 @@ TEST_P(LookupRequestTest, ResultWithBodyMatchesExpectation) {
   EXPECT_FALSE(lookup_response.has_trailers_);
 }
 
+TEST_F(LookupRequestTest, StaleIfError) {
+  const LookupRequest lookup_request(request_headers_, currentTime() + Seconds(1500),
+                                     vary_allow_list_);
+  {
+    // Fresh responses are served without validation, so never served on error.
+    const LookupRequest fresh_lookup_request(request_headers_, currentTime() + Seconds(999),
+                                             vary_allow_list_);
+    const LookupResult lookup_response = makeLookupResult(
+        fresh_lookup_request,
+        Http::TestResponseHeaderMapImpl({{"cache-control", "max-age=1000, stale-if-error=500"},
+                                         {"date", formatter_.fromTime(currentTime())}}));
+    EXPECT_EQ(CacheEntryStatus::Ok, lookup_response.cache_entry_status_);
+    EXPECT_FALSE(lookup_response.serve_stale_if_error_);
+  }
+  {
+    const LookupResult lookup_response = makeLookupResult(
+        lookup_request,
+        Http::TestResponseHeaderMapImpl({{"cache-control", "max-age=1000, stale-if-error=500"},
+                                         {"date", formatter_.fromTime(currentTime())}}));
+    EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+    EXPECT_TRUE(lookup_response.serve_stale_if_error_);
+  }
+  {
+    const LookupResult lookup_response = makeLookupResult(
+        lookup_request,
+        Http::TestResponseHeaderMapImpl({{"cache-control", "max-age=1000, stale-if-error=499"},
+                                         {"date", formatter_.fromTime(currentTime())}}));
+    EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+    EXPECT_FALSE(lookup_response.serve_stale_if_error_);
+  }
+  {
+    const LookupResult lookup_response = makeLookupResult(
+        lookup_request, Http::TestResponseHeaderMapImpl(
+                            {{"cache-control", "max-age=1000, stale-if-error=500, must-revalidate"},
+                             {"date", formatter_.fromTime(currentTime())}}));
+    EXPECT_EQ(CacheEntryStatus::RequiresValidation, lookup_response.cache_entry_status_);
+    EXPECT_FALSE(lookup_response.serve_stale_if_error_);
+  }
+}
+
 TEST_F(LookupRequestTest, ExpiredViaFallbackheader) {
   const LookupRequest lookup_request(request_headers_, currentTime(), vary_allow_list_);
   const Http::TestResponseHeaderMapImpl response_headers(
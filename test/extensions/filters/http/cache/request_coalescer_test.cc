@@ -0,0 +1,103 @@
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class RequestCoalescerTest : public testing::Test {
+protected:
+  RequestCoalescerTest()
+      : coalescer_(std::make_shared<RequestCoalescer>("cache.", *store_.rootScope())) {
+    key_.set_host("example.com");
+    key_.set_path("/foo");
+    other_key_.set_host("example.com");
+    other_key_.set_path("/bar");
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, name)->value();
+  }
+  uint64_t waiting() {
+    return TestUtility::findGauge(store_, "cache.coalesced_requests_waiting")->value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  RequestCoalescerSharedPtr coalescer_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Key key_;
+  Key other_key_;
+};
+
+TEST_F(RequestCoalescerTest, FirstRequestLeads) {
+  CoalescedRequestPtr leader = coalescer_->join(key_, dispatcher_, []() { FAIL(); });
+  EXPECT_TRUE(leader->leader());
+  // A request for another key leads its own fetch.
+  CoalescedRequestPtr other = coalescer_->join(other_key_, dispatcher_, []() { FAIL(); });
+  EXPECT_TRUE(other->leader());
+  EXPECT_EQ(0, counter("cache.coalesced_requests"));
+  EXPECT_EQ(0, waiting());
+}
+
+TEST_F(RequestCoalescerTest, WaitersNotifiedOnCompletion) {
+  CoalescedRequestPtr leader = coalescer_->join(key_, dispatcher_, []() { FAIL(); });
+  int completed = 0;
+  CoalescedRequestPtr waiter1 = coalescer_->join(key_, dispatcher_, [&]() { ++completed; });
+  CoalescedRequestPtr waiter2 = coalescer_->join(key_, dispatcher_, [&]() { ++completed; });
+  EXPECT_FALSE(waiter1->leader());
+  EXPECT_FALSE(waiter2->leader());
+  EXPECT_EQ(2, counter("cache.coalesced_requests"));
+  EXPECT_EQ(2, waiting());
+
+  // The waiters are notified through their dispatcher.
+  EXPECT_CALL(dispatcher_, post(_)).Times(2);
+  leader.reset();
+  EXPECT_EQ(2, completed);
+  EXPECT_EQ(0, waiting());
+
+  // Destroying a notified waiter has no effect.
+  waiter1.reset();
+  EXPECT_EQ(0, waiting());
+
+  // The next request leads a new fetch.
+  EXPECT_TRUE(coalescer_->join(key_, dispatcher_, []() { FAIL(); })->leader());
+}
+
+TEST_F(RequestCoalescerTest, WaiterLeaves) {
+  CoalescedRequestPtr leader = coalescer_->join(key_, dispatcher_, []() { FAIL(); });
+  CoalescedRequestPtr waiter = coalescer_->join(key_, dispatcher_, []() { FAIL(); });
+  EXPECT_EQ(1, waiting());
+
+  waiter.reset();
+  EXPECT_EQ(0, waiting());
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  leader.reset();
+}
+
+TEST_F(RequestCoalescerTest, RequestOutlivesCoalescer) {
+  CoalescedRequestPtr leader = coalescer_->join(key_, dispatcher_, []() { FAIL(); });
+  bool completed = false;
+  CoalescedRequestPtr waiter = coalescer_->join(key_, dispatcher_, [&]() { completed = true; });
+
+  // The requests keep the coalescer alive.
+  coalescer_.reset();
+  leader.reset();
+  EXPECT_TRUE(completed);
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
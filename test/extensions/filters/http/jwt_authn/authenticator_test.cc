@@ -1030,10 +1030,10 @@ TEST_F(AuthenticatorJwtCacheTest, TestCacheHit) {
 
   createAuthenticator("provider");
 
-  ::google::jwt_verify::Jwt cached_jwt;
-  cached_jwt.parseFromString(GoodToken);
+  auto cached_jwt = std::make_shared<::google::jwt_verify::Jwt>();
+  cached_jwt->parseFromString(GoodToken);
   // jwt_cache hit: lookup return a cached jwt.
-  EXPECT_CALL(jwks_cache_.jwks_data_.jwt_cache_, lookup(_)).WillOnce(Return(&cached_jwt));
+  EXPECT_CALL(jwks_cache_.jwks_data_.jwt_cache_, lookup(_)).WillOnce(Return(cached_jwt));
   // jwt_cache insert is not called.
   EXPECT_CALL(jwks_cache_.jwks_data_.jwt_cache_, insert(_, _)).Times(0);
 
@@ -9,6 +9,8 @@
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 using ::google::jwt_verify::Status;
 
 namespace Envoy {
@@ -19,21 +21,22 @@ namespace {
 
 class JwtCacheTest : public testing::Test {
 public:
-  void setupCache(bool enable) {
+  void setupCache(bool enable, uint32_t size = 0) {
     envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig config;
-    config.set_jwt_cache_size(0);
+    config.set_jwt_cache_size(size);
     cache_ = JwtCache::create(enable, config, time_system_);
   }
 
   void loadJwt(const char* jwt_str) {
-    jwt_ = std::make_unique<::google::jwt_verify::Jwt>();
-    Status status = jwt_->parseFromString(jwt_str);
+    auto jwt = std::make_shared<::google::jwt_verify::Jwt>();
+    Status status = jwt->parseFromString(jwt_str);
     EXPECT_EQ(status, Status::Ok);
+    jwt_ = std::move(jwt);
   }
 
   Event::SimulatedTimeSystem time_system_;
   JwtCachePtr cache_;
-  std::unique_ptr<::google::jwt_verify::Jwt> jwt_;
+  JwtConstSharedPtr jwt_;
 };
 
 TEST_F(JwtCacheTest, TestEnabledCache) {
@@ -41,16 +44,13 @@ TEST_F(JwtCacheTest, TestEnabledCache) {
   setupCache(true);
   loadJwt(GoodToken);
 
-  auto* origin_jwt = jwt_.get();
-  cache_->insert(GoodToken, std::move(jwt_));
-  // jwt ownership is moved into the cache.
-  EXPECT_FALSE(jwt_);
+  cache_->insert(GoodToken, jwt_);
 
-  auto* jwt1 = cache_->lookup(GoodToken);
+  auto jwt1 = cache_->lookup(GoodToken);
   EXPECT_TRUE(jwt1 != nullptr);
-  EXPECT_EQ(jwt1, origin_jwt);
+  EXPECT_EQ(jwt1, jwt_);
 
-  auto* jwt2 = cache_->lookup(ExpiredToken);
+  auto jwt2 = cache_->lookup(ExpiredToken);
   EXPECT_TRUE(jwt2 == nullptr);
 }
 
@@ -59,11 +59,9 @@ TEST_F(JwtCacheTest, TestDisabledCache) {
   setupCache(false);
   loadJwt(GoodToken);
 
-  cache_->insert(GoodToken, std::move(jwt_));
-  // jwt ownership is not moved into the cache.
-  EXPECT_TRUE(jwt_);
+  cache_->insert(GoodToken, jwt_);
 
-  auto* jwt = cache_->lookup(GoodToken);
+  auto jwt = cache_->lookup(GoodToken);
   // not found since cache is disabled.
   EXPECT_TRUE(jwt == nullptr);
 }
@@ -73,13 +71,53 @@ TEST_F(JwtCacheTest, TestExpiredToken) {
   setupCache(true);
   loadJwt(ExpiredToken);
 
-  cache_->insert(ExpiredToken, std::move(jwt_));
+  cache_->insert(ExpiredToken, jwt_);
 
-  auto* jwt = cache_->lookup(ExpiredToken);
+  auto jwt = cache_->lookup(ExpiredToken);
   // not be found since it is expired.
   EXPECT_TRUE(jwt == nullptr);
 }
 
+TEST_F(JwtCacheTest, TestEvictLeastRecentlyUsed) {
+  // setup a cache of one entry
+  setupCache(true, 1);
+  loadJwt(GoodToken);
+  cache_->insert(GoodToken, jwt_);
+  auto good_jwt = cache_->lookup(GoodToken);
+  EXPECT_EQ(good_jwt, jwt_);
+
+  loadJwt(OtherGoodToken);
+  cache_->insert(OtherGoodToken, jwt_);
+  EXPECT_EQ(cache_->lookup(OtherGoodToken), jwt_);
+  // The evicted jwt is still owned by the caller which looked it up.
+  EXPECT_TRUE(cache_->lookup(GoodToken) == nullptr);
+  EXPECT_EQ(good_jwt.use_count(), 1);
+}
+
+// A cache of the default size is not split into shards which evict before the cache is full.
+TEST_F(JwtCacheTest, TestDefaultSizeHoldsAllEntries) {
+  setupCache(true);
+  loadJwt(GoodToken);
+  for (int i = 0; i < 100; ++i) {
+    cache_->insert(absl::StrCat("token", i), jwt_);
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(cache_->lookup(absl::StrCat("token", i)), jwt_) << i;
+  }
+}
+
+// A token verified by several threads concurrently is cached once, by the first insert.
+TEST_F(JwtCacheTest, TestInsertCachedToken) {
+  setupCache(true);
+  loadJwt(GoodToken);
+  const JwtConstSharedPtr first_jwt = jwt_;
+  cache_->insert(GoodToken, first_jwt);
+
+  loadJwt(GoodToken);
+  cache_->insert(GoodToken, jwt_);
+  EXPECT_EQ(cache_->lookup(GoodToken), first_jwt);
+}
+
 } // namespace
 } // namespace JwtAuthn
 } // namespace HttpFilters
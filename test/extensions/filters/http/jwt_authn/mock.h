@@ -64,8 +64,8 @@ public:
 
 class MockJwtCache : public JwtCache {
 public:
-  MOCK_METHOD(::google::jwt_verify::Jwt*, lookup, (const std::string&), ());
-  MOCK_METHOD(void, insert, (const std::string&, std::unique_ptr<::google::jwt_verify::Jwt>&&), ());
+  MOCK_METHOD(JwtConstSharedPtr, lookup, (const std::string&), ());
+  MOCK_METHOD(void, insert, (const std::string&, const JwtConstSharedPtr&), ());
 };
 
 class MockJwksData : public JwksCache::JwksData {
@@ -192,6 +192,7 @@ class ConfigBufferSizeGTSingleRequest : public Config {
   ReadPolicy readPolicy() const override { return ReadPolicy::Primary; }
   bool connectionRateLimitEnabled() const override { return false; }
   uint32_t connectionRateLimitPerSec() const override { return 0; }
+  uint32_t connectionsPerHost() const override { return 1; }
 };
 
 TEST_F(RedisClientImplTest, BatchWithTimerFiring) {
@@ -287,6 +288,66 @@ TEST_F(RedisClientImplTest, BatchWithTimerCancelledByBufferFlush) {
   client_->close();
 }
 
+class ConfigBufferSizeGTSingleRequestNoTimeout : public ConfigBufferSizeGTSingleRequest {
+  unsigned int maxBufferSizeBeforeFlush() const override { return 64; }
+  std::chrono::milliseconds bufferFlushTimeoutInMs() const override {
+    return std::chrono::milliseconds(0);
+  }
+};
+
+TEST_F(RedisClientImplTest, BatchFlushedAtEndOfIteration) {
+  // With a zero flush timeout, the requests made during an event loop iteration are flushed
+  // together at the end of the iteration, without the flush timer.
+  Event::MockSchedulableCallback* flush_cb = new Event::MockSchedulableCallback(&dispatcher_);
+  InSequence s;
+
+  setup(std::make_unique<ConfigBufferSizeGTSingleRequestNoTimeout>());
+
+  // The first request schedules the flush.
+  Common::Redis::RespValue request1;
+  MockClientCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  PoolRequest* handle1 = client_->makeRequest(request1, callbacks1);
+  EXPECT_NE(nullptr, handle1);
+
+  // The second request is added to the same batch.
+  Common::Redis::RespValue request2;
+  MockClientCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _));
+  PoolRequest* handle2 = client_->makeRequest(request2, callbacks2);
+  EXPECT_NE(nullptr, handle2);
+
+  // Both requests are written at once at the end of the iteration.
+  EXPECT_CALL(*flush_cb, cancel());
+  EXPECT_CALL(*upstream_connection_, write(_, false));
+  flush_cb->invokeCallback();
+
+  // Process the dummy requests
+  Buffer::OwnedImpl fake_data;
+  EXPECT_CALL(*decoder_, decode(Ref(fake_data))).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    InSequence s;
+    Common::Redis::RespValuePtr response1(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks1, onResponse_(Ref(response1)));
+    EXPECT_CALL(*connect_or_op_timer_, enableTimer(_, _));
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response1));
+
+    Common::Redis::RespValuePtr response2(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks2, onResponse_(Ref(response2)));
+    EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response2));
+  }));
+  upstream_read_filter_->onData(fake_data, false);
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  client_->close();
+}
+
 TEST_F(RedisClientImplTest, Basic) {
   InSequence s;
 
@@ -339,6 +400,55 @@ TEST_F(RedisClientImplTest, Basic) {
   client_->close();
 }
 
+class MockPushCallbacks : public PushCallbacks {
+public:
+  void onPushValue(Common::Redis::RespValuePtr&& value) override { onPushValue_(value); }
+
+  MOCK_METHOD(void, onPushValue_, (Common::Redis::RespValuePtr & value));
+};
+
+// Values received while there are no pending requests are passed to the push callbacks.
+TEST_F(RedisClientImplTest, PushValues) {
+  InSequence s;
+
+  setup();
+
+  MockPushCallbacks push_callbacks;
+  client_->setPushCallbacks(push_callbacks);
+  client_->initialize(auth_username_, auth_password_);
+
+  Common::Redis::RespValue request;
+  MockClientCallbacks callbacks;
+  EXPECT_CALL(*encoder_, encode(Ref(request), _));
+  EXPECT_CALL(*flush_timer_, enabled()).WillOnce(Return(false));
+  PoolRequest* handle = client_->makeRequest(request, callbacks);
+  EXPECT_NE(nullptr, handle);
+
+  onConnected();
+
+  Buffer::OwnedImpl fake_data;
+  EXPECT_CALL(*decoder_, decode(Ref(fake_data))).WillOnce(Invoke([&](Buffer::Instance&) -> void {
+    InSequence s;
+    Common::Redis::RespValuePtr response(new Common::Redis::RespValue());
+    EXPECT_CALL(callbacks, onResponse_(Ref(response)));
+    EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+    EXPECT_CALL(host_->outlier_detector_,
+                putResult(Upstream::Outlier::Result::ExtOriginRequestSuccess, _));
+    callbacks_->onRespValue(std::move(response));
+
+    Common::Redis::RespValuePtr push_value(new Common::Redis::RespValue());
+    EXPECT_CALL(push_callbacks, onPushValue_(Ref(push_value)));
+    callbacks_->onRespValue(std::move(push_value));
+  }));
+  upstream_read_filter_->onData(fake_data, false);
+
+  EXPECT_EQ(1UL, host_->cluster_.traffic_stats_->upstream_rq_total_.value());
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  client_->close();
+}
+
 class ConfigEnableCommandStats : public Config {
   bool disableOutlierEvents() const override { return false; }
   std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
@@ -353,6 +463,7 @@ class ConfigEnableCommandStats : public Config {
   bool enableCommandStats() const override { return true; }
   bool connectionRateLimitEnabled() const override { return false; }
   uint32_t connectionRateLimitPerSec() const override { return 0; }
+  uint32_t connectionsPerHost() const override { return 1; }
 };
 
 void initializeRedisSimpleCommand(Common::Redis::RespValue* request, std::string command_name,
@@ -741,6 +852,7 @@ class ConfigOutlierDisabled : public Config {
   bool enableCommandStats() const override { return false; }
   bool connectionRateLimitEnabled() const override { return false; }
   uint32_t connectionRateLimitPerSec() const override { return 0; }
+  uint32_t connectionsPerHost() const override { return 1; }
 };
 
 TEST_F(RedisClientImplTest, OutlierDisabled) {
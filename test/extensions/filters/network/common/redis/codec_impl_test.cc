@@ -6,6 +6,7 @@
 
 #include "test/extensions/filters/network/common/redis/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -162,6 +163,34 @@ TEST_F(RedisRespValueTest, MoveOperationsTest) {
   verifyMoves(composite_array_empty);
 }
 
+TEST_F(RedisRespValueTest, BufferedBulkStringTest) {
+  RespValue value;
+  value.type(RespType::BulkString);
+  EXPECT_EQ(nullptr, value.buffer());
+  auto buffer = std::make_shared<Buffer::OwnedImpl>("foo");
+  value.buffer(buffer);
+  EXPECT_EQ(buffer, value.buffer());
+
+  // Copies share the buffer.
+  RespValue copy = value;
+  EXPECT_EQ(buffer, copy.buffer());
+  RespValue move(std::move(copy));
+  EXPECT_EQ(buffer, move.buffer());
+  RespValue move_assign;
+  move_assign = std::move(move);
+  EXPECT_EQ(buffer, move_assign.buffer());
+
+  // Reading the value as a string copies the buffer into it.
+  EXPECT_EQ("foo", move_assign.asString());
+  EXPECT_EQ(nullptr, move_assign.buffer());
+  EXPECT_EQ(buffer, value.buffer());
+  EXPECT_EQ("\"foo\"", value.toString());
+  EXPECT_EQ(nullptr, value.buffer());
+  EXPECT_EQ("foo", buffer->toString());
+
+  verifyMoves(value);
+}
+
 TEST_F(RedisRespValueTest, SwapTest) {
   InSequence s;
 
@@ -275,6 +304,69 @@ TEST_F(RedisEncoderDecoderImplTest, BulkString) {
   EXPECT_EQ(0UL, buffer_.length());
 }
 
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkString) {
+  RespValue value;
+  value.type(RespType::BulkString);
+  value.asString() = std::string(DecoderImpl::DefaultMinBufferedBulkStringSize, 'a');
+  encoder_.encode(value, buffer_);
+  encoder_.encode(value, buffer_);
+  decoder_.decode(buffer_);
+  EXPECT_EQ(0UL, buffer_.length());
+  ASSERT_EQ(2UL, decoded_values_.size());
+
+  // The contents are held in a buffer, which is encoded without copying it.
+  std::shared_ptr<const Buffer::Instance> decoded_buffer = decoded_values_[0]->buffer();
+  ASSERT_NE(nullptr, decoded_buffer);
+  Buffer::OwnedImpl encoded;
+  encoder_.encode(*decoded_values_[0], encoded);
+  EXPECT_EQ(decoded_buffer->frontSlice().mem_, encoded.getRawSlices()[1].mem_);
+  decoded_values_[0].reset();
+  EXPECT_EQ(fmt::format("${}\r\n{}\r\n", value.asString().size(), value.asString()),
+            encoded.toString());
+
+  EXPECT_NE(nullptr, decoded_values_[1]->buffer());
+  EXPECT_EQ(value, *decoded_values_[1]);
+}
+
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringInArraySplitAcrossDecodes) {
+  DecoderImpl decoder(*this, 4);
+  RespValue value;
+  std::vector<RespValue> values(3);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = "set";
+  values[1].type(RespType::BulkString);
+  values[1].asString() = "key";
+  values[2].type(RespType::BulkString);
+  values[2].asString() = "buffered value";
+  value.type(RespType::Array);
+  value.asArray().swap(values);
+  encoder_.encode(value, buffer_);
+
+  // Decode a byte at a time.
+  const std::string encoded = buffer_.toString();
+  buffer_.drain(buffer_.length());
+  for (const char c : encoded) {
+    buffer_.add(&c, 1);
+    decoder.decode(buffer_);
+    EXPECT_EQ(0UL, buffer_.length());
+  }
+  ASSERT_EQ(1UL, decoded_values_.size());
+  EXPECT_EQ(nullptr, decoded_values_[0]->asArray()[1].buffer());
+  EXPECT_NE(nullptr, decoded_values_[0]->asArray()[2].buffer());
+  EXPECT_EQ(value, *decoded_values_[0]);
+}
+
+TEST_F(RedisEncoderDecoderImplTest, BufferedBulkStringDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.redis_buffered_bulk_strings", "false"}});
+  DecoderImpl decoder(*this, 4);
+  buffer_.add("$14\r\nbuffered value\r\n");
+  decoder.decode(buffer_);
+  ASSERT_EQ(1UL, decoded_values_.size());
+  EXPECT_EQ(nullptr, decoded_values_[0]->buffer());
+  EXPECT_EQ("buffered value", decoded_values_[0]->asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, Integer) {
   RespValue value;
   value.type(RespType::Integer);
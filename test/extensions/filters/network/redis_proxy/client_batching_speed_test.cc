@@ -0,0 +1,128 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/network/common/redis/client_impl.h"
+#include "source/extensions/filters/network/common/redis/codec_impl.h"
+
+#include "test/extensions/filters/network/common/redis/test_utils.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/connection.h"
+#include "test/mocks/upstream/host.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+
+// Makes batches of small requests on an upstream client during one event loop iteration, and
+// counts the writes to the upstream connection.
+class ClientBatchingSpeedTest : public Common::Redis::Client::ClientCallbacks {
+public:
+  ClientBatchingSpeedTest(uint32_t max_buffer_size_before_flush) {
+    auto settings = Common::Redis::Client::createConnPoolSettings();
+    settings.set_max_buffer_size_before_flush(max_buffer_size_before_flush);
+    settings.mutable_buffer_flush_timeout()->CopyFrom(
+        Protobuf::util::TimeUtil::MillisecondsToDuration(0));
+    config_ = std::make_unique<Common::Redis::Client::ConfigImpl>(settings);
+
+    Upstream::MockHost::MockCreateConnectionData conn_info;
+    conn_info.connection_ = connection_;
+    ON_CALL(*host_, createConnection_(_, _)).WillByDefault(Return(conn_info));
+    ON_CALL(*connection_, addReadFilter(_)).WillByDefault(SaveArg<0>(&read_filter_));
+    ON_CALL(*connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          ++writes_;
+          data.drain(data.length());
+        }));
+    if (max_buffer_size_before_flush > 0) {
+      // Owned by the client.
+      flush_cb_ = new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    }
+
+    client_ = Common::Redis::Client::ClientImpl::create(
+        host_, dispatcher_, std::make_unique<Common::Redis::EncoderImpl>(), decoder_factory_,
+        *config_,
+        Common::Redis::RedisCommandStats::createRedisCommandStats(store_.symbolTable()),
+        *store_.rootScope(), false);
+    connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+    request_.type(Common::Redis::RespType::Array);
+    std::vector<Common::Redis::RespValue> values(2);
+    values[0].type(Common::Redis::RespType::BulkString);
+    values[0].asString() = "get";
+    values[1].type(Common::Redis::RespType::BulkString);
+    values[1].asString() = "key";
+    request_.asArray().swap(values);
+  }
+
+  ~ClientBatchingSpeedTest() override { client_->close(); }
+
+  void makeRequests(uint64_t num_requests) {
+    for (uint64_t i = 0; i < num_requests; ++i) {
+      client_->makeRequest(request_, *this);
+    }
+    // End of the event loop iteration.
+    if (flush_cb_ != nullptr && flush_cb_->enabled()) {
+      flush_cb_->invokeCallback();
+    }
+
+    Buffer::OwnedImpl responses;
+    for (uint64_t i = 0; i < num_requests; ++i) {
+      responses.add("+OK\r\n");
+    }
+    read_filter_->onData(responses, false);
+  }
+
+  // Common::Redis::Client::ClientCallbacks
+  void onResponse(Common::Redis::RespValuePtr&&) override {}
+  void onFailure() override {}
+  void onRedirection(Common::Redis::RespValuePtr&&, const std::string&, bool) override {}
+
+  uint64_t writes_{};
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{new NiceMock<Upstream::MockHost>()};
+  NiceMock<Network::MockClientConnection>* connection_{
+      new NiceMock<Network::MockClientConnection>()};
+  Network::ReadFilterSharedPtr read_filter_;
+  Event::MockSchedulableCallback* flush_cb_{};
+  Common::Redis::DecoderFactoryImpl decoder_factory_;
+  std::unique_ptr<Common::Redis::Client::ConfigImpl> config_;
+  Common::Redis::Client::ClientPtr client_;
+  Common::Redis::RespValue request_;
+};
+
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
+
+// Makes batches of state.range(0) requests with a buffer of state.range(1) bytes, zero disabling
+// batching.
+static void bmClientBatching(benchmark::State& state) {
+  Envoy::Extensions::NetworkFilters::RedisProxy::ClientBatchingSpeedTest context(state.range(1));
+  uint64_t requests = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    context.makeRequests(state.range(0));
+    requests += state.range(0);
+  }
+  state.counters["writes_per_request"] = static_cast<double>(context.writes_) / requests;
+}
+BENCHMARK(bmClientBatching)->ArgsProduct({{1, 16, 256}, {0, 1024, 16384}});
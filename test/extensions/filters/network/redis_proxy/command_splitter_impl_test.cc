@@ -18,6 +18,7 @@
 #include "test/test_common/simulated_time_system.h"
 
 using testing::_;
+using testing::ByMove;
 using testing::DoAll;
 using testing::InSequence;
 using testing::NiceMock;
@@ -406,6 +407,29 @@ TEST_F(RedisSingleServerRequestTest, PingSuccess) {
   EXPECT_EQ(nullptr, handle_);
 };
 
+// A GET of a key in the near cache of the pool is responded to without making a request.
+TEST_F(RedisSingleServerRequestTest, GetCached) {
+  InSequence s;
+
+  Common::Redis::RespValuePtr request{new Common::Redis::RespValue()};
+  makeBulkStringArray(*request, {"GET", "hello"});
+
+  auto cached_response = std::make_unique<Common::Redis::RespValue>();
+  cached_response->type(Common::Redis::RespType::BulkString);
+  cached_response->asString() = "world";
+  Common::Redis::RespValue response = *cached_response;
+
+  EXPECT_CALL(callbacks_, connectionAllowed()).WillOnce(Return(true));
+  EXPECT_CALL(*conn_pool_, cachedResponse("hello"))
+      .WillOnce(Return(ByMove(std::move(cached_response))));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&response)));
+  handle_ = splitter_.makeRequest(std::move(request), callbacks_, dispatcher_, stream_info_);
+  EXPECT_EQ(nullptr, handle_);
+
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.get.total").value());
+  EXPECT_EQ(1UL, store_.counter("redis.foo.command.get.success").value());
+};
+
 TEST_F(RedisSingleServerRequestTest, Time) {
   InSequence s;
 
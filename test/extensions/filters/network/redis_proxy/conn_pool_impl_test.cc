@@ -27,6 +27,7 @@
 #include "test/mocks/upstream/host_set.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -93,11 +94,15 @@ public:
         std::make_shared<NiceMock<Extensions::Common::Redis::MockClusterRefreshManager>>();
     auto redis_command_stats =
         Common::Redis::RedisCommandStats::createRedisCommandStats(store_.symbolTable());
+    auto settings = Common::Redis::Client::createConnPoolSettings(
+        20, hashtagging, true, max_unknown_conns, read_policy_, redis_cx_rate_limit_per_sec);
+    settings.mutable_connections_per_host()->set_value(connections_per_host_);
+    if (near_cache_.has_value()) {
+      settings.mutable_near_cache()->CopyFrom(near_cache_.value());
+    }
     std::shared_ptr<InstanceImpl> conn_pool_impl = std::make_shared<InstanceImpl>(
-        cluster_name_, cm_, *this, tls_,
-        Common::Redis::Client::createConnPoolSettings(20, hashtagging, true, max_unknown_conns,
-                                                      read_policy_, redis_cx_rate_limit_per_sec),
-        api_, store_.rootScope(), redis_command_stats, cluster_refresh_manager_, dns_cache);
+        cluster_name_, cm_, *this, tls_, settings, api_, store_.rootScope(), redis_command_stats,
+        cluster_refresh_manager_, dns_cache);
     conn_pool_impl->init();
     // Set the authentication password for this connection pool.
     conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_username_ = auth_username_;
@@ -175,7 +180,7 @@ public:
     return conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_password_;
   }
 
-  absl::node_hash_map<Upstream::HostConstSharedPtr, InstanceImpl::ThreadLocalActiveClientPtr>&
+  absl::node_hash_map<Upstream::HostConstSharedPtr, InstanceImpl::ThreadLocalActiveClients>&
   clientMap() {
     InstanceImpl* conn_pool_impl = dynamic_cast<InstanceImpl*>(conn_pool_.get());
     return conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().client_map_;
@@ -183,7 +188,9 @@ public:
 
   InstanceImpl::ThreadLocalActiveClient* clientMap(Upstream::HostConstSharedPtr host) {
     InstanceImpl* conn_pool_impl = dynamic_cast<InstanceImpl*>(conn_pool_.get());
-    return conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().client_map_[host].get();
+    auto& client_map = conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().client_map_;
+    auto clients = client_map.find(host);
+    return clients == client_map.end() ? nullptr : clients->second[0].get();
   }
 
   absl::node_hash_map<std::string, Upstream::HostConstSharedPtr>& hostAddressMap() {
@@ -232,6 +239,11 @@ public:
     return conn_pool_impl->redis_cluster_stats_.connection_rate_limited_;
   }
 
+  Stats::Counter& nearCacheTrackingFailed() {
+    InstanceImpl* conn_pool_impl = dynamic_cast<InstanceImpl*>(conn_pool_.get());
+    return conn_pool_impl->redis_cluster_stats_.near_cache_tracking_failed_;
+  }
+
   // Common::Redis::Client::ClientFactory
   Common::Redis::Client::ClientPtr create(Upstream::HostConstSharedPtr host, Event::Dispatcher&,
                                           const Common::Redis::Client::Config&,
@@ -332,6 +344,9 @@ public:
   std::shared_ptr<NiceMock<Extensions::Common::Redis::MockClusterRefreshManager>>
       cluster_refresh_manager_;
   Common::Redis::Client::NoOpTransaction transaction_;
+  uint32_t connections_per_host_{1};
+  absl::optional<envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::NearCache>
+      near_cache_;
 };
 
 TEST_F(RedisConnPoolImplTest, Basic) {
@@ -739,6 +754,239 @@ TEST_F(RedisConnPoolImplTest, HostRemove) {
   testing::Mock::AllowLeak(host2.get());
 }
 
+TEST_F(RedisConnPoolImplTest, ConnectionsPerHost) {
+  connections_per_host_ = 2;
+  setup();
+
+  // Find a key for each of the connections to the host.
+  std::string keys[2];
+  for (uint32_t i = 0; keys[0].empty() || keys[1].empty(); ++i) {
+    const std::string key = absl::StrCat("key", i);
+    std::string& key_for_index = keys[MurmurHash::murmurHash2(key) % 2];
+    if (key_for_index.empty()) {
+      key_for_index = key;
+    }
+  }
+
+  MockPoolCallbacks callbacks;
+  Common::Redis::RespValueSharedPtr value = std::make_shared<Common::Redis::RespValue>();
+  Common::Redis::Client::MockPoolRequest active_request;
+  Common::Redis::Client::MockClient* client1 = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* client2 = new NiceMock<Common::Redis::Client::MockClient>();
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillRepeatedly(Return(cm_.thread_local_cluster_.lb_.host_));
+  EXPECT_CALL(*cm_.thread_local_cluster_.lb_.host_, address())
+      .WillRepeatedly(Return(test_address_));
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client1)).WillOnce(Return(client2));
+
+  // The requests for a key are made on the same connection.
+  EXPECT_CALL(*client1, makeRequest_(Ref(*value), _))
+      .Times(2)
+      .WillRepeatedly(Return(&active_request));
+  EXPECT_CALL(*client2, makeRequest_(Ref(*value), _)).WillOnce(Return(&active_request));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest(keys[0], value, callbacks, transaction_));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest(keys[1], value, callbacks, transaction_));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest(keys[0], value, callbacks, transaction_));
+  EXPECT_EQ(clientMap().size(), 1);
+  EXPECT_EQ(clientMap()[cm_.thread_local_cluster_.lb_.host_].size(), 2);
+
+  // Removing the host closes both connections.
+  EXPECT_CALL(*client1, close());
+  EXPECT_CALL(*client2, close());
+  cm_.thread_local_cluster_.cluster_.prioritySet().getMockHostSet(0)->runCallbacks(
+      {}, {cm_.thread_local_cluster_.lb_.host_});
+  EXPECT_EQ(clientMap().size(), 0);
+
+  EXPECT_CALL(active_request, cancel()).Times(3);
+  EXPECT_CALL(callbacks, onFailure_()).Times(3);
+  tls_.shutdownThread();
+}
+
+Common::Redis::RespValue makeBulkStringArray(const std::vector<std::string>& strings) {
+  std::vector<Common::Redis::RespValue> values(strings.size());
+  for (size_t i = 0; i < strings.size(); ++i) {
+    values[i].type(Common::Redis::RespType::BulkString);
+    values[i].asString() = strings[i];
+  }
+  Common::Redis::RespValue array;
+  array.type(Common::Redis::RespType::Array);
+  array.asArray().swap(values);
+  return array;
+}
+
+Common::Redis::RespValuePtr makeBulkString(const std::string& string) {
+  auto value = std::make_unique<Common::Redis::RespValue>();
+  value->type(Common::Redis::RespType::BulkString);
+  value->asString() = string;
+  return value;
+}
+
+// Responses to GETs are cached once the invalidation client of the host is subscribed to the
+// invalidations of the keys, until the keys are invalidated.
+TEST_F(RedisConnPoolImplTest, NearCache) {
+  near_cache_.emplace();
+  near_cache_->set_max_bytes(1024);
+  near_cache_->mutable_ttl()->set_seconds(60);
+  near_cache_->add_key_prefixes("cached:");
+  setup();
+
+  MockPoolCallbacks callbacks;
+  Common::Redis::Client::MockPoolRequest active_request;
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* invalidation_client =
+      new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::PushCallbacks* push_callbacks{};
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillRepeatedly(Return(cm_.thread_local_cluster_.lb_.host_));
+  EXPECT_CALL(*cm_.thread_local_cluster_.lb_.host_, address())
+      .WillRepeatedly(Return(test_address_));
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client)).WillOnce(Return(invalidation_client));
+  EXPECT_CALL(*client, makeRequest_(_, _)).WillRepeatedly(Return(&active_request));
+  EXPECT_CALL(*invalidation_client, setPushCallbacks(_))
+      .WillOnce(SaveArgAddress(&push_callbacks));
+  EXPECT_CALL(*invalidation_client, makeRequest_(Eq(makeBulkStringArray({"CLIENT", "ID"})), _))
+      .WillOnce(Return(&active_request));
+
+  auto get = [&](const std::string& key) {
+    Common::Redis::RespValueSharedPtr request =
+        std::make_shared<Common::Redis::RespValue>(makeBulkStringArray({"get", key}));
+    EXPECT_NE(nullptr, conn_pool_->makeRequest(key, request, callbacks, transaction_));
+  };
+  auto respond = [&](const std::string& value) {
+    EXPECT_CALL(callbacks, onResponse_(_));
+    client->client_callbacks_.back()->onResponse(makeBulkString(value));
+  };
+
+  // The response is not cached until the invalidation client is subscribed.
+  get("cached:key");
+  respond("value1");
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("cached:key"));
+
+  auto client_id = std::make_unique<Common::Redis::RespValue>();
+  client_id->type(Common::Redis::RespType::Integer);
+  client_id->asInteger() = 7;
+  EXPECT_CALL(*invalidation_client,
+              makeRequest_(Eq(makeBulkStringArray({"CLIENT", "TRACKING", "ON", "REDIRECT", "7",
+                                                   "BCAST", "PREFIX", "cached:"})),
+                           _))
+      .WillOnce(Return(&active_request));
+  EXPECT_CALL(*invalidation_client,
+              makeRequest_(Eq(makeBulkStringArray({"SUBSCRIBE", "__redis__:invalidate"})), _))
+      .WillOnce(Return(&active_request));
+  invalidation_client->client_callbacks_.back()->onResponse(std::move(client_id));
+  auto ok = std::make_unique<Common::Redis::RespValue>();
+  ok->type(Common::Redis::RespType::SimpleString);
+  ok->asString() = "OK";
+  invalidation_client->client_callbacks_.back()->onResponse(std::move(ok));
+  invalidation_client->client_callbacks_.back()->onResponse(
+      std::make_unique<Common::Redis::RespValue>(
+          makeBulkStringArray({"subscribe", "__redis__:invalidate"})));
+
+  get("cached:key");
+  respond("value2");
+  Common::Redis::RespValuePtr cached = conn_pool_->cachedResponse("cached:key");
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ("value2", cached->asString());
+
+  // Keys without the prefixes are not cached.
+  get("other:key");
+  respond("value");
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("other:key"));
+
+  // A response to a request made before an invalidation is not cached.
+  get("cached:key2");
+  ASSERT_NE(nullptr, push_callbacks);
+  auto invalidation = std::make_unique<Common::Redis::RespValue>(
+      makeBulkStringArray({"message", "__redis__:invalidate", ""}));
+  invalidation->asArray()[2] = makeBulkStringArray({"cached:key"});
+  push_callbacks->onPushValue(std::move(invalidation));
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("cached:key"));
+  respond("value");
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("cached:key2"));
+
+  // Closing the invalidation client clears the cache.
+  get("cached:key");
+  respond("value3");
+  EXPECT_NE(nullptr, conn_pool_->cachedResponse("cached:key"));
+  invalidation_client->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("cached:key"));
+
+  tls_.shutdownThread();
+}
+
+// A host whose tracking fails to be set up isn't reconnected to until the backoff, which doubles
+// on each failure, expires.
+TEST_F(RedisConnPoolImplTest, NearCacheTrackingFailureBackoff) {
+  near_cache_.emplace();
+  near_cache_->set_max_bytes(1024);
+  near_cache_->mutable_ttl()->set_seconds(60);
+  near_cache_->add_key_prefixes("cached:");
+  setup();
+
+  MockPoolCallbacks callbacks;
+  Common::Redis::Client::MockPoolRequest active_request;
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* invalidation_client1 =
+      new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* invalidation_client2 =
+      new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* invalidation_client3 =
+      new NiceMock<Common::Redis::Client::MockClient>();
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillRepeatedly(Return(cm_.thread_local_cluster_.lb_.host_));
+  EXPECT_CALL(*cm_.thread_local_cluster_.lb_.host_, address())
+      .WillRepeatedly(Return(test_address_));
+  EXPECT_CALL(*this, create_(_))
+      .WillOnce(Return(client))
+      .WillOnce(Return(invalidation_client1))
+      .WillOnce(Return(invalidation_client2))
+      .WillOnce(Return(invalidation_client3));
+  EXPECT_CALL(*client, makeRequest_(_, _)).WillRepeatedly(Return(&active_request));
+  for (auto* invalidation_client :
+       {invalidation_client1, invalidation_client2, invalidation_client3}) {
+    EXPECT_CALL(*invalidation_client, makeRequest_(_, _)).WillRepeatedly(Return(&active_request));
+  }
+
+  auto get = [&]() {
+    Common::Redis::RespValueSharedPtr request =
+        std::make_shared<Common::Redis::RespValue>(makeBulkStringArray({"get", "cached:key"}));
+    EXPECT_NE(nullptr, conn_pool_->makeRequest("cached:key", request, callbacks, transaction_));
+    EXPECT_CALL(callbacks, onResponse_(_));
+    client->client_callbacks_.back()->onResponse(makeBulkString("value"));
+  };
+  auto advance = [&](std::chrono::milliseconds duration) {
+    tls_.dispatcher_.globalTimeSystem().advanceTimeWait(duration);
+  };
+
+  // The host rejects enabling tracking.
+  get();
+  auto error = std::make_unique<Common::Redis::RespValue>();
+  error->type(Common::Redis::RespType::Error);
+  error->asString() = "ERR unknown subcommand";
+  invalidation_client1->client_callbacks_.back()->onResponse(std::move(error));
+  EXPECT_EQ(1, nearCacheTrackingFailed().value());
+
+  // The host isn't reconnected to until a second passed.
+  get();
+  advance(std::chrono::milliseconds(999));
+  get();
+  advance(std::chrono::milliseconds(1));
+  get();
+
+  // The host can't be connected to, so the backoff doubles.
+  invalidation_client2->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(2, nearCacheTrackingFailed().value());
+  advance(std::chrono::seconds(1));
+  get();
+  advance(std::chrono::seconds(1));
+  get();
+  EXPECT_EQ(nullptr, conn_pool_->cachedResponse("cached:key"));
+
+  // Shutting down isn't a failure.
+  tls_.shutdownThread();
+  EXPECT_EQ(2, nearCacheTrackingFailed().value());
+}
+
 // This test removes a host from a ConnPool that was never added in the first place. No errors
 // should be encountered.
 TEST_F(RedisConnPoolImplTest, HostRemovedNeverAdded) {
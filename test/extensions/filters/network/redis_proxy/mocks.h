@@ -92,6 +92,7 @@ public:
 
   MOCK_METHOD(Common::Redis::Client::PoolRequest*, makeRequest_,
               (const std::string& hash_key, RespVariant& request, PoolCallbacks& callbacks));
+  MOCK_METHOD(Common::Redis::RespValuePtr, cachedResponse, (const std::string& key));
   MOCK_METHOD(bool, onRedirection, ());
 };
 } // namespace ConnPool
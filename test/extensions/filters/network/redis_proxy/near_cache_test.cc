@@ -0,0 +1,147 @@
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/filters/network/redis_proxy/v3/redis_proxy.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/network/redis_proxy/near_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+namespace {
+
+class NearCacheTest : public testing::Test {
+public:
+  NearCacheTest() {
+    config_.set_max_bytes(1024);
+    config_.mutable_ttl()->set_seconds(10);
+  }
+
+  static Common::Redis::RespValue bulkString(const std::string& string) {
+    Common::Redis::RespValue value;
+    value.type(Common::Redis::RespType::BulkString);
+    value.asString() = string;
+    return value;
+  }
+
+  envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::NearCache config_;
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(NearCacheTest, InsertAndLookup) {
+  NearCache cache(config_, time_system_);
+  EXPECT_EQ(nullptr, cache.lookup("key"));
+
+  EXPECT_EQ(0, cache.insert("key", bulkString("value")));
+  EXPECT_EQ(0, cache.insert("null", Common::Redis::RespValue()));
+  EXPECT_EQ(2, cache.size());
+  Common::Redis::RespValuePtr value = cache.lookup("key");
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(bulkString("value"), *value);
+  value = cache.lookup("null");
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(Common::Redis::RespType::Null, value->type());
+
+  // Inserting a key again replaces its entry.
+  const uint64_t bytes = cache.bytes();
+  EXPECT_EQ(0, cache.insert("key", bulkString("value2")));
+  EXPECT_EQ(bulkString("value2"), *cache.lookup("key"));
+  EXPECT_EQ(bytes + 1, cache.bytes());
+}
+
+TEST_F(NearCacheTest, Expiry) {
+  NearCache cache(config_, time_system_);
+  cache.insert("key", bulkString("value"));
+  time_system_.advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_NE(nullptr, cache.lookup("key"));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, cache.lookup("key"));
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.bytes());
+}
+
+TEST_F(NearCacheTest, EvictsLeastRecentlyUsed) {
+  NearCache cache(config_, time_system_);
+  const std::string value(200, 'v');
+  EXPECT_EQ(0, cache.insert("key1", bulkString(value)));
+  EXPECT_EQ(0, cache.insert("key2", bulkString(value)));
+  EXPECT_EQ(0, cache.insert("key3", bulkString(value)));
+  EXPECT_NE(nullptr, cache.lookup("key1"));
+
+  EXPECT_EQ(1, cache.insert("key4", bulkString(value)));
+  EXPECT_LE(cache.bytes(), config_.max_bytes());
+  EXPECT_NE(nullptr, cache.lookup("key1"));
+  EXPECT_EQ(nullptr, cache.lookup("key2"));
+  EXPECT_NE(nullptr, cache.lookup("key3"));
+  EXPECT_NE(nullptr, cache.lookup("key4"));
+
+  // Values larger than the cache are not cached.
+  EXPECT_EQ(0, cache.insert("key5", bulkString(std::string(1024, 'v'))));
+  EXPECT_EQ(nullptr, cache.lookup("key5"));
+  EXPECT_EQ(3, cache.size());
+}
+
+// The size of a value held in a buffer is accounted for without copying it.
+TEST_F(NearCacheTest, BufferedValue) {
+  NearCache cache(config_, time_system_);
+  auto buffer = std::make_shared<Buffer::OwnedImpl>(std::string(512, 'v'));
+  Common::Redis::RespValue value;
+  value.type(Common::Redis::RespType::BulkString);
+  value.buffer(buffer);
+  cache.insert("key", value);
+  EXPECT_GT(cache.bytes(), 512);
+
+  Common::Redis::RespValuePtr cached = cache.lookup("key");
+  ASSERT_NE(nullptr, cached);
+  EXPECT_EQ(buffer, cached->buffer());
+}
+
+TEST_F(NearCacheTest, Invalidate) {
+  NearCache cache(config_, time_system_);
+  cache.insert("key1", bulkString("value"));
+  cache.insert("key2", bulkString("value"));
+
+  uint64_t generation = cache.generation();
+  EXPECT_TRUE(cache.invalidate("key1"));
+  EXPECT_NE(generation, cache.generation());
+  EXPECT_EQ(nullptr, cache.lookup("key1"));
+  EXPECT_NE(nullptr, cache.lookup("key2"));
+
+  // Invalidating a key which is not cached still changes the generation.
+  generation = cache.generation();
+  EXPECT_FALSE(cache.invalidate("key1"));
+  EXPECT_NE(generation, cache.generation());
+
+  generation = cache.generation();
+  cache.clear();
+  EXPECT_NE(generation, cache.generation());
+  EXPECT_EQ(nullptr, cache.lookup("key2"));
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(0, cache.bytes());
+}
+
+TEST_F(NearCacheTest, KeyPrefixes) {
+  EXPECT_TRUE(NearCache(config_, time_system_).cacheableKey("key"));
+
+  config_.add_key_prefixes("a:");
+  config_.add_key_prefixes("b:");
+  NearCache cache(config_, time_system_);
+  EXPECT_TRUE(cache.cacheableKey("a:key"));
+  EXPECT_TRUE(cache.cacheableKey("b:key"));
+  EXPECT_FALSE(cache.cacheableKey("c:key"));
+  EXPECT_FALSE(cache.cacheableKey("a"));
+}
+
+} // namespace
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -15,6 +15,7 @@
 #include "test/extensions/filters/udp/udp_proxy/mocks.h"
 #include "test/mocks/api/mocks.h"
 #include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/network/mocks.h"
 #include "test/mocks/network/socket.h"
 #include "test/mocks/server/factory_context.h"
 #include "test/mocks/server/listener_factory_context.h"
@@ -24,6 +25,7 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/registry.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
@@ -35,6 +37,7 @@ using testing::DoAll;
 using testing::DoDefault;
 using testing::InSequence;
 using testing::InvokeWithoutArgs;
+using testing::Property;
 using testing::Return;
 using testing::ReturnNew;
 using testing::ReturnRef;
@@ -63,6 +66,42 @@ Api::IoCallUint64Result makeError(int sys_errno) {
   return {0, Network::IoSocketError::create(sys_errno)};
 }
 
+// Creates upstream writers which batch the datagrams written until they are flushed.
+class BatchWriterFactoryFactory : public Network::UdpPacketWriterFactoryFactory {
+public:
+  std::string name() const override { return "envoy.udp_packet_writer.test_batch"; }
+  Network::UdpPacketWriterFactoryPtr
+  createUdpPacketWriterFactory(const envoy::config::core::v3::TypedExtensionConfig&) override {
+    auto factory = std::make_unique<NiceMock<Network::MockUdpPacketWriterFactory>>();
+    ON_CALL(*factory, createUdpPacketWriter(_, _))
+        .WillByDefault(
+            Invoke([this](Network::IoHandle&, Stats::Scope&) -> Network::UdpPacketWriterPtr {
+              auto writer = std::make_unique<NiceMock<Network::MockUdpPacketWriter>>();
+              ON_CALL(*writer, isBatchMode()).WillByDefault(Return(true));
+              ON_CALL(*writer, writePacket(_, _, _))
+                  .WillByDefault(Invoke([this](const Buffer::Instance& buffer,
+                                               const Network::Address::Ip*,
+                                               const Network::Address::Instance&) {
+                    batched_.push_back(buffer.toString());
+                    return makeNoError(buffer.length());
+                  }));
+              ON_CALL(*writer, flush()).WillByDefault(Invoke([this]() {
+                flushed_.insert(flushed_.end(), batched_.begin(), batched_.end());
+                batched_.clear();
+                return makeNoError(0);
+              }));
+              return writer;
+            }));
+    return factory;
+  }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+
+  std::vector<std::string> batched_;
+  std::vector<std::string> flushed_;
+};
+
 class UdpProxyFilterBase : public testing::Test {
 public:
   UdpProxyFilterBase() {
@@ -637,6 +676,108 @@ matcher:
   EXPECT_EQ(output_.back(), "fake_cluster 0 10 1 0 2");
 }
 
+// Datagrams written upstream by a batching writer are flushed at the end of the event loop
+// iteration, and the batch sizes are recorded.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  BatchWriterFactoryFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterFactoryFactory> registered_writer_factory(
+      writer_factory);
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.test_batch
+  typed_config:
+    '@type': type.googleapis.com/google.protobuf.Struct
+  )EOF"));
+
+  Stats::MockIsolatedStatsStore& stats_store =
+      factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_;
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(2);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration()).Times(2);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  EXPECT_EQ(std::vector<std::string>({"hello", "hello2"}), writer_factory.batched_);
+  EXPECT_TRUE(writer_factory.flushed_.empty());
+
+  EXPECT_CALL(stats_store, deliverHistogramToSinks(
+                               Property(&Stats::Metric::name, "udp.sess_tx_batch_size"), 2));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(std::vector<std::string>({"hello", "hello2"}), writer_factory.flushed_);
+  EXPECT_EQ(2, TestUtility::findCounter(stats_store, "udp.sess_tx_datagrams")->value());
+  EXPECT_EQ(11, factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+                    ->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+
+  // The datagrams read from the upstream in one read event are recorded as a batch.
+  EXPECT_CALL(stats_store, deliverHistogramToSinks(
+                               Property(&Stats::Metric::name, "udp.sess_rx_batch_size"), 1));
+  test_sessions_[0].recvDataFromUpstream("world");
+  checkTransferStats(11 /*rx_bytes*/, 2 /*rx_datagrams*/, 5 /*tx_bytes*/, 1 /*tx_datagrams*/);
+
+  // Datagrams which are still batched when the session is destroyed are flushed.
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  EXPECT_CALL(stats_store, deliverHistogramToSinks(
+                               Property(&Stats::Metric::name, "udp.sess_tx_batch_size"), 1));
+  filter_.reset();
+  EXPECT_EQ(std::vector<std::string>({"hello", "hello2", "hello3"}), writer_factory.flushed_);
+}
+
+// An empty datagram has no slice for a batching writer to copy, so it is written directly, after
+// the datagrams batched before it are flushed.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWritesEmptyDatagram) {
+  BatchWriterFactoryFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterFactoryFactory> registered_writer_factory(
+      writer_factory);
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.test_batch
+  typed_config:
+    '@type': type.googleapis.com/google.protobuf.Struct
+  )EOF"));
+
+  Stats::MockIsolatedStatsStore& stats_store =
+      factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_;
+  expectSessionCreate(upstream_address_);
+  auto* flush_cb = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(2);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  EXPECT_CALL(*flush_cb, cancel());
+  EXPECT_CALL(stats_store, deliverHistogramToSinks(
+                               Property(&Stats::Metric::name, "udp.sess_tx_batch_size"), 1));
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_, sendmsg(_, 0, 0, _, _))
+      .WillOnce(Return(ByMove(makeNoError(0))));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "");
+  EXPECT_EQ(std::vector<std::string>({"hello"}), writer_factory.flushed_);
+  EXPECT_TRUE(writer_factory.batched_.empty());
+  EXPECT_EQ(2, TestUtility::findCounter(stats_store, "udp.sess_tx_datagrams")->value());
+}
+
 // Verify upstream connect error handling.
 TEST_F(UdpProxyFilterTest, ConnectErrorHandling) {
   InSequence s;
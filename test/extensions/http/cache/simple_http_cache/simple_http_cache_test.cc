@@ -2,6 +2,7 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
@@ -26,7 +27,10 @@ public:
   bool validationEnabled() const override { return true; }
 
 private:
-  std::shared_ptr<SimpleHttpCache> cache_ = std::make_shared<SimpleHttpCache>();
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<SimpleHttpCache> cache_ = std::make_shared<SimpleHttpCache>(
+      envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig(),
+      *stats_store_.rootScope());
 };
 
 INSTANTIATE_TEST_SUITE_P(SimpleHttpCacheTest, HttpCacheImplementationTest,
@@ -35,6 +39,121 @@ INSTANTIATE_TEST_SUITE_P(SimpleHttpCacheTest, HttpCacheImplementationTest,
                            return "SimpleHttpCache";
                          });
 
+class SimpleHttpCacheShardTest : public testing::Test {
+public:
+  void initialize(uint32_t shard_count, uint64_t max_size_bytes) {
+    envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig config;
+    config.mutable_shard_count()->set_value(shard_count);
+    config.set_max_size_bytes(max_size_bytes);
+    cache_ = std::make_unique<SimpleHttpCache>(config, *stats_store_.rootScope());
+  }
+
+  LookupRequest request(absl::string_view path) {
+    Http::TestRequestHeaderMapImpl request_headers{{":path", std::string(path)},
+                                                   {":method", "GET"},
+                                                   {":scheme", "https"},
+                                                   {":authority", "example.com"}};
+    return {request_headers, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  bool insert(absl::string_view path, std::string body) {
+    return cache_->insert(request(path).key(),
+                          std::make_unique<Http::TestResponseHeaderMapImpl>(
+                              Http::TestResponseHeaderMapImpl{{":status", "200"}}),
+                          ResponseMetadata{time_system_.systemTime()}, std::move(body), nullptr);
+  }
+
+  bool cached(absl::string_view path) { return cache_->lookup(request(path)).body_ != nullptr; }
+
+  uint64_t shardCounterSum(absl::string_view name) {
+    uint64_t sum = 0;
+    for (size_t shard = 0; shard < cache_->shardCount(); ++shard) {
+      sum += TestUtility::findCounter(stats_store_,
+                                      absl::StrCat("simple_http_cache.shard_", shard, ".", name))
+                 ->value();
+    }
+    return sum;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  VaryAllowList vary_allow_list_{
+      Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>()};
+  std::unique_ptr<SimpleHttpCache> cache_;
+};
+
+TEST_F(SimpleHttpCacheShardTest, EvictsLeastRecentlyUsed) {
+  // Two of the entries fit into the cache, three do not.
+  initialize(1, 25000);
+  EXPECT_TRUE(insert("/a", std::string(10000, 'a')));
+  EXPECT_TRUE(insert("/b", std::string(10000, 'b')));
+  EXPECT_TRUE(cached("/a"));
+
+  EXPECT_TRUE(insert("/c", std::string(10000, 'c')));
+  EXPECT_EQ(1, cache_->shardStats(0).evictions_.value());
+  EXPECT_EQ(2, cache_->shardStats(0).entries_.value());
+  EXPECT_LE(cache_->shardStats(0).size_bytes_.value(), 25000);
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_FALSE(cached("/b"));
+  EXPECT_TRUE(cached("/c"));
+}
+
+TEST_F(SimpleHttpCacheShardTest, ReplacesEntry) {
+  initialize(1, 25000);
+  EXPECT_TRUE(insert("/a", std::string(10000, 'a')));
+  EXPECT_TRUE(insert("/a", std::string(20000, 'a')));
+  EXPECT_EQ(0, cache_->shardStats(0).evictions_.value());
+  EXPECT_EQ(1, cache_->shardStats(0).entries_.value());
+  EXPECT_EQ(20000, cache_->lookup(request("/a")).body_->size());
+}
+
+TEST_F(SimpleHttpCacheShardTest, DoesNotInsertEntryLargerThanShard) {
+  initialize(4, 40000);
+  EXPECT_FALSE(insert("/a", std::string(20000, 'a')));
+  EXPECT_FALSE(cached("/a"));
+  EXPECT_TRUE(insert("/b", std::string(5000, 'b')));
+  EXPECT_TRUE(cached("/b"));
+}
+
+TEST_F(SimpleHttpCacheShardTest, UnboundedSize) {
+  initialize(2, 0);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(insert(absl::StrCat("/", i), std::string(10000, 'a')));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(cached(absl::StrCat("/", i)));
+  }
+  EXPECT_EQ(0, shardCounterSum("evictions"));
+}
+
+TEST_F(SimpleHttpCacheShardTest, ShardStats) {
+  initialize(8, 0);
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_TRUE(insert(absl::StrCat("/", i), "body"));
+  }
+  for (int i = 0; i < 64; ++i) {
+    const std::string path = absl::StrCat("/", i);
+    const size_t shard = cache_->shardIndex(request(path).key());
+    const uint64_t hits = cache_->shardStats(shard).lookup_hits_.value();
+    const uint64_t misses = cache_->shardStats(shard).lookup_misses_.value();
+    EXPECT_EQ(i < 32, cached(path));
+    EXPECT_EQ(hits + (i < 32 ? 1 : 0), cache_->shardStats(shard).lookup_hits_.value());
+    EXPECT_EQ(misses + (i < 32 ? 0 : 1), cache_->shardStats(shard).lookup_misses_.value());
+  }
+  EXPECT_EQ(32, shardCounterSum("lookup_hits"));
+  EXPECT_EQ(32, shardCounterSum("lookup_misses"));
+}
+
+TEST_F(SimpleHttpCacheShardTest, LookupsShareBody) {
+  initialize(1, 0);
+  EXPECT_TRUE(insert("/a", "body"));
+  const SimpleHttpCache::Entry first = cache_->lookup(request("/a"));
+  const SimpleHttpCache::Entry second = cache_->lookup(request("/a"));
+  ASSERT_NE(nullptr, first.body_);
+  EXPECT_EQ(first.body_.get(), second.body_.get());
+  EXPECT_EQ("body", *first.body_);
+}
+
 TEST(Registration, GetFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cmath>
+
+#include "source/extensions/load_balancing_policies/peak_ewma/peak_ewma_lb.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/mocks/upstream/priority_set.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class PeakEwmaHostDataTest : public Event::TestUsingSimulatedTime, public testing::Test {
+protected:
+  PeakEwmaHostData host_data_{std::chrono::seconds(10), std::chrono::milliseconds(30), simTime()};
+};
+
+TEST_F(PeakEwmaHostDataTest, InitialRtt) {
+  EXPECT_DOUBLE_EQ(30e6, host_data_.rtt(simTime().monotonicTime()));
+  const auto gauges = host_data_.gauges();
+  ASSERT_EQ(1, gauges.size());
+  EXPECT_EQ("peak_ewma_rtt_us", gauges[0].first);
+  EXPECT_EQ(30000, gauges[0].second.get().value());
+}
+
+// Round trip times above the estimate replace it, and lower ones are averaged in.
+TEST_F(PeakEwmaHostDataTest, PeakAndAverage) {
+  host_data_.onRequestRtt(std::chrono::milliseconds(100));
+  EXPECT_DOUBLE_EQ(100e6, host_data_.rtt(simTime().monotonicTime()));
+  EXPECT_EQ(100000, host_data_.gauges()[0].second.get().value());
+
+  // A round trip time right after the previous one barely moves the estimate.
+  host_data_.onRequestRtt(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(100e6, host_data_.rtt(simTime().monotonicTime()));
+
+  // After the decay time, the previous estimate has a weight of 1/e.
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  host_data_.onRequestRtt(std::chrono::milliseconds(10));
+  EXPECT_NEAR(100e6 * std::exp(-1) + 10e6 * (1 - std::exp(-1)),
+              host_data_.rtt(simTime().monotonicTime()), 1);
+}
+
+// Without new round trip times the estimate decays towards zero.
+TEST_F(PeakEwmaHostDataTest, Decay) {
+  host_data_.onRequestRtt(std::chrono::milliseconds(100));
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_NEAR(100e6 * std::exp(-1), host_data_.rtt(simTime().monotonicTime()), 1);
+  // The gauge reports the estimate as of the last round trip time.
+  EXPECT_EQ(100000, host_data_.gauges()[0].second.get().value());
+}
+
+// A failed request only raises the estimate to the time it took.
+TEST_F(PeakEwmaHostDataTest, Failure) {
+  host_data_.onRequestFailure(std::chrono::milliseconds(10));
+  EXPECT_DOUBLE_EQ(30e6, host_data_.rtt(simTime().monotonicTime()));
+
+  host_data_.onRequestFailure(std::chrono::seconds(1));
+  EXPECT_DOUBLE_EQ(1e9, host_data_.rtt(simTime().monotonicTime()));
+  EXPECT_EQ(1000000, host_data_.gauges()[0].second.get().value());
+
+  // A failure below the decayed estimate doesn't reset its decay.
+  simTime().advanceTimeWait(std::chrono::seconds(10));
+  host_data_.onRequestFailure(std::chrono::milliseconds(100));
+  EXPECT_NEAR(1e9 * std::exp(-1), host_data_.rtt(simTime().monotonicTime()), 1);
+}
+
+class PeakEwmaLoadBalancerTest : public Event::TestUsingSimulatedTime, public testing::Test {
+protected:
+  void init() {
+    host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                                makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+    host_set_.hosts_ = host_set_.healthy_hosts_;
+    host_set_.runCallbacks({}, {});
+    thread_aware_lb_ = std::make_unique<PeakEwmaThreadAwareLoadBalancer>(
+        config_, *info_, priority_set_, runtime_, random_, simTime());
+    thread_aware_lb_->initialize();
+    lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+  }
+
+  // Picks between the two hosts.
+  HostConstSharedPtr chooseHost() {
+    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+    return lb_->chooseHost(nullptr);
+  }
+
+  PeakEwmaHostData& hostData(const HostSharedPtr& host) {
+    return dynamic_cast<PeakEwmaHostData&>(host->lbPolicyData().ref());
+  }
+
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<MockPrioritySet> priority_set_;
+  MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  PeakEwmaLbProto config_;
+  std::unique_ptr<PeakEwmaThreadAwareLoadBalancer> thread_aware_lb_;
+  LoadBalancerPtr lb_;
+};
+
+TEST_F(PeakEwmaLoadBalancerTest, NoHosts) {
+  thread_aware_lb_ = std::make_unique<PeakEwmaThreadAwareLoadBalancer>(
+      config_, *info_, priority_set_, runtime_, random_, simTime());
+  thread_aware_lb_->initialize();
+  lb_ = thread_aware_lb_->factory()->create({priority_set_, nullptr});
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+}
+
+// The cost of a host is its estimated round trip time times its active requests plus one.
+TEST_F(PeakEwmaLoadBalancerTest, PicksLowestCost) {
+  init();
+  const HostVector& hosts = host_set_.healthy_hosts_;
+
+  // Both hosts start with the default round trip time, so their active requests decide.
+  hosts[0]->stats().rq_active_.set(1);
+  EXPECT_EQ(hosts[1], chooseHost());
+  hosts[0]->stats().rq_active_.set(0);
+  EXPECT_EQ(hosts[0], chooseHost());
+
+  hostData(hosts[0]).onRequestRtt(std::chrono::milliseconds(100));
+  EXPECT_EQ(hosts[1], chooseHost());
+
+  // 30ms * 3 is still cheaper than 100ms * 1, but 30ms * 4 is not.
+  hosts[1]->stats().rq_active_.set(2);
+  EXPECT_EQ(hosts[1], chooseHost());
+  hosts[1]->stats().rq_active_.set(3);
+  EXPECT_EQ(hosts[0], chooseHost());
+}
+
+// A host whose requests only timed out, so it has no round trip time, is not preferred over hosts
+// with outstanding requests.
+TEST_F(PeakEwmaLoadBalancerTest, TimedOutHostNotPreferred) {
+  init();
+  const HostVector& hosts = host_set_.healthy_hosts_;
+
+  hostData(hosts[0]).onRequestFailure(std::chrono::seconds(1));
+  hosts[1]->stats().rq_active_.set(10);
+  EXPECT_EQ(hosts[1], chooseHost());
+}
+
+// Hosts with a zero estimate but outstanding requests cost a penalty, rather than nothing.
+TEST_F(PeakEwmaLoadBalancerTest, ZeroRttPenalty) {
+  config_.mutable_default_rtt()->set_seconds(0);
+  init();
+  const HostVector& hosts = host_set_.healthy_hosts_;
+
+  // Without active requests, a host with a zero estimate is free.
+  hostData(hosts[1]).onRequestRtt(std::chrono::milliseconds(100));
+  hosts[1]->stats().rq_active_.set(5);
+  EXPECT_EQ(hosts[0], chooseHost());
+
+  // With active requests, it costs more than any measured host, and the active requests decide
+  // between such hosts.
+  hosts[0]->stats().rq_active_.set(1);
+  EXPECT_EQ(hosts[1], chooseHost());
+  // The estimate of the measured host decays to zero too.
+  simTime().advanceTimeWait(std::chrono::seconds(1000));
+  EXPECT_EQ(hosts[0], chooseHost());
+}
+
+// Hosts added after the load balancer was initialized get their estimates installed too.
+TEST_F(PeakEwmaLoadBalancerTest, AddedHosts) {
+  init();
+  HostSharedPtr host = makeTestHost(info_, "tcp://127.0.0.1:82", simTime());
+  EXPECT_FALSE(host->lbPolicyData().has_value());
+  host_set_.hosts_.push_back(host);
+  host_set_.runCallbacks({host}, {});
+  ASSERT_TRUE(host->lbPolicyData().has_value());
+  EXPECT_DOUBLE_EQ(30e6, hostData(host).rtt(simTime().monotonicTime()));
+
+  // The estimate is reported with the other gauges of the host, e.g. by /clusters.
+  bool found = false;
+  for (const auto& [name, gauge] : host->gauges()) {
+    if (name == "peak_ewma_rtt_us") {
+      EXPECT_EQ(30000, gauge.get().value());
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
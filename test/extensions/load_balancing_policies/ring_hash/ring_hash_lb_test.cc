@@ -6,6 +6,7 @@
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/router/router.h"
 
+#include "source/common/config/metadata.h"
 #include "source/common/network/utility.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
@@ -578,6 +579,108 @@ TEST_P(RingHashLoadBalancerTest, UnevenHosts) {
   }
 }
 
+// Given updates which leave the number of hashes of most hosts unchanged, expect the ring to be
+// updated incrementally, and to pick the same hosts as a ring built from scratch.
+TEST_P(RingHashLoadBalancerTest, IncrementalUpdate) {
+  for (uint32_t i = 0; i < 1000; ++i) {
+    hostSet().hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 10000 + i), simTime()));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(1024);
+  common_config_.mutable_healthy_panic_threshold()->set_value(0);
+  init();
+  EXPECT_EQ(2000, lb_->stats().size_.value());
+  EXPECT_EQ(2, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_EQ(2, lb_->stats().max_hashes_per_host_.value());
+
+  const auto expect_same_as_new_ring = [this]() {
+    RingHashLoadBalancer new_lb(
+        priority_set_, stats_, *stats_store_.rootScope(), runtime_, random_,
+        makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(config_.value()),
+        common_config_);
+    new_lb.initialize();
+    LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+    LoadBalancerPtr expected_lb = new_lb.factory()->create(lb_params_);
+    for (uint64_t i = 0; i < 10000; ++i) {
+      TestLoadBalancerContext context(i * 0x9E3779B97F4A7C15);
+      EXPECT_EQ(expected_lb->chooseHost(&context), lb->chooseHost(&context));
+    }
+  };
+
+  // Replace a host.
+  hostSet().hosts_[7] = makeTestHost(info_, "tcp://127.0.0.1:20000", simTime());
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(2000, lb_->stats().size_.value());
+  expect_same_as_new_ring();
+
+  // Double the weight of a host, which doubles its number of hashes.
+  hostSet().hosts_[3] = makeTestHost(info_, "tcp://127.0.0.1:10003", simTime(), 2);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(2002, lb_->stats().size_.value());
+  EXPECT_EQ(2, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_EQ(4, lb_->stats().max_hashes_per_host_.value());
+  expect_same_as_new_ring();
+
+  // Mark a host unhealthy.
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 11);
+  hostSet().runCallbacks({}, {});
+  expect_same_as_new_ring();
+
+  // Mark most hosts unhealthy, which changes the number of hashes of every host, so the ring is
+  // built from scratch.
+  hostSet().healthy_hosts_.resize(100);
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(1111, lb_->stats().size_.value());
+  EXPECT_EQ(11, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_EQ(22, lb_->stats().max_hashes_per_host_.value());
+  expect_same_as_new_ring();
+}
+
+// Given an update which only changes the hash_key of a host, which is applied to the host in place,
+// expect the ring to be rebuilt with the new key.
+TEST_P(RingHashLoadBalancerTest, MetadataHashKeyUpdate) {
+  hostSet().hosts_ = {makeTestHostWithHashKey(info_, "90", "tcp://127.0.0.1:90", simTime()),
+                      makeTestHostWithHashKey(info_, "91", "tcp://127.0.0.1:91", simTime()),
+                      makeTestHostWithHashKey(info_, "92", "tcp://127.0.0.1:92", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  init();
+  LoadBalancerPtr old_lb = lb_->factory()->create(lb_params_);
+
+  envoy::config::core::v3::Metadata metadata;
+  Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                         Config::MetadataEnvoyLbKeys::get().HASH_KEY)
+      .set_string_value("99");
+  hostSet().hosts_[1]->metadata(
+      std::make_shared<const envoy::config::core::v3::Metadata>(metadata));
+  hostSet().runCallbacks({}, {});
+
+  RingHashLoadBalancer new_lb(
+      priority_set_, stats_, *stats_store_.rootScope(), runtime_, random_,
+      makeOptRef<const envoy::config::cluster::v3::Cluster::RingHashLbConfig>(config_.value()),
+      common_config_);
+  new_lb.initialize();
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  LoadBalancerPtr expected_lb = new_lb.factory()->create(lb_params_);
+  bool changed = false;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    TestLoadBalancerContext context(i * 0x9E3779B97F4A7C15);
+    HostConstSharedPtr host = lb->chooseHost(&context);
+    EXPECT_EQ(expected_lb->chooseHost(&context), host);
+    changed |= old_lb->chooseHost(&context) != host;
+  }
+  EXPECT_TRUE(changed);
+}
+
 // Given hosts with weights 1, 2 and 3, and a ring size of exactly 6, expect the correct number of
 // hashes for each host.
 TEST_P(RingHashLoadBalancerTest, HostWeightedTinyRing) {
@@ -6,6 +6,7 @@
 
 #include "source/common/common/random_generator.h"
 #include "source/common/memory/stats.h"
+#include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
@@ -28,8 +29,18 @@ namespace {
 
 class SubsetLbTester : public LoadBalancingPolices::Common::BaseTester {
 public:
-  SubsetLbTester(uint64_t num_hosts, bool single_host_per_subset)
+  // Every host has its own subset, unless num_subsets is set, in which case the hosts are spread
+  // evenly over num_subsets subsets.
+  SubsetLbTester(uint64_t num_hosts, bool single_host_per_subset, uint64_t num_subsets = 0)
       : BaseTester(num_hosts, 0, 0, true /* attach metadata */) {
+    if (num_subsets > 0) {
+      const Upstream::HostVector& hosts = priority_set_.getOrCreateHostSet(0).hosts();
+      for (uint64_t i = 0; i < hosts.size(); i++) {
+        hosts[i]->metadata(std::make_shared<envoy::config::core::v3::Metadata>(
+            subsetMetadata(i % num_subsets)));
+      }
+    }
+
     envoy::config::cluster::v3::Cluster::LbSubsetConfig subset_config;
     subset_config.set_fallback_policy(
         envoy::config::cluster::v3::Cluster::LbSubsetConfig::ANY_ENDPOINT);
@@ -64,6 +75,14 @@ public:
         host_moved_, {}, absl::nullopt);
   }
 
+  static envoy::config::core::v3::Metadata subsetMetadata(uint64_t subset) {
+    envoy::config::core::v3::Metadata metadata;
+    ProtobufWkt::Struct& map =
+        (*metadata.mutable_filter_metadata())[Config::MetadataFilters::get().ENVOY_LB];
+    (*map.mutable_fields())[std::string(metadata_key)].set_number_value(subset);
+    return metadata;
+  }
+
   std::unique_ptr<Upstream::LoadBalancerSubsetInfoImpl> subset_info_;
   std::unique_ptr<Upstream::SubsetLoadBalancer> lb_;
   Upstream::HostVectorConstSharedPtr orig_hosts_;
@@ -109,6 +128,67 @@ BENCHMARK(benchmarkSubsetLoadBalancerUpdate)
     ->Ranges({{false, true}, {50, 2500}})
     ->Unit(::benchmark::kMillisecond);
 
+class SubsetLoadBalancerContext : public Upstream::LoadBalancerContextBase {
+public:
+  explicit SubsetLoadBalancerContext(uint64_t subset) {
+    const envoy::config::core::v3::Metadata metadata = SubsetLbTester::subsetMetadata(subset);
+    criteria_ = std::make_unique<Router::MetadataMatchCriteriaImpl>(
+        metadata.filter_metadata().at(Config::MetadataFilters::get().ENVOY_LB));
+  }
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return criteria_.get(); }
+
+private:
+  std::unique_ptr<Router::MetadataMatchCriteria> criteria_;
+};
+
+// Updates of a cluster whose hosts are spread over many subsets, where a single host is removed
+// and added back.
+void benchmarkSubsetLoadBalancerUpdateManySubsets(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_subsets = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, false, num_subsets);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.update();
+  }
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerUpdateManySubsets)
+    ->Args({100, 10})
+    ->Args({10000, 1000})
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkSubsetLoadBalancerChooseHostManySubsets(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_subsets = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, false, num_subsets);
+  std::vector<SubsetLoadBalancerContext> contexts;
+  contexts.reserve(num_subsets);
+  for (uint64_t i = 0; i < num_subsets; i++) {
+    contexts.emplace_back(i);
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(&contexts[i++ % num_subsets]));
+  }
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerChooseHostManySubsets)
+    ->Args({100, 10})
+    ->Args({10000, 1000});
+
 } // namespace
 } // namespace Subset
 } // namespace LoadBalancingPolices
@@ -69,6 +69,13 @@ public:
               legacy_child_lb_creator->lbLeastRequestConfig() != absl::nullopt);
   }
 
+  // Returns the priority set of the subset which the context matches.
+  const PrioritySet& subsetPrioritySet(LoadBalancerContext& context) {
+    auto entry = lb_->findSubset(context.metadataMatchCriteria()->metadataMatchCriteria());
+    EXPECT_NE(nullptr, entry);
+    return dynamic_cast<SubsetLoadBalancer::PriorityLbSubset&>(*entry->lb_subset_).subset_;
+  }
+
 private:
   std::shared_ptr<SubsetLoadBalancer> lb_;
 };
@@ -1340,6 +1347,62 @@ TEST_P(SubsetLoadBalancerTest, UpdateRemovingLastSubsetHost) {
   EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
 }
 
+TEST_P(SubsetLoadBalancerTest, OnlyChangedSubsetsUpdated) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {makeSelector({"version"})};
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:82", {{"version", "1.1"}}},
+      {"tcp://127.0.0.1:83", {{"version", "1.1"}}},
+  });
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  SubsetLoadBalancerInternalStateTester tester(lb_);
+  uint32_t updates_10 = 0;
+  uint32_t updates_11 = 0;
+  auto handle_10 = tester.subsetPrioritySet(context_10).addMemberUpdateCb(
+      [&](const HostVector&, const HostVector&) { updates_10++; });
+  auto handle_11 = tester.subsetPrioritySet(context_11).addMemberUpdateCb(
+      [&](const HostVector&, const HostVector&) { updates_11++; });
+
+  // Removing a host of 1.1 leaves the 1.0 subset as is.
+  HostSharedPtr host_v11 = host_set_.hosts_[3];
+  modifyHosts({}, {host_v11});
+  EXPECT_EQ(0U, updates_10);
+  EXPECT_EQ(1U, updates_11);
+
+  // So does adding it back.
+  modifyHosts({host_v11}, {}, 0);
+  EXPECT_EQ(0U, updates_10);
+  EXPECT_EQ(2U, updates_11);
+
+  // A host of 1.0 becomes unhealthy.
+  host_set_.healthy_hosts_ = {host_set_.hosts_[1], host_set_.hosts_[2], host_set_.hosts_[3]};
+  host_set_.healthy_hosts_per_locality_ = makeHostsPerLocality({host_set_.healthy_hosts_});
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1U, updates_10);
+  EXPECT_EQ(2U, updates_11);
+  EXPECT_EQ(1U,
+            tester.subsetPrioritySet(context_10).hostSetsPerPriority()[0]->healthyHosts().size());
+
+  // The weight of a host of 1.1 changes.
+  host_set_.hosts_[2]->weight(2);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1U, updates_10);
+  EXPECT_EQ(3U, updates_11);
+
+  // Nothing changed.
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1U, updates_10);
+  EXPECT_EQ(3U, updates_11);
+}
+
 TEST_P(SubsetLoadBalancerTest, UpdateRemovingUnknownHost) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
       .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
@@ -0,0 +1,112 @@
+#include <chrono>
+
+#include "source/extensions/load_balancing_policies/worker_least_request/worker_least_request_lb.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/mocks/upstream/host_set.h"
+#include "test/mocks/upstream/priority_set.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class WorkerLeastRequestLoadBalancerTest : public Event::TestUsingSimulatedTime,
+                                           public testing::Test {
+protected:
+  WorkerLeastRequestLoadBalancerTest()
+      : stat_names_(stats_store_.symbolTable()), stats_(stat_names_, *stats_store_.rootScope()) {
+    config_.mutable_sync_interval()->set_seconds(1);
+  }
+
+  void init() {
+    host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                                makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+    host_set_.hosts_ = host_set_.healthy_hosts_;
+    host_set_.runCallbacks({}, {});
+    lb_ = std::make_unique<WorkerLeastRequestLoadBalancer>(
+        priority_set_, nullptr, stats_, runtime_, random_, 50, config_, simTime());
+  }
+
+  // Picks between the two hosts.
+  HostConstSharedPtr chooseHost() {
+    EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(1));
+    return lb_->chooseHost(nullptr);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterLbStatNames stat_names_;
+  ClusterLbStats stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<MockPrioritySet> priority_set_;
+  MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  WorkerLeastRequestLbProto config_;
+  std::unique_ptr<WorkerLeastRequestLoadBalancer> lb_;
+};
+
+TEST_F(WorkerLeastRequestLoadBalancerTest, NoHosts) {
+  lb_ = std::make_unique<WorkerLeastRequestLoadBalancer>(
+      priority_set_, nullptr, stats_, runtime_, random_, 50, config_, simTime());
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+}
+
+// Between syncs, hosts are compared by the requests this worker sent to them.
+TEST_F(WorkerLeastRequestLoadBalancerTest, CountsPicksBetweenSyncs) {
+  init();
+  const HostVector& hosts = host_set_.healthy_hosts_;
+
+  EXPECT_EQ(hosts[0], chooseHost());
+  EXPECT_EQ(hosts[1], chooseHost());
+  EXPECT_EQ(hosts[0], chooseHost());
+
+  // Requests of other workers are not seen until the next sync.
+  hosts[0]->stats().rq_active_.set(10);
+  EXPECT_EQ(hosts[1], chooseHost());
+  EXPECT_EQ(hosts[0], chooseHost());
+
+  // Once synced, the cluster wide count replaces the picks of this worker.
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  hosts[1]->stats().rq_active_.set(2);
+  EXPECT_EQ(hosts[1], chooseHost());
+  for (uint32_t i = 0; i < 7; ++i) {
+    EXPECT_EQ(hosts[1], chooseHost());
+  }
+  // Both hosts are at 10 requests.
+  EXPECT_EQ(hosts[0], chooseHost());
+  EXPECT_EQ(hosts[1], chooseHost());
+}
+
+// A host which is removed and added again starts over with the cluster wide count.
+TEST_F(WorkerLeastRequestLoadBalancerTest, RemovedHost) {
+  init();
+  HostVector hosts = host_set_.healthy_hosts_;
+
+  EXPECT_EQ(hosts[0], chooseHost());
+  EXPECT_EQ(hosts[1], chooseHost());
+  EXPECT_EQ(hosts[0], chooseHost());
+
+  host_set_.healthy_hosts_ = {hosts[1]};
+  host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {hosts[0]});
+  host_set_.healthy_hosts_ = hosts;
+  host_set_.hosts_ = hosts;
+  host_set_.runCallbacks({hosts[0]}, {});
+
+  // The host is synced again, without the 2 requests this worker sent to it.
+  EXPECT_EQ(hosts[0], chooseHost());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,186 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/io/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+protected:
+  IoUringSocketHandleImplTest()
+      : io_uring_worker_factory_(std::make_shared<NiceMock<Io::MockIoUringWorkerFactory>>()) {
+    ON_CALL(*io_uring_worker_factory_, getIoUringWorker())
+        .WillByDefault(Return(OptRef<Io::IoUringWorker>(io_uring_worker_)));
+    ON_CALL(io_uring_worker_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+  }
+
+  void initializeFileEvent(IoHandle& handle, Event::Dispatcher& dispatcher) {
+    handle.initializeFileEvent(
+        dispatcher, [](uint32_t) {}, Event::PlatformDefaultTriggerType,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Io::MockIoUringWorker> io_uring_worker_;
+  std::shared_ptr<NiceMock<Io::MockIoUringWorkerFactory>> io_uring_worker_factory_;
+};
+
+TEST_F(IoUringSocketHandleImplTest, FallbackWithoutIoUringWorker) {
+  IoUringSocketHandleImpl handle(io_uring_worker_factory_, 42, false, AF_INET, true);
+
+  // The file events are initialized on a dispatcher which is not the one of the io_uring worker.
+  NiceMock<Event::MockDispatcher> other_dispatcher;
+  EXPECT_CALL(io_uring_worker_, addServerSocket(_, _)).Times(0);
+  EXPECT_CALL(other_dispatcher, createFileEvent_(42, _, _, _));
+  initializeFileEvent(handle, other_dispatcher);
+
+  EXPECT_CALL(os_sys_calls_, readv(42, _, _)).WillOnce(Return(Api::SysCallSizeResult{5, 0}));
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, handle.read(buffer, absl::nullopt).return_value_);
+
+  // Once the socket used syscalls, it keeps using them.
+  handle.resetFileEvents();
+  EXPECT_CALL(dispatcher_, createFileEvent_(42, _, _, _));
+  initializeFileEvent(handle, dispatcher_);
+
+  EXPECT_CALL(os_sys_calls_, close(42)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_TRUE(handle.close().ok());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ServerSocket) {
+  NiceMock<Io::MockIoUringSocket> io_uring_socket;
+  IoUringSocketHandleImpl handle(io_uring_worker_factory_, 42, false, AF_INET, true);
+
+  EXPECT_CALL(io_uring_worker_, addServerSocket(42, _)).WillOnce(ReturnRef(io_uring_socket));
+  EXPECT_CALL(io_uring_socket,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  initializeFileEvent(handle, dispatcher_);
+
+  EXPECT_CALL(io_uring_socket, read(_, 10))
+      .WillOnce(Invoke([](Buffer::Instance& buffer, uint64_t) {
+        buffer.add("hello");
+        return Api::IoCallUint64Result(5, Api::IoError::none());
+      }));
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, handle.read(buffer, 10).return_value_);
+  EXPECT_EQ("hello", buffer.toString());
+
+  // Reads into slices are copied out of the read buffer of the socket.
+  EXPECT_CALL(io_uring_socket, read(_, 4))
+      .WillOnce(Invoke([](Buffer::Instance& buffer, uint64_t) {
+        buffer.add("abcd");
+        return Api::IoCallUint64Result(4, Api::IoError::none());
+      }));
+  char first[3];
+  char second[3];
+  Buffer::RawSlice slices[2] = {{first, sizeof(first)}, {second, sizeof(second)}};
+  EXPECT_EQ(4, handle.readv(4, slices, 2).return_value_);
+  EXPECT_EQ("abc", absl::string_view(first, 3));
+  EXPECT_EQ('d', second[0]);
+
+  EXPECT_CALL(io_uring_socket, write(_)).WillOnce(Invoke([](Buffer::Instance& buffer) {
+    const uint64_t length = buffer.length();
+    buffer.drain(length);
+    return Api::IoCallUint64Result(length, Api::IoError::none());
+  }));
+  EXPECT_EQ(5, handle.write(buffer).return_value_);
+
+  EXPECT_CALL(io_uring_socket, shutdown(SHUT_WR));
+  EXPECT_EQ(0, handle.shutdown(SHUT_WR).return_value_);
+
+  // Resetting the file events keeps the socket and its buffered data.
+  EXPECT_CALL(io_uring_socket, enableFileEvents(0));
+  EXPECT_CALL(io_uring_socket, setFileReadyCb(_)).Times(2);
+  handle.resetFileEvents();
+  EXPECT_CALL(io_uring_worker_, addServerSocket(_, _)).Times(0);
+  EXPECT_CALL(io_uring_socket,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  initializeFileEvent(handle, dispatcher_);
+
+  // The io_uring socket closes the fd.
+  EXPECT_CALL(io_uring_socket, close());
+  EXPECT_CALL(os_sys_calls_, close(_)).Times(0);
+  EXPECT_TRUE(handle.close().ok());
+  EXPECT_FALSE(handle.isOpen());
+}
+
+TEST_F(IoUringSocketHandleImplTest, AcceptSocket) {
+  NiceMock<Io::MockIoUringSocket> io_uring_socket;
+  NiceMock<Io::MockIoUringSocket> accepted_io_uring_socket;
+  NiceMock<Io::MockIoUringSocket> duplicated_io_uring_socket;
+  IoUringSocketHandleImpl handle(io_uring_worker_factory_, 42, false, AF_INET);
+
+  EXPECT_CALL(os_sys_calls_, listen(42, 128)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  handle.listen(128);
+  EXPECT_CALL(io_uring_worker_, addAcceptSocket(42, _)).WillOnce(ReturnRef(io_uring_socket));
+  initializeFileEvent(handle, dispatcher_);
+
+  EXPECT_CALL(io_uring_socket, accept(nullptr, nullptr))
+      .WillOnce(Return(INVALID_SOCKET))
+      .WillOnce(Return(43));
+  EXPECT_EQ(nullptr, handle.accept(nullptr, nullptr));
+  IoHandlePtr accepted = handle.accept(nullptr, nullptr);
+  ASSERT_NE(nullptr, accepted);
+  EXPECT_EQ(43, accepted->fdDoNotUse());
+
+  // Accepted sockets are connected already.
+  EXPECT_CALL(io_uring_worker_, addServerSocket(43, _))
+      .WillOnce(ReturnRef(accepted_io_uring_socket));
+  initializeFileEvent(*accepted, dispatcher_);
+  EXPECT_CALL(accepted_io_uring_socket, close());
+  accepted.reset();
+
+  // Listen sockets which are duplicated for other workers accept connections as well.
+  EXPECT_CALL(os_sys_calls_, duplicate(42)).WillOnce(Return(Api::SysCallSocketResult{44, 0}));
+  IoHandlePtr duplicated = handle.duplicate();
+  EXPECT_CALL(io_uring_worker_, addAcceptSocket(44, _))
+      .WillOnce(ReturnRef(duplicated_io_uring_socket));
+  initializeFileEvent(*duplicated, dispatcher_);
+
+  EXPECT_CALL(duplicated_io_uring_socket, close());
+  EXPECT_CALL(io_uring_socket, close());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ClientSocket) {
+  NiceMock<Io::MockIoUringSocket> io_uring_socket;
+  IoUringSocketHandleImpl handle(io_uring_worker_factory_, 42, false, AF_INET);
+
+  EXPECT_CALL(io_uring_worker_, addClientSocket(42, _)).WillOnce(ReturnRef(io_uring_socket));
+  initializeFileEvent(handle, dispatcher_);
+
+  auto address = std::make_shared<Address::Ipv4Instance>("127.0.0.1", 80);
+  EXPECT_CALL(io_uring_socket, connect(_));
+  EXPECT_CALL(os_sys_calls_, connect(_, _, _)).Times(0);
+  Api::SysCallIntResult result = handle.connect(address);
+  EXPECT_EQ(-1, result.return_value_);
+  EXPECT_EQ(SOCKET_ERROR_IN_PROGRESS, result.errno_);
+
+  EXPECT_CALL(io_uring_socket, connectError()).WillOnce(Return(ECONNREFUSED));
+  int error = 0;
+  socklen_t error_length = sizeof(error);
+  EXPECT_EQ(0, handle.getOption(SOL_SOCKET, SO_ERROR, &error, &error_length).return_value_);
+  EXPECT_EQ(ECONNREFUSED, error);
+
+  EXPECT_CALL(io_uring_socket, close());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
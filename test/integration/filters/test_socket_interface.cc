@@ -69,7 +69,7 @@ Api::SysCallIntResult TestIoSocketHandle::connect(Address::InstanceConstSharedPt
 }
 
 IoHandlePtr TestSocketInterface::makeSocket(int socket_fd, bool socket_v6only,
-                                            absl::optional<int> domain) const {
+                                            absl::optional<int> domain, Socket::Type) const {
   return std::make_unique<TestIoSocketHandle>(write_override_proc_, socket_fd, socket_v6only,
                                               domain);
 }
@@ -106,8 +106,8 @@ public:
 
 private:
   // SocketInterfaceImpl
-  IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
-                         absl::optional<int> domain) const override;
+  IoHandlePtr makeSocket(int socket_fd, bool socket_v6only, absl::optional<int> domain,
+                         Socket::Type socket_type) const override;
 
   const TestIoSocketHandle::WriteOverrideProc write_override_proc_;
 };
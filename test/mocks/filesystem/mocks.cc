@@ -31,6 +31,20 @@ Api::IoCallSizeResult MockFile::write(absl::string_view buffer) {
   return result;
 }
 
+Api::IoCallSizeResult MockFile::writev(absl::Span<const absl::string_view> buffers) {
+  // Each buffer is passed to write_() so that tests can match on the data of a single write.
+  ssize_t bytes_written = 0;
+  for (absl::string_view buffer : buffers) {
+    Api::IoCallSizeResult result = write(buffer);
+    if (!result.ok() || result.return_value_ != static_cast<ssize_t>(buffer.size())) {
+      return result;
+    }
+    bytes_written += result.return_value_;
+  }
+  return {bytes_written,
+          Api::IoErrorPtr(nullptr, [](Api::IoError*) { PANIC("reached unexpected code"); })};
+}
+
 Api::IoCallSizeResult MockFile::pread(void* buf, uint64_t count, uint64_t offset) {
   absl::MutexLock lock(&mutex_);
   if (!is_open_) {
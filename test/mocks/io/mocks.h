@@ -16,12 +16,16 @@ public:
   MOCK_METHOD(IoUringResult, prepareAccept,
               (os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareMultishotAccept, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareConnect,
               (os_fd_t fd, const Network::Address::InstanceConstSharedPtr& address,
                Request* user_data));
   MOCK_METHOD(IoUringResult, prepareReadv,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareReadFixed,
+              (os_fd_t fd, void* buf, unsigned nbytes, off_t offset, int buf_index,
+               Request* user_data));
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
@@ -29,6 +33,7 @@ public:
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));
   MOCK_METHOD(IoUringResult, submit, ());
+  MOCK_METHOD(IoUringResult, registerBuffers, (const struct iovec* iovecs, unsigned nr_iovecs));
   MOCK_METHOD(void, injectCompletion, (os_fd_t fd, Request* user_data, int32_t result));
   MOCK_METHOD(void, removeInjectedCompletion, (os_fd_t fd));
 };
@@ -45,6 +50,35 @@ public:
   MOCK_METHOD(void, onCancel, (Request * req, int32_t result, bool injected));
   MOCK_METHOD(void, onShutdown, (Request * req, int32_t result, bool injected));
   MOCK_METHOD(void, injectCompletion, (Request::RequestType type));
+  MOCK_METHOD(void, setFileReadyCb, (Event::FileReadyCb cb));
+  MOCK_METHOD(void, enableFileEvents, (uint32_t events));
+  MOCK_METHOD(void, activateFileEvents, (uint32_t events));
+  MOCK_METHOD(void, close, ());
+  MOCK_METHOD(os_fd_t, accept, (struct sockaddr * addr, socklen_t* addrlen));
+  MOCK_METHOD(void, connect, (const Network::Address::InstanceConstSharedPtr& address));
+  MOCK_METHOD(int32_t, connectError, (), (const));
+  MOCK_METHOD(Api::IoCallUint64Result, read, (Buffer::Instance & buffer, uint64_t max_length));
+  MOCK_METHOD(Api::IoCallUint64Result, recv, (void* buffer, size_t length, int flags));
+  MOCK_METHOD(Api::IoCallUint64Result, write, (Buffer::Instance & buffer));
+  MOCK_METHOD(Api::IoCallUint64Result, writev,
+              (const Buffer::RawSlice* slices, uint64_t num_slice));
+  MOCK_METHOD(void, shutdown, (int how));
+};
+
+class MockIoUringWorker : public IoUringWorker {
+public:
+  MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(IoUringSocket&, addAcceptSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(IoUringSocket&, addServerSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(IoUringSocket&, addClientSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(uint32_t, getNumOfSockets, (), (const));
+};
+
+class MockIoUringWorkerFactory : public IoUringWorkerFactory {
+public:
+  MOCK_METHOD(OptRef<IoUringWorker>, getIoUringWorker, ());
+  MOCK_METHOD(void, onWorkerThreadInitialized, ());
+  MOCK_METHOD(bool, currentThreadRegistered, ());
 };
 
 } // namespace Io
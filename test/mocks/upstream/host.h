@@ -77,6 +77,17 @@ public:
   MOCK_METHOD(void, setUnhealthy, (UnhealthyType));
 };
 
+class MockHostLbPolicyData : public HostLbPolicyData {
+public:
+  MockHostLbPolicyData();
+  ~MockHostLbPolicyData() override;
+
+  MOCK_METHOD(void, onRequestRtt, (std::chrono::microseconds rtt));
+  MOCK_METHOD(void, onRequestFailure, (std::chrono::microseconds elapsed));
+  MOCK_METHOD((std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>), gauges,
+              (), (const));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -93,6 +104,7 @@ public:
   MOCK_METHOD(const ClusterInfo&, cluster, (), (const));
   MOCK_METHOD(bool, canCreateConnection, (Upstream::ResourcePriority), (const));
   MOCK_METHOD(Outlier::DetectorHostMonitor&, outlierDetector, (), (const));
+  MOCK_METHOD(OptRef<HostLbPolicyData>, lbPolicyData, (), (const));
   MOCK_METHOD(HealthCheckHostMonitor&, healthChecker, (), (const));
   MOCK_METHOD(const std::string&, hostnameForHealthChecks, (), (const));
   MOCK_METHOD(const std::string&, hostname, (), (const));
@@ -157,6 +169,10 @@ public:
     setOutlierDetector_(outlier_detector);
   }
 
+  void setLbPolicyData(HostLbPolicyDataPtr&& lb_policy_data) override {
+    setLbPolicyData_(lb_policy_data);
+  }
+
   void setLastHcPassTime(MonotonicTime last_hc_pass_time) override {
     setLastHcPassTime_(last_hc_pass_time);
   }
@@ -207,6 +223,8 @@ public:
   MOCK_METHOD(Outlier::DetectorHostMonitor&, outlierDetector, (), (const));
   MOCK_METHOD(void, setHealthChecker_, (HealthCheckHostMonitorPtr & health_checker));
   MOCK_METHOD(void, setOutlierDetector_, (Outlier::DetectorHostMonitorPtr & outlier_detector));
+  MOCK_METHOD(OptRef<HostLbPolicyData>, lbPolicyData, (), (const));
+  MOCK_METHOD(void, setLbPolicyData_, (HostLbPolicyDataPtr & lb_policy_data));
   MOCK_METHOD(void, setLastHcPassTime_, (MonotonicTime & last_hc_pass_time));
   MOCK_METHOD(HostStats&, stats, (), (const));
   MOCK_METHOD(LoadMetricStats&, loadMetricStats, (), (const));
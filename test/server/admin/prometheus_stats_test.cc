@@ -87,6 +87,23 @@ protected:
 
   Stats::StatName makeStat(absl::string_view name) { return pool_.add(name); }
 
+  // Streams the whole response of a request, checking that each chunk stops growing once it
+  // reaches the chunk size.
+  std::string streamResponse(PrometheusStatsRequest& request, uint64_t chunk_size) {
+    request.setChunkSize(chunk_size);
+    Http::TestResponseHeaderMapImpl response_headers;
+    EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+    std::string response;
+    Buffer::OwnedImpl chunk;
+    bool more = true;
+    while (more) {
+      more = request.nextChunk(chunk);
+      response.append(chunk.toString());
+      chunk.drain(chunk.length());
+    }
+    return response;
+  }
+
   // Format tags into the name to create a unique stat_name for each name:tag combination.
   // If the same stat_name is passed to makeGauge() or makeCounter(), even with different
   // tags, a copy of the previous metric will be returned.
@@ -290,23 +307,15 @@ envoy_cluster_default_total_match_count{envoy_cluster_name="a"} 0
 envoy_cluster_default_total_match_count{envoy_cluster_name="x"} 0
 )EOF";
 
-  // Note: in the version of prometheus_stats_test.cc that works with the
-  // streaming GroupedStatsRequest, the test code is slightly different;
-  // it's based on the local 'store' object rather than being based on
-  // the counters_ member variable.
-  //    StatsParams params;
-  //    params.type_ = StatsType::Counters;
-  //    params.format_ = StatsFormat::Prometheus;
-  //    auto request = std::make_unique<GroupedStatsRequest>(store, params, custom_namespaces_);
-  //    EXPECT_EQ(expected_output, response(*request));
-  // This code is left here so that we can verify the bug is fixed if we decide to
-  // re-try the streaming Prometheus implementation.
-
   Buffer::OwnedImpl response;
   const uint64_t size = PrometheusStatsFormatter::statsAsPrometheus(
       counters_, gauges_, histograms_, textReadouts_, response, StatsParams(), custom_namespaces);
   EXPECT_EQ(1, size);
   EXPECT_EQ(expected_output, response.toString());
+
+  // The streaming request groups all the stats of the store before rendering any of them.
+  PrometheusStatsRequest request(store, StatsParams(), custom_namespaces);
+  EXPECT_EQ(expected_output, streamResponse(request, PrometheusStatsRequest::DefaultChunkSize));
 }
 
 TEST_F(PrometheusStatsFormatterTest, HistogramWithNonDefaultBuckets) {
@@ -915,5 +924,71 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   }
 }
 
+// Streams stats of all types in small chunks, which must add up to the same output as the
+// buffered rendering.
+TEST_F(PrometheusStatsFormatterTest, StreamedInChunks) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  Stats::ThreadLocalStoreImpl store(alloc_);
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  store.setTagProducer(std::make_unique<Stats::TagProducerImpl>(stats_config));
+
+  std::vector<Stats::ScopeSharedPtr> scopes;
+  for (absl::string_view cluster : {"x", "a", "m"}) {
+    Stats::ScopeSharedPtr scope =
+        store.rootScope()->createScope(absl::StrCat("cluster.", cluster));
+    scope->counterFromStatName(makeStat("upstream_rq_total")).add(3);
+    scope->counterFromStatName(makeStat("upstream_cx_total")).inc();
+    scope->gaugeFromStatName(makeStat("upstream_cx_active"), Stats::Gauge::ImportMode::Accumulate)
+        .set(2);
+    scope->textReadoutFromStatName(makeStat("version")).set(cluster);
+    scopes.push_back(scope);
+  }
+
+  StatsParams params;
+  params.prometheus_text_readouts_ = true;
+  Buffer::OwnedImpl buffered;
+  PrometheusStatsFormatter::statsAsPrometheus(store.counters(), store.gauges(),
+                                              store.histograms(), store.textReadouts(), buffered,
+                                              params, custom_namespaces);
+  const std::string expected_output = buffered.toString();
+  EXPECT_THAT(expected_output, testing::StartsWith("# TYPE envoy_cluster_upstream_cx_total"));
+
+  for (uint64_t chunk_size : {1, 10, 1000}) {
+    PrometheusStatsRequest request(store, params, custom_namespaces);
+    EXPECT_EQ(expected_output, streamResponse(request, chunk_size)) << chunk_size;
+  }
+
+  // Text readouts are only rendered on request.
+  PrometheusStatsRequest request(store, StatsParams(), custom_namespaces);
+  EXPECT_THAT(streamResponse(request, PrometheusStatsRequest::DefaultChunkSize),
+              testing::Not(testing::HasSubstr("envoy_cluster_version")));
+}
+
+// Stats which are deleted while the response is streamed are still rendered, as the request holds
+// them until they are rendered.
+TEST_F(PrometheusStatsFormatterTest, StatsDeletedWhileStreaming) {
+  Stats::CustomStatNamespacesImpl custom_namespaces;
+  Stats::ThreadLocalStoreImpl store(alloc_);
+  Stats::ScopeSharedPtr scope = store.rootScope()->createScope("scope");
+  scope->counterFromStatName(makeStat("a")).inc();
+  scope->counterFromStatName(makeStat("b")).inc();
+
+  PrometheusStatsRequest request(store, StatsParams(), custom_namespaces);
+  request.setChunkSize(1);
+  Http::TestResponseHeaderMapImpl response_headers;
+  EXPECT_EQ(Http::Code::OK, request.start(response_headers));
+  Buffer::OwnedImpl response;
+  EXPECT_TRUE(request.nextChunk(response));
+  scope.reset();
+  while (request.nextChunk(response)) {
+  }
+  EXPECT_EQ(R"EOF(# TYPE envoy_scope_a counter
+envoy_scope_a{} 1
+# TYPE envoy_scope_b counter
+envoy_scope_b{} 1
+)EOF",
+            response.toString());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -80,24 +80,28 @@ public:
    */
   uint64_t handlerStats(const StatsParams& params) {
     Buffer::OwnedImpl data;
-    if (params.format_ == StatsFormat::Prometheus) {
-      StatsHandler::prometheusRender(*store_, custom_namespaces_, params, data);
-      return data.length();
-    }
-    Admin::RequestPtr request = StatsHandler::makeRequest(*store_, params);
+    Admin::RequestPtr request =
+        params.format_ == StatsFormat::Prometheus
+            ? StatsHandler::makePrometheusRequest(*store_, params, custom_namespaces_)
+            : StatsHandler::makeRequest(*store_, params);
     auto response_headers = Http::ResponseHeaderMapImpl::create();
     request->start(*response_headers);
     uint64_t count = 0;
+    max_chunk_length_ = 0;
     bool more = true;
     do {
       more = request->nextChunk(data);
       count += data.length();
+      max_chunk_length_ = std::max(max_chunk_length_, data.length());
       data.drain(data.length());
     } while (more);
     return count;
   }
 
   std::vector<Stats::ScopeSharedPtr> scopes_;
+  // The length of the longest chunk of the last response, which bounds the memory
+  // used for buffering the response.
+  uint64_t max_chunk_length_{0};
   Envoy::Stats::CustomStatNamespacesImpl custom_namespaces_;
 };
 
@@ -204,6 +208,9 @@ static void BM_AllCountersPrometheus(benchmark::State& state) {
   for (auto _ : state) { // NOLINT
     uint64_t count = test_context.handlerStats(params);
     RELEASE_ASSERT(count > 250 * 1000 * 1000, "expected count > 250M"); // actual = 261,578,000
+    RELEASE_ASSERT(test_context.max_chunk_length_ < 3 * 1000 * 1000,
+                   absl::StrCat("max_chunk_length=", test_context.max_chunk_length_,
+                                ", expected < 3M"));
   }
 }
 BENCHMARK(BM_AllCountersPrometheus)->Unit(benchmark::kMillisecond);
@@ -251,3 +258,17 @@ static void BM_HistogramsJson(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_HistogramsJson)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramsPrometheus(benchmark::State& state) {
+  Envoy::Server::StatsHandlerTest& test_context = testContext();
+  Envoy::Server::StatsParams params;
+  Envoy::Buffer::OwnedImpl response;
+  params.parse("?format=prometheus&filter=^h[0-9]", response);
+
+  for (auto _ : state) { // NOLINT
+    uint64_t count = test_context.handlerStats(params);
+    RELEASE_ASSERT(count > 50 * 1000, absl::StrCat("count=", count, ", expected > 50k"));
+  }
+}
+BENCHMARK(BM_HistogramsPrometheus)->Unit(benchmark::kMillisecond);
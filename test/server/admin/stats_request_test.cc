@@ -183,10 +183,8 @@ TEST_F(StatsRequestTest, OneStatJson) {
 }
 
 TEST_F(StatsRequestTest, OneStatPrometheus) {
-  // Currently the rendering infrastructure does not support Prometheus -- that
-  // gets rendered using a different code-path. This will be fixed at some
-  // point, to make Prometheus consume less resource, and when that occurs this
-  // test can exercise that.
+  // Prometheus groups stats by their tag-extracted names, so it is streamed by
+  // PrometheusStatsRequest rather than this request.
   store_.rootScope()->counterFromStatName(makeStatName("foo"));
   EXPECT_ENVOY_BUG(iterateChunks(*makeRequest(false, StatsFormat::Prometheus, StatsType::All), true,
                                  Http::Code::BadRequest),
@@ -1,14 +1,18 @@
 #include <cstdint>
 #include <memory>
 
+#include "envoy/config/metrics/v3/stats.pb.h"
 #include "envoy/stats/sink.h"
 #include "envoy/stats/stats.h"
 
+#include "source/common/stats/histogram_impl.h"
 #include "source/common/stats/thread_local_store.h"
 #include "source/server/server.h"
 
 #include "test/benchmark/main.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -88,6 +92,58 @@ private:
   Event::SimulatedTimeSystem time_system_;
 };
 
+// Records values into histograms, and merges and flushes them, as the server does at every flush
+// interval.
+class HistogramFlushSpeedTest {
+public:
+  HistogramFlushSpeedTest(size_t const num_histograms, bool fixed_buckets)
+      : stats_allocator_(symbol_table_), stats_store_(stats_allocator_) {
+    envoy::config::metrics::v3::StatsConfig config;
+    config.set_use_fixed_bucket_histograms(fixed_buckets);
+    stats_store_.setHistogramSettings(std::make_unique<Stats::HistogramSettingsImpl>(config));
+    stats_store_.initializeThreading(dispatcher_, tls_);
+
+    for (uint64_t idx = 0; idx < num_histograms; ++idx) {
+      histograms_.push_back(&stats_store_.histogramFromString(
+          absl::StrCat("histogram.", idx), Stats::Histogram::Unit::Milliseconds));
+    }
+  }
+
+  ~HistogramFlushSpeedTest() {
+    tls_.shutdownGlobalThreading();
+    stats_store_.shutdownThreading();
+    tls_.shutdownThread();
+  }
+
+  void test(::benchmark::State& state) {
+    uint64_t value = 0;
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      for (Stats::Histogram* histogram : histograms_) {
+        for (uint64_t i = 0; i < ValuesPerFlush; ++i) {
+          histogram->recordValue(++value % 10000);
+        }
+      }
+      std::list<Stats::SinkPtr> sinks;
+      sinks.emplace_back(new testing::NiceMock<Stats::MockSink>());
+      stats_store_.mergeHistograms([this, &sinks]() {
+        Server::InstanceUtil::flushMetricsToSinks(sinks, stats_store_, time_system_);
+      });
+    }
+  }
+
+private:
+  static constexpr uint64_t ValuesPerFlush = 10;
+
+  testing::NiceMock<Event::MockDispatcher> dispatcher_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::AllocatorImpl stats_allocator_;
+  Stats::ThreadLocalStoreImpl stats_store_;
+  Event::SimulatedTimeSystem time_system_;
+  std::vector<Stats::Histogram*> histograms_;
+};
+
 static void bmFlushToSinks(::benchmark::State& state) {
   // Skip expensive benchmarks for unit tests.
   if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
@@ -110,10 +166,40 @@ static void bmFlushToSinksWithPredicatesSet(::benchmark::State& state) {
   speed_test.test(state);
 }
 
+static void bmFlushHistograms(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  HistogramFlushSpeedTest speed_test(state.range(0), false);
+  speed_test.test(state);
+}
+
+static void bmFlushFixedBucketHistograms(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  HistogramFlushSpeedTest speed_test(state.range(0), true);
+  speed_test.test(state);
+}
+
 BENCHMARK(bmFlushToSinks)->Unit(::benchmark::kMillisecond)->RangeMultiplier(10)->Range(10, 1000000);
 BENCHMARK(bmFlushToSinksWithPredicatesSet)
     ->Unit(::benchmark::kMillisecond)
     ->RangeMultiplier(10)
     ->Range(10, 1000000);
+BENCHMARK(bmFlushHistograms)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
+BENCHMARK(bmFlushFixedBucketHistograms)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
 
 } // namespace Envoy
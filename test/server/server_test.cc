@@ -13,6 +13,7 @@
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/socket_option_impl.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/thread_local_store.h"
 #include "source/common/thread_local/thread_local_impl.h"
 #include "source/common/version/version.h"
 #include "source/server/process_context_impl.h"
@@ -158,6 +159,64 @@ TEST(ServerInstanceUtil, flushImportModeUninitializedGauges) {
   InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
 }
 
+TEST(ServerInstanceUtil, flushChangedOnly) {
+  InSequence s;
+
+  Stats::SymbolTableImpl symbol_table;
+  Stats::AllocatorImpl allocator(symbol_table);
+  Stats::ThreadLocalStoreImpl store(allocator);
+  Stats::StatNamePool pool(symbol_table);
+  Event::SimulatedTimeSystem time_system;
+  Stats::Scope& scope = *store.rootScope();
+  Stats::Counter& c = scope.counterFromStatName(pool.add("hello"));
+  Stats::Gauge& g =
+      scope.gaugeFromStatName(pool.add("world"), Stats::Gauge::ImportMode::Accumulate);
+  scope.histogramFromStatName(pool.add("histogram"), Stats::Histogram::Unit::Unspecified);
+  c.inc();
+  g.set(5);
+  store.trackChangedStats();
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+
+  // The first flush has all the stats, except for the histograms without values.
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "hello");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 1);
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().value(), 5);
+    EXPECT_TRUE(snapshot.histograms().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system, true);
+
+  // Nothing changed since the previous flush.
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+    EXPECT_TRUE(snapshot.histograms().empty());
+    EXPECT_TRUE(snapshot.textReadouts().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system, true);
+
+  c.add(2);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].delta_, 2);
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system, true);
+
+  // A full flush still has all the stats.
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].delta_, 0);
+    EXPECT_EQ(snapshot.gauges().size(), 1);
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
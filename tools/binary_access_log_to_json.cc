@@ -0,0 +1,48 @@
+/**
+ * Utility to decode an access log written by the binary file access logger into JSON, with one
+ * object per record.
+ *
+ * Usage:
+ *
+ * binary_access_log_to_json <access log path>
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/access_loggers/binary_file/block_format.h"
+
+// NOLINT(namespace-envoy)
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <access log path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string data = contents.str();
+
+  Envoy::Extensions::AccessLoggers::BinaryFile::BlockReader reader(data);
+  while (true) {
+    const absl::StatusOr<bool> result = reader.next();
+    if (!result.ok()) {
+      std::cerr << "Invalid access log: " << result.status().message() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!result.value()) {
+      return EXIT_SUCCESS;
+    }
+    // Records are written block by block, so that the whole file is not held as JSON.
+    Envoy::Buffer::OwnedImpl json;
+    reader.recordsToJson(json);
+    std::cout << json.toString();
+  }
+}